@@ -9,6 +9,10 @@ option(BUILD_SCRIPTDEV      "Build ScriptDev. (OFF Speedup build)"  ON)
 option(BUILD_PLAYERBOT      "Build Playerbot mod"                   OFF)
 option(BUILD_AHBOT          "Build Auction House Bot mod"           OFF)
 option(BUILD_METRICS        "Build Metrics, generate data for Grafana" OFF)
+option(BUILD_BENCHMARKS     "Build micro benchmarks"                OFF)
+option(EVENTS_TIMING_WHEEL  "Use timing wheel EventProcessor"       OFF)
+option(EVENTS_POOL_ALLOCATOR "Allocate frequent events from pools"  OFF)
+option(SLAB_ALLOCATOR       "Allocate creatures, gameobjects, items and auras from slabs" OFF)
 option(BUILD_RECASTDEMOMOD  "Build map/vmap/mmap viewer"            OFF)
 option(BUILD_GIT_ID         "Build git_id"                          OFF)
 option(BUILD_DOCS           "Build documentation with doxygen"      OFF)
@@ -61,6 +61,30 @@ else()
   message(STATUS "Build METRICs         : No  (default)")
 endif()
 
+if(BUILD_BENCHMARKS)
+  message(STATUS "Build benchmarks      : Yes")
+else()
+  message(STATUS "Build benchmarks      : No  (default)")
+endif()
+
+if(EVENTS_TIMING_WHEEL)
+  message(STATUS "Timing wheel events   : Yes")
+else()
+  message(STATUS "Timing wheel events   : No  (default)")
+endif()
+
+if(EVENTS_POOL_ALLOCATOR)
+  message(STATUS "Pooled events         : Yes")
+else()
+  message(STATUS "Pooled events         : No  (default)")
+endif()
+
+if(SLAB_ALLOCATOR)
+  message(STATUS "Slab allocator        : Yes")
+else()
+  message(STATUS "Slab allocator        : No  (default)")
+endif()
+
 if(BUILD_PLAYERBOT)
   message(STATUS "Build Playerbot       : Yes")
 else()
@@ -18,24 +18,32 @@
 
 #include <string>
 #include <iostream>
+#include <thread>
+#include <cstdlib>
 
 #include "TileAssembler.h"
 
 //=======================================================
 int main(int argc, char* argv[])
 {
-    if (argc != 3)
+    if (argc != 3 && argc != 4)
     {
-        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir>" << std::endl;
+        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir> [threads]" << std::endl;
+        std::cout << "       threads defaults to the number of cores" << std::endl;
         return 1;
     }
 
     std::string src = argv[1];
     std::string dest = argv[2];
+    int threads = argc == 4 ? atoi(argv[3]) : int(std::thread::hardware_concurrency());
+    if (threads <= 0)
+        threads = 1;
 
     std::cout << "using " << src << " as source directory and writing output to " << dest << std::endl;
+    std::cout << "using " << threads << " thread(s)" << std::endl;
 
     VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest);
+    ta->setThreadCount(threads);
 
     if (!ta->convertWorld2())
     {
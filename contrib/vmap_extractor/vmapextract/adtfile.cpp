@@ -91,7 +91,7 @@ ADTFile::ADTFile(char* filename): ADT(filename)
     Adtfilename.append(filename);
 }
 
-bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY, StringSet& failedPaths)
+bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY, FILE* dirfile, StringSet& failedPaths)
 {
     if (ADT.isEof())
         return false;
@@ -113,15 +113,6 @@ bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY, StringSet& failed
     //printf("xMap = %s\n", xMap.c_str());
     //printf("yMap = %s\n", yMap.c_str());
 
-    std::string dirname = std::string(szWorkDirWmo) + "/dir_bin";
-    FILE* dirfile;
-    dirfile = fopen(dirname.c_str(), "ab");
-    if (!dirfile)
-    {
-        printf("Can't open dirfile!'%s'\n", dirname.c_str());
-        return false;
-    }
-
     while (!ADT.isEof())
     {
         char fourcc[5];
@@ -204,7 +195,11 @@ bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY, StringSet& failed
                     uint32 id;
                     ADT.read(&id, 4);
                     WMOInstance inst(ADT, WmoInstanceNames[id].c_str(), map_num, tileX, tileY, dirfile);
-                    Doodad::ExtractSet(WmoDoodads[WmoInstanceNames[id]], inst.m_wmo, map_num, tileX, tileY, dirfile);
+
+                    // doodads of all wmos are known before the tiles are parsed, look up without inserting
+                    auto doodads = WmoDoodads.find(WmoInstanceNames[id]);
+                    if (doodads != WmoDoodads.end())
+                        Doodad::ExtractSet(doodads->second, inst.m_wmo, map_num, tileX, tileY, dirfile);
                 }
             }
         }
@@ -212,7 +207,6 @@ bool ADTFile::init(uint32 map_num, uint32 tileX, uint32 tileY, StringSet& failed
         ADT.seek(nextpos);
     }
     ADT.close();
-    fclose(dirfile);
 
     return true;
 }
@@ -145,7 +145,8 @@ class ADTFile
         int nMDX;
         std::vector<std::string> WmoInstanceNames;
         std::vector<std::string> ModelInstanceNames;
-        bool init(uint32 map_num, uint32 tileX, uint32 tileY, StringSet& failedPaths);
+        // spawns are written to dirfile, can run for several tiles at once when each tile gets its own file
+        bool init(uint32 map_num, uint32 tileX, uint32 tileY, FILE* dirfile, StringSet& failedPaths);
         //void LoadMapChunks();
 
         //uint32 wmo_count;
@@ -4,8 +4,15 @@
 #include "vmapexport.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include <stdio.h>
 
+// models currently written by a tile worker, others wait for them instead of reading a half written file
+static std::mutex extractMutex;
+static std::condition_variable extractDone;
+static StringSet extractingModels;
+
 bool ExtractSingleModel(std::string& origPath, std::string& fixedName, StringSet& failedPaths)
 {
     if (origPath.length() < 4)
@@ -29,14 +36,27 @@ bool ExtractSingleModel(std::string& origPath, std::string& fixedName, StringSet
     output += "/";
     output += fixedName;
 
-    if (FileExists(output.c_str()))
-        return true;
+    {
+        std::unique_lock<std::mutex> lock(extractMutex);
+        extractDone.wait(lock, [&output]() { return extractingModels.find(output) == extractingModels.end(); });
+
+        if (FileExists(output.c_str()))
+            return true;
+
+        extractingModels.insert(output);
+    }
 
+    bool result = false;
     Model mdl(origPath);                                    // Possible changed fname
-    if (!mdl.open(failedPaths))
-        return false;
+    if (mdl.open(failedPaths))
+        result = mdl.ConvertToVMAPModel(output.c_str());
 
-    return mdl.ConvertToVMAPModel(output.c_str());
+    {
+        std::lock_guard<std::mutex> lock(extractMutex);
+        extractingModels.erase(output);
+    }
+    extractDone.notify_all();
+    return result;
 }
 
 void ExtractGameobjectModels()
@@ -69,6 +69,7 @@ MPQFile::MPQFile(const char* filename):
     for (ArchiveSet::iterator i = gOpenArchives.begin(); i != gOpenArchives.end(); ++i)
     {
         mpq_archive* mpq_a = (*i)->mpq_a;
+        std::lock_guard<std::mutex> guard((*i)->mpqLock);
 
         uint32 filenum;
         if (libmpq__file_number(mpq_a, filename, &filenum)) continue;
@@ -29,6 +29,7 @@
 #include <vector>
 #include <iostream>
 #include <deque>
+#include <mutex>
 
 using namespace std;
 
@@ -37,6 +38,7 @@ class MPQArchive
 
     public:
         mpq_archive_s* mpq_a;
+        std::mutex mpqLock;                                 // libmpq reads through one file handle per archive
 
         MPQArchive(const char* filename);
         void close();
@@ -38,7 +38,12 @@
 //#pragma warning(disable : 4505)
 //#pragma comment(lib, "Winmm.lib")
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 //From Extractor
@@ -71,6 +76,7 @@ char input_path[path_l] = ".";
 bool hasInputPathParam = false;
 bool hasOutputPathParam = false;
 bool preciseVectorData = false;
+unsigned int threadCount = 0;
 std::unordered_map<std::string, WMODoodadData> WmoDoodads;
 
 // Constants
@@ -81,9 +87,45 @@ const char* szRawVMAPMagic = "VMAPs05";
 
 std::map<std::pair<uint32, uint16>, uint32> uniqueObjectIds;
 
+// id field of a spawn record written by a map tile worker, numbered once the whole map is parsed
+struct DeferredObjectId
+{
+    std::pair<uint32, uint16> key;
+    long offset;                                            // in the file of the worker
+};
+
+// spawn records of one map tile, written to the temporary file of the worker that parsed it
+struct TileSpawns
+{
+    TileSpawns() : file(nullptr), start(0), size(0) {}
+
+    FILE* file;
+    long start;
+    long size;
+    std::vector<DeferredObjectId> ids;
+};
+
+thread_local FILE* deferredIdFile = nullptr;
+thread_local std::vector<DeferredObjectId>* deferredIds = nullptr;
+
+// ids are numbered in the order spawns are first seen, map tile workers leave that to ParsMapFiles
+// so the ids do not depend on which worker gets to a spawn first
 uint32 GenerateUniqueObjectId(uint32 clientId, uint16 clientDoodadId)
 {
-    return uniqueObjectIds.emplace(std::make_pair(clientId, clientDoodadId), uniqueObjectIds.size() + 1).first->second;
+    std::pair<uint32, uint16> key(clientId, clientDoodadId);
+    if (deferredIds)
+    {
+        // the record is written right after, its id follows mapID, tileX, tileY, flags and the uint16 set/adt id
+        deferredIds->push_back({ key, ftell(deferredIdFile) + long(4 * sizeof(uint32) + sizeof(uint16)) });
+        return 0;
+    }
+
+    return uniqueObjectIds.emplace(key, uniqueObjectIds.size() + 1).first->second;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 }
 
 // Local testing functions
@@ -263,12 +305,33 @@ bool ExtractSingleWmo(std::string& fname)
     return true;
 }
 
+// copy the spawns of a tile into dir_bin, numbering their ids like a single threaded run would
+void AppendTileSpawns(FILE* dirfile, TileSpawns const& spawns, std::vector<char>& buffer)
+{
+    buffer.resize(spawns.size);
+    fseek(spawns.file, spawns.start, SEEK_SET);
+    if (fread(buffer.data(), 1, spawns.size, spawns.file) != size_t(spawns.size))
+    {
+        printf("Could not read back the spawns of a map tile\n");
+        return;
+    }
+
+    for (DeferredObjectId const& id : spawns.ids)
+    {
+        uint32 uniqueId = GenerateUniqueObjectId(id.key.first, id.key.second);
+        memcpy(&buffer[id.offset - spawns.start], &uniqueId, sizeof(uniqueId));
+    }
+
+    fwrite(buffer.data(), 1, spawns.size, dirfile);
+}
+
 void ParsMapFiles()
 {
     char fn[512];
     //char id_filename[64];
     char id[10];
     StringSet failedPaths;
+    std::string dirname = std::string(szWorkDirWmo) + "/dir_bin";
     for (unsigned int i = 0; i < map_count; ++i)
     {
         sprintf(id, "%03u", map_ids[i].id);
@@ -276,21 +339,85 @@ void ParsMapFiles()
         WDTFile WDT(fn, map_ids[i].name);
         if (WDT.init(id, map_ids[i].id))
         {
+            FILE* dirfile = fopen(dirname.c_str(), "ab");
+            if (!dirfile)
+            {
+                printf("Can't open dirfile!'%s'\n", dirname.c_str());
+                continue;
+            }
+
             printf("Processing Map %u\n[", map_ids[i].id);
-            for (int x = 0; x < 64; ++x)
+
+            // tiles are parsed by the workers in any order into their own temporary file,
+            // then copied to dir_bin in tile order once all are done
+            std::vector<FILE*> tilefiles(threadCount);
+            bool tilefilesOk = true;
+            for (FILE*& tilefile : tilefiles)
+                tilefilesOk = (tilefile = tmpfile()) && tilefilesOk;
+
+            if (!tilefilesOk)
             {
-                for (int y = 0; y < 64; ++y)
+                printf("Can't create temporary files for map tiles!\n");
+                for (FILE* tilefile : tilefiles)
+                    if (tilefile)
+                        fclose(tilefile);
+                fclose(dirfile);
+                continue;
+            }
+
+            std::vector<TileSpawns> tiles(64 * 64);
+            std::atomic<uint32> nextTile(0);
+            std::atomic<uint32> tilesDone(0);
+            std::mutex failedPathsLock;
+            auto worker = [&](FILE* tilefile)
+            {
+                StringSet workerFailedPaths;
+                deferredIdFile = tilefile;
+                for (uint32 tile = nextTile++; tile < 64 * 64; tile = nextTile++)
                 {
-                    if (ADTFile* ADT = WDT.GetMap(x, y))
+                    TileSpawns& spawns = tiles[tile];
+                    spawns.file = tilefile;
+                    spawns.start = ftell(tilefile);
+                    deferredIds = &spawns.ids;
+
+                    if (ADTFile* ADT = WDT.GetMap(tile / 64, tile % 64))
                     {
-                        //sprintf(id_filename,"%02u %02u %03u",x,y,map_ids[i].id);//!!!!!!!!!
-                        ADT->init(map_ids[i].id, x, y, failedPaths);
+                        ADT->init(map_ids[i].id, tile / 64, tile % 64, tilefile, workerFailedPaths);
                         delete ADT;
                     }
+
+                    spawns.size = ftell(tilefile) - spawns.start;
+
+                    if (++tilesDone % 64 == 0)
+                    {
+                        printf("#");
+                        fflush(stdout);
+                    }
                 }
-                printf("#");
-                fflush(stdout);
-            }
+
+                deferredIds = nullptr;
+                deferredIdFile = nullptr;
+
+                std::lock_guard<std::mutex> guard(failedPathsLock);
+                failedPaths.insert(workerFailedPaths.begin(), workerFailedPaths.end());
+            };
+
+            std::vector<std::thread> workers;
+            for (unsigned int t = 1; t < threadCount; ++t)
+                workers.emplace_back(worker, tilefiles[t]);
+            worker(tilefiles[0]);
+            for (std::thread& thread : workers)
+                thread.join();
+
+            std::vector<char> buffer;
+            for (TileSpawns const& spawns : tiles)
+                if (spawns.size)
+                    AppendTileSpawns(dirfile, spawns, buffer);
+
+            for (FILE* tilefile : tilefiles)
+                fclose(tilefile);
+
+            fclose(dirfile);
             printf("]\n");
         }
     }
@@ -423,6 +550,18 @@ bool processArgv(int argc, char** argv)
                 result = false;
             }
         }
+        else if (strcmp("-t", argv[i]) == 0)
+        {
+            if ((i + 1) < argc && atoi(argv[i + 1]) > 0)
+            {
+                threadCount = atoi(argv[i + 1]);
+                ++i;
+            }
+            else
+            {
+                result = false;
+            }
+        }
         else if (strcmp("-?", argv[1]) == 0)
         {
             result = false;
@@ -440,11 +579,12 @@ bool processArgv(int argc, char** argv)
     if (!result)
     {
         printf("Extract for %s.\n", szRawVMAPMagic);
-        printf("%s [-?][-s][-l][-d <path>]\n", argv[0]);
+        printf("%s [-?][-s][-l][-d <path>][-o <path>][-t <threads>]\n", argv[0]);
         printf("   -s : (default) small size (data size optimization), ~500MB less vmap data.\n");
         printf("   -l : large size, ~500MB more vmap data. (might contain more details)\n");
         printf("   -d <path>: Path to the vector data source folder.\n");
         printf("   -o <path>: Path to the output folder.\n");
+        printf("   -t <threads>: Number of threads parsing map tiles, default is the number of cores.\n");
         printf("   -? : This message.\n");
     }
     return result;
@@ -511,9 +651,15 @@ int main(int argc, char** argv)
     }
     ReadLiquidTypeTableDBC();
 
+    if (!threadCount)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    printf("Using %u thread(s) for map tiles.\n", threadCount);
+
     // extract data
+    std::chrono::steady_clock::time_point stageStart = std::chrono::steady_clock::now();
     if (success)
         success = ExtractWmo();
+    printf("Stage wmo extraction took %.2f s\n", SecondsSince(stageStart));
 
     //xxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
     //map.dbc
@@ -537,11 +683,15 @@ int main(int argc, char** argv)
 
 
         delete dbc;
+        stageStart = std::chrono::steady_clock::now();
         ParsMapFiles();
+        printf("Stage map tiles took %.2f s\n", SecondsSince(stageStart));
         delete [] map_ids;
         //nError = ERROR_SUCCESS;
         // Extract models, listed in DameObjectDisplayInfo.dbc
+        stageStart = std::chrono::steady_clock::now();
         ExtractGameobjectModels();
+        printf("Stage gameobject models took %.2f s\n", SecondsSince(stageStart));
     }
 
     printf("\n");
@@ -0,0 +1,3 @@
+ALTER TABLE character_db_version CHANGE COLUMN required_z2799_01_characters_account_data required_z2802_01_characters_mail_expire_time bit;
+
+ALTER TABLE `mail` ADD KEY `idx_expire_time` (`expire_time`,`id`);
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// SlabPool against the default heap, with the allocation pattern of a grid load and unload: a batch of objects
+/// created together, touched, and freed in another order.
+
+#include "Benchmark.h"
+#include "Utilities/SlabAllocator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace
+{
+    // object size, objects per batch, 1 for the slab pool
+    void BM_GridLoadAllocation(Benchmark::State& state)
+    {
+        std::size_t const size = std::size_t(state.Arg(0));
+        uint32 const count = uint32(state.Arg(1));
+        bool const slab = state.Arg(2) != 0;
+
+        static SlabPool* pools[2] = { nullptr, nullptr };
+        SlabPool*& pool = pools[size > 1024];
+        if (slab && !pool)
+            pool = new SlabPool(size > 1024 ? "BenchmarkLarge" : "BenchmarkSmall", size);
+
+        std::vector<void*> objects(count);
+        std::vector<uint32> order(count);
+        for (uint32 i = 0; i < count; ++i)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(count));
+
+        while (state.KeepRunning())
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                objects[i] = slab ? pool->Allocate() : ::operator new(size);
+                std::memset(objects[i], int(i), 64);        // constructor touching the first fields
+            }
+
+            uint32 sum = 0;
+            for (void* object : objects)                    // an update walking all of them
+                sum += *static_cast<uint8*>(object);
+            Benchmark::DoNotOptimize(sum);
+
+            for (uint32 index : order)
+            {
+                if (slab)
+                    pool->Deallocate(objects[index]);
+                else
+                    ::operator delete(objects[index]);
+            }
+        }
+
+        state.SetItemsProcessed(state.Iterations() * count);
+    }
+    BENCHMARK(BM_GridLoadAllocation)->Args({ 400, 1000, 0 })->Args({ 400, 1000, 1 })->Args({ 3000, 1000, 0 })->Args({ 3000, 1000, 1 });
+}
@@ -0,0 +1,384 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+namespace Benchmark
+{
+    State::State(uint64 maxIterations, std::vector<int64> const& args) : m_iterations(0), m_maxIterations(maxIterations), m_args(args),
+        m_running(false), m_cpuStart(0), m_realSeconds(0.0), m_cpuSeconds(0.0), m_items(0), m_bytes(0)
+    {
+    }
+
+    void State::PauseTiming()
+    {
+        if (!m_running)
+            return;
+
+        m_realSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_realStart).count();
+        m_cpuSeconds += double(std::clock() - m_cpuStart) / CLOCKS_PER_SEC;
+        m_running = false;
+    }
+
+    void State::ResumeTiming()
+    {
+        if (m_running)
+            return;
+
+        m_running = true;
+        m_cpuStart = std::clock();
+        m_realStart = std::chrono::steady_clock::now();
+    }
+
+    void State::SetCounter(std::string const& name, double value, bool perIteration)
+    {
+        m_counters[name] = { value, perIteration };
+    }
+
+    struct Result
+    {
+        std::string name;
+        uint64 iterations;
+        double realNs;                                      // per iteration
+        double cpuNs;
+        double itemsPerSecond;
+        double bytesPerSecond;
+        std::vector<std::pair<std::string, double>> counters;
+        std::string label;
+        std::string error;
+    };
+
+    struct Options
+    {
+        Options() : minTime(0.5), list(false) {}
+
+        std::string filter;
+        std::string jsonFile;
+        std::string configFile;
+        double minTime;                                     // seconds
+        bool list;
+    };
+
+    class Runner
+    {
+        public:
+            static Runner& Instance()
+            {
+                static Runner runner;
+                return runner;
+            }
+
+            Definition* Add(char const* name, Function function)
+            {
+                m_definitions.push_back(std::unique_ptr<Definition>(new Definition(name, function)));
+                return m_definitions.back().get();
+            }
+
+            bool SetWorldHandlers(WorldStartup startup, WorldShutdown shutdown)
+            {
+                m_worldStartup = startup;
+                m_worldShutdown = shutdown;
+                return true;
+            }
+
+            int Run(Options const& options);
+
+        private:
+            Runner() : m_worldStartup(nullptr), m_worldShutdown(nullptr) {}
+
+            static std::string GetName(Definition const& definition, std::vector<int64> const& args);
+            static Result RunOne(Definition const& definition, std::vector<int64> const& args, std::string const& name, double minTime);
+            static void Print(Result const& result);
+            static bool WriteJson(std::string const& fileName, std::vector<Result> const& results);
+
+            std::vector<std::unique_ptr<Definition>> m_definitions;
+            WorldStartup m_worldStartup;
+            WorldShutdown m_worldShutdown;
+    };
+
+    std::string Runner::GetName(Definition const& definition, std::vector<int64> const& args)
+    {
+        std::string name = definition.m_name;
+        for (int64 arg : args)
+            name += "/" + std::to_string(arg);
+        return name;
+    }
+
+    Result Runner::RunOne(Definition const& definition, std::vector<int64> const& args, std::string const& name, double minTime)
+    {
+        uint64 const maxIterations = 1000000000;
+
+        uint64 iterations = 1;
+        while (true)
+        {
+            State state(iterations, args);
+            definition.m_function(state);
+            state.PauseTiming();
+
+            if (!state.m_error.empty())
+            {
+                Result result = Result();
+                result.name = name;
+                result.error = state.m_error;
+                return result;
+            }
+
+            // the same as Google Benchmark: grow by the missing time with some headroom, at most tenfold
+            if (state.m_realSeconds < minTime && iterations < maxIterations)
+            {
+                double multiplier = state.m_realSeconds > 0.0 ? minTime * 1.4 / state.m_realSeconds : 10.0;
+                multiplier = std::min(multiplier, 10.0);
+                iterations = std::min(maxIterations, std::max(uint64(iterations * multiplier), iterations + 1));
+                continue;
+            }
+
+            uint64 const done = std::max<uint64>(state.m_iterations, 1);
+
+            Result result;
+            result.name = name;
+            result.iterations = state.m_iterations;
+            result.realNs = state.m_realSeconds * 1e9 / done;
+            result.cpuNs = state.m_cpuSeconds * 1e9 / done;
+            result.itemsPerSecond = state.m_items && state.m_realSeconds > 0.0 ? state.m_items / state.m_realSeconds : 0.0;
+            result.bytesPerSecond = state.m_bytes && state.m_realSeconds > 0.0 ? state.m_bytes / state.m_realSeconds : 0.0;
+            for (auto const& counter : state.m_counters)
+                result.counters.push_back({ counter.first, counter.second.second ? counter.second.first / done : counter.second.first });
+            result.label = state.m_label;
+            return result;
+        }
+    }
+
+    void Runner::Print(Result const& result)
+    {
+        if (!result.error.empty())
+        {
+            printf("%-48s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+            return;
+        }
+
+        printf("%-48s %14.1f ns %14.1f ns %12llu", result.name.c_str(), result.realNs, result.cpuNs, (unsigned long long)result.iterations);
+        if (result.itemsPerSecond > 0.0)
+            printf(" items/s=%.4g", result.itemsPerSecond);
+        if (result.bytesPerSecond > 0.0)
+            printf(" bytes/s=%.4g", result.bytesPerSecond);
+        for (auto const& counter : result.counters)
+            printf(" %s=%.4g", counter.first.c_str(), counter.second);
+        if (!result.label.empty())
+            printf(" %s", result.label.c_str());
+        printf("\n");
+    }
+
+    namespace
+    {
+        std::string JsonString(std::string const& value)
+        {
+            std::string escaped = "\"";
+            for (char c : value)
+            {
+                if (c == '"' || c == '\\')
+                    escaped += '\\';
+                if (uint8(c) < 0x20)
+                {
+                    char code[8];
+                    snprintf(code, sizeof(code), "\\u%04x", uint32(uint8(c)));
+                    escaped += code;
+                    continue;
+                }
+                escaped += c;
+            }
+            return escaped + "\"";
+        }
+    }
+
+    // same layout as the JSON reporter of Google Benchmark, so its compare.py can diff two runs
+    bool Runner::WriteJson(std::string const& fileName, std::vector<Result> const& results)
+    {
+        FILE* file = fileName == "-" ? stdout : fopen(fileName.c_str(), "w");
+        if (!file)
+        {
+            printf("Can not write %s\n", fileName.c_str());
+            return false;
+        }
+
+        char date[64];
+        time_t now = time(nullptr);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+        fprintf(file, "{\n  \"context\": {\n");
+        fprintf(file, "    \"date\": %s,\n", JsonString(date).c_str());
+        fprintf(file, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+#ifdef NDEBUG
+        fprintf(file, "    \"library_build_type\": \"release\"\n");
+#else
+        fprintf(file, "    \"library_build_type\": \"debug\"\n");
+#endif
+        fprintf(file, "  },\n  \"benchmarks\": [");
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            Result const& result = results[i];
+            fprintf(file, "%s\n    {\n      \"name\": %s,\n      \"run_name\": %s,\n      \"run_type\": \"iteration\",\n",
+                    i ? "," : "", JsonString(result.name).c_str(), JsonString(result.name).c_str());
+
+            if (!result.error.empty())
+            {
+                fprintf(file, "      \"error_occurred\": true,\n      \"error_message\": %s\n    }", JsonString(result.error).c_str());
+                continue;
+            }
+
+            fprintf(file, "      \"iterations\": %llu,\n      \"real_time\": %.3f,\n      \"cpu_time\": %.3f,\n      \"time_unit\": \"ns\"",
+                    (unsigned long long)result.iterations, result.realNs, result.cpuNs);
+            if (result.itemsPerSecond > 0.0)
+                fprintf(file, ",\n      \"items_per_second\": %.6g", result.itemsPerSecond);
+            if (result.bytesPerSecond > 0.0)
+                fprintf(file, ",\n      \"bytes_per_second\": %.6g", result.bytesPerSecond);
+            for (auto const& counter : result.counters)
+                fprintf(file, ",\n      %s: %.6g", JsonString(counter.first).c_str(), counter.second);
+            if (!result.label.empty())
+                fprintf(file, ",\n      \"label\": %s", JsonString(result.label).c_str());
+            fprintf(file, "\n    }");
+        }
+
+        fprintf(file, "\n  ]\n}\n");
+        if (file != stdout)
+            fclose(file);
+        return true;
+    }
+
+    int Runner::Run(Options const& options)
+    {
+        bool world = false;
+        if (!options.configFile.empty() && !options.list)
+        {
+            if (!m_worldStartup)
+            {
+                printf("Benchmarks were built without the game server, --config is not supported\n");
+                return 1;
+            }
+
+            if (!m_worldStartup(options.configFile))
+                return 1;
+
+            world = true;
+        }
+
+        // the table would end up in the JSON on stdout
+        bool const table = options.jsonFile != "-";
+
+        std::vector<Result> results;
+        if (table && !options.list)
+            printf("%-48s %17s %17s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+
+        bool failed = false;
+        for (auto const& definition : m_definitions)
+        {
+            std::vector<std::vector<int64>> argSets = definition->m_args;
+            if (argSets.empty())
+                argSets.push_back({});
+
+            for (std::vector<int64> const& args : argSets)
+            {
+                std::string const name = GetName(*definition, args);
+                if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+                    continue;
+
+                if (options.list)
+                {
+                    printf("%s%s\n", name.c_str(), definition->m_requiresWorld ? " (world)" : "");
+                    continue;
+                }
+
+                if (definition->m_requiresWorld && !world)
+                    continue;
+
+                results.push_back(RunOne(*definition, args, name, options.minTime));
+                if (table)
+                    Print(results.back());
+                failed = failed || !results.back().error.empty();
+            }
+        }
+
+        if (!world && m_worldStartup && !options.list && table)
+            printf("World benchmarks skipped, run with --config <mangosd.conf> to load the world\n");
+
+        if (world && m_worldShutdown)
+            m_worldShutdown();
+
+        if (!options.jsonFile.empty() && !WriteJson(options.jsonFile, results))
+            return 1;
+
+        return failed ? 1 : 0;
+    }
+
+    Definition* Register(char const* name, Function function)
+    {
+        return Runner::Instance().Add(name, function);
+    }
+
+    bool SetWorldHandlers(WorldStartup startup, WorldShutdown shutdown)
+    {
+        return Runner::Instance().SetWorldHandlers(startup, shutdown);
+    }
+}
+
+namespace
+{
+    void Usage(char const* program)
+    {
+        printf("Usage: %s [options]\n"
+               "    --filter <text>     run only benchmarks with <text> in their name\n"
+               "    --min-time <secs>   minimum run time of each benchmark (default 0.5)\n"
+               "    --json <file>       write the results as JSON, - for stdout\n"
+               "    --config <file>     load the world with this mangosd.conf for the world benchmarks\n"
+               "    --list              list the benchmarks\n", program);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark::Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        char const* arg = argv[i];
+        bool const hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--filter") && hasValue)
+            options.filter = argv[++i];
+        else if (!strcmp(arg, "--min-time") && hasValue)
+            options.minTime = atof(argv[++i]);
+        else if (!strcmp(arg, "--json") && hasValue)
+            options.jsonFile = argv[++i];
+        else if (!strcmp(arg, "--config") && hasValue)
+            options.configFile = argv[++i];
+        else if (!strcmp(arg, "--list"))
+            options.list = true;
+        else
+        {
+            Usage(argv[0]);
+            return strcmp(arg, "--help") ? 1 : 0;
+        }
+    }
+
+    return Benchmark::Runner::Instance().Run(options);
+}
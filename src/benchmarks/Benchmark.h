@@ -0,0 +1,146 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Minimal micro benchmark harness, modelled after Google Benchmark so results can be compared with its tooling.
+/// A benchmark is a function taking a Benchmark::State, registered with BENCHMARK() and optional arguments:
+///
+///     static void BM_Something(Benchmark::State& state)
+///     {
+///         Setup(state.Arg());
+///         while (state.KeepRunning())
+///             DoSomething();
+///         state.SetItemsProcessed(state.Iterations());
+///     }
+///     BENCHMARK(BM_Something)->Arg(10)->Arg(1000);
+///
+/// The iteration count grows until a run takes at least the minimum time. Benchmarks registered with RequiresWorld()
+/// need the world loaded from a database (--config <mangosd.conf>) and are skipped without one.
+
+#ifndef MANGOS_BENCHMARK_H
+#define MANGOS_BENCHMARK_H
+
+#include "Platform/Define.h"
+
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+    class State
+    {
+        public:
+            State(uint64 maxIterations, std::vector<int64> const& args);
+
+            // runs the timed loop, the clock starts with the first call
+            bool KeepRunning()
+            {
+                if (m_iterations < m_maxIterations)
+                {
+                    if (!m_iterations++)
+                        ResumeTiming();
+                    return true;
+                }
+
+                PauseTiming();
+                return false;
+            }
+
+            // excludes setup done inside the loop from the measurement
+            void PauseTiming();
+            void ResumeTiming();
+
+            int64 Arg(size_t index = 0) const { return index < m_args.size() ? m_args[index] : 0; }
+            uint64 Iterations() const { return m_iterations; }
+
+            void SetItemsProcessed(uint64 items) { m_items = items; }
+            void SetBytesProcessed(uint64 bytes) { m_bytes = bytes; }
+            // reported as is, averaged over the iterations when perIteration is set
+            void SetCounter(std::string const& name, double value, bool perIteration = false);
+            void SetLabel(std::string const& label) { m_label = label; }
+            void SkipWithError(std::string const& error) { m_error = error; m_maxIterations = 0; }
+
+        private:
+            friend class Runner;
+
+            uint64 m_iterations;
+            uint64 m_maxIterations;
+            std::vector<int64> const& m_args;
+
+            bool m_running;
+            std::chrono::steady_clock::time_point m_realStart;
+            std::clock_t m_cpuStart;
+            double m_realSeconds;
+            double m_cpuSeconds;
+
+            uint64 m_items;
+            uint64 m_bytes;
+            std::map<std::string, std::pair<double, bool>> m_counters;
+            std::string m_label;
+            std::string m_error;
+    };
+
+    typedef void (*Function)(State&);
+
+    class Definition
+    {
+        public:
+            Definition(char const* name, Function function) : m_name(name), m_function(function), m_requiresWorld(false) {}
+
+            Definition* Arg(int64 arg) { m_args.push_back({ arg }); return this; }
+            Definition* Args(std::vector<int64> const& args) { m_args.push_back(args); return this; }
+            Definition* RequiresWorld() { m_requiresWorld = true; return this; }
+
+        private:
+            friend class Runner;
+
+            std::string m_name;
+            Function m_function;
+            std::vector<std::vector<int64>> m_args;
+            bool m_requiresWorld;
+    };
+
+    Definition* Register(char const* name, Function function);
+
+    // world loading of the game fixtures, set by them when the game library is linked
+    typedef bool (*WorldStartup)(std::string const& configFile);
+    typedef void (*WorldShutdown)();
+    bool SetWorldHandlers(WorldStartup startup, WorldShutdown shutdown);
+
+    // keeps the compiler from optimizing away a result
+    template <class T>
+    inline void DoNotOptimize(T const& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile char const* sink;
+        sink = reinterpret_cast<char const volatile*>(&value);
+#endif
+    }
+}
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+#define BENCHMARK(function) \
+    static Benchmark::Definition* BENCHMARK_CONCAT(s_benchmark_, __LINE__) = Benchmark::Register(#function, function)
+
+#endif
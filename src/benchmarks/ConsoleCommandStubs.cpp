@@ -0,0 +1,38 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// The chat command table of the game library refers to the console commands which mangosd defines
+/// next to its console thread (CliRunnable.cpp). The benchmarks never run chat commands, so they
+/// only need the symbols.
+
+#include "Common.h"
+#include "Chat/Chat.h"
+
+bool ChatHandler::HandleAccountDeleteCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleCharacterDeletedListCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleCharacterDeletedRestoreCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleCharacterDeletedDeleteCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleCharacterDeletedOldCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleCharacterEraseCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleQuitCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleServerExitCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleAccountOnlineListCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleAccountCreateCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleServerLogFilterCommand(char* /*args*/) { return false; }
+bool ChatHandler::HandleServerLogLevelCommand(char* /*args*/) { return false; }
@@ -0,0 +1,202 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Compares MultimapEventProcessor and TimingWheelEventProcessor on an event mix modelled after what units schedule:
+/// short delayed lambdas, AI notify events killed and re-added on movement, spell events re-adding themselves
+/// every tick and long timers occasionally moved with ModifyEventTime.
+
+#include "Benchmark.h"
+#include "Utilities/EventProcessor.h"
+
+#include <vector>
+
+namespace
+{
+    uint32 const TICK_MS = 100;
+
+    /// xorshift, both implementations have to see the same operation sequence
+    class Random
+    {
+        public:
+            explicit Random(uint64 seed) : m_state(seed) {}
+
+            uint32 Next()
+            {
+                m_state ^= m_state << 13;
+                m_state ^= m_state >> 7;
+                m_state ^= m_state << 17;
+                return uint32(m_state >> 32);
+            }
+
+            uint32 Range(uint32 min, uint32 max) { return min + Next() % (max - min + 1); }
+            bool Chance(uint32 percent) { return Next() % 1000 < percent * 10; }
+
+        private:
+            uint64 m_state;
+    };
+
+    struct MixStats
+    {
+        MixStats() : operations(0), executed(0) {}
+
+        uint64 operations;
+        uint64 executed;
+    };
+
+    class CountingEvent : public PooledEvent<CountingEvent>
+    {
+        public:
+            CountingEvent(MixStats& stats, BasicEvent** handle = nullptr) : m_stats(stats), m_handle(handle) {}
+
+            bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+            {
+                ++m_stats.executed;
+                if (m_handle)
+                    *m_handle = nullptr;
+                return true;
+            }
+
+            void Abort(uint64 /*e_time*/) override
+            {
+                if (m_handle)
+                    *m_handle = nullptr;
+            }
+
+        private:
+            MixStats& m_stats;
+            BasicEvent** m_handle;
+    };
+
+    template <class Processor>
+    class RepeatingEvent : public BasicEvent
+    {
+        public:
+            RepeatingEvent(Processor& events, MixStats& stats, uint32 repeats) : m_events(events), m_stats(stats), m_repeats(repeats) {}
+
+            bool Execute(uint64 e_time, uint32 /*p_time*/) override
+            {
+                ++m_stats.executed;
+                if (!m_repeats--)
+                    return true;
+
+                // like SpellEvent, keep the event alive and queue it again
+                m_events.AddEvent(this, e_time + 1, false);
+                return false;
+            }
+
+        private:
+            Processor& m_events;
+            MixStats& m_stats;
+            uint32 m_repeats;
+    };
+
+    template <class Processor>
+    struct Owner
+    {
+        Owner() : notify(nullptr), timer(nullptr) {}
+
+        Processor events;
+        BasicEvent* notify;                                 // AI notify, rescheduled on movement
+        BasicEvent* timer;                                  // long timer, sometimes moved
+    };
+
+    template <class Processor>
+    MixStats RunMix(uint32 ownerCount, uint32 seconds)
+    {
+        typedef Owner<Processor> OwnerType;
+
+        MixStats stats;
+        Random random(0x9E3779B97F4A7C15ull);
+        std::vector<OwnerType> owners(ownerCount);
+
+        uint32 ticks = seconds * 1000 / TICK_MS;
+        for (uint32 tick = 0; tick < ticks; ++tick)
+        {
+            for (OwnerType& owner : owners)
+            {
+                Processor& events = owner.events;
+
+                if (random.Chance(20))
+                {
+                    events.AddEvent(new CountingEvent(stats), events.CalculateTime(random.Range(0, 3000)));
+                    ++stats.operations;
+                }
+
+                if (random.Chance(30))
+                {
+                    if (owner.notify)
+                        events.KillEvent(owner.notify);
+
+                    owner.notify = new CountingEvent(stats, &owner.notify);
+                    events.AddEvent(owner.notify, events.CalculateTime(random.Range(200, 1000)));
+                    stats.operations += 2;
+                }
+
+                if (random.Chance(5))
+                {
+                    events.AddEvent(new RepeatingEvent<Processor>(events, stats, random.Range(10, 30)), events.CalculateTime(0));
+                    ++stats.operations;
+                }
+
+                if (random.Chance(1))
+                {
+                    if (!owner.timer)
+                    {
+                        owner.timer = new CountingEvent(stats, &owner.timer);
+                        events.AddEvent(owner.timer, events.CalculateTime(random.Range(30000, 600000)));
+                    }
+                    else
+                        events.ModifyEventTime(owner.timer, events.CalculateTime(random.Range(30000, 600000)));
+                    ++stats.operations;
+                }
+
+                events.Update(TICK_MS);
+                ++stats.operations;
+            }
+        }
+
+        for (OwnerType& owner : owners)
+            owner.events.KillAllEvents(true);
+
+        return stats;
+    }
+
+    // one iteration is a whole mix, the executed counter has to be the same for both implementations
+    template <class Processor>
+    void BM_EventProcessorMix(Benchmark::State& state)
+    {
+        MixStats total;
+        while (state.KeepRunning())
+        {
+            MixStats stats = RunMix<Processor>(uint32(state.Arg(0)), uint32(state.Arg(1)));
+            total.operations += stats.operations;
+            total.executed += stats.executed;
+        }
+
+        state.SetItemsProcessed(total.operations);
+        state.SetCounter("executed", double(total.executed), true);
+    }
+
+    void BM_MultimapEventProcessor(Benchmark::State& state) { BM_EventProcessorMix<MultimapEventProcessor>(state); }
+    void BM_TimingWheelEventProcessor(Benchmark::State& state) { BM_EventProcessorMix<TimingWheelEventProcessor>(state); }
+}
+
+// many processors with few events each (units of a busy map) and few processors with a long history (map and world events)
+BENCHMARK(BM_MultimapEventProcessor)->Args({ 2000, 300 })->Args({ 20, 30000 });
+BENCHMARK(BM_TimingWheelEventProcessor)->Args({ 2000, 300 })->Args({ 20, 30000 });
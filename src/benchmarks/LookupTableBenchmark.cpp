@@ -0,0 +1,96 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Lookups of sparse uint32 keys as done on the world tables: the std::unordered_map and std::multimap the
+/// storages used before, against the FlatLookupTable they use now. Every eighth lookup misses.
+
+#include "Benchmark.h"
+#include "Util/FlatLookupTable.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    enum LookupContainer
+    {
+        LOOKUP_UNORDERED_MAP = 0,
+        LOOKUP_MULTIMAP      = 1,
+        LOOKUP_FLAT_TABLE    = 2,
+    };
+
+    // entries, container
+    void BM_SparseKeyLookup(Benchmark::State& state)
+    {
+        uint32 const count = uint32(state.Arg(0));
+        LookupContainer const container = LookupContainer(state.Arg(1));
+
+        // gameobject_template like ids: sparse over a range about ten times the row count
+        std::mt19937 random(0x4D614E47);
+        std::vector<uint32> keys;
+        for (uint32 i = 0; i < count; ++i)
+            keys.push_back(random() % (count * 10));
+
+        std::unordered_map<uint32, char*> unorderedMap;
+        std::multimap<uint32, char*> multimap;
+        FlatLookupTable<char*> table;
+        FlatLookupTable<char*>::Container entries;
+        for (uint32 key : keys)
+        {
+            char* record = reinterpret_cast<char*>(uintptr_t(key) + 1);
+            unorderedMap[key] = record;
+            multimap.insert(std::make_pair(key, record));
+            entries.push_back(std::make_pair(key, record));
+        }
+        table.Assign(std::move(entries));
+
+        std::vector<uint32> lookups(keys);
+        for (size_t i = 7; i < lookups.size(); i += 8)
+            lookups[i] = count * 10 + uint32(i);
+        std::shuffle(lookups.begin(), lookups.end(), random);
+
+        uint64 found = 0;
+        size_t next = 0;
+        while (state.KeepRunning())
+        {
+            uint32 const key = lookups[next++ % lookups.size()];
+            switch (container)
+            {
+                case LOOKUP_UNORDERED_MAP:
+                    found += unorderedMap.find(key) != unorderedMap.end();
+                    break;
+                case LOOKUP_MULTIMAP:
+                    found += multimap.find(key) != multimap.end();
+                    break;
+                case LOOKUP_FLAT_TABLE:
+                    found += table.find(key) != table.end();
+                    break;
+            }
+        }
+
+        Benchmark::DoNotOptimize(found);
+        state.SetItemsProcessed(state.Iterations());
+        state.SetCounter("found", double(found), true);
+    }
+    BENCHMARK(BM_SparseKeyLookup)->Args({ 2000, 0 })->Args({ 2000, 1 })->Args({ 2000, 2 })
+                                 ->Args({ 200000, 0 })->Args({ 200000, 1 })->Args({ 200000, 2 });
+}
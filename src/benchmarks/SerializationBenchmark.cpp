@@ -0,0 +1,169 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Packet building: movement packets written and read through WorldPacket, and UpdateData::BuildPacket with the
+/// zlib compression of large update packets. Update blocks are synthetic but laid out like the ones of creatures.
+
+#include "Benchmark.h"
+#include "Common.h"
+#include "Server/WorldPacket.h"
+#include "Server/Opcodes.h"
+#include "Entities/ObjectGuid.h"
+#include "Entities/UpdateData.h"
+#include "Entities/UpdateFields.h"
+#include "World/World.h"
+
+namespace
+{
+    ObjectGuid CreatureGuid(uint32 index)
+    {
+        return ObjectGuid(HIGHGUID_UNIT, 3000 + index % 500, 100000 + index);
+    }
+
+    void WriteHeartbeat(WorldPacket& packet, ObjectGuid const& guid, uint32 time)
+    {
+        packet << guid.WriteAsPacked();
+        packet << uint32(0x00000001);                       // MOVEFLAG_FORWARD
+        packet << time;
+        packet << float(1629.36f) << float(-4373.39f) << float(31.26f) << float(3.54f);
+        packet << uint32(0);                                // fall time
+    }
+
+    // a creature create block: movement block and an update mask with the fields a spawned npc sends
+    void WriteCreateBlock(ByteBuffer& block, ObjectGuid const& guid)
+    {
+        block << uint8(UPDATETYPE_CREATE_OBJECT);
+        block << guid.WriteAsPacked();
+        block << uint8(3);                                  // TYPEID_UNIT
+        block << uint8(UPDATEFLAG_LIVING | UPDATEFLAG_HAS_POSITION | UPDATEFLAG_ALL);
+        block << uint32(0) << uint32(0);                    // movement flags, time
+        block << float(1629.36f) << float(-4373.39f) << float(31.26f) << float(3.54f);
+        block << uint32(0);                                 // fall time
+        for (uint32 i = 0; i < 6; ++i)                      // speeds
+            block << float(2.5f + i);
+        block << uint32(1);                                 // UPDATEFLAG_ALL
+
+        uint32 const maskBlocks = (uint32(UNIT_END) + 31) / 32;
+        block << uint8(maskBlocks);
+        for (uint32 i = 0; i < maskBlocks; ++i)
+            block << uint32(i < 3 ? 0x0F3F00FF : 0x00010003);
+        for (uint32 i = 0; i < 60; ++i)
+            block << uint32(guid.GetCounter() + i * 7);
+    }
+
+    // a health/power change
+    void WriteValuesBlock(ByteBuffer& block, ObjectGuid const& guid, uint32 value)
+    {
+        block << uint8(UPDATETYPE_VALUES);
+        block << guid.WriteAsPacked();
+        block << uint8(1) << uint32(0x00C00000);
+        block << value << value / 2;
+    }
+
+    void BM_WorldPacketHeartbeat(Benchmark::State& state)
+    {
+        uint32 const packets = uint32(state.Arg());
+        uint64 bytes = 0;
+        while (state.KeepRunning())
+        {
+            for (uint32 i = 0; i < packets; ++i)
+            {
+                WorldPacket packet(MSG_MOVE_HEARTBEAT, 8 + 4 + 4 + 4 * 4 + 4);
+                WriteHeartbeat(packet, CreatureGuid(i), i);
+                bytes += packet.size();
+
+                ObjectGuid guid;
+                uint32 flags, time, fallTime;
+                float x, y, z, o;
+                packet >> guid.ReadAsPacked() >> flags >> time >> x >> y >> z >> o >> fallTime;
+                Benchmark::DoNotOptimize(x + y + z + o + time);
+            }
+        }
+
+        state.SetItemsProcessed(state.Iterations() * packets);
+        state.SetBytesProcessed(bytes);
+    }
+    BENCHMARK(BM_WorldPacketHeartbeat)->Arg(1)->Arg(100);
+
+    void BM_WorldPacketChat(Benchmark::State& state)
+    {
+        std::string const message(size_t(state.Arg()), 'x');
+        std::string const channel = "General - Orgrimmar";
+        uint64 bytes = 0;
+        while (state.KeepRunning())
+        {
+            WorldPacket packet(SMSG_MESSAGECHAT, 1 + 4 + channel.size() + 1 + 8 + 8 + 4 + message.size() + 1 + 1);
+            packet << uint8(17) << uint32(0) << channel << uint32(0) << CreatureGuid(1) << uint32(message.size() + 1) << message << uint8(0);
+            bytes += packet.size();
+
+            uint8 type, tag;
+            uint32 language, rank, length;
+            std::string readChannel, readMessage;
+            ObjectGuid guid;
+            packet >> type >> language >> readChannel >> rank >> guid >> length >> readMessage >> tag;
+            Benchmark::DoNotOptimize(readMessage.size());
+        }
+
+        state.SetBytesProcessed(bytes);
+    }
+    BENCHMARK(BM_WorldPacketChat)->Arg(16)->Arg(255);
+
+    // blocks, share of value updates in percent, zlib level (Compression of mangosd.conf)
+    void BM_UpdateDataBuildPacket(Benchmark::State& state)
+    {
+        uint32 const blocks = uint32(state.Arg(0));
+        uint32 const valuesPercent = uint32(state.Arg(1));
+        uint32 const compression = sWorld.getConfig(CONFIG_UINT32_COMPRESSION);
+        sWorld.setConfig(CONFIG_UINT32_COMPRESSION, uint32(state.Arg(2)));
+
+        std::vector<ByteBuffer> updateBlocks(blocks);
+        for (uint32 i = 0; i < blocks; ++i)
+        {
+            if (i * 100 < blocks * valuesPercent)
+                WriteValuesBlock(updateBlocks[i], CreatureGuid(i), 1000 + i);
+            else
+                WriteCreateBlock(updateBlocks[i], CreatureGuid(i));
+        }
+
+        uint64 bytes = 0;
+        uint64 packetBytes = 0;
+        while (state.KeepRunning())
+        {
+            UpdateData data;
+            for (ByteBuffer const& block : updateBlocks)
+                data.AddUpdateBlock(block);
+            data.AddOutOfRangeGUID(CreatureGuid(blocks + 1));
+
+            for (size_t i = 0; i < data.GetPacketCount(); ++i)
+            {
+                WorldPacket packet = data.BuildPacket(i);
+                packetBytes += packet.size();
+            }
+        }
+
+        for (ByteBuffer const& block : updateBlocks)
+            bytes += block.size();
+
+        sWorld.setConfig(CONFIG_UINT32_COMPRESSION, compression);
+
+        state.SetBytesProcessed(bytes * state.Iterations());
+        state.SetCounter("packet_bytes", double(packetBytes), true);
+    }
+    BENCHMARK(BM_UpdateDataBuildPacket)->Args({ 1, 100, 1 })->Args({ 50, 80, 1 })->Args({ 200, 0, 1 })->Args({ 200, 0, 6 });
+}
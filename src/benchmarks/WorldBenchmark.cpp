@@ -0,0 +1,424 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Benchmarks of code that needs the loaded world: grid searches, terrain, vmap and navmesh queries, template
+/// lookups and loot generation. The world is loaded the way mangosd does it, from the databases and data files of
+/// the given mangosd.conf, and grids around a few Kalimdor positions of different object density are loaded.
+
+#include "Benchmark.h"
+#include "Common.h"
+#include "Config/Config.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "World/World.h"
+#include "Maps/MapManager.h"
+#include "Maps/Map.h"
+#include "Maps/GridMap.h"
+#include "Grids/GridNotifiers.h"
+#include "Grids/GridNotifiersImpl.h"
+#include "Grids/CellImpl.h"
+#include "Entities/Creature.h"
+#include "Entities/GameObject.h"
+#include "Entities/ItemPrototype.h"
+#include "Globals/ObjectMgr.h"
+#include "Server/SQLStorages.h"
+#include "Loot/LootMgr.h"
+#include "Spells/SpellMgr.h"
+#include "MotionGenerators/PathFinder.h"
+#include "MotionGenerators/MoveMap.h"
+#include "vmap/VMapFactory.h"
+#include "vmap/IVMapManager.h"
+
+#include <algorithm>
+#include <random>
+
+DatabaseType WorldDatabase;                                 ///< Accessor to the world database
+DatabaseType CharacterDatabase;                             ///< Accessor to the character database
+DatabaseType LoginDatabase;                                 ///< Accessor to the realm/login database
+DatabaseType LogsDatabase;                                  ///< Accessor to the logs database
+
+uint32 realmID;                                             ///< Id of the realm
+
+namespace
+{
+    uint32 const BENCHMARK_MAP = 1;                         // Kalimdor
+    uint32 const POINTS_PER_POSITION = 1024;
+
+    struct BenchmarkPosition
+    {
+        char const* name;
+        float x, y, z;
+    };
+
+    // by object density, the index is the argument of the benchmarks
+    BenchmarkPosition const Positions[] =
+    {
+        { "sparse",  -1285.0f,  -170.0f,  -41.0f },         // Mulgore plains
+        { "town",     -450.0f, -2650.0f,   95.0f },         // The Crossroads
+        { "city",     1629.36f, -4373.39f,  31.26f },       // Orgrimmar
+    };
+
+    uint32 const POSITION_COUNT = sizeof(Positions) / sizeof(Positions[0]);
+
+    Map* s_map = nullptr;
+    std::vector<G3D::Vector3> s_points[POSITION_COUNT];    // random ground points around the positions
+    Creature* s_pathOwner[POSITION_COUNT];
+
+    class InPointRangeCheck
+    {
+        public:
+            InPointRangeCheck(float x, float y, float z, float range) : m_x(x), m_y(y), m_z(z), m_range(range) {}
+            bool operator()(WorldObject* object) const { return object->IsWithinDist3d(m_x, m_y, m_z, m_range); }
+
+        private:
+            float m_x, m_y, m_z, m_range;
+    };
+
+    bool StartDatabase(DatabaseType& database, char const* name, char const* infoField, char const* connectionsField)
+    {
+        std::string const info = sConfig.GetStringDefault(infoField);
+        if (info.empty())
+        {
+            sLog.outError("%s database not specified in configuration file", name);
+            return false;
+        }
+
+        if (!database.Initialize(info.c_str(), sConfig.GetIntDefault(connectionsField, 1)))
+        {
+            sLog.outError("Cannot connect to %s database %s", name, info.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool StartWorld(std::string const& configFile)
+    {
+        if (!sConfig.SetSource(configFile))
+        {
+            sLog.outError("Could not find configuration file %s.", configFile.c_str());
+            return false;
+        }
+
+        if (!StartDatabase(WorldDatabase, "World", "WorldDatabaseInfo", "WorldDatabaseConnections") ||
+            !StartDatabase(CharacterDatabase, "Character", "CharacterDatabaseInfo", "CharacterDatabaseConnections") ||
+            !StartDatabase(LoginDatabase, "Login", "LoginDatabaseInfo", "LoginDatabaseConnections") ||
+            !StartDatabase(LogsDatabase, "Logs", "LogsDatabaseInfo", "LogsDatabaseConnections"))
+            return false;
+
+        realmID = sConfig.GetIntDefault("RealmID", 0);
+        sWorld.LoadDBVersion();
+        sWorld.SetInitialWorldSettings();
+
+        s_map = sMapMgr.FindMap(BENCHMARK_MAP);
+        if (!s_map)
+        {
+            sLog.outError("Map %u was not created", BENCHMARK_MAP);
+            return false;
+        }
+
+        std::mt19937 random(0x4D614E47);
+        std::uniform_real_distribution<float> offset(-60.0f, 60.0f);
+        TerrainInfo const* terrain = s_map->GetTerrain();
+        for (uint32 i = 0; i < POSITION_COUNT; ++i)
+        {
+            BenchmarkPosition const& position = Positions[i];
+
+            // the searched cells and the points around them
+            for (float dx = -SIZE_OF_GRIDS; dx <= SIZE_OF_GRIDS; dx += SIZE_OF_GRIDS)
+                for (float dy = -SIZE_OF_GRIDS; dy <= SIZE_OF_GRIDS; dy += SIZE_OF_GRIDS)
+                    s_map->ForceLoadGrid(position.x + dx, position.y + dy);
+
+            for (uint32 tries = 0; tries < POINTS_PER_POSITION * 4 && s_points[i].size() < POINTS_PER_POSITION; ++tries)
+            {
+                float const x = position.x + offset(random);
+                float const y = position.y + offset(random);
+                float const z = terrain->GetHeightStatic(x, y, position.z + 20.0f);
+                if (z > INVALID_HEIGHT)
+                    s_points[i].push_back(G3D::Vector3(x, y, z));
+            }
+
+            // no map files
+            if (s_points[i].empty())
+                s_points[i].push_back(G3D::Vector3(position.x, position.y, position.z));
+
+            // any creature near the position walks the paths
+            std::list<Creature*> creatures;
+            InPointRangeCheck check(position.x, position.y, position.z, 100.0f);
+            MaNGOS::CreatureListSearcher<InPointRangeCheck> searcher(creatures, check);
+            Cell::VisitGridObjects(position.x, position.y, s_map, searcher, 100.0f);
+            s_pathOwner[i] = creatures.empty() ? nullptr : creatures.front();
+        }
+
+        return true;
+    }
+
+    void StopWorld()
+    {
+        World::StopNow(SHUTDOWN_EXIT_CODE);
+        sWorld.CleanupsBeforeStop();
+
+        CharacterDatabase.HaltDelayThread();
+        WorldDatabase.HaltDelayThread();
+        LoginDatabase.HaltDelayThread();
+        LogsDatabase.HaltDelayThread();
+    }
+
+    bool const s_worldHandlers = Benchmark::SetWorldHandlers(&StartWorld, &StopWorld);
+
+    void SetPositionLabel(Benchmark::State& state)
+    {
+        state.SetLabel(Positions[state.Arg()].name);
+    }
+
+    // radius searches of creatures around random points, the argument is the position
+    void BM_CellVisitCreatures(Benchmark::State& state)
+    {
+        std::vector<G3D::Vector3> const& points = s_points[state.Arg()];
+        float const radius = float(state.Arg(1));
+
+        uint64 found = 0;
+        size_t next = 0;
+        std::list<Creature*> creatures;
+        while (state.KeepRunning())
+        {
+            G3D::Vector3 const& point = points[next++ % points.size()];
+            InPointRangeCheck check(point.x, point.y, point.z, radius);
+            MaNGOS::CreatureListSearcher<InPointRangeCheck> searcher(creatures, check);
+            Cell::VisitGridObjects(point.x, point.y, s_map, searcher, radius);
+            found += creatures.size();
+            creatures.clear();
+        }
+
+        SetPositionLabel(state);
+        state.SetCounter("found", double(found), true);
+    }
+    BENCHMARK(BM_CellVisitCreatures)->Args({ 0, 30 })->Args({ 1, 30 })->Args({ 2, 30 })->Args({ 2, 100 })->RequiresWorld();
+
+    // grid and world objects, like the searches of spell targets
+    void BM_CellVisitAllObjects(Benchmark::State& state)
+    {
+        std::vector<G3D::Vector3> const& points = s_points[state.Arg()];
+        float const radius = float(state.Arg(1));
+
+        uint64 found = 0;
+        size_t next = 0;
+        WorldObjectList objects;
+        while (state.KeepRunning())
+        {
+            G3D::Vector3 const& point = points[next++ % points.size()];
+            InPointRangeCheck check(point.x, point.y, point.z, radius);
+            MaNGOS::WorldObjectListSearcher<InPointRangeCheck> searcher(objects, check);
+            Cell::VisitAllObjects(point.x, point.y, s_map, searcher, radius);
+            found += objects.size();
+            objects.clear();
+        }
+
+        SetPositionLabel(state);
+        state.SetCounter("found", double(found), true);
+    }
+    BENCHMARK(BM_CellVisitAllObjects)->Args({ 0, 30 })->Args({ 1, 30 })->Args({ 2, 30 })->RequiresWorld();
+
+    // arg 1 selects the vmap check of GetHeightStatic, without it only the GridMap height is read
+    void BM_TerrainGetHeight(Benchmark::State& state)
+    {
+        std::vector<G3D::Vector3> const& points = s_points[state.Arg()];
+        bool const checkVMap = state.Arg(1) != 0;
+        TerrainInfo const* terrain = s_map->GetTerrain();
+
+        float sum = 0.0f;
+        size_t next = 0;
+        while (state.KeepRunning())
+        {
+            G3D::Vector3 const& point = points[next++ % points.size()];
+            sum += terrain->GetHeightStatic(point.x, point.y, point.z + 2.0f, checkVMap);
+        }
+
+        Benchmark::DoNotOptimize(sum);
+        SetPositionLabel(state);
+    }
+    BENCHMARK(BM_TerrainGetHeight)->Args({ 0, 0 })->Args({ 2, 0 })->Args({ 0, 1 })->Args({ 2, 1 })->RequiresWorld();
+
+    void BM_VMapLineOfSight(Benchmark::State& state)
+    {
+        VMAP::IVMapManager* vmaps = VMAP::VMapFactory::createOrGetVMapManager();
+        if (!vmaps->isLineOfSightCalcEnabled())
+        {
+            state.SkipWithError("vmap line of sight is disabled");
+            return;
+        }
+
+        std::vector<G3D::Vector3> const& points = s_points[state.Arg()];
+
+        uint64 visible = 0;
+        size_t next = 0;
+        while (state.KeepRunning())
+        {
+            G3D::Vector3 const& from = points[next % points.size()];
+            G3D::Vector3 const& to = points[(next * 7 + 3) % points.size()];
+            ++next;
+            if (vmaps->isInLineOfSight(BENCHMARK_MAP, from.x, from.y, from.z + 2.0f, to.x, to.y, to.z + 2.0f, false))
+                ++visible;
+        }
+
+        SetPositionLabel(state);
+        state.SetCounter("visible", double(visible), true);
+    }
+    BENCHMARK(BM_VMapLineOfSight)->Arg(0)->Arg(1)->Arg(2)->RequiresWorld();
+
+    void BM_PathFinder(Benchmark::State& state)
+    {
+        Creature const* owner = s_pathOwner[state.Arg()];
+        if (!owner)
+        {
+            state.SkipWithError("no creature near the position");
+            return;
+        }
+
+        if (!MMAP::MMapFactory::IsPathfindingEnabled(BENCHMARK_MAP, owner))
+        {
+            state.SkipWithError("pathfinding is disabled");
+            return;
+        }
+
+        std::vector<G3D::Vector3> const& points = s_points[state.Arg()];
+        PathFinder path(owner);
+
+        uint64 complete = 0;
+        uint64 pathPoints = 0;
+        size_t next = 0;
+        while (state.KeepRunning())
+        {
+            G3D::Vector3 const& to = points[next++ % points.size()];
+            path.calculate(to.x, to.y, to.z);
+            if (path.getPathType() & PATHFIND_NORMAL)
+                ++complete;
+            pathPoints += path.getPath().size();
+        }
+
+        SetPositionLabel(state);
+        state.SetCounter("complete", double(complete), true);
+        state.SetCounter("points", double(pathPoints), true);
+    }
+    BENCHMARK(BM_PathFinder)->Arg(0)->Arg(1)->Arg(2)->RequiresWorld();
+
+    // existing entries in random order, every eighth lookup misses
+    template <class T, class Storage, class EntryOf>
+    void LookupEntries(Benchmark::State& state, Storage const& storage, EntryOf entryOf)
+    {
+        std::vector<uint32> entries;
+        for (auto itr = storage.template getDataBegin<T>(); itr < storage.template getDataEnd<T>(); ++itr)
+            entries.push_back(entries.size() % 8 == 7 ? storage.GetMaxEntry() + uint32(entries.size()) : entryOf(*itr));
+
+        if (entries.empty())
+        {
+            state.SkipWithError(std::string(storage.GetTableName()) + " is empty");
+            return;
+        }
+
+        std::shuffle(entries.begin(), entries.end(), std::mt19937(0x4D614E47));
+
+        uint64 found = 0;
+        size_t next = 0;
+        while (state.KeepRunning())
+            if (storage.template LookupEntry<T>(entries[next++ % entries.size()]))
+                ++found;
+
+        state.SetItemsProcessed(state.Iterations());
+        state.SetCounter("found", double(found), true);
+    }
+
+    void BM_SQLStorageLookupCreature(Benchmark::State& state)
+    {
+        LookupEntries<CreatureInfo>(state, sCreatureStorage, [](CreatureInfo const* info) { return info->Entry; });
+    }
+
+    void BM_SQLStorageLookupItem(Benchmark::State& state)
+    {
+        LookupEntries<ItemPrototype>(state, sItemStorage, [](ItemPrototype const* proto) { return proto->ItemId; });
+    }
+
+    void BM_SQLHashStorageLookupGameObject(Benchmark::State& state)
+    {
+        LookupEntries<GameObjectInfo>(state, sGOStorage, [](GameObjectInfo const* info) { return info->id; });
+    }
+
+    BENCHMARK(BM_SQLStorageLookupCreature)->RequiresWorld();
+    BENCHMARK(BM_SQLStorageLookupItem)->RequiresWorld();
+    BENCHMARK(BM_SQLHashStorageLookupGameObject)->RequiresWorld();
+
+    // max range and radius of the first effect of all spells in random order: 0 through the store rows, 1 through the projections
+    void BM_SpellRangeLookup(Benchmark::State& state)
+    {
+        std::vector<SpellEntry const*> spells;
+        for (auto itr = sSpellTemplate.getDataBegin<SpellEntry>(); itr < sSpellTemplate.getDataEnd<SpellEntry>(); ++itr)
+            spells.push_back(*itr);
+
+        if (spells.empty())
+        {
+            state.SkipWithError("spell_template is empty");
+            return;
+        }
+
+        std::shuffle(spells.begin(), spells.end(), std::mt19937(0x4D614E47));
+
+        bool const projection = state.Arg() != 0;
+        float sum = 0.0f;
+        size_t next = 0;
+        while (state.KeepRunning())
+        {
+            SpellEntry const* spellInfo = spells[next++ % spells.size()];
+            if (projection)
+                sum += GetSpellMaxRangeByIndex(spellInfo->rangeIndex) + GetSpellRadiusByIndex(spellInfo->EffectRadiusIndex[EFFECT_INDEX_0]);
+            else
+                sum += GetSpellMaxRange(sSpellRangeStore.LookupEntry(spellInfo->rangeIndex)) + GetSpellRadius(sSpellRadiusStore.LookupEntry(spellInfo->EffectRadiusIndex[EFFECT_INDEX_0]));
+        }
+
+        Benchmark::DoNotOptimize(sum);
+        state.SetItemsProcessed(state.Iterations());
+    }
+    BENCHMARK(BM_SpellRangeLookup)->Arg(0)->Arg(1)->RequiresWorld();
+
+    // creature corpse loot of all templates, without a looter so conditions are not checked
+    void BM_LootTemplateProcess(Benchmark::State& state)
+    {
+        std::vector<LootTemplate const*> templates;
+        for (auto itr = sCreatureStorage.getDataBegin<CreatureInfo>(); itr < sCreatureStorage.getDataEnd<CreatureInfo>(); ++itr)
+            if (LootTemplate const* lootTemplate = itr->LootId ? LootTemplates_Creature.GetLootFor(itr->LootId) : nullptr)
+                templates.push_back(lootTemplate);
+
+        if (templates.empty())
+        {
+            state.SkipWithError("no creature loot templates");
+            return;
+        }
+
+        std::shuffle(templates.begin(), templates.end(), std::mt19937(0x4D614E47));
+
+        size_t next = 0;
+        while (state.KeepRunning())
+        {
+            Loot loot(LOOT_CORPSE);
+            templates[next++ % templates.size()]->Process(loot, nullptr, LootTemplates_Creature, true);
+        }
+
+        state.SetItemsProcessed(state.Iterations());
+    }
+    BENCHMARK(BM_LootTemplateProcess)->RequiresWorld();
+}
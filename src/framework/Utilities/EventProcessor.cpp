@@ -18,18 +18,35 @@
 
 #include "EventProcessor.h"
 
-EventProcessor::EventProcessor()
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static inline uint32 LowestBitIndex(uint32 bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return uint32(index);
+#else
+    return uint32(__builtin_ctz(bits));
+#endif
+}
+
+MultimapEventProcessor::MultimapEventProcessor()
 {
     m_time = 0;
     m_aborting = false;
 }
 
-EventProcessor::~EventProcessor()
+MultimapEventProcessor::~MultimapEventProcessor()
 {
     KillAllEvents(true);
 }
 
-void EventProcessor::Update(uint32 p_time)
+void MultimapEventProcessor::Update(uint32 p_time)
 {
     // update time
     m_time += p_time;
@@ -58,7 +75,7 @@ void EventProcessor::Update(uint32 p_time)
     }
 }
 
-void EventProcessor::KillAllEvents(bool force)
+void MultimapEventProcessor::KillAllEvents(bool force)
 {
     // prevent event insertions
     m_aborting = true;
@@ -85,7 +102,7 @@ void EventProcessor::KillAllEvents(bool force)
         m_events.clear();
 }
 
-void EventProcessor::KillEvent(BasicEvent* event)
+void MultimapEventProcessor::KillEvent(BasicEvent* event)
 {
     for (EventList::iterator iter = m_events.begin(); iter != m_events.end();)
     {
@@ -98,7 +115,7 @@ void EventProcessor::KillEvent(BasicEvent* event)
     }
 }
 
-void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
+void MultimapEventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
 {
     if (set_addtime)
         Event->m_addTime = m_time;
@@ -107,7 +124,7 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
     m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
 }
 
-void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
+void MultimapEventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
 {
     for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
     {
@@ -121,7 +138,325 @@ void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
     }
 }
 
-uint64 EventProcessor::CalculateTime(uint64 t_offset) const
+uint64 MultimapEventProcessor::CalculateTime(uint64 t_offset) const
+{
+    return m_time + t_offset;
+}
+
+TimingWheelEventProcessor::Wheels::Wheels()
+{
+    for (BasicEvent*& head : lists)
+        head = nullptr;
+
+    for (uint32& bits : occupied)
+        bits = 0;
+}
+
+TimingWheelEventProcessor::TimingWheelEventProcessor() : m_time(0), m_cursor(0), m_count(0), m_aborting(false)
+{
+}
+
+TimingWheelEventProcessor::~TimingWheelEventProcessor()
+{
+    KillAllEvents(true);
+}
+
+void TimingWheelEventProcessor::Link(BasicEvent* event, uint16 list)
+{
+    BasicEvent*& head = m_wheels->lists[list];
+    if (!head)
+    {
+        head = event;
+        event->m_wheelPrev = event;
+        event->m_wheelNext = event;
+
+        if (list < LIST_DUE)
+            m_wheels->occupied[list / WHEEL_SLOTS] |= uint32(1) << (list % WHEEL_SLOTS);
+    }
+    else
+    {
+        // append at the tail to keep the order of addition
+        BasicEvent* tail = head->m_wheelPrev;
+        event->m_wheelPrev = tail;
+        event->m_wheelNext = head;
+        tail->m_wheelNext = event;
+        head->m_wheelPrev = event;
+    }
+
+    event->m_wheelOwner = this;
+    event->m_wheelList = list;
+    ++m_count;
+}
+
+void TimingWheelEventProcessor::Unlink(BasicEvent* event)
+{
+    uint16 list = event->m_wheelList;
+    BasicEvent*& head = m_wheels->lists[list];
+    if (event->m_wheelNext == event)
+    {
+        head = nullptr;
+
+        if (list < LIST_DUE)
+            m_wheels->occupied[list / WHEEL_SLOTS] &= ~(uint32(1) << (list % WHEEL_SLOTS));
+    }
+    else
+    {
+        event->m_wheelPrev->m_wheelNext = event->m_wheelNext;
+        event->m_wheelNext->m_wheelPrev = event->m_wheelPrev;
+        if (head == event)
+            head = event->m_wheelNext;
+    }
+
+    event->m_wheelOwner = nullptr;
+    event->m_wheelPrev = nullptr;
+    event->m_wheelNext = nullptr;
+    --m_count;
+}
+
+BasicEvent* TimingWheelEventProcessor::PopFront(uint16 list)
+{
+    BasicEvent* event = m_wheels->lists[list];
+    if (event)
+        Unlink(event);
+    return event;
+}
+
+void TimingWheelEventProcessor::MoveList(uint16 from, uint16 to)
+{
+    BasicEvent* head = m_wheels->lists[from];
+    if (!head)
+        return;
+
+    // whole slot becomes due, splice it in place
+    if (to == LIST_DUE)
+    {
+        m_wheels->lists[from] = nullptr;
+        m_wheels->occupied[from / WHEEL_SLOTS] &= ~(uint32(1) << (from % WHEEL_SLOTS));
+
+        BasicEvent* event = head;
+        do
+        {
+            event->m_wheelList = LIST_DUE;
+            event = event->m_wheelNext;
+        }
+        while (event != head);
+
+        BasicEvent*& due = m_wheels->lists[LIST_DUE];
+        if (!due)
+            due = head;
+        else
+        {
+            BasicEvent* dueTail = due->m_wheelPrev;
+            BasicEvent* tail = head->m_wheelPrev;
+            dueTail->m_wheelNext = head;
+            head->m_wheelPrev = dueTail;
+            tail->m_wheelNext = due;
+            due->m_wheelPrev = tail;
+        }
+        return;
+    }
+
+    // detach the whole list first, events may be inserted into the same list again (overflow)
+    m_wheels->lists[from] = nullptr;
+    if (from < LIST_DUE)
+        m_wheels->occupied[from / WHEEL_SLOTS] &= ~(uint32(1) << (from % WHEEL_SLOTS));
+    head->m_wheelPrev->m_wheelNext = nullptr;
+
+    BasicEvent* event = head;
+    while (event)
+    {
+        BasicEvent* next = event->m_wheelNext;
+        --m_count;
+
+        if (to == LIST_COUNT)
+            Insert(event);
+        else
+            Link(event, to);
+
+        event = next;
+    }
+}
+
+void TimingWheelEventProcessor::Insert(BasicEvent* event)
+{
+    uint64 time = event->m_execTime;
+    if (time <= m_cursor)
+    {
+        Link(event, LIST_DUE);
+        return;
+    }
+
+    // the highest bit differing from the cursor selects the wheel, the slot is the time at the resolution of that wheel
+    uint64 diff = time ^ m_cursor;
+    for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
+    {
+        if (diff < (uint64(1) << (WHEEL_BITS * (level + 1))))
+        {
+            Link(event, level * WHEEL_SLOTS + ((time >> (WHEEL_BITS * level)) & WHEEL_MASK));
+            return;
+        }
+    }
+
+    Link(event, LIST_OVERFLOW);
+}
+
+void TimingWheelEventProcessor::Cascade()
+{
+    // m_cursor reached a multiple of WHEEL_SLOTS, redistribute the slots of the upper wheels that start now
+    for (uint32 level = 1; level < WHEEL_LEVELS; ++level)
+    {
+        uint32 slot = (m_cursor >> (WHEEL_BITS * level)) & WHEEL_MASK;
+        MoveList(level * WHEEL_SLOTS + slot, LIST_COUNT);
+        if (slot)
+            return;
+    }
+
+    // all wheels wrapped, overflow events may fit now
+    MoveList(LIST_OVERFLOW, LIST_COUNT);
+}
+
+void TimingWheelEventProcessor::RunDue(uint32 p_time)
+{
+    // events added while executing with a time not after m_cursor are appended and run in this loop too
+    while (BasicEvent* event = PopFront(LIST_DUE))
+    {
+        if (!event->to_Abort)
+        {
+            if (event->Execute(m_time, p_time))
+            {
+                // completely destroy event if it is not re-added
+                delete event;
+            }
+        }
+        else
+        {
+            event->Abort(m_time);
+            delete event;
+        }
+    }
+}
+
+uint64 TimingWheelEventProcessor::NextSlotTime() const
+{
+    // the first used slot after the cursor position, looking from the finest wheel up, is the earliest one
+    for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
+    {
+        uint32 shift = WHEEL_BITS * level;
+        uint32 position = (m_cursor >> shift) & WHEEL_MASK;
+        if (position == WHEEL_MASK)
+            continue;
+
+        uint32 pending = m_wheels->occupied[level] & (~uint32(0) << (position + 1));
+        if (!pending)
+            continue;
+
+        uint64 windowStart = m_cursor & ~((uint64(1) << (shift + WHEEL_BITS)) - 1);
+        return windowStart + (uint64(LowestBitIndex(pending)) << shift);
+    }
+
+    // only overflow events left, they are redistributed when the last wheel wraps
+    if (m_wheels->lists[LIST_OVERFLOW])
+        return (m_cursor | ((uint64(1) << (WHEEL_BITS * WHEEL_LEVELS)) - 1)) + 1;
+
+    return ~uint64(0);
+}
+
+void TimingWheelEventProcessor::Update(uint32 p_time)
+{
+    // update time
+    m_time += p_time;
+
+    if (m_count)
+    {
+        // events added since last update for a time already passed
+        RunDue(p_time);
+
+        // jump from used slot to used slot, empty ones are never visited
+        while (m_count)
+        {
+            uint64 next = NextSlotTime();
+            if (next > m_time)
+                break;
+
+            m_cursor = next;
+
+            // slot 0 of the finest wheel is always empty, a time at its start is a wrap of the upper wheels
+            if (next & WHEEL_MASK)
+                MoveList(uint16(next & WHEEL_MASK), LIST_DUE);
+            else
+                Cascade();
+
+            RunDue(p_time);
+        }
+    }
+
+    m_cursor = m_time;
+}
+
+void TimingWheelEventProcessor::KillAllEvents(bool force)
+{
+    // prevent event insertions
+    m_aborting = true;
+
+    if (!m_count)
+        return;
+
+    // Abort() may kill other events, so work on a copy
+    std::vector<BasicEvent*> events;
+    events.reserve(m_count);
+    VisitEvents([&events](BasicEvent* event) { events.push_back(event); });
+
+    for (BasicEvent* event : events)
+    {
+        if (event->m_wheelOwner != this)
+            continue;
+
+        event->to_Abort = true;
+        event->Abort(m_time);
+        if (force || event->IsDeletable())
+        {
+            if (event->m_wheelOwner == this)
+                Unlink(event);
+            delete event;
+        }
+    }
+}
+
+void TimingWheelEventProcessor::KillEvent(BasicEvent* event)
+{
+    // not queued here (for example currently executing)
+    if (event->m_wheelOwner != this)
+        return;
+
+    Unlink(event);
+    delete event;
+}
+
+void TimingWheelEventProcessor::AddEvent(BasicEvent* event, uint64 e_time, bool set_addtime)
+{
+    if (set_addtime)
+        event->m_addTime = m_time;
+
+    if (!m_wheels)
+        m_wheels.reset(new Wheels());
+    else if (event->m_wheelOwner == this)
+        Unlink(event);
+
+    event->m_execTime = e_time;
+    Insert(event);
+}
+
+void TimingWheelEventProcessor::ModifyEventTime(BasicEvent* event, uint64 msTime)
+{
+    if (event->m_wheelOwner != this)
+        return;
+
+    Unlink(event);
+    event->m_execTime = msTime;
+    Insert(event);
+}
+
+uint64 TimingWheelEventProcessor::CalculateTime(uint64 t_offset) const
 {
     return m_time + t_offset;
 }
@@ -22,15 +22,19 @@
 #include "Platform/Define.h"
 
 #include <map>
+#include <memory>
+#include <new>
 
 // Note. All times are in milliseconds here.
 
+class TimingWheelEventProcessor;
+
 class BasicEvent
 {
     public:
 
         BasicEvent()
-            : to_Abort(false)
+            : to_Abort(false), m_wheelOwner(nullptr), m_wheelPrev(nullptr), m_wheelNext(nullptr), m_wheelList(0)
         {
         }
 
@@ -53,16 +57,115 @@ class BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
+
+    private:
+        friend class TimingWheelEventProcessor;
+
+        // intrusive links of TimingWheelEventProcessor
+        TimingWheelEventProcessor* m_wheelOwner;
+        BasicEvent* m_wheelPrev;
+        BasicEvent* m_wheelNext;
+        uint16 m_wheelList;
+};
+
+/// Allocation of events from per thread free lists, used by frequently created event types when built with EVENTS_POOL_ALLOCATOR
+/// An event may be freed by another thread than the one that allocated it, so each list is capped and blocks beyond
+/// the cap go back to the global allocator, as do the blocks of a list when its thread ends.
+template <std::size_t Size>
+class EventPool
+{
+    public:
+        static void* Allocate()
+        {
+            FreeList& list = GetFreeList();
+            if (!list.head)
+                return ::operator new(Size);
+
+            FreeNode* node = list.head;
+            list.head = node->next;
+            --list.count;
+            return node;
+        }
+
+        static void Deallocate(void* ptr)
+        {
+            FreeList& list = GetFreeList();
+            if (list.count >= MAX_FREE)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            FreeNode* node = static_cast<FreeNode*>(ptr);
+            node->next = list.head;
+            list.head = node;
+            ++list.count;
+        }
+
+    private:
+        static std::size_t const MAX_FREE = 4096;          // per thread and event size
+
+        struct FreeNode
+        {
+            FreeNode* next;
+        };
+
+        struct FreeList
+        {
+            FreeList() : head(nullptr), count(0) {}
+            ~FreeList()
+            {
+                while (FreeNode* node = head)
+                {
+                    head = node->next;
+                    ::operator delete(node);
+                }
+            }
+
+            FreeNode* head;
+            std::size_t count;
+        };
+
+        static FreeList& GetFreeList()
+        {
+            static thread_local FreeList list;
+            return list;
+        }
+};
+
+/// Base for event types which want to be allocated from EventPool
+template <class T>
+class PooledEvent : public BasicEvent
+{
+#ifdef EVENTS_POOL_ALLOCATOR
+    public:
+        static void* operator new(std::size_t size)
+        {
+            // derived types of T are bigger, they use the default allocation
+            if (size != sizeof(T))
+                return ::operator new(size);
+            return EventPool<sizeof(T)>::Allocate();
+        }
+
+        static void operator delete(void* ptr, std::size_t size)
+        {
+            if (size != sizeof(T))
+                ::operator delete(ptr);
+            else
+                EventPool<sizeof(T)>::Deallocate(ptr);
+        }
+#endif
 };
 
 typedef std::multimap<uint64, BasicEvent*> EventList;
 
-class EventProcessor
+/// Events ordered in a multimap, every insert and remove is O(log n) and allocates a node
+class MultimapEventProcessor
 {
     public:
 
-        EventProcessor();
-        ~EventProcessor();
+        MultimapEventProcessor();
+        ~MultimapEventProcessor();
 
         void Update(uint32 p_time);
         void KillAllEvents(bool force);
@@ -72,6 +175,14 @@ class EventProcessor
         uint64 CalculateTime(uint64 t_offset) const;
         EventList& GetEvents() { return m_events; }
 
+        // call visitor(BasicEvent*) for all queued events, the visitor must not add or remove events
+        template <class Visitor>
+        void VisitEvents(Visitor&& visitor) const
+        {
+            for (auto const& itr : m_events)
+                visitor(itr.second);
+        }
+
     protected:
 
         uint64 m_time;
@@ -79,4 +190,88 @@ class EventProcessor
         bool m_aborting;
 };
 
+/// Events kept in hierarchical timing wheels with 1ms resolution, insert, remove and expire are O(1)
+/// Events of the same millisecond are executed in the order they were added, like with MultimapEventProcessor.
+/// The wheels (~1KB) are only allocated when the first event is added.
+class TimingWheelEventProcessor
+{
+    public:
+
+        TimingWheelEventProcessor();
+        ~TimingWheelEventProcessor();
+
+        void Update(uint32 p_time);
+        void KillAllEvents(bool force);
+        void KillEvent(BasicEvent* Event);
+        void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
+        void ModifyEventTime(BasicEvent* event, uint64 msTime);
+        uint64 CalculateTime(uint64 t_offset) const;
+
+        // call visitor(BasicEvent*) for all queued events, the visitor must not add or remove events
+        template <class Visitor>
+        void VisitEvents(Visitor&& visitor) const
+        {
+            if (!m_wheels)
+                return;
+
+            for (BasicEvent* head : m_wheels->lists)
+            {
+                if (!head)
+                    continue;
+
+                BasicEvent* event = head;
+                do
+                {
+                    BasicEvent* next = event->m_wheelNext;
+                    visitor(event);
+                    event = next;
+                }
+                while (event != head);
+            }
+        }
+
+    private:
+
+        enum
+        {
+            WHEEL_BITS      = 5,
+            WHEEL_SLOTS     = 1 << WHEEL_BITS,
+            WHEEL_MASK      = WHEEL_SLOTS - 1,
+            WHEEL_LEVELS    = 4,                            // 2^20 ms (~17 minutes) until events go to the overflow list
+
+            LIST_DUE        = WHEEL_LEVELS * WHEEL_SLOTS,   // events due at or before m_cursor
+            LIST_OVERFLOW,                                  // events beyond the last wheel
+            LIST_COUNT
+        };
+
+        struct Wheels
+        {
+            Wheels();
+
+            BasicEvent* lists[LIST_COUNT];                  // circular lists, head is the first event
+            uint32 occupied[WHEEL_LEVELS];                  // bit per non empty slot
+        };
+
+        void Insert(BasicEvent* event);
+        void Link(BasicEvent* event, uint16 list);
+        void Unlink(BasicEvent* event);
+        BasicEvent* PopFront(uint16 list);
+        void MoveList(uint16 from, uint16 to);
+        void Cascade();
+        uint64 NextSlotTime() const;
+        void RunDue(uint32 p_time);
+
+        uint64 m_time;
+        uint64 m_cursor;                                    // last millisecond whose events were moved to the due list
+        uint32 m_count;
+        std::unique_ptr<Wheels> m_wheels;
+        bool m_aborting;
+};
+
+#ifdef EVENTS_TIMING_WHEEL
+typedef TimingWheelEventProcessor EventProcessor;
+#else
+typedef MultimapEventProcessor EventProcessor;
+#endif
+
 #endif
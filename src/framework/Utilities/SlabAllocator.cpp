@@ -0,0 +1,195 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "SlabAllocator.h"
+
+#include <algorithm>
+
+namespace
+{
+    std::mutex s_poolsLock;
+    std::vector<SlabPool*> s_pools;
+
+    // objects freed by static destructors after the caches of the main thread are gone go straight to their pool
+    thread_local bool s_threadCachesReleased = false;
+}
+
+/// Free slots a thread holds of every pool, given back to the pools when the thread ends
+struct SlabThreadCaches
+{
+    SlabThreadCaches()
+    {
+        for (SlabPool::ThreadCache& cache : caches)
+            cache = { nullptr, 0 };
+    }
+
+    ~SlabThreadCaches()
+    {
+        s_threadCachesReleased = true;
+
+        std::lock_guard<std::mutex> guard(s_poolsLock);
+        for (std::size_t i = 0; i < s_pools.size() && i < SLAB_POOL_MAX_CACHED; ++i)
+            if (caches[i].count)
+                s_pools[i]->Release(caches[i], caches[i].count);
+    }
+
+    SlabPool::ThreadCache caches[SLAB_POOL_MAX_CACHED];
+};
+
+static thread_local SlabThreadCaches s_threadCaches;
+
+SlabPool::SlabPool(char const* name, std::size_t objectSize) : m_name(name), m_free(nullptr), m_live(0)
+{
+    // slots keep the alignment of operator new
+    std::size_t const align = alignof(std::max_align_t);
+    m_slotSize = (std::max(objectSize, sizeof(FreeNode)) + align - 1) / align * align;
+    m_slabSlots = std::max<std::size_t>(64 * 1024 / m_slotSize, 16);
+
+    std::lock_guard<std::mutex> guard(s_poolsLock);
+    m_index = uint32(s_pools.size());
+    s_pools.push_back(this);
+}
+
+void* SlabPool::Allocate()
+{
+    m_live.fetch_add(1, std::memory_order_relaxed);
+
+    ThreadCache local = { nullptr, 0 };
+    ThreadCache* cache = GetThreadCache();
+    if (!cache)
+        cache = &local;
+
+    if (!cache->head)
+        Refill(*cache);
+
+    FreeNode* node = cache->head;
+    cache->head = node->next;
+    --cache->count;
+
+    if (cache == &local)
+        Release(local, local.count);
+
+    return node;
+}
+
+void SlabPool::Deallocate(void* ptr)
+{
+    m_live.fetch_sub(1, std::memory_order_relaxed);
+
+    FreeNode* node = static_cast<FreeNode*>(ptr);
+    ThreadCache* cache = GetThreadCache();
+    if (!cache)
+    {
+        ThreadCache local = { node, 1 };
+        node->next = nullptr;
+        Release(local, 1);
+        return;
+    }
+
+    node->next = cache->head;
+    cache->head = node;
+
+    // a thread mostly freeing, like the one unloading grids, hands the slots back for the others
+    if (++cache->count >= 2 * SLAB_POOL_CACHE_BATCH)
+        Release(*cache, SLAB_POOL_CACHE_BATCH);
+}
+
+SlabPool::ThreadCache* SlabPool::GetThreadCache() const
+{
+    if (m_index >= SLAB_POOL_MAX_CACHED || s_threadCachesReleased)
+        return nullptr;
+
+    return &s_threadCaches.caches[m_index];
+}
+
+void SlabPool::Refill(ThreadCache& cache)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (!m_free)
+        AddSlab();
+
+    for (uint32 i = 0; i < SLAB_POOL_CACHE_BATCH && m_free; ++i)
+    {
+        FreeNode* node = m_free;
+        m_free = node->next;
+        node->next = cache.head;
+        cache.head = node;
+        ++cache.count;
+    }
+}
+
+void SlabPool::Release(ThreadCache& cache, uint32 count)
+{
+    if (!count)
+        return;
+
+    // unlink count slots from the cache first, then splice them in front of the pool free list
+    FreeNode* first = cache.head;
+    FreeNode* last = first;
+    for (uint32 i = 1; i < count; ++i)
+        last = last->next;
+
+    cache.head = last->next;
+    cache.count -= count;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    last->next = m_free;
+    m_free = first;
+}
+
+void SlabPool::AddSlab()
+{
+    char* slab = static_cast<char*>(::operator new(m_slabSlots * m_slotSize));
+    m_slabs.push_back(slab);
+
+    // linked back to front, so the slots are handed out in address order
+    for (std::size_t i = m_slabSlots; i > 0; --i)
+    {
+        FreeNode* node = reinterpret_cast<FreeNode*>(slab + (i - 1) * m_slotSize);
+        node->next = m_free;
+        m_free = node;
+    }
+}
+
+SlabPoolStats SlabPool::GetStats() const
+{
+    SlabPoolStats stats;
+    stats.name = m_name;
+    stats.slotSize = m_slotSize;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        stats.slabs = m_slabs.size();
+    }
+    stats.slots = stats.slabs * m_slabSlots;
+    stats.live = m_live.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::vector<SlabPoolStats> SlabPool::GetAllStats()
+{
+    std::vector<SlabPool*> pools;
+    {
+        std::lock_guard<std::mutex> guard(s_poolsLock);
+        pools = s_pools;
+    }
+
+    std::vector<SlabPoolStats> stats;
+    for (SlabPool const* pool : pools)
+        stats.push_back(pool->GetStats());
+    return stats;
+}
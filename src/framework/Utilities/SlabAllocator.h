@@ -0,0 +1,124 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SLAB_ALLOCATOR_H
+#define MANGOS_SLAB_ALLOCATOR_H
+
+#include "Platform/Define.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// pools which get a thread cache, pools created beyond that always take the pool lock
+#define SLAB_POOL_MAX_CACHED        16
+// slots a thread moves between its cache and the pool at once
+#define SLAB_POOL_CACHE_BATCH       32
+
+struct SlabPoolStats
+{
+    char const* name;
+    std::size_t slotSize;
+    std::size_t slabs;
+    std::size_t slots;                                      // live and free
+    std::size_t live;
+};
+
+/// Allocation of equally sized objects of one type from slabs, used by frequently created and destroyed game objects
+/// when built with SLAB_ALLOCATOR
+/// Slots are carved out of slabs of at least 64KB, so objects created by a grid load sit next to each other instead
+/// of being spread over the heap. Every thread keeps a cache of free slots of each pool and exchanges them with the
+/// pool in batches of SLAB_POOL_CACHE_BATCH, so most allocations take no lock. An object may be freed by another
+/// thread than the one which created it, its slot then goes to the cache of the freeing thread.
+/// Slabs are never given back: after the peak amount of objects was reached the memory use stays flat, instead of
+/// the heap fragmenting over grid load and unload cycles. For the same reason pools are never destroyed, objects can
+/// still be freed by static destructors at shutdown.
+class SlabPool
+{
+    public:
+        SlabPool(char const* name, std::size_t objectSize);
+
+        void* Allocate();
+        void Deallocate(void* ptr);
+
+        SlabPoolStats GetStats() const;
+
+        // statistics of all pools created so far
+        static std::vector<SlabPoolStats> GetAllStats();
+
+    private:
+        friend struct SlabThreadCaches;
+
+        struct FreeNode
+        {
+            FreeNode* next;
+        };
+
+        struct ThreadCache
+        {
+            FreeNode* head;
+            uint32 count;
+        };
+
+        // nullptr when the thread can not cache slots of this pool
+        ThreadCache* GetThreadCache() const;
+        // moves a batch of free slots from the pool to the cache, carving a new slab when the pool has none
+        void Refill(ThreadCache& cache);
+        // moves count slots from the cache back to the pool
+        void Release(ThreadCache& cache, uint32 count);
+        void AddSlab();
+
+        char const* m_name;
+        std::size_t m_slotSize;
+        std::size_t m_slabSlots;
+        uint32 m_index;                                     // of the thread caches
+
+        mutable std::mutex m_lock;
+        FreeNode* m_free;
+        std::vector<char*> m_slabs;
+        std::atomic<std::size_t> m_live;
+};
+
+#ifdef SLAB_ALLOCATOR
+/// Declares class specific new and delete allocating Type from its own SlabPool, used inside the class definition.
+/// Derived types without their own declaration are bigger and use the default allocation.
+#define SLAB_ALLOCATED(Type)                                                                \
+    public:                                                                                 \
+        static void* operator new(std::size_t size)                                         \
+        {                                                                                   \
+            return size == sizeof(Type) ? GetSlabPool().Allocate() : ::operator new(size);  \
+        }                                                                                   \
+        static void operator delete(void* ptr, std::size_t size)                            \
+        {                                                                                   \
+            if (size == sizeof(Type))                                                       \
+                GetSlabPool().Deallocate(ptr);                                              \
+            else                                                                            \
+                ::operator delete(ptr);                                                     \
+        }                                                                                   \
+        static SlabPool& GetSlabPool()                                                      \
+        {                                                                                   \
+            static SlabPool* pool = new SlabPool(#Type, sizeof(Type));                      \
+            return *pool;                                                                   \
+        }
+#else
+#define SLAB_ALLOCATED(Type)
+#endif
+
+#endif
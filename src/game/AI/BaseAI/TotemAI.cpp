@@ -75,8 +75,7 @@ void TotemAI::UpdateAI(const uint32 diff)
 		return;
 
     // Get spell rangy
-    SpellRangeEntry const* srange = sSpellRangeStore.LookupEntry(spellInfo->rangeIndex);
-    float maxRange = GetSpellMaxRange(srange);
+    float maxRange = GetSpellMaxRangeByIndex(spellInfo->rangeIndex);
 
     // SPELLMOD_RANGE not applied in this place just because nonexistent range mods for attacking totems
 
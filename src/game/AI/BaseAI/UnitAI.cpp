@@ -687,8 +687,7 @@ Unit* UnitAI::DoSelectLowestHpFriendly(float range, float minMissing, bool perce
 float UnitAI::CalculateSpellRange(SpellEntry const* spellInfo) const
 {
     // optimized duplicate of Spell::GetMinMaxRange for just max range
-    SpellRangeEntry const* spellRange = sSpellRangeStore.LookupEntry(spellInfo->rangeIndex);
-    float maxRange = GetSpellMaxRange(spellRange);
+    float maxRange = GetSpellMaxRangeByIndex(spellInfo->rangeIndex);
     if (Player* modOwner = m_unit->GetSpellModOwner()) // Player AI support
         modOwner->ApplySpellMod(spellInfo->Id, SPELLMOD_RANGE, maxRange);
     return maxRange;
@@ -948,7 +947,7 @@ void UnitAI::AddMainSpell(uint32 spellId)
         m_mainSpellId = spellId;
         SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(m_mainSpellId);
         m_mainSpellCost = Spell::CalculatePowerCost(spellInfo, m_unit);
-        m_mainSpellMinRange = GetSpellMinRange(sSpellRangeStore.LookupEntry(spellInfo->rangeIndex));
+        m_mainSpellMinRange = GetSpellMinRangeByIndex(spellInfo->rangeIndex);
         m_mainAttackMask = SpellSchoolMask(m_mainAttackMask + GetSchoolMask(spellInfo->School));
         m_mainSpellInfo = spellInfo;
     }
@@ -207,7 +207,7 @@ struct CallAllZombies : public SpellScript
             {
                 if (unitTarget->IsAlive())
                 {
-                    float radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(spell->m_spellInfo->EffectRadiusIndex[effIdx]));
+                    float radius = GetSpellRadiusByIndex(spell->m_spellInfo->EffectRadiusIndex[effIdx]);
                     unitTarget->GetMotionMaster()->MoveFollow(spell->GetCaster(), radius, 0);
                 }
             }
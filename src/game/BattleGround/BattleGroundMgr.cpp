@@ -54,6 +54,10 @@ BattleGroundQueue::BattleGroundQueue()
                 m_waitTimes[i][j][k] = 0;
         }
     }
+
+    for (auto& waitingPlayers : m_waitingPlayers)
+        for (uint32& count : waitingPlayers)
+            count = 0;
 }
 
 BattleGroundQueue::~BattleGroundQueue()
@@ -203,7 +207,10 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* group, Battle
         }
 
         // add GroupInfo to m_QueuedGroups
+        queueInfo->bracketId = bracketId;
+        queueInfo->queueIndex = index;
         m_queuedGroups[bracketId][index].push_back(queueInfo);
+        m_waitingPlayers[bracketId][index] += queueInfo->players.size();
 
         // announce to world, this code needs mutex
         if (!isPremade && sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN))
@@ -212,17 +219,9 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* group, Battle
             {
                 char const* bgName = bg->GetName();
                 uint32 minPlayers = bg->GetMinPlayersPerTeam();
-                uint32 qHorde = 0;
-                uint32 qAlliance = 0;
+                uint32 qHorde = m_waitingPlayers[bracketId][BG_QUEUE_NORMAL_HORDE];
+                uint32 qAlliance = m_waitingPlayers[bracketId][BG_QUEUE_NORMAL_ALLIANCE];
                 uint32 q_min_level = leader->GetMinLevelForBattleGroundBracketId(bracketId, bgTypeId);
-                GroupsQueueType::const_iterator itr;
-                for (itr = m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].begin(); itr != m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].end(); ++itr)
-                    if (!(*itr)->isInvitedToBgInstanceGuid)
-                        qAlliance += (*itr)->players.size();
-
-                for (itr = m_queuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].begin(); itr != m_queuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].end(); ++itr)
-                    if (!(*itr)->isInvitedToBgInstanceGuid)
-                        qHorde += (*itr)->players.size();
 
                 // Show queue status to player only (when joining queue)
                 if (sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN) == 1)
@@ -306,8 +305,6 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // Player *plr = sObjectMgr.GetPlayer(guid);
     // std::lock_guard<std::recursive_mutex> guard(m_Lock);
 
-    int32 bracketId = -1;                                   // signed for proper for-loop finish
-
     // remove player from map, if he's there
     QueuedPlayersMap::iterator itr = m_queuedPlayers.find(guid);
     if (itr == m_queuedPlayers.end())
@@ -317,34 +314,12 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     }
 
     GroupQueueInfo* group = itr->second.groupInfo;
-    GroupsQueueType::iterator group_itr;
-    // mostly people with the highest levels are in battlegrounds, thats why
-    // we count from MAX_BATTLEGROUND_QUEUES - 1 to 0
-    // variable index removes useless searching in other team's queue
-    uint32 index = GetTeamIndexByTeamId(group->groupTeam);
-
-    for (int8 bracketIdTmp = MAX_BATTLEGROUND_BRACKETS - 1; bracketIdTmp >= 0 && bracketId == -1; --bracketIdTmp)
-    {
-        // we must check premade and normal team's queue - because when players from premade are joining bg,
-        // they leave groupinfo so we can't use its players size to find out index
-        for (uint8 j = index; j < BG_QUEUE_GROUP_TYPES_COUNT; j += BG_QUEUE_NORMAL_ALLIANCE)
-        {
-            for (GroupsQueueType::iterator group_itr_tmp = m_queuedGroups[bracketIdTmp][j].begin(); group_itr_tmp != m_queuedGroups[bracketIdTmp][j].end(); ++group_itr_tmp)
-            {
-                if ((*group_itr_tmp) == group)
-                {
-                    bracketId = bracketIdTmp;
-                    group_itr = group_itr_tmp;
-                    // we must store index to be able to erase iterator
-                    index = j;
-                    break;
-                }
-            }
-        }
-    }
+    BattleGroundBracketId bracketId = group->bracketId;
+    uint32 index = group->queueIndex;
+    GroupsQueueType::iterator group_itr = std::find(m_queuedGroups[bracketId][index].begin(), m_queuedGroups[bracketId][index].end(), group);
 
     // player can't be in queue without group, but just in case
-    if (bracketId == -1)
+    if (group_itr == m_queuedGroups[bracketId][index].end())
     {
         sLog.outError("BattleGroundQueue: ERROR Cannot find groupinfo for %s", guid.GetString().c_str());
         return;
@@ -359,7 +334,11 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // remove player queue info from group queue info
     GroupQueueInfoPlayers::iterator pitr = group->players.find(guid);
     if (pitr != group->players.end())
+    {
         group->players.erase(pitr);
+        if (!group->isInvitedToBgInstanceGuid)
+            --m_waitingPlayers[bracketId][index];
+    }
 
     // if invited to bg, and should decrease invited count, then do it
     if (decreaseInvitedCount && group->isInvitedToBgInstanceGuid)
@@ -432,6 +411,7 @@ bool BattleGroundQueue::InviteGroupToBg(GroupQueueInfo* queueInfo, BattleGround*
         // not yet invited
         // set invitation
         queueInfo->isInvitedToBgInstanceGuid = bg->GetInstanceId();
+        m_waitingPlayers[queueInfo->bracketId][queueInfo->queueIndex] -= queueInfo->players.size();
         BattleGroundTypeId bgTypeId = bg->GetTypeId();
         BattleGroundQueueTypeId bgQueueTypeId = BattleGroundMgr::BgQueueTypeId(bgTypeId);
         BattleGroundBracketId bracket_id = bg->GetBracketId();
@@ -573,7 +553,7 @@ void BattleGroundQueue::FillPlayersToBg(BattleGround* bg, BattleGroundBracketId
 bool BattleGroundQueue::CheckPremadeMatch(BattleGroundBracketId bracketId, uint32 minPlayersPerTeam, uint32 maxPlayersPerTeam)
 {
     // check match
-    if (!m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].empty() && !m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].empty())
+    if (m_waitingPlayers[bracketId][BG_QUEUE_PREMADE_ALLIANCE] && m_waitingPlayers[bracketId][BG_QUEUE_PREMADE_HORDE])
     {
         // start premade match
         // if groups aren't invited
@@ -620,6 +600,9 @@ bool BattleGroundQueue::CheckPremadeMatch(BattleGroundBracketId bracketId, uint3
             if (!(*itr)->isInvitedToBgInstanceGuid && ((*itr)->joinTime < time_before || (*itr)->players.size() < minPlayersPerTeam))
             {
                 // we must insert group to normal queue and erase pointer from premade queue
+                (*itr)->queueIndex = BG_QUEUE_NORMAL_ALLIANCE + i;
+                m_waitingPlayers[bracketId][BG_QUEUE_NORMAL_ALLIANCE + i] += (*itr)->players.size();
+                m_waitingPlayers[bracketId][BG_QUEUE_PREMADE_ALLIANCE + i] -= (*itr)->players.size();
                 m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE + i].push_front((*itr));
                 m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE + i].erase(itr);
             }
@@ -698,17 +681,18 @@ bool BattleGroundQueue::CheckNormalMatch(BattleGroundBracketId bracketId, uint32
 void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketId bracketId)
 {
     // std::lock_guard<std::recursive_mutex> guard(m_Lock);
-    // if no players in queue - do nothing
-    if (m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].empty() &&
-            m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].empty() &&
-            m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].empty() &&
-            m_queuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].empty())
+    // if no players waiting for an invitation - do nothing, invited groups only leave the queue
+    uint32 const (&waitingPlayers)[BG_QUEUE_GROUP_TYPES_COUNT] = m_waitingPlayers[bracketId];
+    if (!waitingPlayers[BG_QUEUE_PREMADE_ALLIANCE] && !waitingPlayers[BG_QUEUE_PREMADE_HORDE] &&
+            !waitingPlayers[BG_QUEUE_NORMAL_ALLIANCE] && !waitingPlayers[BG_QUEUE_NORMAL_HORDE])
         return;
 
     // battleground with free slot for player should be always in the beggining of the queue
     // maybe it would be better to create bgfreeslotqueue for each bracket_id
+    // only normal groups are invited into running battlegrounds
     BgFreeSlotQueueType::iterator next;
-    for (BgFreeSlotQueueType::iterator itr = sBattleGroundMgr.BgFreeSlotQueue[bgTypeId].begin(); itr != sBattleGroundMgr.BgFreeSlotQueue[bgTypeId].end(); itr = next)
+    for (BgFreeSlotQueueType::iterator itr = sBattleGroundMgr.BgFreeSlotQueue[bgTypeId].begin(); itr != sBattleGroundMgr.BgFreeSlotQueue[bgTypeId].end() &&
+            (waitingPlayers[BG_QUEUE_NORMAL_ALLIANCE] || waitingPlayers[BG_QUEUE_NORMAL_HORDE]); itr = next)
     {
         next = itr;
         ++next;
@@ -784,6 +768,11 @@ void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketI
     }
 
     // now check if there are in queues enough players to start new game of (normal battleground)
+    // the pools only take waiting normal groups, so without enough of them on both sides no match is possible
+    bool const enoughPlayers = sBattleGroundMgr.IsTesting() ?
+        waitingPlayers[BG_QUEUE_NORMAL_ALLIANCE] || waitingPlayers[BG_QUEUE_NORMAL_HORDE] :
+        waitingPlayers[BG_QUEUE_NORMAL_ALLIANCE] >= minPlayersPerTeam && waitingPlayers[BG_QUEUE_NORMAL_HORDE] >= minPlayersPerTeam;
+    if (enoughPlayers)
     {
         // if there are enough players in pools, start new battleground or non rated arena
         if (CheckNormalMatch(bracketId, minPlayersPerTeam, maxPlayersPerTeam))
@@ -940,32 +929,26 @@ void BattleGroundMgr::DeleteAllBattleGrounds()
 }
 
 /**
-  Update method
+  Update method, called by the matchmaking scheduler when queue updates were scheduled
 
   @param    diff
 */
-void BattleGroundMgr::Update(uint32 diff)
+void BattleGroundMgr::Update(uint32 /*diff*/)
 {
     // update scheduled queues
-    if (!m_queueUpdateScheduler.empty())
+    std::vector<uint64> scheduled;
     {
-        std::vector<uint64> scheduled;
-        {
-            // create mutex
-            // std::lock_guard<std::mutex> guard(SchedulerLock);
-            // copy vector and clear the other
-            scheduled = std::vector<uint64>(m_queueUpdateScheduler);
-            m_queueUpdateScheduler.clear();
-            // release lock
-        }
+        // battlegrounds schedule updates from the map threads
+        std::lock_guard<std::mutex> guard(schedulerLock);
+        std::swap(scheduled, m_queueUpdateScheduler);
+    }
 
-        for (uint32 i : scheduled)
-        {
-            BattleGroundQueueTypeId bgQueueTypeId = BattleGroundQueueTypeId(i >> 16 & 255);
-            BattleGroundTypeId bgTypeId = BattleGroundTypeId((i >> 8) & 255);
-            BattleGroundBracketId bracketId = BattleGroundBracketId(i & 255);
-            m_battleGroundQueues[bgQueueTypeId].Update(bgTypeId, bracketId);
-        }
+    for (uint32 i : scheduled)
+    {
+        BattleGroundQueueTypeId bgQueueTypeId = BattleGroundQueueTypeId(i >> 16 & 255);
+        BattleGroundTypeId bgTypeId = BattleGroundTypeId((i >> 8) & 255);
+        BattleGroundBracketId bracketId = BattleGroundBracketId(i & 255);
+        m_battleGroundQueues[bgQueueTypeId].Update(bgTypeId, bracketId);
     }
 }
 
@@ -1567,20 +1550,16 @@ void BattleGroundMgr::ToggleTesting()
 */
 void BattleGroundMgr::ScheduleQueueUpdate(BattleGroundQueueTypeId bgQueueTypeId, BattleGroundTypeId bgTypeId, BattleGroundBracketId bracket_id)
 {
-    // std::lock_guard<std::mutex> guard(SchedulerLock);
-    // we will use only 1 number created of bgTypeId and bracket_id
-    uint32 schedule_id = (bgQueueTypeId << 16) | (bgTypeId << 8) | bracket_id;
-    bool found = false;
-    for (unsigned long long i : m_queueUpdateScheduler)
     {
-        if (i == schedule_id)
-        {
-            found = true;
-            break;
-        }
+        std::lock_guard<std::mutex> guard(schedulerLock);
+        // we will use only 1 number created of bgTypeId and bracket_id
+        uint32 schedule_id = (bgQueueTypeId << 16) | (bgTypeId << 8) | bracket_id;
+        if (std::find(m_queueUpdateScheduler.begin(), m_queueUpdateScheduler.end(), schedule_id) == m_queueUpdateScheduler.end())
+            m_queueUpdateScheduler.push_back(schedule_id);
     }
-    if (!found)
-        m_queueUpdateScheduler.push_back(schedule_id);
+
+    // the queue is matched on the next world tick
+    sWorld.GetMatchmakingScheduler().Wake(MATCHMAKING_BATTLEGROUND);
 }
 
 uint32 BattleGroundMgr::GetPrematureFinishTime() const
@@ -54,6 +54,8 @@ struct GroupQueueInfo                                       // stores informatio
     uint32  removeInviteTime;                               // time when we will remove invite for players in group
     uint32  isInvitedToBgInstanceGuid;                      // was invited to certain BG
     uint32  desiredInstanceId;                              // queued for this instance specifically
+    BattleGroundBracketId bracketId;                        // bracket and BattleGroundQueueGroupTypes of the queue the group is in
+    uint32  queueIndex;
 };
 
 enum BattleGroundQueueGroupTypes
@@ -107,6 +109,9 @@ class BattleGroundQueue
         */
         GroupsQueueType m_queuedGroups[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT];
 
+        // players of the not yet invited groups in each of the queues above, tells without iterating whether a match is possible
+        uint32 m_waitingPlayers[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT];
+
         // class to select and invite groups to bg
         class SelectionPool
         {
@@ -229,6 +229,18 @@ ChatCommand* ChatHandler::getCommandTable()
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
+    static ChatCommand debugPacketLogCommandTable[] =
+    {
+        { "status",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketLogStatus,            "", nullptr },
+        { "all",            SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketLogAll,               "", nullptr },
+        { "opcode",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketLogOpcode,            "", nullptr },
+        { "connections",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketLogConnections,       "", nullptr },
+        { "replay",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketLogReplay,            "", nullptr },
+        { "replaystop",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketLogReplayStop,        "", nullptr },
+        { "",               SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugPacketLog,                  "", nullptr },
+        { nullptr,          0,                  false, nullptr,                                             "", nullptr }
+    };
+
     static ChatCommand debugCommandTable[] =
     {
         { "anim",           SEC_GAMEMASTER,     false, &ChatHandler::HandleDebugAnimCommand,                "", nullptr },
@@ -267,8 +279,10 @@ ChatCommand* ChatHandler::getCommandTable()
         { "transports",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugTransports,                 "", nullptr },
         { "spawn",          SEC_GAMEMASTER,     true,  nullptr,                                             "", debugSpawnsCommandtable },
         { "debugflags",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugObjectFlags,                "", nullptr },
-        { "packetlog",      SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketLog,                  "", nullptr },
+        { "packetlog",      SEC_ADMINISTRATOR,  true,  nullptr,                                             "", debugPacketLogCommandTable },
         { "dbscript",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugDbscript,                   "", nullptr },
+        { "slabs",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugSlabs,                      "", nullptr },
+        { "tickprofile",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugTickProfile,                "", nullptr },
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
@@ -775,6 +789,7 @@ ChatCommand* ChatHandler::getCommandTable()
         { "idleshutdown",   SEC_ADMINISTRATOR,  true,  nullptr,                                        "", serverIdleShutdownCommandTable },
         { "info",           SEC_PLAYER,         true,  &ChatHandler::HandleServerInfoCommand,          "", nullptr },
         { "log",            SEC_CONSOLE,        true,  nullptr,                                        "", serverLogCommandTable },
+        { "metrics",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerMetricsCommand,       "", nullptr },
         { "motd",           SEC_PLAYER,         true,  &ChatHandler::HandleServerMotdCommand,          "", nullptr },
         { "plimit",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerPLimitCommand,        "", nullptr },
         { "resetallraid",   SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerResetAllRaidCommand,  "", nullptr },
@@ -313,7 +313,15 @@ class ChatHandler
         bool HandleDebugRespawnDynguid(char* args);
 
         bool HandleDebugPacketLog(char* args);
+        bool HandleDebugPacketLogStatus(char* args);
+        bool HandleDebugPacketLogAll(char* args);
+        bool HandleDebugPacketLogOpcode(char* args);
+        bool HandleDebugPacketLogConnections(char* args);
+        bool HandleDebugPacketLogReplay(char* args);
+        bool HandleDebugPacketLogReplayStop(char* args);
         bool HandleDebugDbscript(char* args);
+        bool HandleDebugSlabs(char* args);
+        bool HandleDebugTickProfile(char* args);
 
         bool HandleSD2HelpCommand(char* args);
         bool HandleSD2ScriptCommand(char* args);
@@ -600,6 +608,7 @@ class ChatHandler
         bool HandleReloadCreatureCooldownsCommand(char* args);
         bool HandleReloadCreatureSpellLists(char* args);
         bool HandleReloadSpawnGroupsCommand(char* args);
+        bool ReloadInBackground(std::function<void()> const& loader, std::string const& doneMessage);
 
         bool HandleResetAllCommand(char* args);
         bool HandleResetHonorCommand(char* args);
@@ -626,6 +635,7 @@ class ChatHandler
         bool HandleServerInfoCommand(char* args);
         bool HandleServerLogFilterCommand(char* args);
         bool HandleServerLogLevelCommand(char* args);
+        bool HandleServerMetricsCommand(char* args);
         bool HandleServerMotdCommand(char* args);
         bool HandleServerPLimitCommand(char* args);
         bool HandleServerResetAllRaidCommand(char* args);
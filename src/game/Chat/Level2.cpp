@@ -48,6 +48,7 @@
 #include "MotionGenerators/TargetedMovementGenerator.h"     // for HandleNpcUnFollowCommand
 #include "MotionGenerators/MoveMap.h"                       // for mmap manager
 #include "MotionGenerators/PathFinder.h"                    // for mmap commands
+#include "MotionGenerators/PathWorkerPool.h"
 #include "Movement/MoveSplineInit.h"
 #include "Anticheat/Anticheat.hpp"
 #include "Entities/Transports.h"
@@ -4026,6 +4027,9 @@ bool ChatHandler::HandleEventInfoCommand(char* args)
     PSendSysMessage(LANG_EVENT_INFO, event_id, eventData.description.c_str(), activeStr,
                     startTimeStr.c_str(), endTimeStr.c_str(), occurenceStr.c_str(), lengthStr.c_str(),
                     nextStr.c_str());
+
+    if (size_t queued = sMapMgr.GetDeferredMessageCount())
+        PSendSysMessage("Game event changes still queued on the maps: %u", uint32(queued));
     return true;
 }
 
@@ -5068,6 +5072,17 @@ bool ChatHandler::HandleMmapStatsCommand(char* /*args*/)
     PSendSysMessage(" %u triangles (%u vertices)", triCount, triVertCount);
     PSendSysMessage(" %.2f MB of data (not including pointers)", ((float)dataSize / sizeof(unsigned char)) / 1048576);
 
+    PathCorridorCache& corridorCache = m_session->GetPlayer()->GetMap()->GetPathCorridorCache();
+    PathCorridorStats const& lastTick = corridorCache.GetLastTickStats();
+    PathCorridorStats const& total = corridorCache.GetTotalStats();
+    PSendSysMessage("Pathfinding on current map:");
+    PSendSysMessage(" last tick: " UI64FMTD " searches (" UI64FMTD " polygon expansions), " UI64FMTD " shared corridors, " UI64FMTD " repaired corridors",
+                    lastTick.paths, lastTick.expansions, lastTick.sharedHits, lastTick.repairs);
+    PSendSysMessage(" total: " UI64FMTD " searches (" UI64FMTD " polygon expansions), " UI64FMTD " shared corridors, " UI64FMTD " repaired corridors",
+                    total.paths, total.expansions, total.sharedHits, total.repairs);
+    PSendSysMessage(" %u corridors kept for sharing", corridorCache.GetCorridorCount());
+    PSendSysMessage(" %u path worker threads, %u requests pending", sPathWorkerPool.GetThreadCount(), sPathWorkerPool.GetPendingCount());
+
     return true;
 }
 
@@ -56,6 +56,7 @@
 #include "World/WorldState.h"
 #ifdef BUILD_METRICS
 #include "Metric/Metric.h"
+#include "Metric/Registry.h"
 #endif
 #include "Server/PacketLog.h"
 
@@ -210,10 +211,11 @@ bool ChatHandler::HandleReloadAllAreaCommand(char* /*args*/)
 bool ChatHandler::HandleReloadAllLootCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables...");
-    LootIdSet ids_set;
-    LoadLootTables(ids_set);
-    SendGlobalSysMessage("DB tables `*_loot_template` reloaded.");
-    return true;
+    return ReloadInBackground([]()
+    {
+        LootIdSet ids_set;
+        LoadLootTables(ids_set);
+    }, "DB tables `*_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadAllNpcCommand(char* args)
@@ -321,6 +323,7 @@ bool ChatHandler::HandleReloadConfigCommand(char* /*args*/)
     sMapMgr.InitializeVisibilityDistanceInfo();
 #ifdef BUILD_METRICS
     metric::metric::instance().reload_config();
+    metric::registry::instance().reload_config();
 #endif
     PacketLog::instance()->Reinitialize();
     SendGlobalSysMessage("World config settings reloaded.");
@@ -376,6 +379,14 @@ bool ChatHandler::HandleReloadCreatureQuestInvRelationsCommand(char* /*args*/)
 
 bool ChatHandler::HandleReloadConditionsCommand(char* /*args*/)
 {
+    // the loot tables check their conditions while loading
+    if (sWorld.IsBackgroundReloadRunning())
+    {
+        SendSysMessage("Loot tables are reloading in the background, reload `conditions` when they are done.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
     sLog.outString("Re-Loading `conditions`... ");
     sObjectMgr.LoadConditions();
     SendGlobalSysMessage("DB table `conditions` reloaded.");
@@ -467,82 +478,112 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesCreatureCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`creature_loot_template`)");
-    LoadLootTemplates_Creature();
-    LootTemplates_Creature.CheckLootRefs();
-    SendGlobalSysMessage("DB table `creature_loot_template` reloaded.");
-    return true;
+    return ReloadInBackground([]()
+    {
+        LoadLootTemplates_Creature();
+        LootTemplates_Creature.CheckLootRefs();
+    }, "DB table `creature_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesDisenchantCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`disenchant_loot_template`)");
-    LoadLootTemplates_Disenchant();
-    LootTemplates_Disenchant.CheckLootRefs();
-    SendGlobalSysMessage("DB table `disenchant_loot_template` reloaded.");
-    return true;
+    return ReloadInBackground([]()
+    {
+        LoadLootTemplates_Disenchant();
+        LootTemplates_Disenchant.CheckLootRefs();
+    }, "DB table `disenchant_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesFishingCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`fishing_loot_template`)");
-    LoadLootTemplates_Fishing();
-    LootTemplates_Fishing.CheckLootRefs();
-    SendGlobalSysMessage("DB table `fishing_loot_template` reloaded.");
-    return true;
+    return ReloadInBackground([]()
+    {
+        LoadLootTemplates_Fishing();
+        LootTemplates_Fishing.CheckLootRefs();
+    }, "DB table `fishing_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesGameobjectCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`gameobject_loot_template`)");
-    LoadLootTemplates_Gameobject();
-    LootTemplates_Gameobject.CheckLootRefs();
-    SendGlobalSysMessage("DB table `gameobject_loot_template` reloaded.");
-    return true;
+    return ReloadInBackground([]()
+    {
+        LoadLootTemplates_Gameobject();
+        LootTemplates_Gameobject.CheckLootRefs();
+    }, "DB table `gameobject_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesItemCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`item_loot_template`)");
-    LoadLootTemplates_Item();
-    LootTemplates_Item.CheckLootRefs();
-    SendGlobalSysMessage("DB table `item_loot_template` reloaded.");
-    return true;
+    return ReloadInBackground([]()
+    {
+        LoadLootTemplates_Item();
+        LootTemplates_Item.CheckLootRefs();
+    }, "DB table `item_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesPickpocketingCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`pickpocketing_loot_template`)");
-    LoadLootTemplates_Pickpocketing();
-    LootTemplates_Pickpocketing.CheckLootRefs();
-    SendGlobalSysMessage("DB table `pickpocketing_loot_template` reloaded.");
-    return true;
+    return ReloadInBackground([]()
+    {
+        LoadLootTemplates_Pickpocketing();
+        LootTemplates_Pickpocketing.CheckLootRefs();
+    }, "DB table `pickpocketing_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesMailCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`mail_loot_template`)");
-    LoadLootTemplates_Mail();
-    LootTemplates_Mail.CheckLootRefs();
-    SendGlobalSysMessage("DB table `mail_loot_template` reloaded.");
-    return true;
+    return ReloadInBackground([]()
+    {
+        LoadLootTemplates_Mail();
+        LootTemplates_Mail.CheckLootRefs();
+    }, "DB table `mail_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesReferenceCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`reference_loot_template`)");
-    LootIdSet ids_set;
-    LoadLootTemplates_Reference(ids_set);
-    CheckLootTemplates_Reference(ids_set);
-    SendGlobalSysMessage("DB table `reference_loot_template` reloaded.");
-    return true;
+    return ReloadInBackground([]()
+    {
+        LootIdSet ids_set;
+        LoadLootTemplates_Reference(ids_set);
+        CheckLootTemplates_Reference(ids_set);
+    }, "DB table `reference_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesSkinningCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`skinning_loot_template`)");
-    LoadLootTemplates_Skinning();
-    LootTemplates_Skinning.CheckLootRefs();
-    SendGlobalSysMessage("DB table `skinning_loot_template` reloaded.");
+    return ReloadInBackground([]()
+    {
+        LoadLootTemplates_Skinning();
+        LootTemplates_Skinning.CheckLootRefs();
+    }, "DB table `skinning_loot_template` reloaded.");
+}
+
+// the world keeps using the live tables until the new ones are loaded and swapped in
+bool ChatHandler::ReloadInBackground(std::function<void()> const& loader, std::string const& doneMessage)
+{
+    bool started = sWorld.StartBackgroundReload(loader, [doneMessage]()
+    {
+        WorldPacket data;
+        ChatHandler::BuildChatPacket(data, CHAT_MSG_SYSTEM, doneMessage.c_str());
+        sWorld.SendGlobalMessage(data);
+    });
+
+    if (!started)
+    {
+        SendSysMessage("Another reload is still running in the background, try again when it is done.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    SendSysMessage("Reloading in the background, the change is announced when it is done.");
     return true;
 }
 
@@ -3218,6 +3259,13 @@ bool ChatHandler::HandleGetLosCommand(char* /*args*/)
     bool normalLos = player->IsWithinLOS(x, y, z, false);
     bool m2Los = player->IsWithinLOS(x, y, z, true);
     PSendSysMessage("Los check: Normal: %s M2: %s", normalLos ? "true" : "false", m2Los ? "true" : "false");
+
+    CollisionQueryStats const& lastTick = player->GetMap()->GetCollisionQueryCache().GetLastTickStats();
+    CollisionQueryStats const& total = player->GetMap()->GetCollisionQueryCache().GetTotalStats();
+    PSendSysMessage("Query cache last tick: los " UI64FMTD "/" UI64FMTD " height " UI64FMTD "/" UI64FMTD " (hits/queries)",
+                    lastTick.losHits, lastTick.losQueries, lastTick.heightHits, lastTick.heightQueries);
+    PSendSysMessage("Query cache total: los " UI64FMTD "/" UI64FMTD " height " UI64FMTD "/" UI64FMTD " (hits/queries)",
+                    total.losHits, total.losQueries, total.heightHits, total.heightQueries);
     return true;
 }
 
@@ -5862,6 +5910,46 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerMetricsCommand(char* args)
+{
+#ifdef BUILD_METRICS
+    std::string const filter = args ? args : "";
+
+    uint32 count = 0;
+    for (metric::snapshot const& item : metric::registry::instance().get_snapshots())
+    {
+        if (!filter.empty() && item.name.find(filter) == std::string::npos)
+            continue;
+
+        std::string name = item.name;
+        for (auto const& tag : item.tags)
+            name += " " + tag.first + "=" + tag.second;
+
+        switch (item.type)
+        {
+            case metric::metric_type::counter:
+                PSendSysMessage("%s: %lld (last interval %lld)", name.c_str(), (long long)item.total, (long long)item.interval);
+                break;
+            case metric::metric_type::gauge:
+                PSendSysMessage("%s: %lld", name.c_str(), (long long)item.value);
+                break;
+            case metric::metric_type::histogram:
+                PSendSysMessage("%s: %lld samples, last interval %lld p50 %llu p99 %llu max %llu us", name.c_str(), (long long)item.total,
+                                (long long)item.interval, (unsigned long long)item.p50, (unsigned long long)item.p99, (unsigned long long)item.max);
+                break;
+        }
+        ++count;
+    }
+
+    PSendSysMessage("%u metrics.", count);
+    return true;
+#else
+    (void)args;
+    SendSysMessage("The server was built without BUILD_METRICS.");
+    return true;
+#endif
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
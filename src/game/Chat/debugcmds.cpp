@@ -36,6 +36,10 @@
 #include "Maps/InstanceData.h"
 #include "Cinematics/M2Stores.h"
 #include "Entities/Transports.h"
+#include "Server/PacketLog.h"
+#include "Server/PacketReplay.h"
+#include "World/World.h"
+#include "World/TickProfiler.h"
 
 bool ChatHandler::HandleDebugSendSpellFailCommand(char* args)
 {
@@ -1847,6 +1851,151 @@ bool ChatHandler::HandleDebugPacketLog(char* args)
     return true;
 }
 
+bool ChatHandler::HandleDebugPacketLogStatus(char* /*args*/)
+{
+    PacketLog* packetLog = sPacketLog;
+    if (!packetLog->CanLogPacket())
+    {
+        SendSysMessage("Packet log is disabled, set PacketLogFile to capture packets.");
+        return true;
+    }
+
+    PacketLogStats stats = packetLog->GetStats();
+    PSendSysMessage("Packet log: %s, capturing %s sessions, %s opcodes", packetLog->GetFileName().c_str(),
+                    packetLog->IsLoggingAllSessions() ? "all" : "enabled",
+                    packetLog->GetOpcodeFilterCount() ? std::to_string(packetLog->GetOpcodeFilterCount()).c_str() : "all");
+    PSendSysMessage("Queued: " UI64FMTD " Written: " UI64FMTD " Dropped: " UI64FMTD " Overflowed: " UI64FMTD,
+                    stats.queued, stats.written, stats.dropped, stats.overflowed);
+    PSendSysMessage("Running replays: %u", sPacketReplay.GetActiveCount());
+    return true;
+}
+
+bool ChatHandler::HandleDebugPacketLogAll(char* args)
+{
+    bool value;
+    if (!ExtractOnOff(&args, value))
+    {
+        SendSysMessage(LANG_USE_BOL);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    sPacketLog->SetLoggingAllSessions(value);
+    PSendSysMessage("Packet log captures %s sessions.", value ? "all" : "enabled");
+    return true;
+}
+
+bool ChatHandler::HandleDebugPacketLogOpcode(char* args)
+{
+    if (ExtractLiteralArg(&args, "clear"))
+    {
+        sPacketLog->ClearOpcodeFilter();
+        SendSysMessage("Packet log captures all opcodes.");
+        return true;
+    }
+
+    char* opcodeArg = ExtractLiteralArg(&args);
+    if (!opcodeArg)
+        return false;
+
+    // numeric id or the opcode name
+    uint32 opcode = NUM_MSG_TYPES;
+    char* end;
+    uint32 id = strtoul(opcodeArg, &end, 0);
+    if (!*end)
+        opcode = id;
+    else
+    {
+        for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        {
+            if (!strcmp(LookupOpcodeName(i), opcodeArg))
+            {
+                opcode = i;
+                break;
+            }
+        }
+    }
+
+    bool value;
+    if (opcode >= NUM_MSG_TYPES || !ExtractOnOff(&args, value))
+        return false;
+
+    sPacketLog->SetOpcodeFilter(opcode, value);
+    PSendSysMessage("Packet log %s %s (0x%.4X), %u opcodes filtered.", value ? "captures" : "ignores",
+                    LookupOpcodeName(opcode), opcode, sPacketLog->GetOpcodeFilterCount());
+    return true;
+}
+
+bool ChatHandler::HandleDebugPacketLogConnections(char* args)
+{
+    char* fileArg = ExtractQuotedOrLiteralArg(&args);
+    std::string fileName = fileArg ? fileArg : sPacketLog->GetFileName();
+    if (fileName.empty())
+        return false;
+
+    std::map<uint32, PacketReplayConnection> connections;
+    std::string error;
+    if (!PacketReplay::ReadConnections(fileName, connections, error))
+    {
+        PSendSysMessage("Packet log: %s", error.c_str());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Connections of %s:", fileName.c_str());
+    for (auto const& connection : connections)
+        PSendSysMessage("%u - %u client packets, %u server packets, %u ms", connection.first, connection.second.clientPackets,
+                        connection.second.serverPackets, connection.second.lastTicks - connection.second.firstTicks);
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugPacketLogReplay(char* args)
+{
+    char* fileArg = ExtractQuotedOrLiteralArg(&args);
+    uint32 connectionId;
+    if (!fileArg || !ExtractUInt32(&args, connectionId))
+        return false;
+
+    char* nameArg = ExtractLiteralArg(&args);
+    uint32 step;
+    if (!nameArg || !ExtractOptUInt32(&args, step, sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE)))
+        return false;
+
+    std::string error;
+    if (!sPacketReplay.Start(fileArg, connectionId, nameArg, step, error))
+    {
+        PSendSysMessage("Packet replay: %s", error.c_str());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Packet replay of connection %u started as %s.", connectionId, nameArg);
+    return true;
+}
+
+bool ChatHandler::HandleDebugPacketLogReplayStop(char* args)
+{
+    char* nameArg = ExtractLiteralArg(&args);
+    if (!nameArg)
+    {
+        sPacketReplay.StopAll();
+        SendSysMessage("All packet replays stopped.");
+        return true;
+    }
+
+    std::string name = nameArg;
+    if (!normalizePlayerName(name) || !sPacketReplay.Stop(sObjectMgr.GetPlayerAccountIdByPlayerName(name)))
+    {
+        PSendSysMessage("No packet replay running as %s.", nameArg);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Packet replay as %s stopped.", name.c_str());
+    return true;
+}
+
 bool ChatHandler::HandleDebugDbscript(char* args)
 {
     Unit* target = getSelectedUnit();
@@ -1861,3 +2010,61 @@ bool ChatHandler::HandleDebugDbscript(char* args)
     player->GetMap()->ScriptsStart(sRelayScripts, chosenId, player, target);
     return true;
 }
+
+bool ChatHandler::HandleDebugSlabs(char* /*args*/)
+{
+#ifdef SLAB_ALLOCATOR
+    std::vector<SlabPoolStats> pools = SlabPool::GetAllStats();
+    if (pools.empty())
+        SendSysMessage("No object was allocated from a slab yet.");
+
+    for (SlabPoolStats const& pool : pools)
+        PSendSysMessage("%s: %u live, %u free, %u slabs, %u KB (%u bytes per slot)", pool.name, uint32(pool.live), uint32(pool.slots > pool.live ? pool.slots - pool.live : 0),
+                        uint32(pool.slabs), uint32(pool.slots * pool.slotSize / 1024), uint32(pool.slotSize));
+#else
+    SendSysMessage("Objects are allocated from the heap, build with SLAB_ALLOCATOR to use slabs.");
+#endif
+    return true;
+}
+
+// .debug tickprofile [#mapid|world|off [#threshold_ms [#frames]]]
+bool ChatHandler::HandleDebugTickProfile(char* args)
+{
+    if (!*args)
+    {
+        uint32 mapId, thresholdMs, frames;
+        if (!sTickProfiler.GetArmed(mapId, thresholdMs, frames))
+            SendSysMessage("No tick capture is armed.");
+        else if (mapId == TICK_PROFILER_WORLD)
+            PSendSysMessage("Capturing %u world ticks of at least %u ms.", frames, thresholdMs);
+        else
+            PSendSysMessage("Capturing %u ticks of map %u of at least %u ms.", frames, mapId, thresholdMs);
+
+        if (uint32 slowTick = sWorld.getConfig(CONFIG_UINT32_TICK_PROFILER_SLOW_TICK))
+            PSendSysMessage("Ticks of at least %u ms are captured on all maps (TickProfiler.SlowTick).", slowTick);
+        return true;
+    }
+
+    uint32 mapId;
+    if (ExtractLiteralArg(&args, "off"))
+    {
+        sTickProfiler.Disarm();
+        SendSysMessage("Tick capture disarmed.");
+        return true;
+    }
+    if (ExtractLiteralArg(&args, "world"))
+        mapId = TICK_PROFILER_WORLD;
+    else if (!ExtractUInt32(&args, mapId) || !sMapStore.LookupEntry(mapId))
+        return false;
+
+    uint32 thresholdMs, frames;
+    if (!ExtractOptUInt32(&args, thresholdMs, 0) || !ExtractOptUInt32(&args, frames, 1))
+        return false;
+
+    sTickProfiler.Arm(mapId, thresholdMs, frames);
+    if (mapId == TICK_PROFILER_WORLD)
+        PSendSysMessage("Capturing the next %u world ticks of at least %u ms, the traces are written to the logs directory.", std::max(frames, 1u), thresholdMs);
+    else
+        PSendSysMessage("Capturing the next %u ticks of map %u of at least %u ms, the traces are written to the logs directory.", std::max(frames, 1u), mapId, thresholdMs);
+    return true;
+}
@@ -22,6 +22,7 @@
 #include "Log.h"
 #include "Util/Errors.h"
 #include "Entities/Player.h"
+#include "World/TickTimings.h"
 
 Camera::Camera(Player* pl) : m_owner(*pl), m_source(pl)
 {
@@ -146,6 +147,7 @@ template void Camera::UpdateVisibilityOf(DynamicObject*, UpdateData&, WorldObjec
 
 void Camera::UpdateVisibilityForOwner(bool addToWorld)
 {
+    TickPhaseScope visibilityPhase(TICK_PHASE_VISIBILITY, "camera visibility");
     MaNGOS::VisibleNotifier notifier(*this);
     Cell::VisitAllObjects(m_source, notifier, addToWorld ? MAX_VISIBILITY_DISTANCE : m_source->GetVisibilityData().GetVisibilityDistance(), false);
     notifier.Notify();
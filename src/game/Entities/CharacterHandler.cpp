@@ -64,6 +64,7 @@ class LoginQueryHolder : public SqlQueryHolder
         ObjectGuid GetGuid() const { return m_guid; }
         uint32 GetAccountId() const { return m_accountId; }
         bool Initialize();
+        void Refresh();
 };
 
 bool LoginQueryHolder::Initialize()
@@ -105,6 +106,28 @@ bool LoginQueryHolder::Initialize()
     return res;
 }
 
+/// Queries of data that can change while the character is offline (mail, group/guild kicks, instance resets, GM commands...)
+/// The rest is only written by the character itself, so a holder prefetched at character select only needs these executed again
+static PlayerLoginQueryIndex const PlayerLoginVolatileQueries[] =
+{
+    PLAYER_LOGIN_QUERY_LOADFROM,
+    PLAYER_LOGIN_QUERY_LOADGROUP,
+    PLAYER_LOGIN_QUERY_LOADBOUNDINSTANCES,
+    PLAYER_LOGIN_QUERY_LOADWEEKLYQUESTSTATUS,
+    PLAYER_LOGIN_QUERY_LOADHONORCP,
+    PLAYER_LOGIN_QUERY_LOADSOCIALLIST,
+    PLAYER_LOGIN_QUERY_LOADGUILD,
+    PLAYER_LOGIN_QUERY_LOADACCOUNTDATA,
+    PLAYER_LOGIN_QUERY_LOADMAILS,
+    PLAYER_LOGIN_QUERY_LOADMAILEDITEMS,
+};
+
+void LoginQueryHolder::Refresh()
+{
+    for (PlayerLoginQueryIndex index : PlayerLoginVolatileQueries)
+        ResetResult(index);
+}
+
 // don't call WorldSession directly
 // it may get deleted before the query callbacks get executed
 // instead pass an account id to this handler
@@ -129,6 +152,18 @@ class CharacterHandler
             if (WorldSession* session = sWorld.FindSession(((LoginQueryHolder*)holder)->GetAccountId()))
                 session->HandlePlayerLogin((LoginQueryHolder*)holder);
         }
+
+        void HandlePlayerLoginPrefetchCallback(QueryResult* /*dummy*/, SqlQueryHolder* holder)
+        {
+            if (!holder) return;
+
+            LoginQueryHolder* lqh = (LoginQueryHolder*)holder;
+
+            // session gone or prefetch discarded meanwhile
+            WorldSession* session = sWorld.FindSession(lqh->GetAccountId());
+            if (!session || !session->HandlePlayerLoginPrefetched(lqh))
+                delete lqh;
+        }
 #ifdef BUILD_PLAYERBOT
         // This callback is different from the normal HandlePlayerLoginCallback in that it
         // sets up the bot's world session and also stores the pointer to the bot player in the master's
@@ -166,6 +201,10 @@ void WorldSession::HandleCharEnum(QueryResult* result)
 
     data << num;
 
+    // last played character, most likely to be logged in next
+    ObjectGuid lastPlayed;
+    uint64 lastLogout = 0;
+
     if (result)
     {
         do
@@ -173,7 +212,16 @@ void WorldSession::HandleCharEnum(QueryResult* result)
             uint32 guidlow = (*result)[0].GetUInt32();
             DETAIL_LOG("Build enum data for char guid %u from account %u.", guidlow, GetAccountId());
             if (Player::BuildEnumData(result, data))
+            {
                 ++num;
+
+                uint64 logoutTime = (*result)[20].GetUInt64();
+                if (lastPlayed.IsEmpty() || logoutTime > lastLogout)
+                {
+                    lastPlayed = ObjectGuid(HIGHGUID_PLAYER, guidlow);
+                    lastLogout = logoutTime;
+                }
+            }
         }
         while (result->NextRow());
 
@@ -183,6 +231,69 @@ void WorldSession::HandleCharEnum(QueryResult* result)
     data.put<uint8>(0, num);
 
     m_anticheat->SendCharEnum(std::move(data));
+
+    if (!lastPlayed.IsEmpty() && !_player && sWorld.getConfig(CONFIG_BOOL_PLAYER_LOGIN_PREFETCH))
+        PrefetchPlayerLogin(lastPlayed);
+}
+
+/// Start loading a character while the client is still at character select
+void WorldSession::PrefetchPlayerLogin(ObjectGuid guid)
+{
+    if (m_loginPrefetch && m_loginPrefetch->GetGuid() == guid)
+        return;
+
+    DiscardPlayerLoginPrefetch();
+
+    LoginQueryHolder* holder = new LoginQueryHolder(GetAccountId(), guid);
+    if (!holder->Initialize())
+    {
+        delete holder;
+        return;
+    }
+
+    m_loginPrefetch = holder;
+    m_loginPrefetchReady = false;
+    m_loginPrefetchWanted = false;
+
+    CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerLoginPrefetchCallback, (SqlQueryHolder*)holder);
+}
+
+/// Returns false if the holder is not the prefetch of this session anymore, the caller deletes it then
+bool WorldSession::HandlePlayerLoginPrefetched(LoginQueryHolder* holder)
+{
+    if (m_loginPrefetch != holder)
+        return false;
+
+    m_loginPrefetchReady = true;
+
+    // client already asked for this character, continue the login
+    if (m_loginPrefetchWanted)
+        LoginFromPrefetch();
+
+    return true;
+}
+
+void WorldSession::LoginFromPrefetch()
+{
+    LoginQueryHolder* holder = m_loginPrefetch;
+    m_loginPrefetch = nullptr;
+    m_loginPrefetchReady = false;
+    m_loginPrefetchWanted = false;
+
+    // only the queries of data that could have changed since the prefetch are executed again
+    holder->Refresh();
+    CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, (SqlQueryHolder*)holder);
+}
+
+void WorldSession::DiscardPlayerLoginPrefetch()
+{
+    // a holder still executing is deleted by its callback
+    if (m_loginPrefetch && m_loginPrefetchReady)
+        delete m_loginPrefetch;
+
+    m_loginPrefetch = nullptr;
+    m_loginPrefetchReady = false;
+    m_loginPrefetchWanted = false;
 }
 
 void WorldSession::HandleCharEnumOpcode(WorldPacket& /*recv_data*/)
@@ -194,7 +305,9 @@ void WorldSession::HandleCharEnumOpcode(WorldPacket& /*recv_data*/)
                                   //   8                9               10                     11                     12                     13                    14
                                   "characters.zone, characters.map, characters.position_x, characters.position_y, characters.position_z, guild_member.guildid, characters.playerFlags, "
                                   //  15                    16                   17                     18                   19
-                                  "characters.at_login, character_pet.entry, character_pet.modelid, character_pet.level, characters.equipmentCache "
+                                  "characters.at_login, character_pet.entry, character_pet.modelid, character_pet.level, characters.equipmentCache, "
+                                  //  20
+                                  "characters.logout_time "
                                   "FROM characters LEFT JOIN character_pet ON characters.guid=character_pet.owner AND character_pet.slot='%u' "
                                   "LEFT JOIN guild_member ON characters.guid = guild_member.guid "
                                   "WHERE characters.account = '%u' ORDER BY characters.guid",
@@ -507,6 +620,18 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket& recv_data)
 
     DEBUG_LOG("WORLD: Received opcode Player Logon Message");
 
+    // character select prefetch of this character, ready or still executing
+    if (m_loginPrefetch && m_loginPrefetch->GetGuid() == playerGuid)
+    {
+        if (m_loginPrefetchReady)
+            LoginFromPrefetch();
+        else
+            m_loginPrefetchWanted = true;
+        return;
+    }
+
+    DiscardPlayerLoginPrefetch();
+
     LoginQueryHolder* holder = new LoginQueryHolder(GetAccountId(), playerGuid);
     if (!holder->Initialize())
     {
@@ -1953,9 +1953,9 @@ SpellEntry const* Creature::ReachWithSpellAttack(Unit* pVictim)
 
         if (spellInfo->manaCost > GetPower(POWER_MANA))
             continue;
-        SpellRangeEntry const* srange = sSpellRangeStore.LookupEntry(spellInfo->rangeIndex);
-        float range = GetSpellMaxRange(srange);
-        float minrange = GetSpellMinRange(srange);
+        SpellRangeProjection srange = sSpellRangeProjection.Get(spellInfo->rangeIndex);
+        float range = srange.maxRange;
+        float minrange = srange.minRange;
 
         float dist = GetDistance(pVictim, true, spellInfo->rangeIndex == SPELL_RANGE_IDX_COMBAT ? DIST_CALC_COMBAT_REACH_WITH_MELEE : DIST_CALC_COMBAT_REACH);
 
@@ -2003,9 +2003,9 @@ SpellEntry const* Creature::ReachWithSpellCure(Unit* pVictim)
 
         if (spellInfo->manaCost > GetPower(POWER_MANA))
             continue;
-        SpellRangeEntry const* srange = sSpellRangeStore.LookupEntry(spellInfo->rangeIndex);
-        float range = GetSpellMaxRange(srange);
-        float minrange = GetSpellMinRange(srange);
+        SpellRangeProjection srange = sSpellRangeProjection.Get(spellInfo->rangeIndex);
+        float range = srange.maxRange;
+        float minrange = srange.minRange;
 
         float dist = GetDistance(pVictim, true, spellInfo->rangeIndex == SPELL_RANGE_IDX_COMBAT ? DIST_CALC_COMBAT_REACH_WITH_MELEE : DIST_CALC_COMBAT_REACH);
 
@@ -2615,10 +2615,13 @@ struct AddCreatureToRemoveListInMapsWorker
     uint32 i_guid;
 };
 
-void Creature::AddToRemoveListInMaps(uint32 db_guid, CreatureData const* data)
+void Creature::AddToRemoveListInMaps(uint32 db_guid, CreatureData const* data, bool deferred /*= false*/)
 {
     AddCreatureToRemoveListInMapsWorker worker(db_guid);
-    sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
+    if (deferred)
+        sMapMgr.DeferForAllMapsWithMapId(data->mapid, worker);
+    else
+        sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
 }
 
 struct SpawnCreatureInMapsWorker
@@ -2628,8 +2631,8 @@ struct SpawnCreatureInMapsWorker
 
     void operator()(Map* map)
     {
-        // We use spawn coords to spawn
-        if (map->IsLoaded(i_data->posX, i_data->posY))
+        // We use spawn coords to spawn, a deferred spawn can find it already loaded with its grid
+        if (map->IsLoaded(i_data->posX, i_data->posY) && !map->GetCreature(i_guid))
         {
             Creature* pCreature = new Creature;
             // DEBUG_LOG("Spawning creature %u",*itr);
@@ -2644,10 +2647,13 @@ struct SpawnCreatureInMapsWorker
     CreatureData const* i_data;
 };
 
-void Creature::SpawnInMaps(uint32 db_guid, CreatureData const* data)
+void Creature::SpawnInMaps(uint32 db_guid, CreatureData const* data, bool deferred /*= false*/)
 {
     SpawnCreatureInMapsWorker worker(db_guid, data);
-    sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
+    if (deferred)
+        sMapMgr.DeferForAllMapsWithMapId(data->mapid, worker);
+    else
+        sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
 }
 
 bool Creature::HasStaticDBSpawnData() const
@@ -554,6 +554,8 @@ enum TemporaryFactionFlags                                  // Used at real fact
 
 class Creature : public Unit
 {
+        SLAB_ALLOCATED(Creature)
+
     public:
 
         explicit Creature(CreatureSubtype subtype = CREATURE_SUBTYPE_GENERIC);
@@ -760,8 +762,9 @@ class Creature : public Unit
         void SetRespawnRadius(float dist) { m_respawnradius = dist; }
 
         // Functions spawn/remove creature with DB guid in all loaded map copies (if point grid loaded in map)
-        static void AddToRemoveListInMaps(uint32 db_guid, CreatureData const* data);
-        static void SpawnInMaps(uint32 db_guid, CreatureData const* data);
+        // deferred: queued to the maps and applied over the next ticks, see MapManager::DeferForAllMapsWithMapId
+        static void AddToRemoveListInMaps(uint32 db_guid, CreatureData const* data, bool deferred = false);
+        static void SpawnInMaps(uint32 db_guid, CreatureData const* data, bool deferred = false);
 
         void SendZoneUnderAttackMessage(Player* attacker) const;
 
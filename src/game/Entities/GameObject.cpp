@@ -2038,6 +2038,7 @@ void GameObject::UpdateCollisionState() const
         return;
 
     m_model->enable(IsCollisionEnabled() ? true : false);
+    GetMap()->InvalidateCollisionQueries(*m_model);
 }
 
 void GameObject::UpdateModel()
@@ -2181,10 +2182,13 @@ struct AddGameObjectToRemoveListInMapsWorker
     ObjectGuid i_guid;
 };
 
-void GameObject::AddToRemoveListInMaps(uint32 db_guid, GameObjectData const* data)
+void GameObject::AddToRemoveListInMaps(uint32 db_guid, GameObjectData const* data, bool deferred /*= false*/)
 {
     AddGameObjectToRemoveListInMapsWorker worker(ObjectGuid(HIGHGUID_GAMEOBJECT, data->id, db_guid));
-    sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
+    if (deferred)
+        sMapMgr.DeferForAllMapsWithMapId(data->mapid, worker);
+    else
+        sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
 }
 
 struct SpawnGameObjectInMapsWorker
@@ -2194,8 +2198,8 @@ struct SpawnGameObjectInMapsWorker
 
     void operator()(Map* map)
     {
-        // Spawn if necessary (loaded grids only)
-        if (map->IsLoaded(i_data->posX, i_data->posY))
+        // Spawn if necessary (loaded grids only), a deferred spawn can find it already loaded with its grid
+        if (map->IsLoaded(i_data->posX, i_data->posY) && !map->GetGameObject(i_guid))
         {
             GameObjectData const* data = sObjectMgr.GetGOData(i_guid);
             MANGOS_ASSERT(data);
@@ -2212,10 +2216,13 @@ struct SpawnGameObjectInMapsWorker
     GameObjectData const* i_data;
 };
 
-void GameObject::SpawnInMaps(uint32 db_guid, GameObjectData const* data)
+void GameObject::SpawnInMaps(uint32 db_guid, GameObjectData const* data, bool deferred /*= false*/)
 {
     SpawnGameObjectInMapsWorker worker(db_guid, data);
-    sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
+    if (deferred)
+        sMapMgr.DeferForAllMapsWithMapId(data->mapid, worker);
+    else
+        sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
 }
 
 bool GameObject::HasStaticDBSpawnData() const
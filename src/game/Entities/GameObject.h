@@ -684,6 +684,8 @@ struct QuaternionData
 
 class GameObject : public WorldObject
 {
+        SLAB_ALLOCATED(GameObject)
+
     public:
         explicit GameObject();
         ~GameObject();
@@ -762,8 +764,9 @@ class GameObject : public WorldObject
         void Delete();
 
         // Functions spawn/remove gameobject with DB guid in all loaded map copies (if point grid loaded in map)
-        static void AddToRemoveListInMaps(uint32 db_guid, GameObjectData const* data);
-        static void SpawnInMaps(uint32 db_guid, GameObjectData const* data);
+        // deferred: queued to the maps and applied over the next ticks, see MapManager::DeferForAllMapsWithMapId
+        static void AddToRemoveListInMaps(uint32 db_guid, GameObjectData const* data, bool deferred = false);
+        static void SpawnInMaps(uint32 db_guid, GameObjectData const* data, bool deferred = false);
 
         GameobjectTypes GetGoType() const { return GameobjectTypes(GetUInt32Value(GAMEOBJECT_TYPE_ID)); }
         void SetGoType(GameobjectTypes type) { SetUInt32Value(GAMEOBJECT_TYPE_ID, type); }
@@ -228,6 +228,8 @@ bool ItemCanGoIntoBag(ItemPrototype const* pProto, ItemPrototype const* pBagProt
 
 class Item : public Object
 {
+        SLAB_ALLOCATED(Item)
+
     public:
         static Item* CreateItem(uint32 item, uint32 count, Player const* player = nullptr, uint32 randomPropertyId = 0);
         Item* CloneItem(uint32 count, Player const* player = nullptr) const;
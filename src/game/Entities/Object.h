@@ -33,6 +33,7 @@
 #include "Entities/ObjectVisibility.h"
 #include "Grids/Cell.h"
 #include "Utilities/EventProcessor.h"
+#include "Utilities/SlabAllocator.h"
 
 #include <set>
 
@@ -152,6 +152,8 @@ class Player;
 
 class Pet : public Creature
 {
+        SLAB_ALLOCATED(Pet)
+
     public:
         explicit Pet(PetType type = MAX_PET_TYPE);
         virtual ~Pet();
@@ -24,6 +24,8 @@
 
 class TemporarySpawn : public Creature
 {
+        SLAB_ALLOCATED(TemporarySpawn)
+
     public:
         explicit TemporarySpawn(ObjectGuid summoner = ObjectGuid());
         virtual ~TemporarySpawn() {};
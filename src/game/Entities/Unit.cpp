@@ -50,9 +50,10 @@
 #include "Tools/Formulas.h"
 #include "Entities/Transports.h"
 #include "Anticheat/Anticheat.hpp"
+#include "World/TickProfiler.h"
 
 #ifdef BUILD_METRICS
- #include "Metric/Metric.h"
+ #include "Metric/Registry.h"
 #endif
 
 #include <math.h>
@@ -353,6 +354,8 @@ Unit::Unit() :
     // m_AurasCheck = 2000;
     // m_removeAuraTimer = 4;
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
+    m_procAuraHoldersFlags = 0;
+    m_procAuraHoldersGeneration = sSpellMgr.GetSpellProcEventGeneration();
     m_AuraFlags = 0;
 
     m_Visibility = VISIBILITY_ON;
@@ -458,13 +461,8 @@ void Unit::Update(const uint32 diff)
     if (!IsInWorld())
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    static metric::histogram_set s_updateTime("unit.update", "unit_type", { "creature", "player" });
+    metric::scoped_timer meas(s_updateTime[IsPlayer()]);
 #endif
 
     /*if(p_time > m_AurasCheck)
@@ -509,15 +507,11 @@ void Unit::Update(const uint32 diff)
     if (AI() && IsAlive())
     {
 #ifdef BUILD_METRICS
-        metric::duration<std::chrono::microseconds> meas_ai("unit.update.ai", {
-            { "entry", std::to_string(GetEntry()) },
-            { "guid", std::to_string(GetGUIDLow()) },
-            { "unit_type", std::to_string(GetGUIDHigh()) },
-            { "map_id", std::to_string(GetMapId()) },
-            { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
+        static metric::histogram_set s_aiUpdateTime("unit.update.ai", "unit_type", { "creature", "player" });
+        metric::scoped_timer meas_ai(s_aiUpdateTime[IsPlayer()]);
 #endif
 
+        TICK_PROFILE_ZONE("ai");
         AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map)
     }
 
@@ -695,6 +689,8 @@ void Unit::SendHeartBeat()
     WorldPacket data(MSG_MOVE_HEARTBEAT, 31);
     data << GetPackGUID();
     data << m_movementInfo;
+    if (IsInWorld())
+        GetMap()->DropRelayedMovement(this);
     SendMessageToSet(data, true);
 }
 
@@ -2385,6 +2381,7 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* caster, SpellSchoolMask schoolMa
             if (dropCharge)
                 if ((*i)->GetHolder()->DropAuraCharge())
                     mod->m_amount = 0;
+            InvalidateAuraModifierTotals(mod->m_auraname);
             // Need remove it later
             if (mod->m_amount <= 0)
                 existExpired = true;
@@ -2444,6 +2441,7 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* caster, SpellSchoolMask schoolMa
         (*i)->OnManaAbsorb(currentAbsorb);
 
         (*i)->GetModifier()->m_amount -= currentAbsorb;
+        InvalidateAuraModifierTotals((*i)->GetModifier()->m_auraname);
         if ((*i)->GetModifier()->m_amount <= 0)
         {
             RemoveAurasDueToSpell((*i)->GetId());
@@ -4004,15 +4002,8 @@ uint32 Unit::GetWeaponSkillValue(WeaponAttackType attType, Unit const* target) c
 void Unit::_UpdateSpells(uint32 time)
 {
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update.spells", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
-
-    std::vector<uint32> updatedSpellIds;
+    static metric::histogram_set s_spellsUpdateTime("unit.update.spells", "unit_type", { "creature", "player" });
+    metric::scoped_timer meas(s_spellsUpdateTime[IsPlayer()]);
 #endif
 
     if (m_currentSpells[CURRENT_AUTOREPEAT_SPELL])
@@ -4030,14 +4021,12 @@ void Unit::_UpdateSpells(uint32 time)
 
     // update auras
     // m_AurasUpdateIterator can be updated in inderect called code at aura remove to skip next planned to update but removed auras
+    TICK_PROFILE_ZONE("auras");
     for (m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.begin(); m_spellAuraHoldersUpdateIterator != m_spellAuraHolders.end();)
     {
         SpellAuraHolder* i_holder = m_spellAuraHoldersUpdateIterator->second;
         ++m_spellAuraHoldersUpdateIterator;                 // need shift to next for allow update if need into aura update
         i_holder->UpdateHolder(time);
-#ifdef BUILD_METRICS
-        updatedSpellIds.push_back(i_holder->GetId());
-#endif
     }
 
     // remove expired auras
@@ -4053,12 +4042,6 @@ void Unit::_UpdateSpells(uint32 time)
         else
             ++iter;
     }
-#ifdef BUILD_METRICS
-    std::string logging;
-    for (uint32 spellId : updatedSpellIds)
-        logging += std::to_string(spellId) + ",";
-    meas.add_field("spells", "\"" + logging + "\"");
-#endif
 }
 
 void Unit::_UpdateAutoRepeatSpell()
@@ -4410,25 +4393,56 @@ void Unit::DeMorph()
     SetDisplayId(GetNativeDisplayId());
 }
 
+// below this amount of auras summing the list is as fast as the cache lookup
+#define AURA_MODIFIER_TOTALS_MIN_AURAS 3
+
 int32 Unit::GetTotalAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
     AuraList const& mTotalAuraList = GetAurasByType(auratype);
+    if (mTotalAuraList.empty())
+        return 0;
+
+    if (m_auraModifierTotals && m_auraModifierTotals->hasTotal[auratype])
+        return m_auraModifierTotals->total[auratype];
+
+    int32 modifier = 0;
     for (auto i : mTotalAuraList)
         modifier += i->GetModifier()->m_amount;
 
+    if (mTotalAuraList.size() >= AURA_MODIFIER_TOTALS_MIN_AURAS)
+    {
+        if (!m_auraModifierTotals)
+            m_auraModifierTotals.reset(new AuraModifierTotals());
+
+        m_auraModifierTotals->total[auratype] = modifier;
+        m_auraModifierTotals->hasTotal.set(auratype);
+    }
+
     return modifier;
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
-    float multiplier = 1.0f;
-
     AuraList const& mTotalAuraList = GetAurasByType(auratype);
+    if (mTotalAuraList.empty())
+        return 1.0f;
+
+    if (m_auraModifierTotals && m_auraModifierTotals->hasMultiplier[auratype])
+        return m_auraModifierTotals->multiplier[auratype];
+
+    float multiplier = 1.0f;
     for (auto i : mTotalAuraList)
         multiplier *= (100.0f + i->GetModifier()->m_amount) / 100.0f;
 
+    if (mTotalAuraList.size() >= AURA_MODIFIER_TOTALS_MIN_AURAS)
+    {
+        if (!m_auraModifierTotals)
+            m_auraModifierTotals.reset(new AuraModifierTotals());
+
+        m_auraModifierTotals->multiplier[auratype] = multiplier;
+        m_auraModifierTotals->hasMultiplier.set(auratype);
+    }
+
     return multiplier;
 }
 
@@ -4746,6 +4760,7 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     holder->_AddSpellAuraHolder();
     holder->SetCreationDelayFlag();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    AddProcAuraHolder(holder);
 
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
@@ -4770,7 +4785,10 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
 void Unit::AddAuraToModList(Aura* aura)
 {
     if (aura->GetModifier()->m_auraname < TOTAL_AURAS)
+    {
         m_modAuras[aura->GetModifier()->m_auraname].push_back(aura);
+        InvalidateAuraModifierTotals(aura->GetModifier()->m_auraname);
+    }
 }
 
 void Unit::RemoveRankAurasDueToSpell(uint32 spellId)
@@ -5241,6 +5259,7 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
         if (itr->second == holder)
         {
             m_spellAuraHolders.erase(itr);
+            RemoveProcAuraHolder(holder);
             break;
         }
     }
@@ -5304,6 +5323,7 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        InvalidateAuraModifierTotals(Aur->GetModifier()->m_auraname);
     }
 
     // Set remove mode
@@ -9312,6 +9332,8 @@ void Unit::ApplyAuraProcTriggerDamage(Aura* aura, bool apply)
         tAuraProcTriggerDamage.push_back(aura);
     else
         tAuraProcTriggerDamage.remove(aura);
+
+    InvalidateAuraModifierTotals(SPELL_AURA_PROC_TRIGGER_DAMAGE);
 }
 
 uint32 Unit::GetCreatePowers(Powers power) const
@@ -10593,6 +10615,8 @@ void Unit::SendTeleportPacket(float x, float y, float z, float ori, GenericTrans
     WorldPacket moveUpdateTeleport(MSG_MOVE_TELEPORT, 38);
     moveUpdateTeleport << GetPackGUID();
     teleportMovementInfo.Write(moveUpdateTeleport);
+    if (IsInWorld())
+        GetMap()->DropRelayedMovement(this);
     SendMessageToSetExcept(moveUpdateTeleport, player);
 }
 
@@ -10834,10 +10858,10 @@ SpellAuraHolder* Unit::GetSpellAuraHolder(uint32 spellid, ObjectGuid casterGuid)
     return nullptr;
 }
 
-class UnitVisitObjectsInRangeNotifyEvent : public BasicEvent
+class UnitVisitObjectsInRangeNotifyEvent : public PooledEvent<UnitVisitObjectsInRangeNotifyEvent>
 {
     public:
-        UnitVisitObjectsInRangeNotifyEvent(Unit& owner) : BasicEvent(), m_owner(owner) {}
+        UnitVisitObjectsInRangeNotifyEvent(Unit& owner) : m_owner(owner) {}
 
         bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
         {
@@ -10921,13 +10945,8 @@ void Unit::UpdateSplineMovement(uint32 t_diff)
     if (movespline->Finalized())
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.updatesplinemovement", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    static metric::histogram_set s_splineUpdateTime("unit.updatesplinemovement", "unit_type", { "creature", "player" });
+    metric::scoped_timer meas(s_splineUpdateTime[IsPlayer()]);
 #endif
     movespline->updateState(t_diff);
     bool arrived = movespline->Finalized();
@@ -11720,11 +11739,13 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
         if (!killDelayed)
             continue;
         // 2/ Interrupt spells that are not referenced but that still have an event (like delayed spell)
-        for (auto i_events = target->m_events.GetEvents().begin(); i_events != target->m_events.GetEvents().end(); ++i_events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_events->second))
-                if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
+        target->m_events.VisitEvents([this](BasicEvent* basicEvent)
+        {
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(basicEvent))
+                if (event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
                     if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                         event->GetSpell()->cancel();
+        });
     }
 }
 
@@ -12057,16 +12078,15 @@ bool Unit::MeetsSelectAttackingRequirement(Unit* target, SpellEntry const* spell
             SpellEntry const* resultingEntry = spellInfo;
             if (selectFlags & SELECT_FLAG_USE_EFFECT_RADIUS_OF_TRIGGERED_SPELL)
                 resultingEntry = sSpellTemplate.LookupEntry<SpellEntry>(spellInfo->EffectTriggerSpell[0]);
-            SpellRadiusEntry const* srange = sSpellRadiusStore.LookupEntry(resultingEntry->EffectRadiusIndex[0]);
-            float max_range = GetSpellRadius(srange);
+            float max_range = GetSpellRadiusByIndex(resultingEntry->EffectRadiusIndex[0]);
             float dist = target->GetDistance(GetPositionX(), GetPositionY(), GetPositionZ(), DIST_CALC_COMBAT_REACH);
             return dist < max_range;
         }
         else
         {
-            SpellRangeEntry const* srange = sSpellRangeStore.LookupEntry(spellInfo->rangeIndex);
-            float max_range = GetSpellMaxRange(srange);
-            float min_range = GetSpellMinRange(srange);
+            SpellRangeProjection srange = sSpellRangeProjection.Get(spellInfo->rangeIndex);
+            float max_range = srange.maxRange;
+            float min_range = srange.minRange;
             float dist = GetDistance(target, true, DIST_CALC_COMBAT_REACH);
             return dist < max_range&& dist >= min_range;
         }
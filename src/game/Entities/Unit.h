@@ -50,6 +50,8 @@
 
 #include <list>
 #include <array>
+#include <bitset>
+#include <memory>
 
 enum SpellPartialResist
 {
@@ -1065,6 +1067,15 @@ struct SelectAttackingTargetParams
 
 struct SpellProcEventEntry;                                 // used only privately
 
+/// Sums of the modifier amounts of the auras of one type, computed on first use and dropped when the auras of the type change
+struct AuraModifierTotals
+{
+    std::bitset<TOTAL_AURAS> hasTotal;
+    std::bitset<TOTAL_AURAS> hasMultiplier;
+    int32 total[TOTAL_AURAS];
+    float multiplier[TOTAL_AURAS];
+};
+
 class Unit : public WorldObject
 {
     public:
@@ -1073,6 +1084,13 @@ class Unit : public WorldObject
         typedef std::pair<SpellAuraHolderMap::iterator, SpellAuraHolderMap::iterator> SpellAuraHolderBounds;
         typedef std::pair<SpellAuraHolderMap::const_iterator, SpellAuraHolderMap::const_iterator> SpellAuraHolderConstBounds;
         typedef std::list<SpellAuraHolder*> SpellAuraHolderList;
+        /// holder able to proc together with the proc flags it reacts to
+        struct ProcAuraHolder
+        {
+            SpellAuraHolder* holder;
+            uint32 procFlags;
+        };
+        typedef std::vector<ProcAuraHolder> ProcAuraHolderList;
         typedef std::list<Aura*> AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<uint32 /*playerGuidLow*/> ComboPointHolderSet;
@@ -1840,6 +1858,15 @@ class Unit : public WorldObject
 
         bool AddSpellAuraHolder(SpellAuraHolder* holder);
         void AddAuraToModList(Aura* aura);
+        // must be called when the modifier amount of an applied aura of this type changes
+        void InvalidateAuraModifierTotals(AuraType type)
+        {
+            if (m_auraModifierTotals && type < TOTAL_AURAS)
+            {
+                m_auraModifierTotals->hasTotal.reset(type);
+                m_auraModifierTotals->hasMultiplier.reset(type);
+            }
+        }
 
         // removing specific aura stack
         void RemoveAura(Aura* Aur, AuraRemoveMode mode = AURA_REMOVE_BY_DEFAULT);
@@ -2109,6 +2136,9 @@ class Unit : public WorldObject
         };
 
         SpellProcEventTriggerCheck IsTriggeredAtSpellProcEvent(ProcExecutionData& data, SpellAuraHolder* holder, SpellProcEventEntry const*& spellProcEvent);
+        void AddProcAuraHolder(SpellAuraHolder* holder);
+        void RemoveProcAuraHolder(SpellAuraHolder* holder);
+        void RebuildProcAuraHolders();                      // proc flags of spell_proc_event changed by a reload
         // only to be used in proc handlers - basepoints is expected to be a MAX_EFFECT_INDEX sized array
         SpellAuraProcResult TriggerProccedSpell(Unit* target, std::array<int32, MAX_EFFECT_INDEX>& basepoints, uint32 triggeredSpellId, Item* castItem, Aura* triggeredByAura, uint32 cooldown, ObjectGuid originalCaster);
         SpellAuraProcResult TriggerProccedSpell(Unit* target, std::array<int32, MAX_EFFECT_INDEX>& basepoints, SpellEntry const* spellInfo, Item* castItem, Aura* triggeredByAura, uint32 cooldown, ObjectGuid originalCaster);
@@ -2401,6 +2431,9 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
+        ProcAuraHolderList m_procAuraHolders;               // holders of m_spellAuraHolders with proc flags, in the same order
+        uint32 m_procAuraHoldersFlags;                      // all proc flags of m_procAuraHolders
+        uint32 m_procAuraHoldersGeneration;                 // spell_proc_event load the proc flags were taken from
         AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
         std::map<uint32, Aura*> m_classScripts;
@@ -2420,6 +2453,7 @@ class Unit : public WorldObject
         std::map<uint32, Creature*> m_creatures;
 
         AuraList m_modAuras[TOTAL_AURAS];
+        mutable std::unique_ptr<AuraModifierTotals> m_auraModifierTotals; // allocated at first query of a type with enough auras
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
 
         WeaponDamageInfo m_weaponDamageInfo;
@@ -2691,7 +2725,7 @@ struct LowestHPNearestOrder
     }
 };
 
-class UnitLambdaEvent : public BasicEvent
+class UnitLambdaEvent : public PooledEvent<UnitLambdaEvent>
 {
     public:
     UnitLambdaEvent(Unit& owner, std::function<void(Unit&)> const& func) : m_owner(owner), m_func(func) {}
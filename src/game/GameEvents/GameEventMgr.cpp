@@ -712,6 +712,8 @@ void GameEventMgr::UnApplyEvent(uint16 event_id)
     SendEventMails(event_nid);
 
     OnEventHappened(event_id, false, false);
+
+    DETAIL_LOG("GameEvent %u: " SIZEFMTD " changes queued on the maps", event_id, sMapMgr.GetDeferredMessageCount());
 }
 
 void GameEventMgr::ApplyNewEvent(uint16 event_id, bool resume)
@@ -745,6 +747,8 @@ void GameEventMgr::ApplyNewEvent(uint16 event_id, bool resume)
         SendEventMails(event_id);
 
     OnEventHappened(event_id, true, resume);
+
+    DETAIL_LOG("GameEvent %u: " SIZEFMTD " changes queued on the maps", event_id, sMapMgr.GetDeferredMessageCount());
 }
 
 void GameEventMgr::GameEventSpawn(int16 event_id)
@@ -777,7 +781,7 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
 
             sObjectMgr.AddCreatureToGrid(itr, data);
 
-            Creature::SpawnInMaps(itr, data);
+            Creature::SpawnInMaps(itr, data, true);
         }
     }
 
@@ -807,7 +811,7 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
 
             sObjectMgr.AddGameobjectToGrid(itr, data);
 
-            GameObject::SpawnInMaps(itr, data);
+            GameObject::SpawnInMaps(itr, data, true);
         }
     }
 
@@ -854,7 +858,7 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
             sObjectMgr.RemoveCreatureFromGrid(itr, data);
 
             // Remove spawned cases
-            Creature::AddToRemoveListInMaps(itr, data);
+            Creature::AddToRemoveListInMaps(itr, data, true);
         }
     }
 
@@ -884,7 +888,7 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
             sObjectMgr.RemoveGameobjectFromGrid(itr, data);
 
             // Remove spawned cases
-            GameObject::AddToRemoveListInMaps(itr, data);
+            GameObject::AddToRemoveListInMaps(itr, data, true);
         }
     }
 
@@ -961,7 +965,7 @@ void GameEventMgr::UpdateCreatureData(int16 event_id, bool activate)
 
         // Update if spawned
         GameEventUpdateCreatureDataInMapsWorker worker(data->GetObjectGuid(itr.first), data, &itr.second, activate);
-        sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
+        sMapMgr.DeferForAllMapsWithMapId(data->mapid, worker);
     }
 }
 
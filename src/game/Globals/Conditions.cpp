@@ -996,8 +996,277 @@ bool ConditionEntry::CanBeUsedWithoutPlayer(uint32 entry)
 
 bool IsConditionSatisfied(uint32 conditionId, WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType)
 {
-    if (ConditionEntry const* condition = sConditionStorage.LookupEntry<ConditionEntry>(conditionId))
-        return condition->Meets(target, map, source, conditionSourceType);
+    return sConditionPrograms.IsSatisfied(conditionId, target, map, source, conditionSourceType);
+}
+// relative cost of evaluating a condition, cheap ones are moved to the front of AND/OR groups
+static uint32 GetConditionCost(ConditionType condition)
+{
+    switch (condition)
+    {
+        case CONDITION_TEAM:
+        case CONDITION_RACE_CLASS:
+        case CONDITION_LEVEL:
+        case CONDITION_GENDER:
+        case CONDITION_PVP_RANK:
+        case CONDITION_ACTIVE_GAME_EVENT:
+        case CONDITION_LAST_WAYPOINT:
+            return 1;                                       // a field or set lookup
+        case CONDITION_AURA:
+        case CONDITION_ITEM_EQUIPPED:
+        case CONDITION_REPUTATION_RANK_MIN:
+        case CONDITION_REPUTATION_RANK_MAX:
+        case CONDITION_SKILL:
+        case CONDITION_SKILL_BELOW:
+        case CONDITION_SPELL:
+        case CONDITION_QUESTREWARDED:
+        case CONDITION_QUESTTAKEN:
+        case CONDITION_QUEST_NONE:
+        case CONDITION_ACTIVE_HOLIDAY:
+        case CONDITION_COMPLETED_ENCOUNTER:
+        case CONDITION_WORLDSTATE:
+            return 2;                                       // a map lookup
+        case CONDITION_CREATURE_IN_RANGE:
+        case CONDITION_DEAD_OR_AWAY:
+            return 8;                                       // grid or group searches
+        default:
+            return 4;                                       // inventory walks, area lookups and scripts
+    }
+}
 
-    return false;
-}
\ No newline at end of file
+struct ConditionPrograms::Node
+{
+    enum Kind
+    {
+        CONSTANT,
+        LEAF,
+        AND,
+        OR,
+    };
+
+    explicit Node(Kind kind = CONSTANT) : kind(kind), value(false), negate(false), swapped(false), condition(nullptr), cost(0) {}
+
+    static Node Constant(bool value)
+    {
+        Node node(CONSTANT);
+        node.value = value;
+        return node;
+    }
+
+    void Negate()
+    {
+        if (kind == CONSTANT)
+            value = !value;
+        else
+            negate = !negate;
+    }
+
+    Kind kind;
+    bool value;                                             // of a constant
+    bool negate;
+    bool swapped;                                           // of a leaf, by its parents
+    ConditionEntry const* condition;                        // of a leaf
+    uint32 cost;
+    std::vector<Node> children;
+};
+
+ConditionPrograms& ConditionPrograms::Instance()
+{
+    static ConditionPrograms programs;
+    return programs;
+}
+
+// Mirrors ConditionEntry::Meets: a parent swapping the targets swaps them for its whole sub-tree, the params of a
+// leaf are still checked by its own Meets, which also applies the flags of the leaf itself
+ConditionPrograms::Node ConditionPrograms::Build(uint32 conditionId, bool swapped) const
+{
+    ConditionEntry const* condition = sConditionStorage.LookupEntry<ConditionEntry>(conditionId);
+    if (!condition)
+        return Node::Constant(false);
+
+    bool const reverse = (condition->m_flags & CONDITION_FLAG_REVERSE_RESULT) != 0;
+    bool const childSwapped = swapped != ((condition->m_flags & CONDITION_FLAG_SWAP_TARGETS) != 0);
+
+    switch (condition->m_condition)
+    {
+        case CONDITION_NONE:
+            return Node::Constant(!reverse);
+        case CONDITION_NOT:
+        {
+            Node node = Build(condition->m_value1, childSwapped);
+            if (!reverse)
+                node.Negate();
+            return node;
+        }
+        case CONDITION_AND:
+        case CONDITION_OR:
+        {
+            bool const isAnd = condition->m_condition == CONDITION_AND;
+            Node node(isAnd ? Node::AND : Node::OR);
+
+            // evaluation order of Meets, the third and fourth condition are optional
+            uint32 const childIds[] = { condition->m_value3, condition->m_value4, condition->m_value1, condition->m_value2 };
+            for (uint32 i = 0; i < 4; ++i)
+            {
+                if (i < 2 && !childIds[i])
+                    continue;
+
+                Node child = Build(childIds[i], childSwapped);
+                if (child.kind == Node::CONSTANT)
+                {
+                    if (child.value == isAnd)               // true in AND, false in OR
+                        continue;
+
+                    return Node::Constant(child.value != reverse);
+                }
+
+                if (child.kind == node.kind && !child.negate)
+                {
+                    for (Node& grandChild : child.children)
+                        node.children.push_back(std::move(grandChild));
+                }
+                else
+                    node.children.push_back(std::move(child));
+            }
+
+            if (node.children.empty())
+                return Node::Constant(isAnd != reverse);
+
+            if (node.children.size() == 1)
+            {
+                Node child = std::move(node.children.front());
+                if (reverse)
+                    child.Negate();
+                return child;
+            }
+
+            // the result of a group does not depend on the order of its pure checks
+            std::stable_sort(node.children.begin(), node.children.end(), [](Node const& a, Node const& b) { return a.cost < b.cost; });
+            for (Node const& child : node.children)
+                node.cost += child.cost;
+
+            node.negate = reverse;
+            return node;
+        }
+        default:
+        {
+            Node node(Node::LEAF);
+            node.condition = condition;
+            node.swapped = swapped;
+            node.cost = GetConditionCost(condition->m_condition);
+            return node;
+        }
+    }
+}
+
+void ConditionPrograms::Emit(Node const& node)
+{
+    switch (node.kind)
+    {
+        case Node::LEAF:
+            m_steps.push_back({ node.condition, node.swapped ? STEP_LEAF_SWAPPED : STEP_LEAF, 0 });
+            break;
+        case Node::AND:
+        case Node::OR:
+        {
+            std::vector<uint32> jumps;
+            for (size_t i = 0; i < node.children.size(); ++i)
+            {
+                Emit(node.children[i]);
+                if (i + 1 == node.children.size())
+                    break;
+
+                jumps.push_back(uint32(m_steps.size()));
+                m_steps.push_back({ nullptr, node.kind == Node::AND ? STEP_JUMP_IF_FALSE : STEP_JUMP_IF_TRUE, 0 });
+            }
+
+            // past the group, to its negation if it has one
+            for (uint32 jump : jumps)
+                m_steps[jump].jump = uint32(m_steps.size());
+            break;
+        }
+        case Node::CONSTANT:
+            MANGOS_ASSERT(false);                           // folded by Build
+            break;
+    }
+
+    if (node.negate)
+        m_steps.push_back({ nullptr, STEP_NOT, 0 });
+}
+
+void ConditionPrograms::Compile()
+{
+    m_steps.clear();
+    m_programs.assign(sConditionStorage.GetMaxEntry(), Program());
+
+    uint32 compiled = 0;
+    uint32 folded = 0;
+    for (uint32 i = 0; i < sConditionStorage.GetMaxEntry(); ++i)
+    {
+        if (!sConditionStorage.LookupEntry<ConditionEntry>(i))
+            continue;
+
+        Node root = Build(i, false);
+        Program& program = m_programs[i];
+        if (root.kind == Node::CONSTANT)
+        {
+            program.result = root.value ? PROGRAM_TRUE : PROGRAM_FALSE;
+            ++folded;
+            continue;
+        }
+
+        program.begin = uint32(m_steps.size());
+        Emit(root);
+        program.end = uint32(m_steps.size());
+        program.result = PROGRAM_EVALUATE;
+        ++compiled;
+    }
+
+    sLog.outString(">> Compiled %u conditions into %u steps, %u folded to a constant result", compiled, uint32(m_steps.size()), folded);
+}
+
+bool ConditionPrograms::IsSatisfied(uint32 conditionId, WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
+{
+    if (conditionId >= m_programs.size())
+        return false;
+
+    Program const& program = m_programs[conditionId];
+    switch (program.result)
+    {
+        case PROGRAM_NONE:
+        case PROGRAM_FALSE:
+            return false;
+        case PROGRAM_TRUE:
+            return true;
+        case PROGRAM_EVALUATE:
+            break;
+    }
+
+    bool result = false;
+    for (uint32 i = program.begin; i < program.end;)
+    {
+        Step const& step = m_steps[i];
+        switch (step.type)
+        {
+            case STEP_LEAF:
+                result = step.condition->Meets(target, map, source, conditionSourceType);
+                ++i;
+                break;
+            case STEP_LEAF_SWAPPED:
+                result = step.condition->Meets(source, map, target, conditionSourceType);
+                ++i;
+                break;
+            case STEP_NOT:
+                result = !result;
+                ++i;
+                break;
+            case STEP_JUMP_IF_FALSE:
+                i = result ? i + 1 : step.jump;
+                break;
+            case STEP_JUMP_IF_TRUE:
+                i = result ? step.jump : i + 1;
+                break;
+        }
+    }
+
+    return result;
+}
@@ -21,6 +21,8 @@
 
 #include "Globals/SharedDefines.h"
 
+#include <vector>
+
 class Map;
 class WorldObject;
 
@@ -154,6 +156,8 @@ class ConditionEntry
         // Checks if the condition is met
         bool Meets(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const;
     private:
+        friend class ConditionPrograms;
+
         void DisableCondition() { m_condition = CONDITION_NONE; m_flags ^= CONDITION_FLAG_REVERSE_RESULT; }
         bool CheckParamRequirements(WorldObject const* target, Map const* map, WorldObject const* source) const;
         bool inline Evaluate(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const;
@@ -166,6 +170,68 @@ class ConditionEntry
         uint8 m_flags;
 };
 
+// Condition trees compiled into flat programs, evaluated without recursion or storage lookups
+// A program is the post-order of its tree: leaves are evaluated in place, AND/OR groups end in short-circuit jumps past
+// the rest of the group and NOT/reversed groups in a negation. Nested groups of the same kind are merged, sub-trees
+// with a constant result are folded and the children of a group are ordered so that cheap checks run first.
+// Rebuilt whenever the conditions are (re)loaded.
+class ConditionPrograms
+{
+    public:
+        static ConditionPrograms& Instance();
+
+        void Compile();
+
+        // returns false for unknown conditions, like a lookup of the condition would
+        bool IsSatisfied(uint32 conditionId, WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const;
+
+    private:
+        enum StepType : uint8
+        {
+            STEP_LEAF,                                      // result = condition->Meets(target, source)
+            STEP_LEAF_SWAPPED,                              // result = condition->Meets(source, target), swapped by a parent
+            STEP_NOT,
+            STEP_JUMP_IF_FALSE,                             // AND: skip the rest of the group
+            STEP_JUMP_IF_TRUE,                              // OR
+        };
+
+        struct Step
+        {
+            ConditionEntry const* condition;
+            StepType type;
+            uint32 jump;                                    // index in m_steps
+        };
+
+        enum ProgramResult : uint8
+        {
+            PROGRAM_NONE,                                   // no such condition
+            PROGRAM_EVALUATE,
+            PROGRAM_FALSE,                                  // folded
+            PROGRAM_TRUE,
+        };
+
+        struct Program
+        {
+            Program() : begin(0), end(0), result(PROGRAM_NONE) {}
+
+            uint32 begin;
+            uint32 end;
+            ProgramResult result;
+        };
+
+        struct Node;
+
+        ConditionPrograms() {}
+
+        Node Build(uint32 conditionId, bool swapped) const;
+        void Emit(Node const& node);
+
+        std::vector<Step> m_steps;
+        std::vector<Program> m_programs;                    // by condition id
+};
+
+#define sConditionPrograms ConditionPrograms::Instance()
+
 // Check if a player meets condition conditionId
 bool IsConditionSatisfied(uint32 conditionId, WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType);
 
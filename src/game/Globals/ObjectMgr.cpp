@@ -18,6 +18,7 @@
 
 #include "Globals/ObjectMgr.h"
 #include "Database/DatabaseEnv.h"
+#include "Database/DatabaseImpl.h"
 #include "Policies/Singleton.h"
 
 #include "Server/SQLStorages.h"
@@ -128,7 +129,8 @@ ObjectMgr::ObjectMgr() :
     m_GroupIds("Group ids"),
     m_FirstTemporaryCreatureGuid(1),
     m_FirstTemporaryGameObjectGuid(1),
-    m_Dbc2StorageLocaleIndex(DEFAULT_LOCALE)
+    m_Dbc2StorageLocaleIndex(DEFAULT_LOCALE),
+    m_expiredMailsPending(false)
 {
 }
 
@@ -2571,14 +2573,14 @@ void ObjectMgr::LoadItemPrototypes()
 
 void ObjectMgr::LoadItemRequiredTarget()
 {
-    m_ItemRequiredTarget.clear();                           // needed for reload case
-
     uint32 count = 0;
 
     QueryResult* result = WorldDatabase.Query("SELECT entry,type,targetEntry FROM item_required_target");
 
     if (!result)
     {
+        m_ItemRequiredTarget.clear();                       // needed for reload case
+
         BarGoLink bar(1);
         bar.step();
         sLog.outErrorDb(">> Loaded 0 ItemRequiredTarget. DB table `item_required_target` is empty.");
@@ -2586,6 +2588,7 @@ void ObjectMgr::LoadItemRequiredTarget()
         return;
     }
 
+    ItemRequiredTargetMap::Container requiredTargets;
     BarGoLink bar(result->GetRowCount());
 
     do
@@ -2659,7 +2662,7 @@ void ObjectMgr::LoadItemRequiredTarget()
             continue;
         }
 
-        m_ItemRequiredTarget.insert(ItemRequiredTargetMap::value_type(uiItemId, ItemRequiredTarget(ItemRequiredTargetType(uiType), uiTargetEntry)));
+        requiredTargets.push_back(ItemRequiredTargetMap::value_type(uiItemId, ItemRequiredTarget(ItemRequiredTargetType(uiType), uiTargetEntry)));
 
         ++count;
     }
@@ -2667,6 +2670,9 @@ void ObjectMgr::LoadItemRequiredTarget()
 
     delete result;
 
+    // replaces the old table only now, so a reload never exposes a half filled one
+    m_ItemRequiredTarget.Assign(std::move(requiredTargets));
+
     sLog.outString(">> Loaded %u Item required targets", count);
     sLog.outString();
 }
@@ -5313,6 +5319,8 @@ void ObjectMgr::LoadConditions()
         }
     }
 
+    sConditionPrograms.Compile();
+
     sLog.outString(">> Loaded %u Condition definitions", sConditionStorage.GetRecordCount());
     sLog.outString();
 }
@@ -5835,117 +5843,184 @@ void ObjectMgr::LoadAreatriggerLocales()
     sLog.outString();
 }
 
-// not very fast function but it is called only once a day, or on starting-up
+#define EXPIRED_MAILS_QUERY_ROWS 500                       // per chunk, a mail has a row per item
+
+#define EXPIRED_MAILS_QUERY "SELECT m.id,m.messageType,m.sender,m.receiver,m.itemTextId,m.has_items,m.expire_time,m.checked,mi.item_guid,mi.item_template " \
+    "FROM mail m LEFT JOIN mail_items mi ON mi.mail_id = m.id " \
+    "WHERE m.expire_time < '" UI64FMTD "' AND (m.expire_time > '" UI64FMTD "' OR (m.expire_time = '" UI64FMTD "' AND m.id > '%u')) " \
+    "ORDER BY m.expire_time, m.id LIMIT %u"
+
 /// @param serverUp true if the server is already running, false when the server is started
 void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
 {
     time_t basetime = time(nullptr);
     DEBUG_LOG("Returning mails current time: hour: %d, minute: %d, second: %d ", localtime(&basetime)->tm_hour, localtime(&basetime)->tm_min, localtime(&basetime)->tm_sec);
+
+    ExpiredMailCursor cursor = { uint64(basetime), 0, 0, 0 };
+
+    if (serverUp)
+    {
+        // still busy with the previous day
+        if (m_expiredMailsPending)
+            return;
+
+        m_expiredMailsPending = true;
+        QueryExpiredMails(cursor);
+        return;
+    }
+
     // delete all old mails without item and without body immediately, if starting server
-    if (!serverUp)
-        CharacterDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND itemTextId = 0", (uint64)basetime);
-    //                                                     0  1           2      3        4          5         6           7   8       9
-    QueryResult* result = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,itemTextId,has_items,expire_time,cod,checked,mailTemplateId FROM mail WHERE expire_time < '" UI64FMTD "'", (uint64)basetime);
-    if (!result)
+    CharacterDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND itemTextId = 0", cursor.basetime);
+
+    bool more;
+    do
     {
-        BarGoLink bar(1);
-        bar.step();
-        sLog.outString(">> Only expired mails (need to be return or delete) or DB table `mail` is empty.");
-        sLog.outString();
-        return;                                             // any mails need to be returned or deleted
+        QueryResult* result = CharacterDatabase.PQuery(EXPIRED_MAILS_QUERY, cursor.basetime, cursor.expireTime, cursor.expireTime, cursor.mailId, EXPIRED_MAILS_QUERY_ROWS);
+        more = HandleExpiredMails(result, false, cursor);
+    }
+    while (more);
+
+    sLog.outString(">> Deleted %u expired mails", cursor.count);
+    sLog.outString();
+}
+
+void ObjectMgr::QueryExpiredMails(ExpiredMailCursor const& cursor)
+{
+    CharacterDatabase.AsyncPQuery(this, &ObjectMgr::HandleExpiredMailsCallback, cursor,
+                                  EXPIRED_MAILS_QUERY, cursor.basetime, cursor.expireTime, cursor.expireTime, cursor.mailId, EXPIRED_MAILS_QUERY_ROWS);
+}
+
+void ObjectMgr::HandleExpiredMailsCallback(QueryResult* result, ExpiredMailCursor cursor)
+{
+    // one chunk per query result, the next chunk is queried only now so a tick handles at most one
+    if (HandleExpiredMails(result, true, cursor))
+    {
+        QueryExpiredMails(cursor);
+        return;
     }
 
-    // std::ostringstream delitems, delmails; // will be here for optimization
-    // bool deletemail = false, deleteitem = false;
-    // delitems << "DELETE FROM item_instance WHERE guid IN ( ";
-    // delmails << "DELETE FROM mail WHERE id IN ( "
+    m_expiredMailsPending = false;
+    sLog.outBasic("Deleted %u expired mails", cursor.count);
+}
 
-    BarGoLink bar(result->GetRowCount());
-    uint32 count = 0;
+/// Returns or deletes a chunk of expired mails, true if there can be more of them after the cursor
+bool ObjectMgr::HandleExpiredMails(QueryResult* result, bool serverUp, ExpiredMailCursor& cursor)
+{
+    if (!result)
+        return false;
 
+    struct ExpiredMail
+    {
+        uint32 id;
+        uint8 messageType;
+        uint32 sender;
+        uint32 receiver;
+        uint32 itemTextId;
+        bool hasItems;
+        uint64 expireTime;
+        uint32 checked;
+        std::vector<uint32> items;
+    };
+
+    std::vector<ExpiredMail> mails;
+    uint64 const rows = result->GetRowCount();
     do
     {
-        bar.step();
-
         Field* fields = result->Fetch();
-        Mail* m = new Mail;
-        m->messageID = fields[0].GetUInt32();
-        m->messageType = fields[1].GetUInt8();
-        m->sender = fields[2].GetUInt32();
-        m->receiverGuid = ObjectGuid(HIGHGUID_PLAYER, fields[3].GetUInt32());
-        bool has_items = fields[5].GetBool();
-        m->expire_time = (time_t)fields[6].GetUInt64();
-        m->deliver_time = 0;
-        m->COD = fields[7].GetUInt32();
-        m->checked = fields[8].GetUInt32();
-        m->mailTemplateId = fields[9].GetInt16();
-
-        Player* pl = nullptr;
-        if (serverUp)
-            pl = GetPlayer(m->receiverGuid);
-        if (pl)
+        uint32 const id = fields[0].GetUInt32();
+        if (mails.empty() || mails.back().id != id)
         {
-            // this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
-            // his in mailbox and he has already listed his mails )
-            delete m;
-            continue;
+            ExpiredMail mail;
+            mail.id = id;
+            mail.messageType = fields[1].GetUInt8();
+            mail.sender = fields[2].GetUInt32();
+            mail.receiver = fields[3].GetUInt32();
+            mail.itemTextId = fields[4].GetUInt32();
+            mail.hasItems = fields[5].GetBool();
+            mail.expireTime = fields[6].GetUInt64();
+            mail.checked = fields[7].GetUInt32();
+            mails.push_back(std::move(mail));
         }
-        // delete or return mail:
-        if (has_items)
-        {
-            QueryResult* resultItems = CharacterDatabase.PQuery("SELECT item_guid,item_template FROM mail_items WHERE mail_id='%u'", m->messageID);
-            if (resultItems)
-            {
-                do
-                {
-                    Field* fields2 = resultItems->Fetch();
 
-                    uint32 item_guid_low = fields2[0].GetUInt32();
-                    uint32 item_template = fields2[1].GetUInt32();
+        // mail_items of the mail, null without items
+        if (uint32 itemGuid = fields[8].GetUInt32())
+            mails.back().items.push_back(itemGuid);
+    }
+    while (result->NextRow());
+    delete result;
 
-                    m->AddItem(item_guid_low, item_template);
-                }
-                while (resultItems->NextRow());
+    // with a full result the items of the last mail can continue in the next chunk
+    bool const more = rows >= EXPIRED_MAILS_QUERY_ROWS;
+    if (more && mails.size() > 1)
+        mails.pop_back();
 
-                delete resultItems;
-            }
+    cursor.expireTime = mails.back().expireTime;
+    cursor.mailId = mails.back().id;
+
+    std::ostringstream deletedMails, deletedItems, deletedTexts;
+    std::map<uint32, std::pair<std::ostringstream, std::ostringstream>> returnedByReceiver;   // new receiver -> mails, items
+    std::vector<ExpiredMail const*> returned;
+
+    for (ExpiredMail const& mail : mails)
+    {
+        // this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
+        // his in mailbox and he has already listed his mails )
+        if (serverUp && GetPlayer(ObjectGuid(HIGHGUID_PLAYER, mail.receiver)))
+            continue;
+
+        if (mail.hasItems)
+        {
             // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
-            if (m->messageType != MAIL_NORMAL || (m->checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
+            if (mail.messageType == MAIL_NORMAL && !(mail.checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
             {
-                // mail open and then not returned
-                for (auto& item : m->items)
-                    CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", item.item_guid);
-            }
-            else
-            {
-                // mail will be returned:
-                CharacterDatabase.PExecute("UPDATE mail SET sender = '%u', receiver = '%u', expire_time = '" UI64FMTD "', deliver_time = '" UI64FMTD "',cod = '0', checked = '%u' WHERE id = '%u'",
-                                           m->receiverGuid.GetCounter(), m->sender, (uint64)basetime + 30 * DAY, (uint64)basetime, MAIL_CHECK_MASK_RETURNED, m->messageID);
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
-                {
-                    // update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
-                    CharacterDatabase.PExecute("UPDATE mail_items SET receiver = %u WHERE item_guid = '%u'", m->sender, itr2->item_guid);
-                    CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = %u WHERE guid = '%u'", m->sender, itr2->item_guid);
-                }
-                delete m;
+                returned.push_back(&mail);
+
+                // update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
+                auto& receiverLists = returnedByReceiver[mail.sender];
+                receiverLists.first << (receiverLists.first.tellp() ? "," : "") << mail.id;
+                for (uint32 itemGuid : mail.items)
+                    receiverLists.second << (receiverLists.second.tellp() ? "," : "") << itemGuid;
                 continue;
             }
+
+            // mail open and then not returned
+            for (uint32 itemGuid : mail.items)
+                deletedItems << (deletedItems.tellp() ? "," : "") << itemGuid;
         }
 
-        if (m->itemTextId)
-            CharacterDatabase.PExecute("DELETE FROM item_text WHERE id = '%u'", m->itemTextId);
+        if (mail.itemTextId)
+            deletedTexts << (deletedTexts.tellp() ? "," : "") << mail.itemTextId;
 
-        // deletemail = true;
-        // delmails << m->messageID << ", ";
-        CharacterDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", m->messageID);
-        delete m;
-        ++count;
+        deletedMails << (deletedMails.tellp() ? "," : "") << mail.id;
+        ++cursor.count;
     }
-    while (result->NextRow());
-    delete result;
 
-    sLog.outString(">> Loaded %u mails", count);
-    sLog.outString();
+    CharacterDatabase.BeginTransaction();
+
+    for (ExpiredMail const* mail : returned)
+        CharacterDatabase.PExecute("UPDATE mail SET sender = '%u', receiver = '%u', expire_time = '" UI64FMTD "', deliver_time = '" UI64FMTD "',cod = '0', checked = '%u' WHERE id = '%u'",
+                                   mail->receiver, mail->sender, cursor.basetime + 30 * DAY, cursor.basetime, MAIL_CHECK_MASK_RETURNED, mail->id);
+
+    for (auto& receiverLists : returnedByReceiver)
+    {
+        CharacterDatabase.PExecute("UPDATE mail_items SET receiver = '%u' WHERE mail_id IN (%s)", receiverLists.first, receiverLists.second.first.str().c_str());
+        if (receiverLists.second.second.tellp())
+            CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = '%u' WHERE guid IN (%s)", receiverLists.first, receiverLists.second.second.str().c_str());
+    }
+
+    if (deletedItems.tellp())
+        CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid IN (%s)", deletedItems.str().c_str());
+    if (deletedTexts.tellp())
+        CharacterDatabase.PExecute("DELETE FROM item_text WHERE id IN (%s)", deletedTexts.str().c_str());
+    if (deletedMails.tellp())
+    {
+        CharacterDatabase.PExecute("DELETE FROM mail_items WHERE mail_id IN (%s)", deletedMails.str().c_str());
+        CharacterDatabase.PExecute("DELETE FROM mail WHERE id IN (%s)", deletedMails.str().c_str());
+    }
+
+    CharacterDatabase.CommitTransaction();
+
+    return more;
 }
 
 void ObjectMgr::LoadQuestAreaTriggers()
@@ -7597,14 +7672,14 @@ void ObjectMgr::DeleteCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_
 
 void ObjectMgr::LoadQuestRelationsHelper(QuestRelationsMap& map, char const* table)
 {
-    map.clear();                                            // need for reload case
-
     uint32 count = 0;
 
     QueryResult* result = WorldDatabase.PQuery("SELECT id,quest FROM %s", table);
 
     if (!result)
     {
+        map.clear();                                        // need for reload case
+
         BarGoLink bar(1);
 
         bar.step();
@@ -7614,6 +7689,7 @@ void ObjectMgr::LoadQuestRelationsHelper(QuestRelationsMap& map, char const* tab
         return;
     }
 
+    QuestRelationsMap::Container relations;
     BarGoLink bar(result->GetRowCount());
 
     do
@@ -7630,7 +7706,7 @@ void ObjectMgr::LoadQuestRelationsHelper(QuestRelationsMap& map, char const* tab
             continue;
         }
 
-        map.insert(QuestRelationsMap::value_type(id, quest));
+        relations.push_back(QuestRelationsMap::value_type(id, quest));
 
         ++count;
     }
@@ -7638,6 +7714,8 @@ void ObjectMgr::LoadQuestRelationsHelper(QuestRelationsMap& map, char const* tab
 
     delete result;
 
+    map.Assign(std::move(relations));
+
     sLog.outString();
     sLog.outString(">> Loaded %u quest relations from %s", count, table);
 }
@@ -8283,10 +8361,7 @@ void ObjectMgr::LoadFishingBaseSkillLevel()
 // Check if a target meets condition conditionId
 bool ObjectMgr::IsConditionSatisfied(uint32 conditionId, WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
 {
-    if (ConditionEntry const* condition = sConditionStorage.LookupEntry<ConditionEntry>(conditionId))
-        return condition->Meets(target, map, source, conditionSourceType);
-
-    return false;
+    return sConditionPrograms.IsSatisfied(conditionId, target, map, source, conditionSourceType);
 }
 
 SkillRangeType GetSkillRangeType(SkillLineEntry const* pSkill, bool racial)
@@ -8827,7 +8902,6 @@ void ObjectMgr::LoadNpcGossips()
 
 void ObjectMgr::LoadGossipMenu(std::set<uint32>& gossipScriptSet)
 {
-    m_mGossipMenusMap.clear();
     //                                                0      1        2
     QueryResult* result = WorldDatabase.Query("SELECT entry, text_id, script_id, "
                           //   3
@@ -8837,11 +8911,13 @@ void ObjectMgr::LoadGossipMenu(std::set<uint32>& gossipScriptSet)
     {
         BarGoLink bar(1);
         bar.step();
+        m_mGossipMenusMap.clear();
         sLog.outErrorDb(">> Loaded gossip_menu, table is empty!");
         sLog.outString();
         return;
     }
 
+    GossipMenusMap::Container menus;
     BarGoLink bar(result->GetRowCount());
 
     uint32 count = 0;
@@ -8889,7 +8965,7 @@ void ObjectMgr::LoadGossipMenu(std::set<uint32>& gossipScriptSet)
             }
         }
 
-        m_mGossipMenusMap.insert(GossipMenusMap::value_type(gMenu.entry, gMenu));
+        menus.push_back(GossipMenusMap::value_type(gMenu.entry, gMenu));
 
         ++count;
     }
@@ -8897,6 +8973,8 @@ void ObjectMgr::LoadGossipMenu(std::set<uint32>& gossipScriptSet)
 
     delete result;
 
+    m_mGossipMenusMap.Assign(std::move(menus));
+
     // post loading tests
     for (uint32 i = 1; i < sCreatureStorage.GetMaxEntry(); ++i)
     {
@@ -8920,8 +8998,6 @@ void ObjectMgr::LoadGossipMenu(std::set<uint32>& gossipScriptSet)
 
 void ObjectMgr::LoadGossipMenuItems(std::set<uint32>& gossipScriptSet)
 {
-    m_mGossipMenuItemsMap.clear();
-
     QueryResult* result = WorldDatabase.Query(
                               "SELECT menu_id, id, option_icon, option_text, option_broadcast_text, option_id, npc_option_npcflag, "
                               "action_menu_id, action_poi_id, action_script_id, box_coded, box_money, box_text, box_broadcast_text, "
@@ -8932,6 +9008,7 @@ void ObjectMgr::LoadGossipMenuItems(std::set<uint32>& gossipScriptSet)
     {
         BarGoLink bar(1);
         bar.step();
+        m_mGossipMenuItemsMap.clear();
         sLog.outErrorDb(">> Loaded gossip_menu_option, table is empty!");
         sLog.outString();
         return;
@@ -8951,6 +9028,7 @@ void ObjectMgr::LoadGossipMenuItems(std::set<uint32>& gossipScriptSet)
     }
 
     // loading
+    GossipMenuItemsMap::Container menuItems;
     BarGoLink bar(result->GetRowCount());
 
     uint32 count = 0;
@@ -9072,7 +9150,7 @@ void ObjectMgr::LoadGossipMenuItems(std::set<uint32>& gossipScriptSet)
             }
         }
 
-        m_mGossipMenuItemsMap.insert(GossipMenuItemsMap::value_type(gMenuItem.menu_id, gMenuItem));
+        menuItems.push_back(GossipMenuItemsMap::value_type(gMenuItem.menu_id, gMenuItem));
 
         ++count;
     }
@@ -9080,6 +9158,8 @@ void ObjectMgr::LoadGossipMenuItems(std::set<uint32>& gossipScriptSet)
 
     delete result;
 
+    m_mGossipMenuItemsMap.Assign(std::move(menuItems));
+
     if (!sLog.HasLogFilter(LOG_FILTER_DB_STRICTED_CHECK))
     {
         for (uint32 menu_id : menu_ids)
@@ -33,6 +33,7 @@
 #include "Entities/ObjectGuid.h"
 #include "Globals/Conditions.h"
 #include "Maps/SpawnGroupDefines.h"
+#include "Util/FlatLookupTable.h"
 
 #include <map>
 
@@ -205,8 +206,8 @@ typedef std::unordered_map<uint32, PointOfInterestLocale> PointOfInterestLocaleM
 typedef std::unordered_map<uint32, AreaTriggerLocale> AreaTriggerLocaleMap;
 
 typedef std::multimap<int32, uint32> ExclusiveQuestGroupsMap;
-typedef std::multimap<uint32, ItemRequiredTarget> ItemRequiredTargetMap;
-typedef std::multimap<uint32, uint32> QuestRelationsMap;
+typedef FlatLookupTable<ItemRequiredTarget> ItemRequiredTargetMap;
+typedef FlatLookupTable<uint32> QuestRelationsMap;
 typedef std::pair<ExclusiveQuestGroupsMap::const_iterator, ExclusiveQuestGroupsMap::const_iterator> ExclusiveQuestGroupsMapBounds;
 typedef std::pair<ItemRequiredTargetMap::const_iterator, ItemRequiredTargetMap::const_iterator> ItemRequiredTargetMapBounds;
 typedef std::pair<QuestRelationsMap::const_iterator, QuestRelationsMap::const_iterator> QuestRelationsMapBounds;
@@ -286,9 +287,9 @@ struct GossipMenus
     uint16          conditionId;
 };
 
-typedef std::multimap<uint32, GossipMenus> GossipMenusMap;
+typedef FlatLookupTable<GossipMenus> GossipMenusMap;
 typedef std::pair<GossipMenusMap::const_iterator, GossipMenusMap::const_iterator> GossipMenusMapBounds;
-typedef std::multimap<uint32, GossipMenuItems> GossipMenuItemsMap;
+typedef FlatLookupTable<GossipMenuItems> GossipMenuItemsMap;
 typedef std::pair<GossipMenuItemsMap::const_iterator, GossipMenuItemsMap::const_iterator> GossipMenuItemsMapBounds;
 
 struct PetCreateSpellEntry
@@ -762,6 +763,7 @@ class ObjectMgr
         void LoadStandingList(uint32 dateBegin);
         void LoadStandingList();
 
+        // at startup all expired mails are handled at once, while running in chunks of async queries
         void ReturnOrDeleteOldMails(bool serverUp);
 
         void SetHighestGuids();
@@ -1266,6 +1268,20 @@ class ObjectMgr
         void LoadGossipMenu(std::set<uint32>& gossipScriptSet);
         void LoadGossipMenuItems(std::set<uint32>& gossipScriptSet);
 
+        // expired mails are handled in (expire_time, id) order, this is the last one handled
+        struct ExpiredMailCursor
+        {
+            uint64 basetime;
+            uint64 expireTime;
+            uint32 mailId;
+            uint32 count;                                   // deleted mails
+        };
+
+        void QueryExpiredMails(ExpiredMailCursor const& cursor);
+        void HandleExpiredMailsCallback(QueryResult* result, ExpiredMailCursor cursor);
+        bool HandleExpiredMails(QueryResult* result, bool serverUp, ExpiredMailCursor& cursor);
+        bool m_expiredMailsPending;
+
         typedef std::map<uint32, PetLevelInfo*> PetLevelInfoMap;
         // PetLevelInfoMap[creature_id][level]
         PetLevelInfoMap petInfo;                            // [creature_id][level]
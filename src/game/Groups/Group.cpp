@@ -406,7 +406,7 @@ uint32 Group::RemoveMember(ObjectGuid guid, uint8 method)
                     data << 0 << uint8(MEETINGSTONE_STATUS_PARTY_MEMBER_REMOVED_PARTY_REMOVED);
                     BroadcastPacket(data, true);
                     leftGroup = true;
-                    sWorld.GetLFGQueue().GetMessager().AddMessage([groupId = GetId()](LFGQueue* queue)
+                    sWorld.GetLFGQueue().AddMessage([groupId = GetId()](LFGQueue* queue)
                     {
                         queue->RemoveGroupFromQueue(groupId);
                     });
@@ -453,7 +453,7 @@ uint32 Group::RemoveMember(ObjectGuid guid, uint8 method)
             data << m_leaderName;
             BroadcastPacket(data, true);
 
-            sWorld.GetLFGQueue().GetMessager().AddMessage([groupId = GetId()](LFGQueue* queue)
+            sWorld.GetLFGQueue().AddMessage([groupId = GetId()](LFGQueue* queue)
             {
                 queue->RemoveGroupFromQueue(groupId);
             });
@@ -540,7 +540,7 @@ void Group::Disband(bool hideDestroy)
 
     if (IsInLFG())
     {
-        sWorld.GetLFGQueue().GetMessager().AddMessage([groupId = GetId()](LFGQueue* queue)
+        sWorld.GetLFGQueue().AddMessage([groupId = GetId()](LFGQueue* queue)
         {
             queue->RemoveGroupFromQueue(groupId);
         });
@@ -27,6 +27,8 @@ enum LfgRoles
     PLAYER_ROLE_DAMAGE = 0x04
 };
 
+#define MAX_LFG_ROLES 3
+
 enum LfgRolePriority
 {
     LFG_PRIORITY_NONE = 0,
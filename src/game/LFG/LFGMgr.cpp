@@ -56,7 +56,7 @@ void LFGMgr::AddToQueue(Player* leader, uint32 queueAreaID)
 
         grp->SetLFGAreaId(queueAreaID);
 
-        sWorld.GetLFGQueue().GetMessager().AddMessage([groupInfo, groupId = grp->GetId()](LFGQueue* queue)
+        sWorld.GetLFGQueue().AddMessage([groupInfo, groupId = grp->GetId()](LFGQueue* queue)
         {
             queue->AddGroup(groupInfo, groupId);
         });
@@ -77,7 +77,7 @@ void LFGMgr::AddToQueue(Player* leader, uint32 queueAreaID)
         playerInfo.name = leader->GetName();
         leader->SetLFGAreaId(queueAreaID);
 
-        sWorld.GetLFGQueue().GetMessager().AddMessage([playerInfo, playerGuid = leader->GetObjectGuid()](LFGQueue* queue)
+        sWorld.GetLFGQueue().AddMessage([playerInfo, playerGuid = leader->GetObjectGuid()](LFGQueue* queue)
         {
             queue->AddPlayer(playerInfo, playerGuid);
         });
@@ -275,7 +275,9 @@ void LFGMgr::UpdateGroup(Group* group, bool join, ObjectGuid playerGuid)
     LFGGroupQueueInfo groupInfo;
     if (!group->IsFull())
         group->CalculateLFGRoles(groupInfo);
-    sWorld.GetLFGQueue().GetMessager().AddMessage([groupInfo, join, playerGuid, groupId = group->GetId()](LFGQueue* queue)
+    else
+        groupInfo.playerCount = group->GetMembersCount();
+    sWorld.GetLFGQueue().AddMessage([groupInfo, join, playerGuid, groupId = group->GetId()](LFGQueue* queue)
     {
         queue->UpdateGroup(groupInfo, join, playerGuid, groupId);
     });
@@ -24,7 +24,7 @@
 #include "Globals/ObjectMgr.h"
 #include "Groups/Group.h"
 
-std::array<LfgRoles, 3> PotentialRoles =
+std::array<LfgRoles, MAX_LFG_ROLES> PotentialRoles =
 {
     PLAYER_ROLE_TANK,
     PLAYER_ROLE_HEALER,
@@ -49,7 +49,7 @@ void LFGPlayerQueueInfo::CalculateTalentRoles(Player* player)
         rolePriority.emplace_back(std::pair<LfgRoles, LfgRolePriority>(role, LFGMgr::GetPriority(Classes(player->getClass()), role)));
 }
 
-LfgRolePriority LFGPlayerQueueInfo::GetRolePriority(LfgRoles role)
+LfgRolePriority LFGPlayerQueueInfo::GetRolePriority(LfgRoles role) const
 {
     for (const auto& iter : rolePriority)
     {
@@ -60,168 +60,215 @@ LfgRolePriority LFGPlayerQueueInfo::GetRolePriority(LfgRoles role)
     return LFG_PRIORITY_NONE;
 }
 
-void LFGQueue::Update()
+void LFGQueue::Update(uint32 diff)
 {
-    TimePoint previously = sWorld.GetCurrentClockTime();
-    while (!World::IsStopped())
+    m_queueTime += diff;
+
+    GetMessager().Execute(this);
+
+    UpdateTimers();
+
+    // rematch only the dungeons that changed, matching can change them again for the next update
+    std::set<uint64> changedBuckets;
+    std::swap(changedBuckets, m_changedBuckets);
+    for (uint64 bucketKey : changedBuckets)
+        MatchBucket(bucketKey);
+}
+
+void LFGQueue::AddMessage(std::function<void(LFGQueue*)> const& message)
+{
+    m_messager.AddMessage(message);
+    sWorld.GetMatchmakingScheduler().Wake(MATCHMAKING_LFG);
+}
+
+void LFGQueue::UpdateTimers()
+{
+    // Give queue priority to players waiting for 30 minutes, the timeline is ordered by join time.
+    while (!m_queuePriorityTimeline.empty() && m_queuePriorityTimeline.begin()->first + LFG_QUEUE_PRIORITY_TIME <= m_queueTime)
+    {
+        ObjectGuid playerGuid = ObjectGuid(m_queuePriorityTimeline.begin()->second);
+        m_queuePriorityTimeline.erase(m_queuePriorityTimeline.begin());
+
+        LFGPlayerQueueInfo& playerInfo = m_queuedPlayers[playerGuid];
+        QueueBucket& bucket = GetBucket(playerInfo.areaId, playerInfo.team);
+        RemoveRoleCandidates(bucket, playerGuid, playerInfo);
+        playerInfo.hasQueuePriority = true;
+        AddRoleCandidates(bucket, playerGuid, playerInfo);
+    }
+
+    // if matchmaking enabled, ignore talents after some time (default 5 min)
+    uint64 const matchmakingTime = uint64(sWorld.getConfig(CONFIG_UINT32_LFG_MATCHMAKING_TIMER)) * IN_MILLISECONDS;
+    while (!m_roleResetTimeline.empty() && m_roleResetTimeline.begin()->first + matchmakingTime <= m_queueTime)
     {
-        GetMessager().Execute(this);
+        ObjectGuid playerGuid = ObjectGuid(m_roleResetTimeline.begin()->second);
+        m_roleResetTimeline.erase(m_roleResetTimeline.begin());
+
+        LFGPlayerQueueInfo& playerInfo = m_queuedPlayers[playerGuid];
+        QueueBucket& bucket = GetBucket(playerInfo.areaId, playerInfo.team);
+        RemoveRoleCandidates(bucket, playerGuid, playerInfo);
+        playerInfo.rolePriority.clear();
+        playerInfo.CalculateRoles((Classes)playerInfo.playerClass);
+        AddRoleCandidates(bucket, playerGuid, playerInfo);
+
+        // the class may fill more roles than the talents
+        MarkChanged(playerInfo.areaId, playerInfo.team);
+    }
 
-        TimePoint now = sWorld.GetCurrentClockTime();
-        uint32 diff = (now - previously).count();
-        previously = now;
+    // After each 5 minutes groups are broadcasted they're still waiting more members.
+    while (!m_groupBroadcasts.empty() && m_groupBroadcasts.begin()->first <= m_queueTime)
+    {
+        uint32 groupId = uint32(m_groupBroadcasts.begin()->second);
+        m_groupBroadcasts.erase(m_groupBroadcasts.begin());
 
-        if (m_queuedGroups.empty() && m_queuedPlayers.empty())
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            continue;
-        }
+        LFGGroupQueueInfo& groupInfo = m_queuedGroups[groupId];
+        groupInfo.broadcastTime = m_queueTime + LFG_GROUP_BROADCAST_INTERVAL;
+        m_groupBroadcasts.insert(QueueEntry(groupInfo.broadcastTime, groupId));
 
-        // Iterate over QueuedPlayersMap to update players timers and remove offline/disconnected players.
-        for (auto itr = m_queuedPlayers.begin(); itr != m_queuedPlayers.end();)
+        sWorld.GetMessager().AddMessage([groupId](World* /*world*/)
         {
-            itr->second.timeInLFG += diff;
+            Group* group = sObjectMgr.GetGroupById(groupId);
+            if (!group)
+                return;
 
-            // Update player timer and give him queue priority.
-            if (itr->second.timeInLFG >= (30 * MINUTE * IN_MILLISECONDS))
-                itr->second.hasQueuePriority = true;
+            WorldPacket data;
+            LFGMgr::BuildInProgressPacket(data);
 
-            // if matchmaking enabled, ignore talents after some time (default 5 min)
-            if (sWorld.getConfig(CONFIG_BOOL_LFG_MATCHMAKING) && itr->second.timeInLFG >= (sWorld.getConfig(CONFIG_UINT32_LFG_MATCHMAKING_TIMER) * IN_MILLISECONDS))
-            {
-                itr->second.rolePriority.clear();
-                itr->second.CalculateRoles((Classes)itr->second.playerClass);
-            }
+            group->BroadcastPacket(data, true);
+        });
+    }
+}
 
-            ++itr;
-        }
+bool LFGQueue::CanFillGroups(QueueBucket const& bucket) const
+{
+    for (uint32 i = 0; i < MAX_LFG_ROLES; ++i)
+        if (bucket.groupsMissingRole[i] && !bucket.candidates[i].empty())
+            return true;
+
+    return false;
+}
+
+void LFGQueue::MatchBucket(uint64 bucketKey)
+{
+    auto bucketItr = m_buckets.find(bucketKey);
+    if (bucketItr == m_buckets.end())
+        return;
+
+    QueueBucket& bucket = bucketItr->second;
+
+    // Fill groups with roles they're missing, the ones waiting the longest first.
+    for (auto entry = bucket.groups.begin(); entry != bucket.groups.end() && CanFillGroups(bucket);)
+    {
+        uint32 groupId = uint32(entry->second);
+        ++entry;                                            // a filled group leaves the queue
+
+        if (FillGroup(bucket, groupId))
+            RemoveGroupFromQueue(groupId, GROUP_SYSTEM_LEAVE);
+    }
+
+    // Pick first 2 players and form group out of them also inserting them into queue as group.
+    if (bucket.players.size() >= m_groupSize)
+        FormGroup(bucket);
+
+    if (bucket.players.empty() && bucket.groups.empty())
+        m_buckets.erase(bucketItr);
+}
+
+bool LFGQueue::FillGroup(QueueBucket& bucket, uint32 groupId)
+{
+    LFGGroupQueueInfo& groupInfo = m_queuedGroups[groupId];
+    RemoveMissingRoles(bucket, groupInfo);
+
+    for (uint32 i = 0; i < MAX_LFG_ROLES && groupInfo.playerCount < m_groupSize; ++i)
+    {
+        LfgRoles role = PotentialRoles[i];
 
-        if (!m_queuedGroups.empty())
+        // candidates are ordered by queue priority, class priority for the role and then by time in queue
+        while (groupInfo.playerCount < m_groupSize && (groupInfo.availableRoles & role) && !bucket.candidates[i].empty())
         {
-            // Iterate over QueuedGroupsMap to fill groups with roles they're missing.
-            for (QueuedGroupsMap::iterator qGroup = m_queuedGroups.begin(); qGroup != m_queuedGroups.end();)
+            if (role == PLAYER_ROLE_DAMAGE)
             {
-                // Remove group from queue if it has been filled by players manually inviting.
-                // We fill 1 group per update since removing it from the queue invalidates
-                // the iterator and we can save on performance a little.
-                // Iterate over QueuedPlayersMap to find suitable player to join group
-                QueuedPlayersMap::iterator next = m_queuedPlayers.begin();
-                for (QueuedPlayersMap::iterator qPlayer = next; next != m_queuedPlayers.end(); qPlayer = next)
-                {
-                    // Pre-increment iterator here since FindRoleToGroup() may remove qPlayer
-                    // from the map
-                    ++next;
-
-                    // Check here that players team and areaId they're in queue are same
-                    if (qPlayer->second.team == qGroup->second.team &&
-                        qPlayer->second.areaId == qGroup->second.areaId)
-                    {
-                        bool groupFound = false;
-                        // Find any role that this player matches and that the group requires. If none,
-                        // then continue onto the next group.
-                        for (LfgRoles role : PotentialRoles)
-                        {
-                            if (!(qPlayer->second.roleMask & role))
-                                continue;
-
-                            if ((role & qGroup->second.availableRoles) == role && FindRoleToGroup(qPlayer->first, qGroup->first, role))
-                            {
-                                groupFound = true;
-                                break;
-                            }
-                        }
-
-                        // If we found a group and it's now full, break. If it's not full,
-                        // go onto the next player and maybe they can fill it.
-                        if (groupFound && qGroup->second.playerCount == 5)
-                        {
-                            break;
-                        }
-                    }
-                }
-
-                if (qGroup->second.playerCount == 5)
+                if (groupInfo.dpsCount >= LFGMgr::GetMaximumDPSSlots())
                 {
-                    RemoveGroupFromQueue(qGroup->first, GROUP_SYSTEM_LEAVE);
+                    groupInfo.availableRoles &= ~PLAYER_ROLE_DAMAGE;
                     break;
                 }
 
-                // Update group timer. After each 5 minutes group will be broadcasted they're still waiting more members.
-                if (qGroup->second.groupTimer <= diff)
-                {
-                    qGroup->second.groupTimer = 5 * MINUTE * IN_MILLISECONDS;
+                // Remove dps flag if there is enough dps in group.
+                if (++groupInfo.dpsCount >= LFGMgr::GetMaximumDPSSlots())
+                    groupInfo.availableRoles &= ~PLAYER_ROLE_DAMAGE;
+            }
+            else
+                groupInfo.availableRoles &= ~role;
 
-                    sWorld.GetMessager().AddMessage([groupId = qGroup->first](World* world)
-                    {
-                        Group* group = sObjectMgr.GetGroupById(groupId);
+            ObjectGuid playerGuid = bucket.candidates[i].begin()->guid;
 
-                        WorldPacket data;
-                        LFGMgr::BuildInProgressPacket(data);
+            // Remove player from queue.
+            RemovePlayerFromQueue(playerGuid, PLAYER_SYSTEM_LEAVE);
 
-                        group->BroadcastPacket(data, true);
-                    });
-                }
-                else
-                {
-                    qGroup->second.groupTimer -= diff;
-                }
+            ++groupInfo.playerCount;
 
-                ++qGroup;
-            }
+            sWorld.GetMessager().AddMessage([playerGuid, groupId](World* /*world*/)
+            {
+                Group* group = sObjectMgr.GetGroupById(groupId);
+                Player* player = sObjectMgr.GetPlayer(playerGuid);
+                if (!group || !player)
+                    return;
+
+                WorldPacket data;
+                LFGMgr::BuildMemberAddedPacket(data, playerGuid);
+                group->BroadcastPacket(data, true);
+
+                // Add member to the group.
+                group->AddMember(playerGuid, player->GetName(), GROUP_LFG);
+            });
         }
+    }
 
-        // Pick first 2 players and form group out of them also inserting them into queue as group.
-        if (m_queuedPlayers.size() >= m_groupSize)
-        {
-            // Pick Leader as first target.
-            QueuedPlayersMap::iterator leader = m_queuedPlayers.begin();
+    AddMissingRoles(bucket, groupInfo);
+    return groupInfo.playerCount >= m_groupSize;
+}
 
-            std::list<ObjectGuid> playersInArea;
-            FindInArea(playersInArea, leader->second.areaId, leader->second.team, leader->first);
+void LFGQueue::FormGroup(QueueBucket& bucket)
+{
+    // the two players waiting the longest, the new group is then filled by roles
+    auto entry = bucket.players.begin();
+    ObjectGuid leaderGuid = ObjectGuid(entry->second);
+    ObjectGuid memberGuid = ObjectGuid((++entry)->second);
+    uint32 areaId = m_queuedPlayers[leaderGuid].areaId;
 
-            // 4 players + the leader
-            if (playersInArea.size() >= m_groupSize - 1)
-            {
-                ObjectGuid leaderGuid = leader->first;
-                ObjectGuid memberGuid = playersInArea.front();
-                uint32 areaId = leader->second.areaId;
+    RemovePlayerFromQueue(leaderGuid, PLAYER_SYSTEM_LEAVE);
+    RemovePlayerFromQueue(memberGuid, PLAYER_SYSTEM_LEAVE);
 
-                RemovePlayerFromQueue(leaderGuid, PLAYER_SYSTEM_LEAVE);
-                RemovePlayerFromQueue(memberGuid, PLAYER_SYSTEM_LEAVE);
+    sWorld.GetMessager().AddMessage([leaderGuid, memberGuid, areaId](World* /*world*/)
+    {
+        Player* leader = sObjectMgr.GetPlayer(leaderGuid);
+        Player* member = sObjectMgr.GetPlayer(memberGuid);
+        if (!leader || !member)
+            return;
 
-                sWorld.GetMessager().AddMessage([leaderGuid, memberGuid, areaId](World* world)
-                {
-                    Player* leader = sObjectMgr.GetPlayer(leaderGuid);
-                    Player* member = sObjectMgr.GetPlayer(memberGuid);
+        WorldPacket data;
+        LFGMgr::BuildMemberAddedPacket(data, member->GetObjectGuid());
 
-                    WorldPacket data;
-                    LFGMgr::BuildMemberAddedPacket(data, member->GetObjectGuid());
-
-                    leader->GetSession()->SendPacket(data);
-
-                    Group* newQueueGroup = new Group;
-                    if (!newQueueGroup->IsCreated())
-                    {
-                        if (newQueueGroup->Create(leader->GetObjectGuid(), leader->GetName()))
-                            sObjectMgr.AddGroup(newQueueGroup);
-                        else
-                        {
-                            // should never be reached for a newly created group
-                            MANGOS_ASSERT(false);
-                        }
-                    }
-
-                    // Add member to the group. Leader is already added upon creation of group.
-                    newQueueGroup->AddMember(member->GetObjectGuid(), member->GetName(), GROUP_LFG);
-
-                    // Add this new group to GroupQueue now and remove players from PlayerQueue - there will be a moment in time when the group isnt in queue
-                    sLFGMgr.AddToQueue(leader, areaId);
-                });
+        leader->GetSession()->SendPacket(data);
+
+        Group* newQueueGroup = new Group;
+        if (!newQueueGroup->IsCreated())
+        {
+            if (newQueueGroup->Create(leader->GetObjectGuid(), leader->GetName()))
+                sObjectMgr.AddGroup(newQueueGroup);
+            else
+            {
+                // should never be reached for a newly created group
+                MANGOS_ASSERT(false);
             }
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    }
+        // Add member to the group. Leader is already added upon creation of group.
+        newQueueGroup->AddMember(member->GetObjectGuid(), member->GetName(), GROUP_LFG);
+
+        // Add this new group to GroupQueue now and remove players from PlayerQueue - there will be a moment in time when the group isnt in queue
+        sLFGMgr.AddToQueue(leader, areaId);
+    });
 }
 
 bool LFGQueue::IsPlayerInQueue(ObjectGuid const& plrGuid) const
@@ -243,7 +290,14 @@ void LFGQueue::UpdateGroup(LFGGroupQueueInfo const& groupInfo, bool join, Object
     if (existingGroupInfo.playerCount == groupInfo.playerCount)
         return;
 
-    existingGroupInfo = groupInfo;
+    // the group keeps its dungeon, team and queue times
+    QueueBucket& bucket = GetBucket(existingGroupInfo.areaId, existingGroupInfo.team);
+    RemoveMissingRoles(bucket, existingGroupInfo);
+    existingGroupInfo.availableRoles = groupInfo.availableRoles;
+    existingGroupInfo.dpsCount = groupInfo.dpsCount;
+    existingGroupInfo.playerCount = groupInfo.playerCount;
+    AddMissingRoles(bucket, existingGroupInfo);
+    MarkChanged(existingGroupInfo.areaId, existingGroupInfo.team);
 
     if (groupInfo.playerCount == 5)
         RemoveGroupFromQueue(groupId, GROUP_SYSTEM_LEAVE);
@@ -251,7 +305,20 @@ void LFGQueue::UpdateGroup(LFGGroupQueueInfo const& groupInfo, bool join, Object
 
 void LFGQueue::AddGroup(LFGGroupQueueInfo const& groupInfo, uint32 groupId)
 {
-    m_queuedGroups[groupId] = groupInfo;
+    auto itr = m_queuedGroups.find(groupId);
+    if (itr != m_queuedGroups.end())
+        UnindexGroup(groupId, itr->second);
+
+    LFGGroupQueueInfo& queuedInfo = m_queuedGroups[groupId];
+    queuedInfo = groupInfo;
+    queuedInfo.joinTime = m_queueTime;
+    queuedInfo.broadcastTime = m_queueTime + groupInfo.groupTimer;
+
+    QueueBucket& bucket = GetBucket(queuedInfo.areaId, queuedInfo.team);
+    bucket.groups.insert(QueueEntry(queuedInfo.joinTime, groupId));
+    AddMissingRoles(bucket, queuedInfo);
+    m_groupBroadcasts.insert(QueueEntry(queuedInfo.broadcastTime, groupId));
+    MarkChanged(queuedInfo.areaId, queuedInfo.team);
 
     sWorld.GetMessager().AddMessage([groupId = groupId, areaId = groupInfo.areaId](World* world)
     {
@@ -266,7 +333,7 @@ void LFGQueue::AddGroup(LFGGroupQueueInfo const& groupInfo, uint32 groupId)
 
 void LFGQueue::AddPlayer(LFGPlayerQueueInfo const& playerInfo, ObjectGuid playerGuid)
 {
-    m_queuedPlayers[playerGuid] = playerInfo;
+    IndexPlayer(playerGuid, playerInfo);
 
     sWorld.GetMessager().AddMessage([playerGuid, areaId = playerInfo.areaId](World* world)
     {
@@ -276,117 +343,53 @@ void LFGQueue::AddPlayer(LFGPlayerQueueInfo const& playerInfo, ObjectGuid player
     });
 }
 
-void LFGQueue::FindInArea(std::list<ObjectGuid>& players, uint32 area, uint32 team, ObjectGuid const& exclude)
+void LFGQueue::IndexPlayer(ObjectGuid playerGuid, LFGPlayerQueueInfo const& playerInfo)
 {
-    for (const auto& itr : m_queuedPlayers)
-    {
-        if (itr.first == exclude)
-            continue;
+    if (IsPlayerInQueue(playerGuid))
+        RemovePlayerFromQueue(playerGuid, PLAYER_SYSTEM_LEAVE);
 
-        if (itr.second.areaId == area && itr.second.team == team)
-            players.push_back(itr.first);
-    }
-}
-
-// Don't pass playerGuid by ref since we may destroy it in RemovePlayerFromQueue
-bool LFGQueue::FindRoleToGroup(ObjectGuid playerGuid, uint32 groupId, LfgRoles role)
-{
-    QueuedGroupsMap::iterator qGroup = m_queuedGroups.find(groupId);
-    QueuedPlayersMap::iterator qPlayer = m_queuedPlayers.find(playerGuid);
+    LFGPlayerQueueInfo& queuedInfo = m_queuedPlayers[playerGuid];
+    queuedInfo = playerInfo;
+    queuedInfo.joinTime = m_queueTime >= playerInfo.timeInLFG ? m_queueTime - playerInfo.timeInLFG : 0;
 
-    if (qGroup != m_queuedGroups.end() && qPlayer != m_queuedPlayers.end())
-    {
-        bool queueTimePriority = qPlayer->second.hasQueuePriority;
-        bool classPriority = qPlayer->second.GetRolePriority(role);
-        // Iterate over QueuedPlayersMap to find if players have been longer in Queue.
-        for (auto& itr : m_queuedPlayers)
-        {
-            if (qPlayer->first == itr.first)
-                continue;
+    QueueBucket& bucket = GetBucket(queuedInfo.areaId, queuedInfo.team);
+    bucket.players.insert(QueueEntry(queuedInfo.joinTime, playerGuid.GetRawValue()));
+    AddRoleCandidates(bucket, playerGuid, queuedInfo);
 
-            // Ignore players queuing for a different dungeon or from opposite factions
-            if (qPlayer->second.areaId != itr.second.areaId || qPlayer->second.team != itr.second.team)
-                continue;
+    if (!queuedInfo.hasQueuePriority)
+        m_queuePriorityTimeline.insert(QueueEntry(queuedInfo.joinTime, playerGuid.GetRawValue()));
+    if (sWorld.getConfig(CONFIG_BOOL_LFG_MATCHMAKING))
+        m_roleResetTimeline.insert(QueueEntry(queuedInfo.joinTime, playerGuid.GetRawValue()));
 
-            // Compare priority/queue time to players that can fill the same role
-            if ((itr.second.roleMask & role) == role)
-            {
-                bool otherTimePriority = itr.second.hasQueuePriority;
-                bool otherClassPriority = itr.second.GetRolePriority(role);
-                bool otherLongerInQueue = itr.second.timeInLFG > qPlayer->second.timeInLFG;
-
-                // Another player is more valuable in this role, they have priority
-                if (otherClassPriority > classPriority)
-                    return false;
-
-                // If the other player has time priority and has spent longer in the queue,
-                // they are ahead of us
-                if (otherTimePriority && otherLongerInQueue)
-                    return false;
-
-                // We do not have priority in the queue and they have spent longer
-                // in the queue, that means they are ahead
-                if (!queueTimePriority && otherLongerInQueue)
-                    return false;
-            }
-        }
-
-        switch (role)
-        {
-            case PLAYER_ROLE_TANK:
-            {
-                // Remove tank flag if player can perform tank role.
-                qGroup->second.availableRoles &= ~PLAYER_ROLE_TANK;
-                break;
-            }
-            case PLAYER_ROLE_HEALER:
-            {
-                // Remove healer flag if player can perform healer role.
-                qGroup->second.availableRoles &= ~PLAYER_ROLE_HEALER;
-                break;
-            }
-            case PLAYER_ROLE_DAMAGE:
-            {
-                if (qGroup->second.dpsCount < LFGMgr::GetMaximumDPSSlots())
-                {
-                    // Update dps count first.
-                    ++qGroup->second.dpsCount;
-
-                    // Remove dps flag if there is enough dps in group.
-                    if (qGroup->second.dpsCount >= LFGMgr::GetMaximumDPSSlots())
-                        qGroup->second.availableRoles &= ~PLAYER_ROLE_DAMAGE;
-                }
-                break;
-            }
-            default:
-            {
-                return false;
-            }
-        }
-
-        // Remove player from queue.
-        RemovePlayerFromQueue(qPlayer->first, PLAYER_SYSTEM_LEAVE);
-
-        ++qGroup->second.playerCount;
-
-        sWorld.GetMessager().AddMessage([playerGuid, groupId](World* world)
-        {
-            Group* group = sObjectMgr.GetGroupById(groupId);
-            Player* player = sObjectMgr.GetPlayer(playerGuid);
+    MarkChanged(queuedInfo.areaId, queuedInfo.team);
+}
 
-            WorldPacket data;
-            LFGMgr::BuildMemberAddedPacket(data, playerGuid);
-            group->BroadcastPacket(data, true);
+void LFGQueue::AddRoleCandidates(QueueBucket& bucket, ObjectGuid playerGuid, LFGPlayerQueueInfo const& playerInfo)
+{
+    for (uint32 i = 0; i < MAX_LFG_ROLES; ++i)
+        if (playerInfo.roleMask & PotentialRoles[i])
+            bucket.candidates[i].insert({ playerInfo.hasQueuePriority, playerInfo.GetRolePriority(PotentialRoles[i]), playerInfo.joinTime, playerGuid });
+}
 
-            // Add member to the group.
-            group->AddMember(playerGuid, player->GetName(), GROUP_LFG);
-        });
+void LFGQueue::RemoveRoleCandidates(QueueBucket& bucket, ObjectGuid playerGuid, LFGPlayerQueueInfo const& playerInfo)
+{
+    for (uint32 i = 0; i < MAX_LFG_ROLES; ++i)
+        if (playerInfo.roleMask & PotentialRoles[i])
+            bucket.candidates[i].erase({ playerInfo.hasQueuePriority, playerInfo.GetRolePriority(PotentialRoles[i]), playerInfo.joinTime, playerGuid });
+}
 
-        // Found player return true.
-        return true;
-    }
+void LFGQueue::AddMissingRoles(QueueBucket& bucket, LFGGroupQueueInfo const& groupInfo)
+{
+    for (uint32 i = 0; i < MAX_LFG_ROLES; ++i)
+        if (groupInfo.availableRoles & PotentialRoles[i])
+            ++bucket.groupsMissingRole[i];
+}
 
-    return false;
+void LFGQueue::RemoveMissingRoles(QueueBucket& bucket, LFGGroupQueueInfo const& groupInfo)
+{
+    for (uint32 i = 0; i < MAX_LFG_ROLES; ++i)
+        if (groupInfo.availableRoles & PotentialRoles[i])
+            --bucket.groupsMissingRole[i];
 }
 
 void LFGQueue::RemovePlayerFromQueue(ObjectGuid playerGuid, PlayerLeaveMethod leaveMethod)
@@ -411,6 +414,14 @@ void LFGQueue::RemovePlayerFromQueue(ObjectGuid playerGuid, PlayerLeaveMethod le
             });
         }
 
+        LFGPlayerQueueInfo const& playerInfo = itr->second;
+        QueueBucket& bucket = GetBucket(playerInfo.areaId, playerInfo.team);
+        bucket.players.erase(QueueEntry(playerInfo.joinTime, playerGuid.GetRawValue()));
+        RemoveRoleCandidates(bucket, playerGuid, playerInfo);
+        m_queuePriorityTimeline.erase(QueueEntry(playerInfo.joinTime, playerGuid.GetRawValue()));
+        m_roleResetTimeline.erase(QueueEntry(playerInfo.joinTime, playerGuid.GetRawValue()));
+        MarkChanged(playerInfo.areaId, playerInfo.team);
+
         m_queuedPlayers.erase(itr);
     }
 }
@@ -447,19 +458,31 @@ void LFGQueue::RemoveGroupFromQueue(uint32 groupId, GroupLeaveMethod leaveMethod
             }
         });
 
+        UnindexGroup(groupId, iter->second);
         m_queuedGroups.erase(iter);
     }
 }
 
+void LFGQueue::UnindexGroup(uint32 groupId, LFGGroupQueueInfo const& groupInfo)
+{
+    // an emptied bucket is erased by its next match
+    QueueBucket& bucket = GetBucket(groupInfo.areaId, groupInfo.team);
+    bucket.groups.erase(QueueEntry(groupInfo.joinTime, groupId));
+    RemoveMissingRoles(bucket, groupInfo);
+    m_groupBroadcasts.erase(QueueEntry(groupInfo.broadcastTime, groupId));
+    MarkChanged(groupInfo.areaId, groupInfo.team);
+}
+
 void LFGQueue::RestoreOfflinePlayer(ObjectGuid playerGuid)
 {
     auto itr = m_offlinePlayers.find(playerGuid);
 
     if (itr != m_offlinePlayers.end())
     {
-        m_queuedPlayers[playerGuid] = itr->second;
+        uint32 areaId = itr->second.areaId;
+        IndexPlayer(playerGuid, itr->second);
         m_offlinePlayers.erase(itr);
-        sWorld.GetMessager().AddMessage([playerGuid, areaId = itr->second.areaId](World* world)
+        sWorld.GetMessager().AddMessage([playerGuid, areaId](World* /*world*/)
         {
             if (Player* player = sObjectMgr.GetPlayer(playerGuid))
                 player->GetSession()->SendMeetingstoneSetqueue(areaId, MEETINGSTONE_STATUS_JOINED_QUEUE);
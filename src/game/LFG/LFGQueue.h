@@ -27,36 +27,47 @@
 
 class Player;
 
+#define LFG_QUEUE_UPDATE_INTERVAL       500                 // ms between the updates of the queue timers
+#define LFG_QUEUE_PRIORITY_TIME         (30 * MINUTE * IN_MILLISECONDS)
+#define LFG_GROUP_BROADCAST_INTERVAL    (5 * MINUTE * IN_MILLISECONDS)
+
 struct LFGPlayerQueueInfo
 {
     LfgRoles roleMask;
     uint32 team;
     uint32 areaId;
-    uint32 timeInLFG;
-    bool hasQueuePriority;
+    uint32 timeInLFG = 0;                                   // time already spent in queue when (re)joining
+    bool hasQueuePriority = false;
     std::string name;
     uint8 playerClass;
     std::list<std::pair<LfgRoles, LfgRolePriority>> rolePriority;
+    uint64 joinTime = 0;                                    // queue time of the join, set by the queue
 
     void CalculateRoles(Classes playerClass);
     void CalculateTalentRoles(Player* player);
-    LfgRolePriority GetRolePriority(LfgRoles role);
+    LfgRolePriority GetRolePriority(LfgRoles role) const;
 };
 
 struct LFGGroupQueueInfo
 {
-    uint32 availableRoles;
-    uint32 dpsCount;
-    uint32 team;
-    uint32 areaId;
-    uint32 groupTimer;
-    uint32 playerCount;
+    uint32 availableRoles = 0;
+    uint32 dpsCount = 0;
+    uint32 team = 0;
+    uint32 areaId = 0;
+    uint32 groupTimer = LFG_GROUP_BROADCAST_INTERVAL;       // until the first in progress broadcast
+    uint32 playerCount = 0;
+    uint64 joinTime = 0;                                    // queue times, set by the queue
+    uint64 broadcastTime = 0;
 };
 
+// Matches the queued players and groups on the world thread, updated by the matchmaking scheduler.
+// Queued players and groups are indexed per dungeon and team: groups by join time, players by join time and for
+// each role by priority, with counters of the groups missing each role. A join or a member leaving a group only
+// rematches its own dungeon and the counters tell in O(1) whether any group can be filled at all.
 class LFGQueue
 {
     public:
-        void Update();
+        void Update(uint32 diff);
 
         bool IsPlayerInQueue(ObjectGuid const& plrGuid) const;
         bool IsGroupInQueue(uint32 groupId) const;
@@ -67,13 +78,58 @@ class LFGQueue
         void RemovePlayerFromQueue(ObjectGuid playerGuid, PlayerLeaveMethod leaveMethod = PLAYER_CLIENT_LEAVE); // 0 == by default system (cmsg, leader leave), 1 == by lfg system (no need report text you left queu)
         void RemoveGroupFromQueue(uint32 groupId, GroupLeaveMethod leaveMethod = GROUP_CLIENT_LEAVE);
 
+        // thread safe, executed on the next update of the queue which is woken for it
+        void AddMessage(std::function<void(LFGQueue*)> const& message);
         Messager<LFGQueue>& GetMessager() { return m_messager; }
 
         void AddGroup(LFGGroupQueueInfo const& groupInfo, uint32 groupId);
         void AddPlayer(LFGPlayerQueueInfo const& playerInfo, ObjectGuid playerGuid);
     private:
-        void FindInArea(std::list<ObjectGuid>& players, uint32 area, uint32 team, ObjectGuid const& exclude);
-        bool FindRoleToGroup(ObjectGuid playerGuid, uint32 groupId, LfgRoles role);
+        typedef std::pair<uint64, uint64> QueueEntry;       // queue time, player guid or group id
+
+        struct RoleCandidate                                // ordered best first
+        {
+            bool hasQueuePriority;
+            LfgRolePriority priority;
+            uint64 joinTime;
+            ObjectGuid guid;
+
+            bool operator<(RoleCandidate const& other) const
+            {
+                if (hasQueuePriority != other.hasQueuePriority)
+                    return hasQueuePriority;
+                if (priority != other.priority)
+                    return priority > other.priority;
+                if (joinTime != other.joinTime)
+                    return joinTime < other.joinTime;
+                return guid < other.guid;
+            }
+        };
+
+        struct QueueBucket                                  // everyone queued for one dungeon by one team
+        {
+            std::set<QueueEntry> players;
+            std::set<QueueEntry> groups;
+            std::set<RoleCandidate> candidates[MAX_LFG_ROLES];
+            uint32 groupsMissingRole[MAX_LFG_ROLES] = {};
+        };
+
+        static uint64 GetBucketKey(uint32 areaId, uint32 team) { return (uint64(areaId) << 32) | team; }
+        QueueBucket& GetBucket(uint32 areaId, uint32 team) { return m_buckets[GetBucketKey(areaId, team)]; }
+        void MarkChanged(uint32 areaId, uint32 team) { m_changedBuckets.insert(GetBucketKey(areaId, team)); }
+
+        void IndexPlayer(ObjectGuid playerGuid, LFGPlayerQueueInfo const& playerInfo);
+        void AddRoleCandidates(QueueBucket& bucket, ObjectGuid playerGuid, LFGPlayerQueueInfo const& playerInfo);
+        void RemoveRoleCandidates(QueueBucket& bucket, ObjectGuid playerGuid, LFGPlayerQueueInfo const& playerInfo);
+        void UnindexGroup(uint32 groupId, LFGGroupQueueInfo const& groupInfo);
+        void AddMissingRoles(QueueBucket& bucket, LFGGroupQueueInfo const& groupInfo);
+        void RemoveMissingRoles(QueueBucket& bucket, LFGGroupQueueInfo const& groupInfo);
+
+        void UpdateTimers();
+        void MatchBucket(uint64 bucketKey);
+        bool CanFillGroups(QueueBucket const& bucket) const;
+        bool FillGroup(QueueBucket& bucket, uint32 groupId);
+        void FormGroup(QueueBucket& bucket);
 
         typedef std::map<ObjectGuid, LFGPlayerQueueInfo> QueuedPlayersMap;
         QueuedPlayersMap m_queuedPlayers;
@@ -82,9 +138,18 @@ class LFGQueue
         typedef std::map<uint32, LFGGroupQueueInfo> QueuedGroupsMap;
         QueuedGroupsMap m_queuedGroups;
 
+        std::map<uint64, QueueBucket> m_buckets;
+        std::set<uint64> m_changedBuckets;                  // to match on the next update
+
+        std::set<QueueEntry> m_queuePriorityTimeline;       // join times of the players without queue priority
+        std::set<QueueEntry> m_roleResetTimeline;           // join times of the players with talent based roles
+        std::set<QueueEntry> m_groupBroadcasts;             // next in progress broadcast of the groups
+
+        uint64 m_queueTime = 0;                             // ms, sum of the update diffs
+
         Messager<LFGQueue> m_messager;
 
         uint32 m_groupSize = 5;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -30,6 +30,7 @@
 #include "Entities/Corpse.h"
 #include "Tools/Language.h"
 #include "BattleGround/BattleGroundMgr.h"
+#include "Multithreading/EpochReclaimer.h"
 #include <sstream>
 #include <iomanip>
 
@@ -77,18 +78,18 @@ class LootTemplate::LootGroup                               // A set of loot def
 };
 
 // Remove all data and free all memory
-void LootStore::Clear()
+void LootStore::DeleteTemplates(LootTemplateMap* templates)
 {
-    for (LootTemplateMap::const_iterator itr = m_LootTemplates.begin(); itr != m_LootTemplates.end(); ++itr)
+    for (LootTemplateMap::const_iterator itr = templates->begin(); itr != templates->end(); ++itr)
         delete itr->second;
-    m_LootTemplates.clear();
+    delete templates;
 }
 
 // Checks validity of the loot store
 // Actual checks are done within LootTemplate::Verify() which is called for every template
 void LootStore::Verify() const
 {
-    for (const auto& m_LootTemplate : m_LootTemplates)
+    for (const auto& m_LootTemplate : GetTemplates())
         m_LootTemplate.second->Verify(*this, m_LootTemplate.first);
 }
 
@@ -99,8 +100,8 @@ void LootStore::LoadLootTable()
     LootTemplateMap::const_iterator tab;
     uint32 count = 0;
 
-    // Clearing store (for reloading case)
-    Clear();
+    // the live templates stay in use until the new ones are complete (for reloading case)
+    LootTemplateMap* templates = new LootTemplateMap;
 
     //                                                 0      1     2                    3        4              5         6
     QueryResult* result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
@@ -151,13 +152,13 @@ void LootStore::LoadLootTable()
 
             // Looking for the template of the entry
             // often entries are put together
-            if (m_LootTemplates.empty() || tab->first != entry)
+            if (templates->empty() || tab->first != entry)
             {
                 // Searching the template (in case template Id changed)
-                tab = m_LootTemplates.find(entry);
-                if (tab == m_LootTemplates.end())
+                tab = templates->find(entry);
+                if (tab == templates->end())
                 {
-                    std::pair< LootTemplateMap::iterator, bool > pr = m_LootTemplates.insert(LootTemplateMap::value_type(entry, new LootTemplate));
+                    std::pair< LootTemplateMap::iterator, bool > pr = templates->insert(LootTemplateMap::value_type(entry, new LootTemplate));
                     tab = pr.first;
                 }
             }
@@ -172,9 +173,11 @@ void LootStore::LoadLootTable()
 
         delete result;
 
-        Verify();                                           // Checks validity of the loot store
+        // Checks validity of the loot store
+        for (const auto& lootTemplate : *templates)
+            lootTemplate.second->Verify(*this, lootTemplate.first);
 
-        sLog.outString(">> Loaded %u loot definitions (" SIZEFMTD " templates) from table %s", count, m_LootTemplates.size(), GetName());
+        sLog.outString(">> Loaded %u loot definitions (" SIZEFMTD " templates) from table %s", count, templates->size(), GetName());
         sLog.outString();
     }
     else
@@ -182,23 +185,29 @@ void LootStore::LoadLootTable()
         sLog.outString();
         sLog.outErrorDb(">> Loaded 0 loot definitions. DB table `%s` is empty.", GetName());
     }
+
+    // map updates already rolling loot keep the old templates until their tick ends
+    LootTemplateMap* oldTemplates = m_LootTemplates.exchange(templates);
+    sEpochReclaimer.Retire([oldTemplates]() { DeleteTemplates(oldTemplates); });
 }
 
 bool LootStore::HaveQuestLootFor(uint32 loot_id) const
 {
-    LootTemplateMap::const_iterator itr = m_LootTemplates.find(loot_id);
-    if (itr == m_LootTemplates.end())
+    LootTemplateMap const& templates = GetTemplates();
+    LootTemplateMap::const_iterator itr = templates.find(loot_id);
+    if (itr == templates.end())
         return false;
 
     // scan loot for quest items
-    return itr->second->HasQuestDrop(m_LootTemplates);
+    return itr->second->HasQuestDrop(templates);
 }
 
 bool LootStore::HaveQuestLootForPlayer(uint32 loot_id, Player* player) const
 {
-    LootTemplateMap::const_iterator tab = m_LootTemplates.find(loot_id);
-    if (tab != m_LootTemplates.end())
-        if (tab->second->HasQuestDropForPlayer(m_LootTemplates, player))
+    LootTemplateMap const& templates = GetTemplates();
+    LootTemplateMap::const_iterator tab = templates.find(loot_id);
+    if (tab != templates.end())
+        if (tab->second->HasQuestDropForPlayer(templates, player))
             return true;
 
     return false;
@@ -206,9 +215,10 @@ bool LootStore::HaveQuestLootForPlayer(uint32 loot_id, Player* player) const
 
 LootTemplate const* LootStore::GetLootFor(uint32 loot_id) const
 {
-    LootTemplateMap::const_iterator tab = m_LootTemplates.find(loot_id);
+    LootTemplateMap const& templates = GetTemplates();
+    LootTemplateMap::const_iterator tab = templates.find(loot_id);
 
-    if (tab == m_LootTemplates.end())
+    if (tab == templates.end())
         return nullptr;
 
     return tab->second;
@@ -218,13 +228,14 @@ void LootStore::LoadAndCollectLootIds(LootIdSet& ids_set)
 {
     LoadLootTable();
 
-    for (LootTemplateMap::const_iterator tab = m_LootTemplates.begin(); tab != m_LootTemplates.end(); ++tab)
+    LootTemplateMap const& templates = GetTemplates();
+    for (LootTemplateMap::const_iterator tab = templates.begin(); tab != templates.end(); ++tab)
         ids_set.insert(tab->first);
 }
 
 void LootStore::CheckLootRefs(LootIdSet* ref_set) const
 {
-    for (const auto& m_LootTemplate : m_LootTemplates)
+    for (const auto& m_LootTemplate : GetTemplates())
         m_LootTemplate.second->CheckLootRefs(ref_set);
 }
 
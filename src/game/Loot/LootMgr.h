@@ -23,6 +23,7 @@
 #include "Entities/ObjectGuid.h"
 #include "Globals/SharedDefines.h"
 
+#include <atomic>
 #include <vector>
 #include "Entities/Bag.h"
 
@@ -223,8 +224,8 @@ class LootStore
 {
     public:
         explicit LootStore(char const* name, char const* entryName, bool ratesAllowed)
-            : m_name(name), m_entryName(entryName), m_ratesAllowed(ratesAllowed) {}
-        virtual ~LootStore() { Clear(); }
+            : m_LootTemplates(new LootTemplateMap), m_name(name), m_entryName(entryName), m_ratesAllowed(ratesAllowed) {}
+        virtual ~LootStore() { DeleteTemplates(m_LootTemplates.load()); }
 
         void Verify() const;
 
@@ -233,7 +234,11 @@ class LootStore
         void ReportUnusedIds(LootIdSet const& ids_set) const;
         void ReportNotExistedId(uint32 id) const;
 
-        bool HaveLootFor(uint32 loot_id) const { return m_LootTemplates.find(loot_id) != m_LootTemplates.end(); }
+        bool HaveLootFor(uint32 loot_id) const
+        {
+            LootTemplateMap const& templates = GetTemplates();      // both iterators must come from the same map
+            return templates.find(loot_id) != templates.end();
+        }
         bool HaveQuestLootFor(uint32 loot_id) const;
         bool HaveQuestLootForPlayer(uint32 loot_id, Player* player) const;
 
@@ -244,9 +249,12 @@ class LootStore
         bool IsRatesAllowed() const { return m_ratesAllowed; }
     protected:
         void LoadLootTable();
-        void Clear();
     private:
-        LootTemplateMap m_LootTemplates;
+        // a (re)load builds a new map and publishes it, the old one is freed once no map update can still read it
+        LootTemplateMap const& GetTemplates() const { return *m_LootTemplates.load(); }
+        static void DeleteTemplates(LootTemplateMap* templates);
+
+        std::atomic<LootTemplateMap*> m_LootTemplates;
         char const* m_name;
         char const* m_entryName;
         bool m_ratesAllowed;
@@ -0,0 +1,198 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "CollisionQueryCache.h"
+#include "Policies/Singleton.h"
+#include "World/World.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+namespace
+{
+    inline uint32 HashFloat(uint32 hash, float value)
+    {
+        uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        hash ^= bits;
+        hash *= 0x01000193;                                 // FNV prime
+        return hash ^ (hash >> 15);
+    }
+}
+
+CollisionQueryCache::CollisionQueryCache() : m_generation(1), m_enabled(sWorld.getConfig(CONFIG_BOOL_VMAP_QUERY_CACHE))
+{
+}
+
+void CollisionQueryCache::Update()
+{
+    m_total.losQueries += m_current.losQueries;
+    m_total.losHits += m_current.losHits;
+    m_total.heightQueries += m_current.heightQueries;
+    m_total.heightHits += m_current.heightHits;
+    m_lastTick = m_current;
+    m_current = CollisionQueryStats();
+
+    m_enabled = sWorld.getConfig(CONFIG_BOOL_VMAP_QUERY_CACHE);
+    Reset();
+}
+
+void CollisionQueryCache::Reset()
+{
+    m_changes.clear();
+
+    if (++m_generation)
+        return;
+
+    // generation wrapped, entries of generation 0 would look valid again
+    std::memset(m_lineOfSight.data(), 0, m_lineOfSight.size() * sizeof(LineOfSightEntry));
+    std::memset(m_height.data(), 0, m_height.size() * sizeof(HeightEntry));
+    m_generation = 1;
+}
+
+void CollisionQueryCache::Invalidate(float minX, float minY, float minZ, float maxX, float maxY, float maxZ)
+{
+    if (!m_enabled)
+        return;
+
+    // checking every change on each hit would cost more than asking the trees again
+    if (m_changes.size() >= COLLISION_CACHE_MAX_CHANGES)
+    {
+        Reset();
+        return;
+    }
+
+    m_changes.push_back({ { minX, minY, minZ }, { maxX, maxY, maxZ } });
+}
+
+bool CollisionQueryCache::IsChanged(uint16 since, Bounds const& bounds) const
+{
+    for (size_t i = since; i < m_changes.size(); ++i)
+    {
+        Bounds const& change = m_changes[i];
+        if (bounds.low[0] <= change.high[0] && bounds.high[0] >= change.low[0] &&
+            bounds.low[1] <= change.high[1] && bounds.high[1] >= change.low[1] &&
+            bounds.low[2] <= change.high[2] && bounds.high[2] >= change.low[2])
+            return true;
+    }
+    return false;
+}
+
+bool CollisionQueryCache::FindLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, bool ignoreM2Model, bool& result)
+{
+    if (!m_enabled)
+        return false;
+
+    ++m_current.losQueries;
+    if (m_lineOfSight.empty())
+        return false;
+
+    uint32 hash = 0x811C9DC5;                               // FNV offset basis
+    hash = HashFloat(hash, srcX); hash = HashFloat(hash, srcY); hash = HashFloat(hash, srcZ);
+    hash = HashFloat(hash, destX); hash = HashFloat(hash, destY); hash = HashFloat(hash, destZ);
+
+    LineOfSightEntry const& entry = m_lineOfSight[(hash + ignoreM2Model) & (COLLISION_CACHE_LOS_SIZE - 1)];
+    if (entry.generation != m_generation || entry.ignoreM2Model != ignoreM2Model ||
+        entry.src[0] != srcX || entry.src[1] != srcY || entry.src[2] != srcZ ||
+        entry.dest[0] != destX || entry.dest[1] != destY || entry.dest[2] != destZ)
+        return false;
+
+    if (entry.changes != m_changes.size())
+    {
+        Bounds const ray = { { std::min(srcX, destX), std::min(srcY, destY), std::min(srcZ, destZ) },
+                             { std::max(srcX, destX), std::max(srcY, destY), std::max(srcZ, destZ) } };
+        if (IsChanged(entry.changes, ray))
+            return false;
+    }
+
+    ++m_current.losHits;
+    result = entry.result;
+    return true;
+}
+
+void CollisionQueryCache::StoreLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, bool ignoreM2Model, bool result)
+{
+    if (!m_enabled)
+        return;
+
+    if (m_lineOfSight.empty())
+        m_lineOfSight.resize(COLLISION_CACHE_LOS_SIZE, LineOfSightEntry());
+
+    uint32 hash = 0x811C9DC5;
+    hash = HashFloat(hash, srcX); hash = HashFloat(hash, srcY); hash = HashFloat(hash, srcZ);
+    hash = HashFloat(hash, destX); hash = HashFloat(hash, destY); hash = HashFloat(hash, destZ);
+
+    // direct mapped, a colliding query just replaces the older one
+    LineOfSightEntry& entry = m_lineOfSight[(hash + ignoreM2Model) & (COLLISION_CACHE_LOS_SIZE - 1)];
+    entry.src[0] = srcX; entry.src[1] = srcY; entry.src[2] = srcZ;
+    entry.dest[0] = destX; entry.dest[1] = destY; entry.dest[2] = destZ;
+    entry.generation = m_generation;
+    entry.changes = uint16(m_changes.size());
+    entry.ignoreM2Model = ignoreM2Model;
+    entry.result = result;
+}
+
+bool CollisionQueryCache::FindHeight(float x, float y, float z, bool swim, float& height)
+{
+    if (!m_enabled)
+        return false;
+
+    ++m_current.heightQueries;
+    if (m_height.empty())
+        return false;
+
+    uint32 hash = 0x811C9DC5;
+    hash = HashFloat(hash, x); hash = HashFloat(hash, y); hash = HashFloat(hash, z);
+
+    HeightEntry const& entry = m_height[(hash + swim) & (COLLISION_CACHE_HEIGHT_SIZE - 1)];
+    if (entry.generation != m_generation || entry.swim != swim ||
+        entry.pos[0] != x || entry.pos[1] != y || entry.pos[2] != z)
+        return false;
+
+    // the height search runs down from z, any model in the column may have changed the answer
+    if (entry.changes != m_changes.size())
+    {
+        Bounds const column = { { x, y, -FLT_MAX }, { x, y, FLT_MAX } };
+        if (IsChanged(entry.changes, column))
+            return false;
+    }
+
+    ++m_current.heightHits;
+    height = entry.height;
+    return true;
+}
+
+void CollisionQueryCache::StoreHeight(float x, float y, float z, bool swim, float height)
+{
+    if (!m_enabled)
+        return;
+
+    if (m_height.empty())
+        m_height.resize(COLLISION_CACHE_HEIGHT_SIZE, HeightEntry());
+
+    uint32 hash = 0x811C9DC5;
+    hash = HashFloat(hash, x); hash = HashFloat(hash, y); hash = HashFloat(hash, z);
+
+    HeightEntry& entry = m_height[(hash + swim) & (COLLISION_CACHE_HEIGHT_SIZE - 1)];
+    entry.pos[0] = x; entry.pos[1] = y; entry.pos[2] = z;
+    entry.generation = m_generation;
+    entry.changes = uint16(m_changes.size());
+    entry.swim = swim;
+    entry.height = height;
+}
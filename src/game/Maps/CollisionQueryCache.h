@@ -0,0 +1,112 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_COLLISION_QUERY_CACHE_H
+#define MANGOS_COLLISION_QUERY_CACHE_H
+
+#include "Common.h"
+
+#include <vector>
+
+// slots of the direct mapped tables, must be powers of two
+#define COLLISION_CACHE_LOS_SIZE        4096
+#define COLLISION_CACHE_HEIGHT_SIZE     2048
+// changed model bounds kept per tick, more changes within one tick drop the whole cache
+#define COLLISION_CACHE_MAX_CHANGES     64
+
+struct CollisionQueryStats
+{
+    CollisionQueryStats() : losQueries(0), losHits(0), heightQueries(0), heightHits(0) {}
+
+    uint64 losQueries;
+    uint64 losHits;
+    uint64 heightQueries;
+    uint64 heightHits;
+};
+
+// Map local cache of line of sight and height results, valid for one map tick
+// Spell target checks, aggro and movement ask the same questions many times per tick (every effect of an AoE
+// spell, every creature of a pack checking the same player). Positions are compared exactly, so a hit returns
+// the very same answer the vmap and dynamic tree would give. Everything is dropped at the start of each tick
+// and when grids load or unload. A gameobject model that moves or toggles only drops the entries whose ray or
+// height column touches its bounds, transports and elevators relocate their models every update.
+class CollisionQueryCache
+{
+    public:
+        CollisionQueryCache();
+
+        // called at the start of every map tick, rolls the per tick counters and drops all entries
+        void Update();
+
+        // drop all entries, done by bumping the generation instead of clearing the tables
+        void Reset();
+
+        // collision inside the box changed, entries stored earlier whose query touches it are outdated
+        void Invalidate(float minX, float minY, float minZ, float maxX, float maxY, float maxZ);
+
+        bool FindLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, bool ignoreM2Model, bool& result);
+        void StoreLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, bool ignoreM2Model, bool result);
+
+        bool FindHeight(float x, float y, float z, bool swim, float& height);
+        void StoreHeight(float x, float y, float z, bool swim, float height);
+
+        CollisionQueryStats const& GetLastTickStats() const { return m_lastTick; }
+        CollisionQueryStats const& GetTotalStats() const { return m_total; }
+
+    private:
+        struct Bounds
+        {
+            float low[3];
+            float high[3];
+        };
+
+        struct LineOfSightEntry
+        {
+            float src[3];
+            float dest[3];
+            uint32 generation;
+            uint16 changes;                                 // size of m_changes when stored
+            bool ignoreM2Model;
+            bool result;
+        };
+
+        struct HeightEntry
+        {
+            float pos[3];
+            uint32 generation;
+            uint16 changes;
+            bool swim;
+            float height;
+        };
+
+        // a change after the entry was stored overlaps the box
+        bool IsChanged(uint16 since, Bounds const& bounds) const;
+
+        // tables are only allocated once the map asks its first question
+        std::vector<LineOfSightEntry> m_lineOfSight;
+        std::vector<HeightEntry> m_height;
+        uint32 m_generation;
+        std::vector<Bounds> m_changes;                      // model bounds changed within the current generation
+        bool m_enabled;                                     // vmap.enableQueryCache, taken once per tick
+
+        CollisionQueryStats m_current;
+        CollisionQueryStats m_lastTick;
+        CollisionQueryStats m_total;
+};
+
+#endif
@@ -31,17 +31,21 @@
 #include "Globals/ObjectAccessor.h"
 #include "Globals/ObjectMgr.h"
 #include "World/World.h"
+#include "World/TickProfiler.h"
+#include "World/TickTimings.h"
 #include "Groups/Group.h"
 #include "MapRefManager.h"
 #include "Server/DBCEnums.h"
 #include "VMapFactory.h"
+#include "vmap/GameObjectModel.h"
 #include "MotionGenerators/MoveMap.h"
+#include "MotionGenerators/PathCorridorCache.h"
 #include "Chat/Chat.h"
 #include "Weather/Weather.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 
 #ifdef BUILD_METRICS
- #include "Metric/Metric.h"
+ #include "Metric/Registry.h"
 #endif
 
 Map::~Map()
@@ -67,6 +71,9 @@ Map::~Map()
     delete m_weatherSystem;
     m_weatherSystem = nullptr;
 
+    delete m_pathCorridorCache;
+    m_pathCorridorCache = nullptr;
+
     for (auto m_Transport : m_transports)
         delete m_Transport;
 }
@@ -136,7 +143,10 @@ void Map::LoadMapAndVMap(int gx, int gy)
         return;
 
     if (m_TerrainData->Load(gx, gy))
+    {
         m_bLoadedGrids[gx][gy] = true;
+        m_collisionQueryCache.Reset();
+    }
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
@@ -149,6 +159,15 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
       m_variableManager(this)
 {
     m_weatherSystem = new WeatherSystem(this);
+    m_pathCorridorCache = new PathCorridorCache;
+
+#ifdef BUILD_METRICS
+    metric::tag_list const tags = { { "map_id", std::to_string(id) } };
+    m_updateTimeMetric = &metric::registry::instance().get_histogram("map.update", tags);
+    m_sessionUpdateTimeMetric = &metric::registry::instance().get_histogram("map.update.session", tags);
+    m_updatedObjectsMetric = &metric::registry::instance().get_counter("map.update.objects", tags);
+    m_updatedSessionsMetric = &metric::registry::instance().get_counter("map.update.sessions", tags);
+#endif
 }
 
 void Map::Initialize(bool loadInstanceData /*= true*/)
@@ -654,19 +673,36 @@ void Map::Update(const uint32& t_diff)
 {
 
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::milliseconds> meas("map.update", {
-        { "map_id", std::to_string(i_id) },
-        { "instance_id", std::to_string(i_InstanceId) }
-});
+    metric::scoped_timer meas(*m_updateTimeMetric);
 #endif
 
 
     uint64 count = 0;
 
-    m_dyn_tree.update(t_diff);
+    {
+        TICK_PROFILE_ZONE("dynamic tree");
+        m_dyn_tree.update(t_diff);
+        m_pathCorridorCache->Update(GetCurrentMSTime());
+        m_collisionQueryCache.Update();
+    }
 
-    GetMessager().Execute(this);
-    m_spawnManager.Update();
+    {
+        TICK_PROFILE_ZONE("messager");
+        GetMessager().Execute(this);
+    }
+
+    // game event spawns and despawns
+    if (GetMessager().GetDeferredCount())
+    {
+        TICK_PROFILE_ZONE("deferred messages");
+        if (!GetMessager().ExecuteDeferred(this, sWorld.getConfig(CONFIG_UINT32_MAP_DEFERRED_MESSAGES_PER_TICK)))
+            DETAIL_LOG("Map %u instance %u applied all deferred game event changes", GetId(), GetInstanceId());
+    }
+
+    {
+        TICK_PROFILE_ZONE("spawn manager");
+        m_spawnManager.Update();
+    }
 
     /// update active cells around players and active objects
     resetMarkedCells();
@@ -676,22 +712,23 @@ void Map::Update(const uint32& t_diff)
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
 
-    for (m_transportsIterator = m_transports.begin(); m_transportsIterator != m_transports.end();)
     {
-        Transport* transport = *m_transportsIterator;
-        ++m_transportsIterator;
-        transport->Update(t_diff);
+        TICK_PROFILE_ZONE("transports");
+        for (m_transportsIterator = m_transports.begin(); m_transportsIterator != m_transports.end();)
+        {
+            Transport* transport = *m_transportsIterator;
+            ++m_transportsIterator;
+            transport->Update(t_diff);
+        }
     }
 
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
     {
+        TickPhaseScope sessionPhase(TICK_PHASE_MAP_SESSIONS, "sessions");
 #ifdef BUILD_METRICS
         uint32 updatedSessions = 0;
-        metric::duration<std::chrono::milliseconds> sessions_meas("map.update.session", {
-            { "map_id", std::to_string(i_id) },
-            { "instance_id", std::to_string(i_InstanceId) },
-            });
+        metric::scoped_timer sessions_meas(*m_sessionUpdateTimeMetric);
 #endif
 
         for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -708,34 +745,47 @@ void Map::Update(const uint32& t_diff)
 #endif
         }
 #ifdef BUILD_METRICS
-        sessions_meas.add_field("count", std::to_string(static_cast<int32>(updatedSessions)));
+        m_updatedSessionsMetric->add(updatedSessions);
 #endif
     }
 
+    // movement handled by the sessions, also the one handled in World::UpdateSessions
+    {
+        TICK_PROFILE_ZONE("movement relay");
+        m_movementRelay.Flush(this);
+    }
+
     /// update players at tick
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
-        Player* plr = m_mapRefIter->getSource();
-        if (plr && plr->IsInWorld())
-            plr->Update(t_diff);
+        TICK_PROFILE_ZONE("players");
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* plr = m_mapRefIter->getSource();
+            if (plr && plr->IsInWorld())
+                plr->Update(t_diff);
+        }
     }
 
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
-        Player* player = m_mapRefIter->getSource();
-        if (!player->IsInWorld() || !player->IsPositionValid())
-            continue;
+        TICK_PROFILE_ZONE("visit nearby cells");
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* player = m_mapRefIter->getSource();
+            if (!player->IsInWorld() || !player->IsPositionValid())
+                continue;
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+            VisitNearbyCellsOf(player, grid_object_update, world_object_update);
 
-        // If player is using far sight, visit that object too
-        if (WorldObject* viewPoint = GetWorldObject(player->GetFarSightGuid()))
-            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+            // If player is using far sight, visit that object too
+            if (WorldObject* viewPoint = GetWorldObject(player->GetFarSightGuid()))
+                VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+        }
     }
 
     // non-player active objects
     if (!m_activeNonPlayers.empty())
     {
+        TICK_PROFILE_ZONE("active objects");
         for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
         {
             // skip not in world
@@ -775,14 +825,17 @@ void Map::Update(const uint32& t_diff)
     }
 
     // update all objects
-    for (auto wObj : objToUpdate)
     {
-        wObj->Update(t_diff);
-        ++count;
+        TICK_PROFILE_ZONE("objects");
+        for (auto wObj : objToUpdate)
+        {
+            wObj->Update(t_diff);
+            ++count;
+        }
     }
 
 #ifdef BUILD_METRICS
-    meas.add_field("count", std::to_string(static_cast<int32>(count)));
+    m_updatedObjectsMetric->add(int64(count));
 #endif
 
     // Send world objects and item update field changes
@@ -792,6 +845,7 @@ void Map::Update(const uint32& t_diff)
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (!IsBattleGround())
     {
+        TICK_PROFILE_ZONE("grid states");
         for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
         {
             NGridType* grid = i->getSource();
@@ -804,12 +858,21 @@ void Map::Update(const uint32& t_diff)
 
     ///- Process necessary scripts
     if (!m_scriptSchedule.empty())
+    {
+        TICK_PROFILE_ZONE("scripts");
         ScriptsProcess();
+    }
 
     if (i_data)
+    {
+        TICK_PROFILE_ZONE("instance data");
         i_data->Update(t_diff);
+    }
 
-    m_weatherSystem->UpdateWeathers(t_diff);
+    {
+        TICK_PROFILE_ZONE("weather");
+        m_weatherSystem->UpdateWeathers(t_diff);
+    }
 }
 
 void Map::Remove(Player* player, bool remove)
@@ -1082,6 +1145,7 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
     {
         m_bLoadedGrids[gx][gy] = false;
         m_TerrainData->Unload(gx, gy);
+        m_collisionQueryCache.Reset();
     }
 
     DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Unloading grid[%u,%u] for map %u finished", x, y, i_id);
@@ -1090,6 +1154,14 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
 
 void Map::UnloadAll(bool pForce)
 {
+    // pool changes are kept by the persistent state, but the spawns they bring are not created in the unloading map
+    if (m_persistentState && GetMessager().GetDeferredCount())
+    {
+        m_persistentState->DetachMapForUnload();
+        GetMessager().ExecuteDeferred(this, 0);
+        m_persistentState->SetUsedByMapState(this);
+    }
+
     for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
     {
         NGridType& grid(*i->getSource());
@@ -1105,6 +1177,7 @@ const char* Map::GetMapName() const
 
 void Map::UpdateObjectVisibility(WorldObject* obj, Cell cell, const CellPair& cellpair)
 {
+    TickPhaseScope visibilityPhase(TICK_PHASE_VISIBILITY, "object visibility");
     cell.SetNoCreate();
     MaNGOS::VisibleChangesNotifier notifier(*obj);
     TypeContainerVisitor<MaNGOS::VisibleChangesNotifier, WorldTypeMapContainer > player_notifier(notifier);
@@ -2026,6 +2099,25 @@ void Map::ScriptsProcess()
     }
 }
 
+void Map::RelayMovement(WorldObject const* mover, WorldPacket const& data, Player const* skipped_receiver)
+{
+    // only heartbeats wait for the flush, other opcodes start or end a movement and must not fall behind packets
+    // sent directly about the mover, like a spell start
+    if (sWorld.getConfig(CONFIG_BOOL_MOVEMENT_RELAY_BATCH) && data.GetOpcode() == MSG_MOVE_HEARTBEAT)
+        m_movementRelay.Queue(mover, data, skipped_receiver);
+    else
+    {
+        DropRelayedMovement(mover);
+        mover->SendMessageToSetExcept(data, skipped_receiver);
+    }
+}
+
+void Map::DropRelayedMovement(WorldObject const* mover)
+{
+    if (sWorld.getConfig(CONFIG_BOOL_MOVEMENT_RELAY_BATCH))
+        m_movementRelay.Drop(mover);
+}
+
 /**
  * Function return player that in world at CURRENT map
  *
@@ -2154,6 +2246,7 @@ WorldObject* Map::GetWorldObject(ObjectGuid guid)
 
 void Map::SendObjectUpdates()
 {
+    TickPhaseScope serializationPhase(TICK_PHASE_SERIALIZATION, "send object updates");
     UpdateDataMapType update_players;
 
     while (!i_objectsToClientUpdate.empty())
@@ -2337,8 +2430,15 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, bool ignoreM2Model) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model);
+    bool result;
+    if (m_collisionQueryCache.FindLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model, result))
+        return result;
+
+    result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model)
+             && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model);
+
+    m_collisionQueryCache.StoreLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model, result);
+    return result;
 }
 
 /**
@@ -2427,21 +2527,36 @@ bool Map::GetHeightInRange(float x, float y, float& z, float maxSearchDist /*= 4
 
 float Map::GetHeight(float x, float y, float z, bool swim) const
 {
+    float height;
+    if (m_collisionQueryCache.FindHeight(x, y, z, swim, height))
+        return height;
+
     float staticHeight = m_TerrainData->GetHeightStatic(x, y, z, true, (swim ? DEFAULT_WATER_SEARCH : DEFAULT_HEIGHT_SEARCH));
 
     // Get Dynamic Height around static Height (if valid)
     float dynSearchHeight = 2.0f + (z < staticHeight ? staticHeight : z);
-    return std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight));
+    height = std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight));
+
+    m_collisionQueryCache.StoreHeight(x, y, z, swim, height);
+    return height;
 }
 
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.insert(mdl);
+    InvalidateCollisionQueries(mdl);
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.remove(mdl);
+    InvalidateCollisionQueries(mdl);
+}
+
+void Map::InvalidateCollisionQueries(const GameObjectModel& mdl)
+{
+    G3D::AABox const& bounds = mdl.getBounds();
+    m_collisionQueryCache.Invalidate(bounds.low().x, bounds.low().y, bounds.low().z, bounds.high().x, bounds.high().y, bounds.high().z);
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
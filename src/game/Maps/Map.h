@@ -39,6 +39,8 @@
 #include "Maps/SpawnManager.h"
 #include "Maps/MapDataContainer.h"
 #include "World/WorldStateVariableManager.h"
+#include "Maps/CollisionQueryCache.h"
+#include "Maps/MovementRelay.h"
 
 #include <bitset>
 #include <functional>
@@ -59,6 +61,7 @@ class BattleGround;
 class GridMap;
 class GameObjectModel;
 class WeatherSystem;
+class PathCorridorCache;
 class GenericTransport;
 namespace MaNGOS { struct ObjectUpdater; }
 class Transport;
@@ -100,6 +103,14 @@ struct WorldTemplate
 
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 
+#ifdef BUILD_METRICS
+namespace metric
+{
+    class counter;
+    class histogram;
+}
+#endif
+
 class Map : public GridRefManager<NGridType>
 {
         friend class MapReference;
@@ -303,6 +314,15 @@ class Map : public GridRefManager<NGridType>
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        // collision of the model changed within the tick, cached line of sight and height results around it are outdated
+        void InvalidateCollisionQueries(const GameObjectModel& mdl);
+        CollisionQueryCache const& GetCollisionQueryCache() const { return m_collisionQueryCache; }
+
+        // sends movement of mover to everyone seeing it, heartbeats are batched until the next map update when enabled
+        void RelayMovement(WorldObject const* mover, WorldPacket const& data, Player const* skipped_receiver);
+        // movement of mover was just sent directly, what it still has batched is older and must not follow
+        void DropRelayedMovement(WorldObject const* mover);
+        MovementRelay const& GetMovementRelay() const { return m_movementRelay; }
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
@@ -358,6 +378,8 @@ class Map : public GridRefManager<NGridType>
         WorldStateVariableManager& GetVariableManager() { return m_variableManager; }
         WorldStateVariableManager const& GetVariableManager() const { return m_variableManager; }
 
+        PathCorridorCache& GetPathCorridorCache() { return *m_pathCorridorCache; }
+
         // debug
         std::set<ObjectGuid> m_objRemoveList; // this will eventually eat up too much memory - only used for debugging VisibleNotifier::Notify() customlog leak
 
@@ -476,6 +498,18 @@ class Map : public GridRefManager<NGridType>
         std::shared_ptr<CreatureSpellListContainer> m_spellListContainer;
 
         WorldStateVariableManager m_variableManager;
+
+        PathCorridorCache* m_pathCorridorCache;
+        mutable CollisionQueryCache m_collisionQueryCache;
+        MovementRelay m_movementRelay;
+
+#ifdef BUILD_METRICS
+        // shared by all instances of the map
+        metric::histogram* m_updateTimeMetric;
+        metric::histogram* m_sessionUpdateTimeMetric;
+        metric::counter* m_updatedObjectsMetric;
+        metric::counter* m_updatedSessionsMetric;
+#endif
 };
 
 class WorldMap : public Map
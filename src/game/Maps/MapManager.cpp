@@ -198,7 +198,10 @@ void MapManager::Update(uint32 diff)
         if (m_updater.activated())
             m_updater.schedule_update(new MapUpdateWorker(*map.second, (uint32)i_timer.GetCurrent(), m_updater));
         else
+        {
+            TickProfileFrame frame(map.second->GetId(), map.second->GetInstanceId(), (uint32)i_timer.GetCurrent());
             map.second->Update((uint32)i_timer.GetCurrent());
+        }
     }
 
     if (m_updater.activated())
@@ -224,6 +227,14 @@ void MapManager::Update(uint32 diff)
     i_timer.SetCurrent(0);
 }
 
+size_t MapManager::GetDeferredMessageCount()
+{
+    size_t count = 0;
+    for (auto& map : i_maps)
+        count += map.second->GetMessager().GetDeferredCount();
+    return count;
+}
+
 void MapManager::RemoveAllObjectsInRemoveList()
 {
     for (auto& i_map : i_maps)
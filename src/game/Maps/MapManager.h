@@ -156,6 +156,9 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
             }
         }
         template<typename Do> void DoForAllMapsWithMapId(uint32 mapId, Do& _do);
+        // queues a copy of _do to each map, they apply it within their budget of deferred messages per tick
+        template<typename Do> void DeferForAllMapsWithMapId(uint32 mapId, Do const& _do);
+        size_t GetDeferredMessageCount();
         template<typename Check> inline WorldObject* SearchOnAllLoadedMap(Check& check);
         void DoForAllMaps(const std::function<void(Map*)>& worker);
         void DoForAllMapsWithMapId(uint32 mapId, std::function<void(Map*)> worker);
@@ -199,6 +202,15 @@ inline void MapManager::DoForAllMapsWithMapId(uint32 mapId, Do& _do)
         _do(itr->second);
 }
 
+template<typename Do>
+inline void MapManager::DeferForAllMapsWithMapId(uint32 mapId, Do const& _do)
+{
+    MapMapType::const_iterator start = i_maps.lower_bound(MapID(mapId, 0));
+    MapMapType::const_iterator end   = i_maps.lower_bound(MapID(mapId + 1, 0));
+    for (MapMapType::const_iterator itr = start; itr != end; ++itr)
+        itr->second->GetMessager().AddDeferredMessage(_do);
+}
+
 template<typename Check>
 inline WorldObject* MapManager::SearchOnAllLoadedMap(Check& check)
 {
@@ -80,6 +80,8 @@ class MapPersistentState
             if (!map)
                 UnloadIfEmpty();
         }
+        // pool changes applied while detached only update the state, without spawning into the map
+        void DetachMapForUnload() { m_usedByMap = nullptr; }
 
         time_t GetCreatureRespawnTime(uint32 loguid) const
         {
@@ -18,6 +18,7 @@
 
 #include "MapUpdater.h"
 #include "MapWorkers.h"
+#include "Multithreading/EpochReclaimer.h"
 
 MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0)
 {
@@ -93,7 +94,11 @@ void MapUpdater::WorkerThread()
             return;
         }
 
-        request->execute();
+        {
+            // tables replaced by a reload meanwhile are freed only after this update
+            EpochReader reader(sEpochReclaimer);
+            request->execute();
+        }
 
         delete request;
     }
@@ -25,6 +25,7 @@
 #include "MotionGenerators/MovementGenerator.h"
 #include "Entities/Object.h"
 #include "Platform/Define.h"
+#include "World/TickProfiler.h"
 
 class Worker
 {
@@ -48,7 +49,10 @@ class MapUpdateWorker : public Worker
 
         void execute() override
         {
-            m_map.Update(m_diff);
+            {
+                TickProfileFrame frame(m_map.GetId(), m_map.GetInstanceId(), m_diff);
+                m_map.Update(m_diff);
+            }
             GetWorker().update_finished();
         }
 
@@ -0,0 +1,158 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MovementRelay.h"
+#include "Maps/Map.h"
+#include "Entities/Player.h"
+#include "Server/WorldSession.h"
+#include "World/World.h"
+
+#include <algorithm>
+
+MovementRelay::MovementRelay() : m_lastDistantCleanup(0)
+{
+}
+
+void MovementRelay::Queue(WorldObject const* mover, WorldPacket const& data, Player const* skipped_receiver)
+{
+    ObjectGuid const moverGuid = mover->GetObjectGuid();
+
+    std::lock_guard<std::mutex> guard(m_queueLock);
+    ++m_total.queued;
+
+    // a heartbeat only carries the latest position, an older one nobody has received yet is of no use
+    auto itr = m_pendingHeartbeats.find(moverGuid.GetRawValue());
+    if (itr != m_pendingHeartbeats.end())
+    {
+        m_queue[itr->second].mover.Clear();                 // skipped by Flush
+        itr->second = m_queue.size();
+        ++m_total.coalesced;
+    }
+    else
+        m_pendingHeartbeats[moverGuid.GetRawValue()] = m_queue.size();
+
+    m_queue.push_back({ moverGuid, skipped_receiver ? skipped_receiver->GetObjectGuid() : ObjectGuid(), data, nullptr });
+}
+
+void MovementRelay::Drop(WorldObject const* mover)
+{
+    std::lock_guard<std::mutex> guard(m_queueLock);
+    auto itr = m_pendingHeartbeats.find(mover->GetObjectGuid().GetRawValue());
+    if (itr == m_pendingHeartbeats.end())
+        return;
+
+    m_queue[itr->second].mover.Clear();                     // skipped by Flush
+    m_pendingHeartbeats.erase(itr);
+}
+
+void MovementRelay::Flush(Map* map)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        if (m_queue.empty())
+            return;
+
+        std::swap(m_sending, m_queue);
+        m_pendingHeartbeats.clear();
+    }
+
+    float const distantRange = sWorld.getConfig(CONFIG_FLOAT_MOVEMENT_RELAY_LOD_DISTANCE);
+    uint32 const distantInterval = sWorld.getConfig(CONFIG_UINT32_MOVEMENT_RELAY_LOD_INTERVAL);
+    uint32 const now = map->GetCurrentMSTime();
+
+    // heartbeats a mover may not send to distant observers this time are marked by the highest bit of the index
+    uint32 const throttledFlag = 0x80000000;
+
+    m_deliveries.clear();
+    for (uint32 i = 0; i < m_sending.size(); ++i)
+    {
+        Relay& relay = m_sending[i];
+        if (relay.mover.IsEmpty())                          // dropped or replaced by a newer heartbeat
+            continue;
+
+        WorldObject* mover = map->GetWorldObject(relay.mover);
+        if (!mover || !mover->IsInWorld())                  // left the map since queued, its new observers get a create
+            continue;
+
+        relay.object = mover;
+
+        uint32 index = i;
+        if (distantRange > 0.0f && relay.data.GetOpcode() == MSG_MOVE_HEARTBEAT)
+        {
+            uint32& lastSent = m_lastDistantHeartbeat[relay.mover.GetRawValue()];
+            if (lastSent && WorldTimer::getMSTimeDiff(lastSent, now) < distantInterval)
+                index |= throttledFlag;
+            else
+                lastSent = now;
+        }
+
+        for (ObjectGuid const& receiver : mover->GetClientGuidsIAmAt())
+            if (receiver != relay.skipped)
+                m_deliveries.push_back({ receiver, index });
+
+        // the client of a player moved by someone else gets the movement too
+        if (mover->GetTypeId() == TYPEID_PLAYER && mover->GetObjectGuid() != relay.skipped)
+            m_deliveries.push_back({ mover->GetObjectGuid(), index });
+    }
+
+    // one lookup per receiver, queue order kept among its packets
+    std::stable_sort(m_deliveries.begin(), m_deliveries.end(), [](std::pair<ObjectGuid, uint32> const& left, std::pair<ObjectGuid, uint32> const& right)
+    {
+        return left.first < right.first;
+    });
+
+    for (size_t i = 0; i < m_deliveries.size();)
+    {
+        ObjectGuid const receiverGuid = m_deliveries[i].first;
+        Player* receiver = map->GetPlayer(receiverGuid);
+        WorldSession* session = receiver ? receiver->GetSession() : nullptr;
+        WorldObject const* eye = receiver ? receiver->GetCamera().GetBody() : nullptr;
+
+        for (; i < m_deliveries.size() && m_deliveries[i].first == receiverGuid; ++i)
+        {
+            if (!session)
+                continue;
+
+            uint32 const index = m_deliveries[i].second;
+            Relay const& relay = m_sending[index & ~throttledFlag];
+            if ((index & throttledFlag) && eye && !eye->IsWithinDist(relay.object, distantRange))
+            {
+                ++m_total.throttled;
+                continue;
+            }
+
+            session->SendPacket(relay.data);
+            ++m_total.sent;
+        }
+    }
+
+    m_sending.clear();
+
+    // forget movers which stopped moving or left
+    if (!m_lastDistantHeartbeat.empty() && WorldTimer::getMSTimeDiff(m_lastDistantCleanup, now) >= MINUTE * IN_MILLISECONDS)
+    {
+        for (auto itr = m_lastDistantHeartbeat.begin(); itr != m_lastDistantHeartbeat.end();)
+        {
+            if (WorldTimer::getMSTimeDiff(itr->second, now) > 10 * distantInterval)
+                itr = m_lastDistantHeartbeat.erase(itr);
+            else
+                ++itr;
+        }
+        m_lastDistantCleanup = now;
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MOVEMENT_RELAY_H
+#define MANGOS_MOVEMENT_RELAY_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+#include "Server/WorldPacket.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class Map;
+class Player;
+class WorldObject;
+
+struct MovementRelayStats
+{
+    MovementRelayStats() : queued(0), coalesced(0), sent(0), throttled(0) {}
+
+    uint64 queued;                                          // packets handed to the relay
+    uint64 coalesced;                                       // heartbeats replaced by a newer one of the same mover
+    uint64 sent;                                            // packets written to sessions
+    uint64 throttled;                                       // heartbeats held back from distant observers
+};
+
+// Map local queue of the movement heartbeats players relay to everyone seeing the mover
+// Instead of walking the grid for every heartbeat, the heartbeats of a tick are collected and sent once per map update
+// to the players that have the mover at their client, grouped by receiver. A heartbeat of a mover still waiting in the
+// queue is replaced by the newer one. Every other movement opcode is sent at once and drops the waiting heartbeat, so
+// nothing older follows it. Optionally, observers further away than a configured distance get the heartbeats of a
+// mover at a reduced rate.
+class MovementRelay
+{
+    public:
+        MovementRelay();
+
+        // queue a heartbeat for everyone who has mover at client except skipped_receiver, may be called from the world thread
+        void Queue(WorldObject const* mover, WorldPacket const& data, Player const* skipped_receiver);
+
+        // forget the heartbeat mover has queued, a newer movement of it was sent past the relay
+        void Drop(WorldObject const* mover);
+
+        // send all queued packets, called from the map update
+        void Flush(Map* map);
+
+        MovementRelayStats const& GetTotalStats() const { return m_total; }
+
+    private:
+        struct Relay
+        {
+            ObjectGuid mover;
+            ObjectGuid skipped;
+            WorldPacket data;
+            WorldObject const* object;                      // resolved by Flush
+        };
+
+        std::mutex m_queueLock;
+        std::vector<Relay> m_queue;
+        std::unordered_map<uint64, size_t> m_pendingHeartbeats;     // mover -> its heartbeat in m_queue
+
+        // reused by Flush
+        std::vector<Relay> m_sending;
+        std::vector<std::pair<ObjectGuid, uint32>> m_deliveries;     // receiver, relay index
+
+        std::unordered_map<uint64, uint32> m_lastDistantHeartbeat;   // mover -> time its heartbeat went to distant observers
+        uint32 m_lastDistantCleanup;
+
+        MovementRelayStats m_total;
+};
+
+#endif
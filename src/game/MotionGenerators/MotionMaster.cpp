@@ -38,7 +38,7 @@
 #include "Log.h"
 
 #ifdef BUILD_METRICS
- #include "Metric/Metric.h"
+ #include "Metric/Registry.h"
 #endif
 
 #include <cassert>
@@ -51,13 +51,8 @@ inline bool isStatic(MovementGenerator* mv)
 void MotionMaster::Initialize()
 {
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("motionmaster.initialize", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
-    }, 1000);
+    static metric::histogram_set s_initializeTime("motionmaster.initialize", "unit_type", { "creature", "player" });
+    metric::scoped_timer meas(s_initializeTime[m_owner->IsPlayer()]);
 #endif
     // stop current move
     m_owner->StopMoving();
@@ -109,13 +104,8 @@ void MotionMaster::UpdateMotion(uint32 diff)
     if (m_owner->hasUnitState(UNIT_STAT_CAN_NOT_MOVE))
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("motionmaster.updatemotion", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
-    }, 1000);
+    static metric::histogram_set s_updateTime("motionmaster.updatemotion", "unit_type", { "creature", "player" });
+    metric::scoped_timer meas(s_updateTime[m_owner->IsPlayer()]);
 #endif
 
     MANGOS_ASSERT(!empty());
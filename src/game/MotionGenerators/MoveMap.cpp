@@ -22,8 +22,84 @@
 #include "MoveMap.h"
 #include "MoveMapSharedDefines.h"
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
 namespace MMAP
 {
+    // ######################## MMapTileFile ########################
+    // mmtile file mapped copy on write, detour hands out pointers into it instead of a heap copy
+    // Adding a tile writes the polygon links, dtPoly::firstLink of every polygon and the start vertices of
+    // off-mesh connections, so only the pages holding those become private copies. The other vertex, detail
+    // mesh and bv tree pages stay clean and are shared with the page cache (and every other process mapping
+    // the same file).
+    static_assert(sizeof(MmapTileHeader) % sizeof(uint64) == 0, "mapped tile data must stay 8 byte aligned");
+
+    class MMapTileFile
+    {
+        public:
+            // nullptr if there is no such file, most grids have no tile
+            static std::unique_ptr<MMapTileFile> Open(char const* fileName)
+            {
+                std::unique_ptr<MMapTileFile> tileFile(new MMapTileFile());
+                try
+                {
+                    boost::interprocess::file_mapping mapping(fileName, boost::interprocess::read_only);
+                    boost::interprocess::mapped_region(mapping, boost::interprocess::copy_on_write).swap(tileFile->m_region);
+                }
+                catch (boost::interprocess::interprocess_exception const& e)
+                {
+                    if (e.get_error_code() != boost::interprocess::not_found_error)
+                        sLog.outError("MMAP: Could not map mmtile file '%s': %s", fileName, e.what());
+                    return nullptr;
+                }
+
+                return tileFile;
+            }
+
+            // a whole header is present and the data it announces fits into the file
+            bool HasHeader() const { return m_region.get_size() >= sizeof(MmapTileHeader); }
+            bool HasData() const { return m_region.get_size() - sizeof(MmapTileHeader) >= GetHeader().size; }
+
+            MmapTileHeader const& GetHeader() const { return *static_cast<MmapTileHeader const*>(m_region.get_address()); }
+            unsigned char* GetData() const { return static_cast<unsigned char*>(m_region.get_address()) + sizeof(MmapTileHeader); }
+
+        private:
+            MMapTileFile() {}
+
+            boost::interprocess::mapped_region m_region;
+    };
+
+    MMapData::MMapData(dtNavMesh* mesh) : navMesh(mesh)
+    {
+    }
+
+    MMapData::~MMapData()
+    {
+        for (auto& navMeshQuerie : navMeshQueries)
+            dtFreeNavMeshQuery(navMeshQuerie.second);
+
+        for (auto& navMeshQuerie : navMeshThreadQueries)
+            dtFreeNavMeshQuery(navMeshQuerie.second);
+
+        // tiles point into mmapTileFiles, those are unmapped after the navmesh is gone
+        if (navMesh)
+            dtFreeNavMesh(navMesh);
+    }
+
+    MMapGOData::MMapGOData(dtNavMesh* mesh, std::unique_ptr<MMapTileFile> tileFile) : navMesh(mesh), file(std::move(tileFile))
+    {
+    }
+
+    MMapGOData::~MMapGOData()
+    {
+        for (auto& navMeshQuerie : navMeshGOQueries)
+            dtFreeNavMeshQuery(navMeshQuerie.second);
+
+        if (navMesh)
+            dtFreeNavMesh(navMesh);
+    }
+
     // ######################## MMapFactory ########################
     // our global singelton copy
     MMapManager* g_MMapManager = nullptr;
@@ -196,6 +272,8 @@ namespace MMAP
 
     bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
     {
+        std::unique_lock<std::shared_mutex> lock(m_navMeshLock);
+
         // make sure the mmap is loaded and ready to load tiles
         if (!loadMapData(mapId))
             return false;
@@ -217,8 +295,8 @@ namespace MMAP
         char* fileName = new char[pathLen];
         snprintf(fileName, pathLen, (sWorld.GetDataPath() + "mmaps/%03i%02i%02i.mmtile").c_str(), mapId, x, y);
 
-        FILE* file = fopen(fileName, "rb");
-        if (!file)
+        std::unique_ptr<MMapTileFile> tileFile = MMapTileFile::Open(fileName);
+        if (!tileFile)
         {
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "ERROR: MMAP:loadMap: Could not open mmtile file '%s'", fileName);
             delete[] fileName;
@@ -226,50 +304,40 @@ namespace MMAP
         }
         delete[] fileName;
 
-        // read header
-        MmapTileHeader fileHeader;
-        fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
-
-        if (fileHeader.mmapMagic != MMAP_MAGIC)
+        // check header
+        if (!tileFile->HasHeader() || tileFile->GetHeader().mmapMagic != MMAP_MAGIC)
         {
             sLog.outError("MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
-            fclose(file);
             return false;
         }
 
+        MmapTileHeader const& fileHeader = tileFile->GetHeader();
         if (fileHeader.mmapVersion != MMAP_VERSION)
         {
             sLog.outError("MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
                           mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
-            fclose(file);
             return false;
         }
 
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        MANGOS_ASSERT(data);
-
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
+        if (!tileFile->HasData())
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
-            fclose(file);
             return false;
         }
 
-        fclose(file);
-
+        unsigned char* data = tileFile->GetData();
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
-        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        // data stays owned by the mapped file, it is unmapped after the tile is removed
+        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, 0, 0, &tileRef);
         if (dtStatusFailed(dtResult))
         {
             sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
             return false;
         }
 
+        mmap->mmapTileFiles[packedGridPos] = std::move(tileFile);
         mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
         ++loadedTiles;
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
@@ -293,47 +361,40 @@ namespace MMAP
         char* fileName = new char[pathLen];
         snprintf(fileName, pathLen, (sWorld.GetDataPath() + "mmaps/go%04i.mmtile").c_str(), displayId);
 
-        FILE* file = fopen(fileName, "rb");
-        if (!file)
+        std::unique_ptr<MMapTileFile> tileFile = MMapTileFile::Open(fileName);
+        if (!tileFile)
         {
             DEBUG_LOG("MMAP:loadGameObject: Error: Could not open mmap file %s", fileName);
             delete[] fileName;
             return false;
         }
 
-        MmapTileHeader fileHeader;
-        fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
-
-        if (fileHeader.mmapMagic != MMAP_MAGIC)
+        if (!tileFile->HasHeader() || tileFile->GetHeader().mmapMagic != MMAP_MAGIC)
         {
             sLog.outError("MMAP:loadGameObject: Bad header in mmap %s", fileName);
-            fclose(file);
+            delete[] fileName;
             return false;
         }
 
+        MmapTileHeader const& fileHeader = tileFile->GetHeader();
         if (fileHeader.mmapVersion != MMAP_VERSION)
         {
             sLog.outError("MMAP:loadGameObject: %s was built with generator v%i, expected v%i",
                 fileName, fileHeader.mmapVersion, MMAP_VERSION);
-            fclose(file);
+            delete[] fileName;
             return false;
         }
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        MANGOS_ASSERT(data);
 
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
+        if (!tileFile->HasData())
         {
             sLog.outError("MMAP:loadGameObject: Bad header or data in mmap %s", fileName);
-            fclose(file);
+            delete[] fileName;
             return false;
         }
 
-        fclose(file);
-
         dtNavMesh* mesh = dtAllocNavMesh();
         MANGOS_ASSERT(mesh);
-        dtStatus r = mesh->init(data, fileHeader.size, DT_TILE_FREE_DATA);
+        dtStatus r = mesh->init(tileFile->GetData(), fileHeader.size, 0);
         if (dtStatusFailed(r))
         {
             dtFreeNavMesh(mesh);
@@ -344,13 +405,15 @@ namespace MMAP
         DETAIL_LOG("MMAP:loadGameObject: Loaded file %s [size=%u]", fileName, fileHeader.size);
         delete[] fileName;
 
-        MMapGOData* mmap_data = new MMapGOData(mesh);
+        MMapGOData* mmap_data = new MMapGOData(mesh, std::move(tileFile));
         m_loadedModels.insert(std::pair<uint32, MMapGOData*>(displayId, mmap_data));
         return true;
     }
 
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
+        std::unique_lock<std::shared_mutex> lock(m_navMeshLock);
+
         // check if we have this map loaded
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
@@ -385,6 +448,7 @@ namespace MMAP
         else
         {
             mmap->mmapLoadedTiles.erase(packedGridPos);
+            mmap->mmapTileFiles.erase(packedGridPos);
             --loadedTiles;
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
             return true;
@@ -395,6 +459,8 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
+        std::unique_lock<std::shared_mutex> lock(m_navMeshLock);
+
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
             // file may not exist, therefore not loaded
@@ -427,6 +493,9 @@ namespace MMAP
 
     bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
     {
+        std::shared_lock<std::shared_mutex> lock(m_navMeshLock);
+        std::lock_guard<std::mutex> guard(m_queriesMutex);
+
         // check if we have this map loaded
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
@@ -453,6 +522,8 @@ namespace MMAP
 
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
+        std::shared_lock<std::shared_mutex> lock(m_navMeshLock);
+
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
             return nullptr;
 
@@ -469,6 +540,10 @@ namespace MMAP
 
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
     {
+        std::shared_lock<std::shared_mutex> lock(m_navMeshLock);
+        // instances of the same map are updated in parallel
+        std::lock_guard<std::mutex> guard(m_queriesMutex);
+
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
             return nullptr;
 
@@ -493,6 +568,37 @@ namespace MMAP
         return mmap->navMeshQueries[instanceId];
     }
 
+    dtNavMeshQuery const* MMapManager::GetThreadNavMeshQuery(uint32 mapId)
+    {
+        auto mmapItr = loadedMMaps.find(mapId);
+        if (mmapItr == loadedMMaps.end())
+            return nullptr;
+
+        auto threadId = std::this_thread::get_id();
+        MMapData* mmap = mmapItr->second;
+
+        std::lock_guard<std::mutex> guard(m_queriesMutex);
+        auto queryItr = mmap->navMeshThreadQueries.find(threadId);
+        if (queryItr != mmap->navMeshThreadQueries.end())
+            return queryItr->second;
+
+        // allocate mesh query
+        std::stringstream ss;
+        ss << threadId;
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:GetThreadNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u tid %s", mapId, ss.str().data());
+            return nullptr;
+        }
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetThreadNavMeshQuery: created dtNavMeshQuery for mapId %03u tid %s", mapId, ss.str().data());
+        mmap->navMeshThreadQueries.emplace(threadId, query);
+        return query;
+    }
+
     dtNavMeshQuery const* MMapManager::GetModelNavMeshQuery(uint32 displayId)
     {
         if (m_loadedModels.find(displayId) == m_loadedModels.end())
@@ -23,7 +23,10 @@
 #include <Detour/Include/DetourAlloc.h>
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
 
 class Unit;
 
@@ -45,39 +48,31 @@ namespace MMAP
     typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
     typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshGOQuerySet;
 
+    class MMapTileFile;
+    typedef std::unordered_map<uint32, std::unique_ptr<MMapTileFile>> MMapTileFileSet;
+
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
-        ~MMapData()
-        {
-            for (auto& navMeshQuerie : navMeshQueries)
-                dtFreeNavMeshQuery(navMeshQuerie.second);
-
-            if (navMesh)
-                dtFreeNavMesh(navMesh);
-        }
+        MMapData(dtNavMesh* mesh);
+        ~MMapData();
 
         dtNavMesh* navMesh;
 
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshQuerySet navMeshQueries;     // instanceId to query
+        NavMeshGOQuerySet navMeshThreadQueries; // path worker thread to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+        MMapTileFileSet mmapTileFiles;      // maps [map grid coords] to the mapped file holding the tile data
     };
 
     struct MMapGOData
     {
-        MMapGOData(dtNavMesh* mesh) : navMesh(mesh) {}
-        ~MMapGOData()
-        {
-            for (auto& navMeshQuerie : navMeshGOQueries)
-                dtFreeNavMeshQuery(navMeshQuerie.second);
-
-            if (navMesh)
-                dtFreeNavMesh(navMesh);
-        }
+        MMapGOData(dtNavMesh* mesh, std::unique_ptr<MMapTileFile> tileFile);
+        ~MMapGOData();
 
         dtNavMesh* navMesh;
+        std::unique_ptr<MMapTileFile> file;
 
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshGOQuerySet navMeshGOQueries;  // instanceId to query
@@ -105,6 +100,10 @@ namespace MMAP
             // the returned [dtNavMeshQuery const*] is NOT threadsafe
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
+            // query of the calling path worker thread, GetNavMeshLock() must be held shared while it is used
+            dtNavMeshQuery const* GetThreadNavMeshQuery(uint32 mapId);
+            // tiles are only added and removed with this lock held exclusively
+            std::shared_mutex& GetNavMeshLock() { return m_navMeshLock; }
             dtNavMesh const* GetNavMesh(uint32 mapId);
             dtNavMesh const* GetGONavMesh(uint32 displayId);
 
@@ -119,6 +118,9 @@ namespace MMAP
 
             std::unordered_map<uint32, MMapGOData*> m_loadedModels;
             std::mutex m_modelsMutex;
+
+            std::shared_mutex m_navMeshLock;
+            std::mutex m_queriesMutex;          // navMeshQueries and navMeshThreadQueries of every MMapData
     };
 
     // static class
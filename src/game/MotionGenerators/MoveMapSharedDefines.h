@@ -23,7 +23,7 @@
 #include <Detour/Include/DetourNavMesh.h>
 
 #define MMAP_MAGIC 0x4d4d4150   // 'MMAP'
-#define MMAP_VERSION 6
+#define MMAP_VERSION 7
 
 struct MmapTileHeader
 {
@@ -32,9 +32,10 @@ struct MmapTileHeader
     uint32 mmapVersion;
     uint32 size;
     uint32 usesLiquids;
+    uint32 padding;             // the tile data follows the header, keeps it 8 byte aligned for 64 bit dtPolyRef when mapped
 
     MmapTileHeader() : mmapMagic(MMAP_MAGIC), dtVersion(DT_NAVMESH_VERSION),
-        mmapVersion(MMAP_VERSION), size(0), usesLiquids(0) {}
+        mmapVersion(MMAP_VERSION), size(0), usesLiquids(0), padding(0) {}
 };
 
 enum NavArea
@@ -0,0 +1,124 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PathCorridorCache.h"
+#include "Policies/Singleton.h"
+#include "World/World.h"
+#include "Util/Timer.h"
+
+PathCorridorCache::PathCorridorCache() : m_now(0)
+{
+}
+
+void PathCorridorCache::Update(uint32 msTime)
+{
+    m_now = msTime;
+
+    m_total.paths += m_current.paths;
+    m_total.expansions += m_current.expansions;
+    m_total.sharedHits += m_current.sharedHits;
+    m_total.repairs += m_current.repairs;
+    m_lastTick = m_current;
+    m_current = PathCorridorStats();
+
+    if (m_corridors.empty())
+        return;
+
+    uint32 const lifetime = sWorld.getConfig(CONFIG_UINT32_PATH_FIND_SHARED_CORRIDOR_LIFETIME);
+    for (CorridorMap::iterator itr = m_corridors.begin(); itr != m_corridors.end();)
+    {
+        if (WorldTimer::getMSTimeDiff(itr->second.created, m_now) >= lifetime)
+            itr = m_corridors.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+void PathCorridorCache::AddStats(PathCorridorStats const& stats)
+{
+    m_current.paths += stats.paths;
+    m_current.expansions += stats.expansions;
+    m_current.sharedHits += stats.sharedHits;
+    m_current.repairs += stats.repairs;
+}
+
+bool PathCorridorCache::Find(dtNavMesh const* navMesh, dtQueryFilter const& filter, dtPolyRef startPoly, dtPolyRef endPoly,
+                             dtPolyRef* path, uint32& pathLength, uint32 maxPathLength)
+{
+    auto bounds = m_corridors.equal_range(endPoly);
+    for (CorridorMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
+    {
+        Corridor const& corridor = itr->second;
+        if (corridor.navMesh != navMesh || corridor.includeFlags != filter.getIncludeFlags() || corridor.excludeFlags != filter.getExcludeFlags())
+            continue;
+
+        auto start = std::find(corridor.polys.begin(), corridor.polys.end(), startPoly);
+        if (start == corridor.polys.end())
+            continue;
+
+        uint32 const length = uint32(corridor.polys.end() - start);
+        if (length > maxPathLength)
+            continue;
+
+        // tiles may have been unloaded since the corridor was built
+        bool valid = true;
+        for (auto poly = start; poly != corridor.polys.end() && valid; ++poly)
+            valid = navMesh->isValidPolyRef(*poly);
+
+        if (!valid)
+        {
+            m_corridors.erase(itr);
+            return false;
+        }
+
+        std::copy(start, corridor.polys.end(), path);
+        pathLength = length;
+        ++m_current.sharedHits;
+        return true;
+    }
+
+    return false;
+}
+
+void PathCorridorCache::Store(dtNavMesh const* navMesh, dtQueryFilter const& filter, dtPolyRef const* path, uint32 pathLength)
+{
+    if (!sWorld.getConfig(CONFIG_UINT32_PATH_FIND_SHARED_CORRIDOR_LIFETIME) || pathLength < 2)
+        return;
+
+    dtPolyRef const endPoly = path[pathLength - 1];
+
+    // keep the newest corridors of this end polygon, the oldest one is replaced first
+    CorridorMap::iterator oldest = m_corridors.end();
+    uint32 count = 0;
+    auto bounds = m_corridors.equal_range(endPoly);
+    for (CorridorMap::iterator itr = bounds.first; itr != bounds.second; ++itr, ++count)
+        if (oldest == m_corridors.end() || itr->second.created < oldest->second.created)
+            oldest = itr;
+
+    if (count >= MAX_SHARED_CORRIDORS_PER_POLY)
+        m_corridors.erase(oldest);
+    else if (m_corridors.size() >= MAX_SHARED_CORRIDORS)
+        return;
+
+    Corridor& corridor = m_corridors.emplace(endPoly, Corridor())->second;
+    corridor.navMesh = navMesh;
+    corridor.includeFlags = filter.getIncludeFlags();
+    corridor.excludeFlags = filter.getExcludeFlags();
+    corridor.created = m_now;
+    corridor.polys.assign(path, path + pathLength);
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATH_CORRIDOR_CACHE_H
+#define MANGOS_PATH_CORRIDOR_CACHE_H
+
+#include "Common.h"
+
+#include <Detour/Include/DetourNavMesh.h>
+#include <Detour/Include/DetourNavMeshQuery.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+// upper bound of corridors kept per map, further paths are just not shared
+#define MAX_SHARED_CORRIDORS            256
+// corridors kept per end polygon, chasers of one target rarely need more
+#define MAX_SHARED_CORRIDORS_PER_POLY   4
+
+struct PathCorridorStats
+{
+    PathCorridorStats() : paths(0), expansions(0), sharedHits(0), repairs(0) {}
+
+    uint64 paths;                                           // full detour searches
+    uint64 expansions;                                      // search nodes touched by those searches
+    uint64 sharedHits;                                      // searches replaced by a corridor of another unit
+    uint64 repairs;                                         // corridors repaired after the target moved off them
+};
+
+// Map local store of recently built poly corridors
+// Units chasing the same target end on the same polygon, so a corridor built for one of them is
+// usually also the (sub)path of the next one - any suffix of a shortest path is a shortest path too.
+// Only accessed from the map update thread, like everything else owned by Map.
+class PathCorridorCache
+{
+    public:
+        PathCorridorCache();
+
+        // called at the start of every map tick, rolls the per tick counters and drops expired corridors
+        void Update(uint32 msTime);
+
+        // copy the part of a cached corridor from startPoly to endPoly into path
+        bool Find(dtNavMesh const* navMesh, dtQueryFilter const& filter, dtPolyRef startPoly, dtPolyRef endPoly,
+                  dtPolyRef* path, uint32& pathLength, uint32 maxPathLength);
+        void Store(dtNavMesh const* navMesh, dtQueryFilter const& filter, dtPolyRef const* path, uint32 pathLength);
+
+        void CountPath(uint32 expansions) { ++m_current.paths; m_current.expansions += expansions; }
+        void CountRepair() { ++m_current.repairs; }
+        void AddStats(PathCorridorStats const& stats);
+
+        PathCorridorStats const& GetLastTickStats() const { return m_lastTick; }
+        PathCorridorStats const& GetTotalStats() const { return m_total; }
+        uint32 GetCorridorCount() const { return uint32(m_corridors.size()); }
+
+    private:
+        struct Corridor
+        {
+            dtNavMesh const* navMesh;
+            uint16 includeFlags;
+            uint16 excludeFlags;
+            uint32 created;
+            std::vector<dtPolyRef> polys;
+        };
+
+        typedef std::unordered_multimap<dtPolyRef, Corridor> CorridorMap; // keyed by end polygon
+
+        CorridorMap m_corridors;
+        uint32 m_now;
+
+        PathCorridorStats m_current;
+        PathCorridorStats m_lastTick;
+        PathCorridorStats m_total;
+};
+
+#endif
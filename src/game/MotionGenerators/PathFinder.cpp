@@ -23,11 +23,13 @@
 #include "Log.h"
 #include "World/World.h"
 #include "Entities/Transports.h"
+#include "PathWorkerPool.h"
 #include <Detour/Include/DetourCommon.h>
 #include <Detour/Include/DetourMath.h>
+#include <Detour/Include/DetourNode.h>
 
 #ifdef BUILD_METRICS
- #include "Metric/Metric.h"
+ #include "Metric/Registry.h"
 #endif
 
 #include <limits>
@@ -35,9 +37,10 @@
 PathFinder::PathFinder(const Unit* owner, bool ignoreNormalization) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_straightLine(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH), // TODO: Fix legitimate long paths
-    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_cachedPoints(m_pointPathLimit * VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(m_sourceUnit->GetMapId()), m_ignoreNormalization(ignoreNormalization)
+    m_sourceUnit(owner), m_sourceGuidLow(owner->GetGUIDLow()), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_cachedPoints(m_pointPathLimit * VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(m_sourceUnit->GetMapId()), m_ignoreNormalization(ignoreNormalization),
+    m_isDungeon(false), m_collisionWidth(0.0f), m_async(false), m_asyncFallback(false), m_randomPoint(false), m_randomPointFailed(false), m_transportDisplayId(0)
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceGuidLow);
 
     if (MMAP::MMapFactory::IsPathfindingEnabled(m_sourceUnit->GetMapId(), m_sourceUnit))
     {
@@ -50,20 +53,27 @@ PathFinder::PathFinder(const Unit* owner, bool ignoreNormalization) :
 
 PathFinder::~PathFinder()
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceGuidLow);
 }
 
 void PathFinder::SetCurrentNavMesh()
 {
+    m_transportDisplayId = 0;
     if (MMAP::MMapFactory::IsPathfindingEnabled(m_sourceUnit->GetMapId(), m_sourceUnit))
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         if (GenericTransport* transport = m_sourceUnit->GetTransport())
+        {
             m_navMeshQuery = mmap->GetModelNavMeshQuery(transport->GetDisplayId());
+            m_transportDisplayId = transport->GetDisplayId();
+        }
         else
         {
             if (m_defaultMapId != m_sourceUnit->GetMapId())
+            {
                 m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
+                m_defaultMapId = m_sourceUnit->GetMapId();
+            }
 
             m_navMeshQuery = m_defaultNavMeshQuery;
         }
@@ -92,28 +102,32 @@ bool PathFinder::calculate(Vector3 const& start, Vector3 const& dest, bool force
         return false;
 
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("pathfinder.calculate", {
-        { "entry", std::to_string(m_sourceUnit->GetEntry()) },
-        { "guid", std::to_string(m_sourceUnit->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_sourceUnit->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_sourceUnit->GetMapId()) },
-        { "instance_id", std::to_string(m_sourceUnit->GetInstanceId()) }
-    }, 1000);
+    static metric::histogram_set s_calculateTime("pathfinder.calculate", "unit_type", { "creature", "player" });
+    metric::scoped_timer meas(s_calculateTime[m_sourceUnit->IsPlayer()]);
 #endif
 
     //if (GenericTransport* transport = m_sourceUnit->GetTransport())
     //    transport->CalculatePassengerOffset(dest.x, dest.y, dest.z, nullptr);
 
+    if (PrepareCalculation(start, dest, forceDest, straightLine))
+        BuildPolyPath(start, dest);
+
+    return true;
+}
+
+bool PathFinder::PrepareCalculation(const Vector3& start, const Vector3& dest, bool forceDest, bool straightLine)
+{
     setStartPosition(start);
 
     setEndPosition(dest);
 
     m_forceDestination = forceDest;
     m_straightLine = straightLine;
+    m_randomPoint = false;
 
     SetCurrentNavMesh();
 
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceGuidLow);
 
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
@@ -122,15 +136,32 @@ bool PathFinder::calculate(Vector3 const& start, Vector3 const& dest, bool force
     {
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-        return true;
+        return false;
     }
 
     updateFilter();
 
-    BuildPolyPath(start, dest);
+    m_isDungeon = m_sourceUnit->GetMap()->IsDungeon();
+    m_collisionWidth = m_sourceUnit->GetCollisionWidth();
     return true;
 }
 
+std::shared_ptr<PathRequest> PathFinder::calculateAsync(std::unique_ptr<PathFinder> path, float destX, float destY, float destZ, bool forceDest/* = false*/, bool straightLine/* = false*/)
+{
+    Unit const* owner = path->m_sourceUnit;
+    float x, y, z;
+    owner->GetPosition(x, y, z, owner->GetTransport());
+    Vector3 start(x, y, z);
+    Vector3 dest(destX, destY, destZ);
+    if (GenericTransport* transport = owner->GetTransport())
+        transport->CalculatePassengerOffset(dest.x, dest.y, dest.z);
+
+    bool const build = MaNGOS::IsValidMapCoord(dest.x, dest.y, dest.z) && MaNGOS::IsValidMapCoord(start.x, start.y, start.z) &&
+                       path->PrepareCalculation(start, dest, forceDest, straightLine);
+
+    return sPathWorkerPool.Schedule(std::move(path), build);
+}
+
 dtPolyRef PathFinder::getPathPolyByPosition(const dtPolyRef* polyPath, uint32 polyPathSize, const float* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -202,7 +233,7 @@ dtPolyRef PathFinder::getPolyByLocation(const float* point, float* distance)
 void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 {
     // *** getting start/end poly logic ***
-    if (m_sourceUnit->GetMap()->IsDungeon())
+    if (m_isDungeon)
     {
         float distance = sqrt((endPos.x - startPos.x) * (endPos.x - startPos.x) + (endPos.y - startPos.y) * (endPos.y - startPos.y) + (endPos.z - startPos.z) * (endPos.z - startPos.z));
         if (distance > 300.f)
@@ -214,6 +245,9 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         if (m_pointPathLimit > m_pathPolyRefs.size())
             m_pathPolyRefs.resize(m_pointPathLimit);
     }
+    // the old corridor can only be extended to a moved target if it actually reached the old one
+    bool const prevPathComplete = m_type == PATHFIND_NORMAL;
+
     float distToStartPoly, distToEndPoly;
     float startPoint[VERTEX_SIZE] = {startPos.y, startPos.z, startPos.x};
     float endPoint[VERTEX_SIZE] = {endPos.y, endPos.z, endPos.x};
@@ -228,6 +262,13 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     // its up to caller how he will use this info
     if (startPoly == INVALID_POLYREF || endPoly == INVALID_POLYREF)
     {
+        // needs terrain and owner data, leave it to the map thread
+        if (m_async)
+        {
+            m_asyncFallback = true;
+            return;
+        }
+
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
         BuildShortcut();
 
@@ -250,6 +291,12 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     bool farFromPoly = (distToStartPoly > 7.0f || distToEndPoly > 7.0f);
     if (farFromPoly)
     {
+        if (m_async)
+        {
+            m_asyncFallback = true;
+            return;
+        }
+
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
 
         bool buildShotrcut = false;
@@ -319,7 +366,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
                 sLog.outError("Invalid poly ref in BuildPolyPath. polyLength: %u, pathStartIndex: %u,"
                               " startPos: %s, endPos: %s, mapId: %u",
                               m_polyLength, pathStartIndex, startPos.toString().c_str(), endPos.toString().c_str(),
-                              m_sourceUnit->GetMapId());
+                              m_defaultMapId);
                 break;
             }
 
@@ -351,6 +398,14 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         m_polyLength = pathEndIndex - pathStartIndex + 1;
         memmove(m_pathPolyRefs.data(), m_pathPolyRefs.data() + pathStartIndex, m_polyLength * sizeof(dtPolyRef));
     }
+    else if (startPolyFound && prevPathComplete && !m_straightLine && RepairPolyPathEnd(pathStartIndex, endPoly, endPoint))
+    {
+        DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPolyFound && !endPolyFound) corridor repaired\n");
+
+        // we are moving on the old path and the target moved a short distance off its end
+        // the corridor was extended towards the target without a new search
+        CountRepair();
+    }
     //else if (startPolyFound && !endPolyFound)
     //{
     //    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPolyFound && !endPolyFound)\n");
@@ -455,15 +510,29 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
         if (!m_straightLine)
         {
-            dtResult = m_navMeshQuery->findPath(
-                    startPoly,          // start polygon
-                    endPoly,            // end polygon
-                    startPoint,         // start position
-                    endPoint,           // end position
-                    &m_filter,          // polygon search filter
-                    m_pathPolyRefs.data(), // [out] path
-                    (int*)&m_polyLength,
-                    m_pointPathLimit);   // max number of polygons in output path
+            // another unit may just have searched a path to the same place, running through our start poly
+            // the cache belongs to the map, so it is not used by path workers
+            PathCorridorCache* corridorCache = m_async ? nullptr : &m_sourceUnit->GetMap()->GetPathCorridorCache();
+            if (corridorCache && corridorCache->Find(m_navMesh, m_filter, startPoly, endPoly, m_pathPolyRefs.data(), m_polyLength, m_pointPathLimit))
+                dtResult = DT_SUCCESS;
+            else
+            {
+                dtResult = m_navMeshQuery->findPath(
+                        startPoly,          // start polygon
+                        endPoly,            // end polygon
+                        startPoint,         // start position
+                        endPoint,           // end position
+                        &m_filter,          // polygon search filter
+                        m_pathPolyRefs.data(), // [out] path
+                        (int*)&m_polyLength,
+                        m_pointPathLimit);   // max number of polygons in output path
+
+                CountPath(m_navMeshQuery->getNodePool()->getNodeCount());
+
+                // only complete corridors can be shared, a partial one ends somewhere else
+                if (corridorCache && dtStatusSucceed(dtResult) && !dtStatusDetail(dtResult, DT_PARTIAL_RESULT) && m_polyLength && m_pathPolyRefs[m_polyLength - 1] == endPoly)
+                    corridorCache->Store(m_navMesh, m_filter, m_pathPolyRefs.data(), m_polyLength);
+            }
         }
         else
         {
@@ -488,7 +557,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
                 float hitPos[3];
                 float distanceToPoly;
 
-                hit = hit - m_sourceUnit->GetCollisionWidth();
+                hit = hit - m_collisionWidth;
                 if (hit < 0.1f)
                 {
                     m_type = PATHFIND_NOPATH;
@@ -528,7 +597,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         if (!m_polyLength || dtStatusFailed(dtResult))
         {
             // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
             BuildShortcut();
             m_type = PATHFIND_NOPATH;
             return;
@@ -545,6 +614,55 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     BuildPointPath(startPoint, endPoint);
 }
 
+bool PathFinder::RepairPolyPathEnd(uint32 pathStartIndex, dtPolyRef endPoly, const float* endPoint)
+{
+    // same approach as dtPathCorridor::moveTargetPosition - walk from the old corridor end over the mesh surface
+    // to the new target and merge the visited polys into the corridor, only if that fails a new search is needed
+    dtPolyRef const oldEndPoly = m_pathPolyRefs[m_polyLength - 1];
+    float oldEndPoint[VERTEX_SIZE];
+    if (dtStatusFailed(m_navMeshQuery->closestPointOnPoly(oldEndPoly, endPoint, oldEndPoint, nullptr)))
+        return false;
+
+    dtPolyRef visited[MAX_CORRIDOR_REPAIR_POLYS];
+    int visitedCount = 0;
+    float resultPos[VERTEX_SIZE];
+    if (dtStatusFailed(m_navMeshQuery->moveAlongSurface(oldEndPoly, oldEndPoint, endPoint, &m_filter, resultPos, visited, &visitedCount, MAX_CORRIDOR_REPAIR_POLYS)))
+        return false;
+
+    // the walk got stuck at a wall or needed too many polys, the target is not just around the corner
+    if (!visitedCount || visited[visitedCount - 1] != endPoly)
+        return false;
+
+    // find the furthest poly shared by the corridor and the walk, the walk may have gone back along the corridor
+    int32 furthestPath = -1;
+    int32 furthestVisited = -1;
+    for (int32 i = int32(m_polyLength) - 1; i >= int32(pathStartIndex) && furthestPath < 0; --i)
+    {
+        for (int32 j = visitedCount - 1; j >= 0; --j)
+        {
+            if (m_pathPolyRefs[i] == visited[j])
+            {
+                furthestPath = i;
+                furthestVisited = j;
+                break;
+            }
+        }
+    }
+
+    if (furthestPath < 0)
+        return false;
+
+    uint32 const prefixLength = uint32(furthestPath) - pathStartIndex;
+    uint32 const suffixLength = uint32(visitedCount - furthestVisited);
+    if (prefixLength + suffixLength > std::min<uint32>(m_pointPathLimit, m_pathPolyRefs.size()))
+        return false;
+
+    memmove(m_pathPolyRefs.data(), m_pathPolyRefs.data() + pathStartIndex, prefixLength * sizeof(dtPolyRef));
+    memcpy(m_pathPolyRefs.data() + prefixLength, visited + furthestVisited, suffixLength * sizeof(dtPolyRef));
+    m_polyLength = prefixLength + suffixLength;
+    return true;
+}
+
 void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 {
     if (m_pointPathLimit * VERTEX_SIZE > m_cachedPoints.size())
@@ -740,6 +858,10 @@ void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 
 void PathFinder::NormalizePath()
 {
+    // done by FinishAsync() on the map thread
+    if (m_async)
+        return;
+
     if (!sWorld.getConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z) || m_ignoreNormalization)
         return;
 
@@ -836,7 +958,8 @@ NavTerrainFlag PathFinder::getNavTerrain(float x, float y, float z) const
 
 bool PathFinder::HaveTile(const Vector3& p) const
 {
-    if (m_sourceUnit->GetTransport())
+    // transport taken by SetCurrentNavMesh on the map thread, the owner is not touched here
+    if (m_transportDisplayId)
         return true;
 
     int tx = -1, ty = -1;
@@ -1064,6 +1187,21 @@ dtStatus PathFinder::findSmoothPath(const float* startPos, const float* endPos,
 }
 
 void PathFinder::ComputePathToRandomPoint(Vector3 const& startPoint, float maxRange)
+{
+    if (!PrepareRandomPoint(startPoint, maxRange))
+        return;
+
+    m_randomPointFailed = BuildRandomPointPath();
+    FinishRandomPointPath();
+}
+
+std::shared_ptr<PathRequest> PathFinder::ComputePathToRandomPointAsync(std::unique_ptr<PathFinder> path, Vector3 const& startPoint, float maxRange)
+{
+    bool const build = path->PrepareRandomPoint(startPoint, maxRange);
+    return sPathWorkerPool.Schedule(std::move(path), build);
+}
+
+bool PathFinder::PrepareRandomPoint(Vector3 const& startPoint, float maxRange)
 {
     clear();
     m_type = PathType(PATHFIND_NOPATH);
@@ -1071,6 +1209,8 @@ void PathFinder::ComputePathToRandomPoint(Vector3 const& startPoint, float maxRa
     // use only straight line
     m_straightLine = true;
     m_forceDestination = false;
+    m_randomPoint = true;
+    m_randomPointFailed = false;
 
     // update unit filter
     updateFilter();
@@ -1081,21 +1221,16 @@ void PathFinder::ComputePathToRandomPoint(Vector3 const& startPoint, float maxRa
     float angle = rand_norm_f() * 2 * M_PI_F;
     float range = rand_norm_f() * maxRange;
 
-    float randomPoint[3];
-    randomPoint[2] = startPoint.x + range * cos(angle);
-    randomPoint[0] = startPoint.y + range * sin(angle);
-    randomPoint[1] = startPoint.z;
-
     Vector3 currPos;
     m_sourceUnit->GetPosition(currPos.x, currPos.y, currPos.z, m_sourceUnit->GetTransport());
-    Vector3 endPoint(randomPoint[2], randomPoint[0], randomPoint[1]);
+    Vector3 endPoint(startPoint.x + range * cos(angle), startPoint.y + range * sin(angle), startPoint.z);
 
     // fast check to see if point is far enough
     if ((currPos - endPoint).squaredMagnitude() < 0.01f)
     {
         m_type = PathType(PATHFIND_NOPATH);
         //sLog.outDebug("PathFinder::GetPathToRandomPoint> too small distance from point start(%s) to end(%s) for %s", currPos.toString().c_str(), endPoint.toString().c_str(), m_sourceUnit->GetGuidStr().c_str());
-        return;
+        return false;
     }
 
     setStartPosition(currPos);
@@ -1109,12 +1244,22 @@ void PathFinder::ComputePathToRandomPoint(Vector3 const& startPoint, float maxRa
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_SHORTCUT);
         //sLog.outString("PathFinder::GetPathToRandomPoint> Shortcut for %s\n", m_sourceUnit->GetGuidStr().c_str());
-        return;
+        return false;
     }
 
+    m_isDungeon = m_sourceUnit->GetMap()->IsDungeon();
+    m_collisionWidth = m_sourceUnit->GetCollisionWidth();
+    return true;
+}
+
+bool PathFinder::BuildRandomPointPath()
+{
+    Vector3 const currPos = getStartPosition();
+    Vector3 endPoint = getEndPosition();
+    float randomPoint[VERTEX_SIZE] = {endPoint.y, endPoint.z, endPoint.x};
+
     float distanceToPoly;
     dtPolyRef centerPoly = getPolyByLocation(randomPoint, &distanceToPoly);
-    bool fail = true;
     if (centerPoly != INVALID_POLYREF)
     {
         // first we have to fix z value before hit test, z is in index 1 of randomPoint
@@ -1126,18 +1271,104 @@ void PathFinder::ComputePathToRandomPoint(Vector3 const& startPoint, float maxRa
         {
             // generate path
             BuildPolyPath(currPos, endPoint);
-            fail = false;
             //sLog.outDebug("PathFinder::GetPathToRandomPoint> path type %d size %d poly-size %d\n", m_type, m_pathPoints.size(), m_polyLength);
+            return false;
         }
     }
 
+    return true;
+}
+
+void PathFinder::FinishRandomPointPath()
+{
+    if (!m_randomPointFailed)
+        return;
+
+    Vector3 const currPos = getStartPosition();
+    Vector3 const endPoint = getEndPosition();
+
     // navmesh queries do not work in water - need to supplement with los check and just build a shortcut
-    if (fail && m_sourceUnit->IsInWater() && m_sourceUnit->CanSwim() && m_sourceUnit->GetMap()->IsInLineOfSight(currPos.x, currPos.y, currPos.z + m_sourceUnit->GetCollisionHeight(), endPoint.x, endPoint.y, endPoint.z + m_sourceUnit->GetCollisionHeight(), false))
+    if (m_sourceUnit->IsInWater() && m_sourceUnit->CanSwim() && m_sourceUnit->GetMap()->IsInLineOfSight(currPos.x, currPos.y, currPos.z + m_sourceUnit->GetCollisionHeight(), endPoint.x, endPoint.y, endPoint.z + m_sourceUnit->GetCollisionHeight(), false))
     {
         BuildShortcut();
     }
 }
 
+void PathFinder::BuildAsync(dtNavMeshQuery const* navMeshQuery)
+{
+    // the tile may have been unloaded meanwhile, or there is no query for this thread
+    if (!navMeshQuery)
+    {
+        m_asyncFallback = true;
+        return;
+    }
+
+    m_navMeshQuery = navMeshQuery;
+    m_navMesh = navMeshQuery->getAttachedNavMesh();
+
+    if (m_randomPoint)
+        m_randomPointFailed = BuildRandomPointPath();
+    else
+    {
+        Vector3 const start = getStartPosition();
+        Vector3 const end = getEndPosition();
+        BuildPolyPath(start, end);
+    }
+}
+
+void PathFinder::FinishAsync()
+{
+    m_async = false;
+
+    // back to the query of the map, the worker one belongs to another thread
+    SetCurrentNavMesh();
+
+    if (m_asyncFallback)
+    {
+        m_asyncFallback = false;
+        if (!m_navMesh || !m_navMeshQuery)
+        {
+            BuildShortcut();
+            m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        }
+        else if (m_randomPoint)
+            m_randomPointFailed = BuildRandomPointPath();
+        else
+        {
+            Vector3 const start = getStartPosition();
+            Vector3 const end = getEndPosition();
+            BuildPolyPath(start, end);
+        }
+    }
+    else
+        NormalizePath();
+
+    if (m_randomPoint)
+        FinishRandomPointPath();
+
+    m_sourceUnit->GetMap()->GetPathCorridorCache().AddStats(m_asyncStats);
+    m_asyncStats = PathCorridorStats();
+}
+
+void PathFinder::CountPath(uint32 expansions)
+{
+    if (m_async)
+    {
+        ++m_asyncStats.paths;
+        m_asyncStats.expansions += expansions;
+    }
+    else
+        m_sourceUnit->GetMap()->GetPathCorridorCache().CountPath(expansions);
+}
+
+void PathFinder::CountRepair()
+{
+    if (m_async)
+        ++m_asyncStats.repairs;
+    else
+        m_sourceUnit->GetMap()->GetPathCorridorCache().CountRepair();
+}
+
 bool PathFinder::inRangeYZX(const float* v1, const float* v2, float r, float h) const
 {
     const float dx = v2[0] - v1[0];
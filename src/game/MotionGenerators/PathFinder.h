@@ -25,11 +25,15 @@
 #include <Detour/Include/DetourNavMeshQuery.h>
 
 #include "Movement/MoveSplineInitArgs.h"
+#include "PathCorridorCache.h"
+
+#include <memory>
 
 using Movement::Vector3;
 using Movement::PointsArray;
 
 class Unit;
+class PathRequest;
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
@@ -47,6 +51,9 @@ class Unit;
 #define VERTEX_SIZE       3
 #define INVALID_POLYREF   0
 
+// max polygons walked when moving the end of an existing corridor to a moved target
+#define MAX_CORRIDOR_REPAIR_POLYS   16
+
 // bound box of poly search area
 static float NearPolySearchBound[VERTEX_SIZE] = { 5.0f, 5.0f, 5.0f };
 static float FarPolySearchBound[VERTEX_SIZE] = { 10.0f, 10.0f, 10.0f };
@@ -76,6 +83,11 @@ class PathFinder
         // compute a straight path to some random point in max range
         void ComputePathToRandomPoint(Vector3 const& startPoint, float maxRange);
 
+        // Asynchronous variants of the above, the navmesh part of the calculation runs on a path worker thread
+        // The path finder is owned by the returned request until PathRequest::TakeResult() is called on the map thread
+        static std::shared_ptr<PathRequest> calculateAsync(std::unique_ptr<PathFinder> path, float destX, float destY, float destZ, bool forceDest = false, bool straightLine = false);
+        static std::shared_ptr<PathRequest> ComputePathToRandomPointAsync(std::unique_ptr<PathFinder> path, Vector3 const& startPoint, float maxRange);
+
         // option setters - use optional
         void setUseStrightPath(bool useStraightPath) { m_useStraightPath = useStraightPath; };
         void setPathLengthLimit(float distance) { m_pointPathLimit = std::min<uint32>(uint32(distance / SMOOTH_PATH_STEP_SIZE * 1.25f), MAX_POINT_PATH_LENGTH); };
@@ -89,6 +101,7 @@ class PathFinder
         PathType getPathType() const { return m_type; }
 
     private:
+        friend class PathRequest;
 
         PointsArray    m_pathPoints;       // our actual (x,y,z) path to the target
         PathType       m_type;             // tells what kind of path this is
@@ -108,6 +121,7 @@ class PathFinder
         Vector3        m_actualEndPosition;// {x, y, z} of the closest possible point to given destination
 
         const Unit* const       m_sourceUnit;       // the unit that is moving
+        uint32 const            m_sourceGuidLow;    // for logging, m_sourceUnit is not touched while calculated asynchronously
         const dtNavMesh*        m_navMesh;          // the nav mesh
         const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
 
@@ -116,6 +130,18 @@ class PathFinder
 
         bool                    m_ignoreNormalization;
 
+        // owner data needed by BuildPolyPath, taken on the map thread
+        bool                    m_isDungeon;
+        float                   m_collisionWidth;
+
+        // asynchronous calculation state, see PathRequest
+        bool                    m_async;            // navmesh part runs on a path worker thread, owner and map must not be touched
+        bool                    m_asyncFallback;    // the worker needed owner or terrain data, navmesh part is redone on the map thread
+        bool                    m_randomPoint;      // request is a ComputePathToRandomPoint
+        bool                    m_randomPointFailed;
+        uint32                  m_transportDisplayId; // model navmesh of the transport the owner is on, 0 for the map navmesh
+        PathCorridorStats       m_asyncStats;       // counted into the map corridor cache when the result is taken
+
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
         void setStartPosition(const Vector3& point) { m_startPosition = point; }
@@ -138,7 +164,17 @@ class PathFinder
         dtPolyRef getPolyByLocation(const float* point, float* distance);
         bool HaveTile(const Vector3& p) const;
 
+        bool PrepareCalculation(const Vector3& startPos, const Vector3& endPos, bool forceDest, bool straightLine);
+        bool PrepareRandomPoint(Vector3 const& startPoint, float maxRange);
+        bool BuildRandomPointPath();
+        void FinishRandomPointPath();
+        void BuildAsync(dtNavMeshQuery const* navMeshQuery);
+        void FinishAsync();
+        void CountPath(uint32 expansions);
+        void CountRepair();
+
         void BuildPolyPath(const Vector3& startPos, const Vector3& endPos);
+        bool RepairPolyPathEnd(uint32 pathStartIndex, dtPolyRef endPoly, const float* endPoint);
         void BuildPointPath(const float* startPoint, const float* endPoint);
         void BuildShortcut();
 
@@ -0,0 +1,128 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PathWorkerPool.h"
+#include "PathFinder.h"
+#include "MoveMap.h"
+
+PathRequest::PathRequest(std::unique_ptr<PathFinder> path, bool build) : m_path(std::move(path)), m_build(build), m_ready(!build)
+{
+    m_path->m_async = build;
+}
+
+PathRequest::~PathRequest()
+{
+}
+
+void PathRequest::Execute()
+{
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+
+    // keeps the tiles from being unloaded while the query runs
+    std::shared_lock<std::shared_mutex> lock(mmap->GetNavMeshLock());
+    if (m_path->m_transportDisplayId)
+        m_path->BuildAsync(mmap->GetModelNavMeshQuery(m_path->m_transportDisplayId));
+    else
+        m_path->BuildAsync(mmap->GetThreadNavMeshQuery(m_path->m_defaultMapId));
+}
+
+std::unique_ptr<PathFinder> PathRequest::TakeResult()
+{
+    MANGOS_ASSERT(IsReady() && m_path);
+
+    if (m_build)
+        m_path->FinishAsync();
+
+    return std::move(m_path);
+}
+
+PathWorkerPool::PathWorkerPool() : m_pending(0)
+{
+}
+
+PathWorkerPool::~PathWorkerPool()
+{
+    Stop();
+}
+
+PathWorkerPool& PathWorkerPool::Instance()
+{
+    static PathWorkerPool pool;
+    return pool;
+}
+
+void PathWorkerPool::Start(uint32 threads)
+{
+    if (!threads)
+        return;
+
+    m_work.reset(new boost::asio::io_service::work(m_service));
+
+    for (uint32 i = 0; i < threads; ++i)
+        m_threads.emplace_back(&PathWorkerPool::WorkerThread, this);
+}
+
+void PathWorkerPool::Stop()
+{
+    if (m_threads.empty())
+        return;
+
+    // pending requests are dropped, only happens at shutdown when no map waits for them anymore
+    m_work.reset();
+    m_service.stop();
+
+    for (auto& thread : m_threads)
+        if (thread.joinable())
+            thread.join();
+
+    m_threads.clear();
+}
+
+void PathWorkerPool::WorkerThread()
+{
+    boost::system::error_code ec;
+    m_service.run(ec);
+}
+
+std::shared_ptr<PathRequest> PathWorkerPool::Schedule(std::unique_ptr<PathFinder> path, bool build)
+{
+    std::shared_ptr<PathRequest> request = std::make_shared<PathRequest>(std::move(path), build);
+    if (!build)
+        return request;
+
+    // no worker threads, calculate right away
+    if (m_threads.empty())
+    {
+        request->Execute();
+        request->m_ready.store(true, std::memory_order_release);
+        return request;
+    }
+
+    ++m_pending;
+    boost::asio::post(m_service, [this, request]()
+    {
+        // nobody is waiting for the result anymore
+        if (request.use_count() > 1)
+            request->Execute();
+
+        --m_pending;
+        request->m_ready.store(true, std::memory_order_release);
+    });
+
+    return request;
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATH_WORKER_POOL_H
+#define MANGOS_PATH_WORKER_POOL_H
+
+#include "Common.h"
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class PathFinder;
+
+// Handle of a path calculation running on a path worker
+// Created by PathFinder::calculateAsync / ComputePathToRandomPointAsync on the map thread. The worker only runs
+// the navmesh part of the calculation, everything needing the owner is done before scheduling or in TakeResult().
+// Dropping the handle before it is ready cancels the request, the worker discards the result.
+class PathRequest
+{
+    public:
+        PathRequest(std::unique_ptr<PathFinder> path, bool build);
+        ~PathRequest();
+
+        bool IsReady() const { return m_ready.load(std::memory_order_acquire); }
+
+        // map thread only, request must be ready - finishes the calculation and hands the path finder back
+        std::unique_ptr<PathFinder> TakeResult();
+
+    private:
+        friend class PathWorkerPool;
+
+        void Execute();
+
+        std::unique_ptr<PathFinder> m_path;
+        bool m_build;                                       // navmesh part still has to be done
+        std::atomic<bool> m_ready;
+};
+
+// Worker threads running path requests, each worker uses its own dtNavMeshQuery per map
+class PathWorkerPool
+{
+    public:
+        static PathWorkerPool& Instance();
+
+        PathWorkerPool();
+        ~PathWorkerPool();
+
+        // with 0 threads requests are calculated right away on the calling thread
+        void Start(uint32 threads);
+        void Stop();
+
+        bool IsEnabled() const { return !m_threads.empty(); }
+        uint32 GetThreadCount() const { return uint32(m_threads.size()); }
+        uint32 GetPendingCount() const { return m_pending.load(); }
+
+        std::shared_ptr<PathRequest> Schedule(std::unique_ptr<PathFinder> path, bool build);
+
+    private:
+        void WorkerThread();
+
+        boost::asio::io_service m_service;
+        // note that the work member *must* be declared after the service member
+        std::unique_ptr<boost::asio::io_service::work> m_work;
+        std::vector<std::thread> m_threads;
+
+        std::atomic<uint32> m_pending;
+};
+
+#define sPathWorkerPool PathWorkerPool::Instance()
+
+#endif
@@ -21,12 +21,14 @@
 #include "Movement/MoveSplineInit.h"
 #include "Movement/MoveSpline.h"
 #include "MotionGenerators/RandomMovementGenerator.h"
+#include "MotionGenerators/PathWorkerPool.h"
 
 void AbstractRandomMovementGenerator::Initialize(Unit& owner)
 {
     owner.addUnitState(i_stateActive);
 
     m_pathFinder = std::make_unique<PathFinder>(&owner);
+    m_pathRequest.reset();
 
     // Client-controlled unit should have control removed
     if (const Player* controllingClientPlayer = owner.GetClientControlling())
@@ -98,7 +100,11 @@ bool AbstractRandomMovementGenerator::Update(Unit& owner, const uint32& diff)
 
         if (i_nextMoveTimer.Passed())
         {
-            if (_setLocation(owner))
+            int32 const duration = _setLocation(owner);
+            if (duration == RANDOM_MOVE_PATH_PENDING)
+                return true;
+
+            if (duration)
             {
                 if (i_nextMoveCount > 1)
                     --i_nextMoveCount;
@@ -118,13 +124,28 @@ bool AbstractRandomMovementGenerator::Update(Unit& owner, const uint32& diff)
 
 int32 AbstractRandomMovementGenerator::_setLocation(Unit& owner)
 {
-    // Look for a random location within certain radius of initial position
-    float x = i_x, y = i_y, z = i_z;
+    if (!m_pathRequest)
+    {
+        // Look for a random location within certain radius of initial position
+        float x = i_x, y = i_y, z = i_z;
+
+        if (i_pathLength != 0.0f)
+            m_pathFinder->setPathLengthLimit(i_pathLength);
+
+        if (i_asyncPath && sPathWorkerPool.IsEnabled())
+            m_pathRequest = PathFinder::ComputePathToRandomPointAsync(std::move(m_pathFinder), Vector3(x, y, z), i_radius);
+        else
+            m_pathFinder->ComputePathToRandomPoint(Vector3(x, y, z), i_radius);
+    }
 
-    if (i_pathLength != 0.0f)
-        m_pathFinder->setPathLengthLimit(i_pathLength);
+    if (m_pathRequest)
+    {
+        if (!m_pathRequest->IsReady())
+            return RANDOM_MOVE_PATH_PENDING;
 
-    m_pathFinder->ComputePathToRandomPoint(Vector3(x, y, z), i_radius);
+        m_pathFinder = m_pathRequest->TakeResult();
+        m_pathRequest.reset();
+    }
 
     if ((m_pathFinder->getPathType() & PATHFIND_NOPATH) != 0)
         return 0;
@@ -166,12 +187,14 @@ WanderMovementGenerator::WanderMovementGenerator(float x, float y, float z, floa
     i_z = z;
     i_radius = radius;
     i_verticalZ = verticalZ;
+    i_asyncPath = true;
 }
 
 WanderMovementGenerator::WanderMovementGenerator(const Creature& npc) :
     AbstractRandomMovementGenerator(UNIT_STAT_ROAMING, UNIT_STAT_ROAMING_MOVE, 3000, 10000, 3)
 {
     npc.GetRespawnCoord(i_x, i_y, i_z, nullptr, &i_radius);
+    i_asyncPath = true;
 }
 
 void WanderMovementGenerator::Finalize(Unit& owner)
@@ -23,12 +23,16 @@
 #include "Entities/ObjectGuid.h"
 
 class PathFinder;
+class PathRequest;
+
+// _setLocation() result while the path is still calculated by a path worker
+#define RANDOM_MOVE_PATH_PENDING -1
 
 class AbstractRandomMovementGenerator : public MovementGenerator
 {
     public:
         explicit AbstractRandomMovementGenerator(uint32 stateActive, uint32 stateMotion, uint32 delayMin, uint32 delayMax, uint32 movesMax = 1) :
-            i_x(0.0f), i_y(0.0f), i_z(0.0f), i_radius(0.0f), i_verticalZ(0.0f), i_pathLength(0.0f), i_walk(true),
+            i_x(0.0f), i_y(0.0f), i_z(0.0f), i_radius(0.0f), i_verticalZ(0.0f), i_pathLength(0.0f), i_walk(true), i_asyncPath(false),
             i_nextMoveTimer(0), i_nextMoveCount(1), i_nextMoveCountMax(movesMax),
             i_nextMoveDelayMin(delayMin), i_nextMoveDelayMax(delayMax),
             i_stateActive(stateActive), i_stateMotion(stateMotion)
@@ -49,8 +53,10 @@ class AbstractRandomMovementGenerator : public MovementGenerator
         float i_verticalZ;
         float i_pathLength;
         bool i_walk;
+        bool i_asyncPath;                                   // path may be calculated by a path worker, used at a later update
 
         std::unique_ptr<PathFinder> m_pathFinder;
+        std::shared_ptr<PathRequest> m_pathRequest;
         ShortTimeTracker i_nextMoveTimer;
         uint32 i_nextMoveCount, i_nextMoveCountMax;
         uint32 i_nextMoveDelayMin, i_nextMoveDelayMax;
@@ -21,6 +21,7 @@
 #include "packet_builder.h"
 #include "Entities/Unit.h"
 #include "Entities/Transports.h"
+#include "Maps/Map.h"
 
 namespace Movement
 {
@@ -114,6 +115,8 @@ namespace Movement
         }
 
         PacketBuilder::WriteMonsterMove(move_spline, data);
+        if (unit.IsInWorld())
+            unit.GetMap()->DropRelayedMovement(&unit);
         unit.SendMessageToAllWhoSeeMe(data, true);
 
         return move_spline.Duration();
@@ -167,6 +170,8 @@ namespace Movement
         data << real_position.x << real_position.y << real_position.z;
         data << move_spline.GetId();
         data << uint8(MonsterMoveStop);
+        if (unit.IsInWorld())
+            unit.GetMap()->DropRelayedMovement(&unit);
         unit.SendMessageToAllWhoSeeMe(data, true);
     }
 
@@ -22,6 +22,7 @@
 #include "Util/ProgressBar.h"
 #include "Log.h"
 #include "Maps/MapPersistentStateMgr.h"
+#include "Maps/Map.h"
 #include "World/World.h"
 #include "Policies/Singleton.h"
 #include <algorithm>
@@ -1164,7 +1165,14 @@ struct SpawnPoolInMapsWorker
 
     void operator()(MapPersistentState* state)
     {
-        i_mgr.SpawnPool(*state, i_pool_id, i_instantly);
+        // a loaded map spawns it within its budget of deferred messages, in order with the other game event spawns
+        if (Map* map = state->GetMap())
+        {
+            SpawnPoolInMapsWorker worker(*this);
+            map->GetMessager().AddDeferredMessage([worker](Map* map) { worker.i_mgr.SpawnPool(*map->GetPersistentState(), worker.i_pool_id, worker.i_instantly); });
+        }
+        else
+            i_mgr.SpawnPool(*state, i_pool_id, i_instantly);
     }
 
     PoolManager& i_mgr;
@@ -1173,6 +1181,7 @@ struct SpawnPoolInMapsWorker
 };
 
 // used for calling from global systems when need spawn pool in all appropriate map persistent states
+// loaded maps apply it over the next ticks, see Messager::AddDeferredMessage
 void PoolManager::SpawnPoolInMaps(uint16 pool_id, bool instantly)
 {
     PoolTemplateData& poolTemplate = mPoolTemplate[pool_id];
@@ -1192,7 +1201,13 @@ struct DespawnPoolInMapsWorker
 
     void operator()(MapPersistentState* state)
     {
-        i_mgr.DespawnPool(*state, i_pool_id);
+        if (Map* map = state->GetMap())
+        {
+            DespawnPoolInMapsWorker worker(*this);
+            map->GetMessager().AddDeferredMessage([worker](Map* map) { worker.i_mgr.DespawnPool(*map->GetPersistentState(), worker.i_pool_id); });
+        }
+        else
+            i_mgr.DespawnPool(*state, i_pool_id);
     }
 
     PoolManager& i_mgr;
@@ -1227,7 +1242,13 @@ struct UpdatePoolInMapsWorker
 
     void operator()(MapPersistentState* state)
     {
-        i_mgr.UpdatePool<T>(*state, i_pool_id, i_db_guid_or_pool_id);
+        if (Map* map = state->GetMap())
+        {
+            UpdatePoolInMapsWorker worker(*this);
+            map->GetMessager().AddDeferredMessage([worker](Map* map) { worker.i_mgr.template UpdatePool<T>(*map->GetPersistentState(), worker.i_pool_id, worker.i_db_guid_or_pool_id); });
+        }
+        else
+            i_mgr.UpdatePool<T>(*state, i_pool_id, i_db_guid_or_pool_id);
     }
 
     PoolManager& i_mgr;
@@ -126,6 +126,9 @@ DBCStorage <SpellDurationEntry> sSpellDurationStore(SpellDurationfmt);
 DBCStorage <SpellFocusObjectEntry> sSpellFocusObjectStore(SpellFocusObjectfmt);
 DBCStorage <SpellRadiusEntry> sSpellRadiusStore(SpellRadiusfmt);
 DBCStorage <SpellRangeEntry> sSpellRangeStore(SpellRangefmt);
+DBCProjection <SpellCastTimesProjection> sSpellCastTimesProjection;
+DBCProjection <float> sSpellRadiusProjection;
+DBCProjection <SpellRangeProjection> sSpellRangeProjection;
 DBCStorage <SpellShapeshiftFormEntry> sSpellShapeshiftFormStore(SpellShapeshiftfmt);
 DBCStorage <StableSlotPricesEntry> sStableSlotPricesStore(StableSlotPricesfmt);
 // DBCStorage <SummonPropertiesEntry> sSummonPropertiesStore(SummonPropertiesfmt);
@@ -572,6 +575,16 @@ void LoadDBCStores(const std::string& dataPath)
         exit(1);
     }
 
+    sSpellCastTimesProjection.Build(sSpellCastTimesStore, [](SpellCastTimesEntry const& entry)
+    {
+        return SpellCastTimesProjection { entry.CastTime, entry.CastTimePerLevel, entry.MinCastTime };
+    });
+    sSpellRadiusProjection.Build(sSpellRadiusStore, [](SpellRadiusEntry const& entry) { return entry.Radius; });
+    sSpellRangeProjection.Build(sSpellRangeStore, [](SpellRangeEntry const& entry)
+    {
+        return SpellRangeProjection { entry.minRange, entry.maxRange, entry.Flags };
+    });
+
     sLog.outString(">> Initialized %d data stores", DBCFilesCount);
     sLog.outString();
 }
@@ -123,6 +123,10 @@ extern ItemSpellCategoryStore                    sItemSpellCategoryStore;
 extern PetFamilySpellsStore                      sPetFamilySpellsStore;
 extern DBCStorage <SpellRadiusEntry>             sSpellRadiusStore;
 extern DBCStorage <SpellRangeEntry>              sSpellRangeStore;
+// hot fields of the spell stores for the spell range, radius and cast time lookups
+extern DBCProjection <SpellCastTimesProjection>  sSpellCastTimesProjection;
+extern DBCProjection <float>                     sSpellRadiusProjection;
+extern DBCProjection <SpellRangeProjection>      sSpellRangeProjection;
 extern DBCStorage <SpellShapeshiftFormEntry>     sSpellShapeshiftFormStore;
 extern DBCStorage <StableSlotPricesEntry>        sStableSlotPricesStore;
 extern DBCStorage <TalentEntry>                  sTalentStore;
@@ -846,6 +846,13 @@ struct SpellCastTimesEntry
     int32     MinCastTime;                                  // 3        m_minimum
 };
 
+struct SpellCastTimesProjection                             // hot fields of SpellCastTimesEntry, see sSpellCastTimesProjection
+{
+    int32     CastTime;
+    int32     CastTimePerLevel;
+    int32     MinCastTime;
+};
+
 struct SpellFocusObjectEntry
 {
     uint32    ID;                                           // 0        m_ID
@@ -873,6 +880,13 @@ struct SpellRangeEntry
     // uint32 NameFlags;                                    // 21 string flags
 };
 
+struct SpellRangeProjection                                 // hot fields of SpellRangeEntry, see sSpellRangeProjection
+{
+    float     minRange;
+    float     maxRange;
+    uint32    Flags;
+};
+
 struct SpellShapeshiftFormEntry
 {
     uint32 ID;                                              // 0        m_ID
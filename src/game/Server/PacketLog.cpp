@@ -20,6 +20,8 @@
 #include "Server/WorldPacket.h"
 #include "Config/Config.h"
 #include "Globals/SharedDefines.h"
+#include "Multithreading/RecordQueue.h"
+#include "Server/Opcodes.h"
 
 #pragma pack(push, 1)
 
@@ -57,17 +59,42 @@ struct PacketHeader
 
 #pragma pack(pop)
 
-PacketLog::PacketLog() : _file(nullptr)
+// Queue of one capturing thread
+class PacketLogQueue : public RecordQueue<PacketHeader>
 {
+    public:
+        explicit PacketLogQueue(size_t capacity) : RecordQueue<PacketHeader>(capacity) {}
+};
+
+namespace
+{
+    struct PacketLogQueueHolder
+    {
+        ~PacketLogQueueHolder()
+        {
+            if (queue)
+                queue->Retire();
+        }
+
+        std::shared_ptr<PacketLogQueue> queue;
+    };
+
+    thread_local PacketLogQueueHolder threadPacketLogQueue;
+}
+
+PacketLog::PacketLog() : _file(nullptr), _indexFile(nullptr), _offset(0), _enabled(false), _allSessions(false),
+    _opcodeFilter(new std::atomic<bool>[NUM_MSG_TYPES]), _opcodeFilterCount(0), _lastConnectionId(0),
+    _queueSize(0), _flushInterval(0), _written(0), _stopWriter(false)
+{
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        _opcodeFilter[i] = false;
+
     std::call_once(_initializeFlag, &PacketLog::Initialize, this);
 }
 
 PacketLog::~PacketLog()
 {
-    if (_file)
-        fclose(_file);
-
-    _file = nullptr;
+    Close();
 }
 
 PacketLog* PacketLog::instance()
@@ -85,10 +112,17 @@ void PacketLog::Initialize()
         if ((logsDir.at(logsDir.length() - 1) != '/') && (logsDir.at(logsDir.length() - 1) != '\\'))
             logsDir.push_back('/');
 
+    _allSessions = sConfig.GetBoolDefault("PacketLogAllSessions", false);
+    _queueSize = GetRecordQueueCapacity(size_t(std::max(0, sConfig.GetIntDefault("PacketLogBufferSize", 1024))) * 1024);
+    _flushInterval = std::max(1, sConfig.GetIntDefault("PacketLogFlushInterval", 1000));
+
     std::string logname = sConfig.GetStringDefault("PacketLogFile", "");
     if (!logname.empty())
     {
-        _file = fopen((logsDir + logname).c_str(), "wb");
+        _fileName = logsDir + logname;
+        _file = fopen(_fileName.c_str(), "wb");
+        if (!_file)
+            return;
 
         LogHeader header;
         header.Signature[0] = 'P'; header.Signature[1] = 'K'; header.Signature[2] = 'T';
@@ -101,29 +135,177 @@ void PacketLog::Initialize()
         header.SniffStartTicks = WorldTimer::getMSTime();
         header.OptionalDataSize = 0;
 
-        if (CanLogPacket())
-            fwrite(&header, sizeof(header), 1, _file);
+        fwrite(&header, sizeof(header), 1, _file);
+        _offset = sizeof(header);
+
+        _indexFile = fopen((_fileName + ".idx").c_str(), "wb");
+        if (_indexFile)
+            fwrite(PACKET_LOG_INDEX_SIGNATURE, 4, 1, _indexFile);
+
+        _stopWriter = false;
+        _writer = std::thread(&PacketLog::WriterThread, this);
+        _enabled = true;
     }
 }
 
 void PacketLog::Reinitialize()
 {
-    std::lock_guard<std::mutex> lock(_logPacketLock);
-    if (CanLogPacket())
+    Close();
+    Initialize();
+}
+
+void PacketLog::Close()
+{
+    _enabled = false;
+
+    if (_writer.joinable())
     {
-        fclose(_file);
-        _file = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_wakeupLock);
+            _stopWriter = true;
+        }
+        _wakeup.notify_one();
+        _writer.join();
     }
-    Initialize();
+
+    std::lock_guard<std::mutex> lock(_logPacketLock);
+    DrainQueues();
+
+    if (_file)
+        fclose(_file);
+    _file = nullptr;
+
+    if (_indexFile)
+        fclose(_indexFile);
+    _indexFile = nullptr;
+}
+
+void PacketLog::SetOpcodeFilter(uint16 opcode, bool on)
+{
+    if (opcode >= NUM_MSG_TYPES || _opcodeFilter[opcode].exchange(on) == on)
+        return;
+
+    if (on)
+        ++_opcodeFilterCount;
+    else
+        --_opcodeFilterCount;
+}
+
+void PacketLog::ClearOpcodeFilter()
+{
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        SetOpcodeFilter(i, false);
+}
+
+bool PacketLog::IsOpcodeLogged(uint16 opcode) const
+{
+    // without filter every opcode is logged
+    if (!_opcodeFilterCount.load(std::memory_order_relaxed))
+        return true;
+
+    return opcode < NUM_MSG_TYPES && _opcodeFilter[opcode].load(std::memory_order_relaxed);
 }
 
-void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port)
+PacketLogStats PacketLog::GetStats()
 {
     std::lock_guard<std::mutex> lock(_logPacketLock);
+    PacketLogStats stats = _retiredStats;
+    for (auto const& queue : _queues)
+    {
+        stats.queued += queue->GetQueued();
+        stats.dropped += queue->GetDropped();
+        stats.overflowed += queue->GetOverflowed();
+    }
+
+    stats.written = _written;
+    return stats;
+}
 
+void PacketLog::WriterThread()
+{
+    while (!_stopWriter)
+    {
+        {
+            // woken early by a thread whose queue runs full
+            std::unique_lock<std::mutex> lock(_wakeupLock);
+            if (!_stopWriter)
+                _wakeup.wait_for(lock, std::chrono::milliseconds(_flushInterval));
+        }
+
+        std::lock_guard<std::mutex> lock(_logPacketLock);
+        if (DrainQueues())
+        {
+            fflush(_file);
+            if (_indexFile)
+                fflush(_indexFile);
+        }
+    }
+}
+
+size_t PacketLog::DrainQueues()
+{
+    size_t written = 0;
     PacketHeader header;
-    header.Direction = direction == CLIENT_TO_SERVER ? 0x47534d43 : 0x47534d53;
-    header.ConnectionId = 0;
+    for (auto itr = _queues.begin(); itr != _queues.end();)
+    {
+        PacketLogQueue& queue = **itr;
+
+        // checked before draining, a retired queue gets no more packets
+        bool const retired = queue.IsRetired();
+        while (queue.Pop(header, _payload))
+        {
+            WritePacket(header, _payload.data(), header.Length - sizeof(header.Opcode));
+            ++written;
+        }
+
+        if (retired)
+        {
+            _retiredStats.queued += queue.GetQueued();
+            _retiredStats.dropped += queue.GetDropped();
+            _retiredStats.overflowed += queue.GetOverflowed();
+            itr = _queues.erase(itr);
+        }
+        else
+            ++itr;
+    }
+
+    return written;
+}
+
+void PacketLog::WritePacket(PacketHeader const& header, char const* data, uint32 length)
+{
+    if (!_file)
+        return;
+
+    if (_indexFile)
+    {
+        PacketLogIndexEntry entry;
+        entry.Offset = _offset;
+        entry.ConnectionId = header.ConnectionId;
+        entry.ArrivalTicks = header.ArrivalTicks;
+        entry.Length = length;
+        entry.Opcode = uint16(header.Opcode);
+        entry.Direction = header.Direction == PACKET_LOG_DIRECTION_CMSG ? CLIENT_TO_SERVER : SERVER_TO_CLIENT;
+        entry.Reserved = 0;
+        fwrite(&entry, sizeof(entry), 1, _indexFile);
+    }
+
+    fwrite(&header, sizeof(header), 1, _file);
+    if (length)
+        fwrite(data, 1, length, _file);
+
+    _offset += sizeof(header) + length;
+    ++_written;
+}
+
+void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port, uint32 connectionId)
+{
+    if (!IsOpcodeLogged(packet.GetOpcode()))
+        return;
+
+    PacketHeader header;
+    header.Direction = direction == CLIENT_TO_SERVER ? PACKET_LOG_DIRECTION_CMSG : PACKET_LOG_DIRECTION_SMSG;
+    header.ConnectionId = connectionId;
     header.ArrivalTicks = WorldTimer::getMSTime();
 
     header.OptionalDataSize = sizeof(header.OptionalData);
@@ -143,9 +325,36 @@ void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost:
     header.Length = packet.size() + sizeof(header.Opcode);
     header.Opcode = packet.GetOpcode();
 
-    fwrite(&header, sizeof(header), 1, _file);
-    if (!packet.empty())
-        fwrite(packet.contents(), 1, packet.size(), _file);
+    if (!threadPacketLogQueue.queue)
+    {
+        threadPacketLogQueue.queue = std::make_shared<PacketLogQueue>(_queueSize);
 
-    fflush(_file);
+        std::lock_guard<std::mutex> lock(_logPacketLock);
+        _queues.push_back(threadPacketLogQueue.queue);
+    }
+
+    char const* data = packet.empty() ? "" : reinterpret_cast<char const*>(packet.contents());
+
+    PacketLogQueue& queue = *threadPacketLogQueue.queue;
+    if (queue.Push(header, data, uint32(packet.size())))
+    {
+        queue.CountQueued();
+        if (queue.IsHalfFull())
+            _wakeup.notify_one();
+        return;
+    }
+
+    // fits once the writer caught up, dropped rather than stalling the network or map thread
+    if (!queue.IsOversized(packet.size()))
+    {
+        queue.CountDropped();
+        return;
+    }
+
+    // never fits, written right away after everything queued before it
+    queue.CountOverflowed();
+
+    std::lock_guard<std::mutex> lock(_logPacketLock);
+    DrainQueues();
+    WritePacket(header, data, uint32(packet.size()));
 }
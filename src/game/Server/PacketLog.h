@@ -21,7 +21,12 @@
 #include "Common.h"
 
 #include <boost/asio/ip/address.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 enum Direction
 {
@@ -30,13 +35,50 @@ enum Direction
 };
 
 class WorldPacket;
+class PacketLogQueue;
+struct PacketHeader;
 
+#pragma pack(push, 1)
+
+// Entry of the index written next to the capture (<PacketLogFile>.idx), one per captured packet
+// Lets tools pick the packets of one connection or opcode without parsing the whole capture.
+struct PacketLogIndexEntry
+{
+    uint64 Offset;                                          // of the packet header in the capture
+    uint32 ConnectionId;
+    uint32 ArrivalTicks;
+    uint32 Length;                                          // packet data without opcode
+    uint16 Opcode;
+    uint8 Direction;
+    uint8 Reserved;
+};
+
+#pragma pack(pop)
+
+#define PACKET_LOG_INDEX_SIGNATURE  "PKI1"
+
+// Direction field of the PKT 3.1 packet header
+#define PACKET_LOG_DIRECTION_CMSG   0x47534d43              // "CMSG"
+#define PACKET_LOG_DIRECTION_SMSG   0x47534d53              // "SMSG"
+
+struct PacketLogStats
+{
+    PacketLogStats() : queued(0), dropped(0), overflowed(0), written(0) {}
+
+    uint64 queued;
+    uint64 dropped;                                         // queue of the capturing thread was full
+    uint64 overflowed;                                      // larger than a queue, written by the capturing thread
+    uint64 written;
+};
+
+// Captures world packets in PKT 3.1 format, parsable by WPP, plus an index for the replay tooling
+// Capturing threads only copy the packet into a queue of their own, a writer thread does the file I/O.
 class PacketLog
 {
     private:
         PacketLog();
         ~PacketLog();
-        std::mutex _logPacketLock;
+        std::mutex _logPacketLock;                          // file, queues and writer state
         std::once_flag _initializeFlag;
 
     public:
@@ -44,11 +86,52 @@ class PacketLog
 
         void Initialize();
         void Reinitialize();
-        bool CanLogPacket() const { return (_file != nullptr); }
-        void LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port);
+        bool CanLogPacket() const { return _enabled.load(std::memory_order_relaxed); }
+        void LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port, uint32 connectionId);
+
+        // every socket gets its own id, stored as ConnectionId of its packets
+        uint32 NewConnectionId() { return ++_lastConnectionId; }
+
+        // runtime filters: sessions enabled by .debug packetlog, or all of them, optionally only some opcodes
+        bool IsLoggingAllSessions() const { return _allSessions.load(std::memory_order_relaxed); }
+        void SetLoggingAllSessions(bool on) { _allSessions = on; }
+        void SetOpcodeFilter(uint16 opcode, bool on);
+        void ClearOpcodeFilter();
+        uint32 GetOpcodeFilterCount() const { return _opcodeFilterCount.load(); }
+        bool IsOpcodeLogged(uint16 opcode) const;
+
+        std::string const& GetFileName() const { return _fileName; }
+        PacketLogStats GetStats();
 
     private:
+        void Close();
+        void WriterThread();
+        // _logPacketLock has to be held for these
+        size_t DrainQueues();
+        void WritePacket(PacketHeader const& header, char const* data, uint32 length);
+
         FILE* _file;
+        FILE* _indexFile;
+        std::string _fileName;
+        uint64 _offset;
+        std::atomic<bool> _enabled;
+
+        std::atomic<bool> _allSessions;
+        std::unique_ptr<std::atomic<bool>[]> _opcodeFilter;
+        std::atomic<uint32> _opcodeFilterCount;
+        std::atomic<uint32> _lastConnectionId;
+
+        size_t _queueSize;
+        uint32 _flushInterval;
+        std::vector<std::shared_ptr<PacketLogQueue>> _queues;
+        std::vector<char> _payload;
+        PacketLogStats _retiredStats;                       // of queues whose thread exited
+        uint64 _written;
+
+        std::atomic<bool> _stopWriter;
+        std::mutex _wakeupLock;
+        std::condition_variable _wakeup;
+        std::thread _writer;
 };
 
 #define sPacketLog PacketLog::instance()
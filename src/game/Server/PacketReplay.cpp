@@ -0,0 +1,411 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/PacketReplay.h"
+#include "Server/PacketLog.h"
+#include "Server/WorldSession.h"
+#include "Server/WorldPacket.h"
+#include "Server/Opcodes.h"
+#include "Accounts/AccountMgr.h"
+#include "Globals/ObjectMgr.h"
+#include "Entities/Player.h"
+#include "World/World.h"
+#include "Log.h"
+
+#include <cstring>
+
+namespace
+{
+    // size of the PKT 3.1 file header up to its optional data
+    size_t const CAPTURE_HEADER_SIZE = 66;
+
+    struct CapturedPacket
+    {
+        uint32 direction;
+        uint32 connectionId;
+        uint32 ticks;
+        uint32 opcode;
+        uint32 length;                                      // of the data following the opcode
+    };
+
+    // checks the file header and positions the file at its first packet
+    FILE* OpenCapture(std::string const& fileName, std::string& error)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (!file)
+        {
+            error = "can not open " + fileName;
+            return nullptr;
+        }
+
+        uint8 header[CAPTURE_HEADER_SIZE];
+        uint16 version;
+        uint32 optionalSize;
+        if (fread(header, sizeof(header), 1, file) != 1 || std::memcmp(header, "PKT", 3) ||
+            (std::memcpy(&version, header + 3, sizeof(version)), version != 0x0301))
+        {
+            error = fileName + " is no PKT 3.1 capture";
+            fclose(file);
+            return nullptr;
+        }
+
+        std::memcpy(&optionalSize, header + CAPTURE_HEADER_SIZE - sizeof(uint32), sizeof(optionalSize));
+        if (optionalSize && fseek(file, optionalSize, SEEK_CUR))
+        {
+            error = fileName + " is truncated";
+            fclose(file);
+            return nullptr;
+        }
+
+        return file;
+    }
+
+    // reads the packet header at the current position, the file is left at the packet data
+    // the optional data size is honoured, so captures of other sniffers can be read as well
+    bool ReadCapturedPacket(FILE* file, CapturedPacket& packet)
+    {
+        uint32 fields[5];                                   // direction, connection, ticks, optional data size, length
+        if (fread(fields, sizeof(fields), 1, file) != 1)
+            return false;
+
+        if (fields[3] && fseek(file, fields[3], SEEK_CUR))
+            return false;
+
+        if (fields[4] < sizeof(uint32) || fread(&packet.opcode, sizeof(uint32), 1, file) != 1)
+            return false;
+
+        packet.direction = fields[0];
+        packet.connectionId = fields[1];
+        packet.ticks = fields[2];
+        packet.length = fields[4] - sizeof(uint32);
+        return true;
+    }
+
+    // a capture that is still written may end with a partial entry, it is ignored
+    bool ReadIndex(std::string const& fileName, std::vector<PacketLogIndexEntry>& entries)
+    {
+        FILE* file = fopen((fileName + ".idx").c_str(), "rb");
+        if (!file)
+            return false;
+
+        char signature[4];
+        if (fread(signature, sizeof(signature), 1, file) != 1 || std::memcmp(signature, PACKET_LOG_INDEX_SIGNATURE, sizeof(signature)))
+        {
+            fclose(file);
+            return false;
+        }
+
+        PacketLogIndexEntry entry;
+        while (fread(&entry, sizeof(entry), 1, file) == 1)
+            entries.push_back(entry);
+
+        fclose(file);
+        return true;
+    }
+
+    // the login is done by the replay, keep alive packets are answered by the socket
+    bool IsSkippedOpcode(uint32 opcode)
+    {
+        switch (opcode)
+        {
+            case CMSG_AUTH_SESSION:
+            case CMSG_PING:
+            case CMSG_KEEP_ALIVE:
+            case CMSG_WARDEN_DATA:
+            case CMSG_CHAR_ENUM:
+                return true;
+            default:
+                return opcode >= NUM_MSG_TYPES;
+        }
+    }
+}
+
+PacketReplay& PacketReplay::Instance()
+{
+    static PacketReplay replay;
+    return replay;
+}
+
+bool PacketReplay::ReadConnections(std::string const& fileName, std::map<uint32, PacketReplayConnection>& connections, std::string& error)
+{
+    auto addPacket = [&connections](uint32 connectionId, bool client, uint32 ticks)
+    {
+        PacketReplayConnection& connection = connections[connectionId];
+        if (!connection.clientPackets && !connection.serverPackets)
+            connection.firstTicks = ticks;
+
+        connection.lastTicks = ticks;
+        if (client)
+            ++connection.clientPackets;
+        else
+            ++connection.serverPackets;
+    };
+
+    std::vector<PacketLogIndexEntry> index;
+    if (ReadIndex(fileName, index))
+    {
+        for (PacketLogIndexEntry const& entry : index)
+            addPacket(entry.ConnectionId, entry.Direction == CLIENT_TO_SERVER, entry.ArrivalTicks);
+
+        return true;
+    }
+
+    // no index, walk the capture
+    FILE* file = OpenCapture(fileName, error);
+    if (!file)
+        return false;
+
+    CapturedPacket packet;
+    while (ReadCapturedPacket(file, packet))
+    {
+        addPacket(packet.connectionId, packet.direction == PACKET_LOG_DIRECTION_CMSG, packet.ticks);
+        if (fseek(file, packet.length, SEEK_CUR))
+            break;
+    }
+
+    fclose(file);
+    return true;
+}
+
+bool PacketReplay::ReadPackets(std::string const& fileName, uint32 connectionId, std::vector<Packet>& packets, std::string& error)
+{
+    FILE* file = OpenCapture(fileName, error);
+    if (!file)
+        return false;
+
+    std::vector<PacketLogIndexEntry> index;
+    bool const indexed = ReadIndex(fileName, index);
+    auto indexItr = index.begin();
+
+    uint32 firstTicks = 0;
+    CapturedPacket packet;
+    while (true)
+    {
+        if (indexed)
+        {
+            // jump straight to the client packets of the connection
+            while (indexItr != index.end() && (indexItr->ConnectionId != connectionId || indexItr->Direction != CLIENT_TO_SERVER))
+                ++indexItr;
+
+            if (indexItr == index.end() || fseek(file, long(indexItr->Offset), SEEK_SET))
+                break;
+
+            ++indexItr;
+        }
+
+        if (!ReadCapturedPacket(file, packet))
+            break;
+
+        if (packet.connectionId != connectionId || packet.direction != PACKET_LOG_DIRECTION_CMSG)
+        {
+            if (fseek(file, packet.length, SEEK_CUR))
+                break;
+
+            continue;
+        }
+
+        std::vector<uint8> data(packet.length);
+        if (packet.length && fread(data.data(), packet.length, 1, file) != 1)
+            break;
+
+        // only the time in world of the captured session is replayed
+        if (packet.opcode == CMSG_PLAYER_LOGIN)
+        {
+            packets.clear();
+            continue;
+        }
+
+        if (packet.opcode == CMSG_LOGOUT_REQUEST && !packets.empty())
+            break;
+
+        if (IsSkippedOpcode(packet.opcode))
+            continue;
+
+        if (packets.empty())
+            firstTicks = packet.ticks;
+
+        packets.push_back({ packet.ticks - firstTicks, uint16(packet.opcode), std::move(data) });
+    }
+
+    fclose(file);
+
+    if (packets.empty())
+    {
+        error = "capture has no client packets of connection " + std::to_string(connectionId);
+        return false;
+    }
+
+    return true;
+}
+
+bool PacketReplay::Start(std::string const& fileName, uint32 connectionId, std::string const& characterName, uint32 step, std::string& error)
+{
+    std::string name = characterName;
+    if (!normalizePlayerName(name))
+    {
+        error = "invalid character name " + characterName;
+        return false;
+    }
+
+    ObjectGuid guid = sObjectMgr.GetPlayerGuidByName(name);
+    uint32 accountId = sObjectMgr.GetPlayerAccountIdByPlayerName(name);
+    if (!guid || !accountId)
+    {
+        error = "character " + name + " does not exist";
+        return false;
+    }
+
+    if (sWorld.FindSession(accountId))
+    {
+        error = "account of " + name + " is online";
+        return false;
+    }
+
+    for (Replay const& replay : m_replays)
+    {
+        if (replay.accountId == accountId)
+        {
+            error = "account of " + name + " is already replaying";
+            return false;
+        }
+    }
+
+    std::vector<Packet> packets;
+    if (!ReadPackets(fileName, connectionId, packets, error))
+        return false;
+
+    std::string accountName;
+    sAccountMgr.GetName(accountId, accountName);
+
+    WorldSession* session = new WorldSession(accountId, nullptr, sAccountMgr.GetSecurity(accountId), 0, DEFAULT_LOCALE, accountName, 0);
+    session->SetNoAnticheat();
+    session->SetSimulatedClient(true);
+    sWorld.AddSession(session);
+
+    m_replays.push_back(Replay());
+    Replay& replay = m_replays.back();
+    replay.fileName = fileName;
+    replay.connectionId = connectionId;
+    replay.accountId = accountId;
+    replay.character = guid;
+    replay.step = step;
+    replay.packets = std::move(packets);
+    replay.next = 0;
+    replay.time = 0;
+    replay.ticks = 0;
+    replay.loginSent = false;
+    replay.loggedIn = false;
+
+    sLog.outString("Packet replay: replaying %u packets of connection %u from %s as %s",
+                   uint32(replay.packets.size()), connectionId, fileName.c_str(), name.c_str());
+    return true;
+}
+
+bool PacketReplay::Stop(uint32 accountId)
+{
+    for (Replay& replay : m_replays)
+    {
+        if (replay.accountId == accountId)
+        {
+            // logged out and dropped at the next update
+            replay.next = replay.packets.size();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void PacketReplay::StopAll()
+{
+    for (Replay& replay : m_replays)
+        replay.next = replay.packets.size();
+}
+
+void PacketReplay::Update(uint32 diff)
+{
+    for (auto itr = m_replays.begin(); itr != m_replays.end();)
+    {
+        Replay& replay = *itr;
+        WorldSession* session = sWorld.FindSession(replay.accountId);
+        if (!session)
+        {
+            // sessions are added to the world with the next session update
+            if (replay.loginSent)
+            {
+                sLog.outError("Packet replay: session of connection %u from %s was removed after %u of %u packets",
+                              replay.connectionId, replay.fileName.c_str(), uint32(replay.next), uint32(replay.packets.size()));
+                itr = m_replays.erase(itr);
+            }
+            else
+                ++itr;
+
+            continue;
+        }
+
+        if (!replay.loggedIn)
+        {
+            if (!replay.loginSent)
+            {
+                std::unique_ptr<WorldPacket> login = std::make_unique<WorldPacket>(CMSG_PLAYER_LOGIN, 8);
+                *login << replay.character;
+                session->QueuePacket(std::move(login));
+                replay.loginSent = true;
+            }
+            else if (session->GetPlayer() && session->GetPlayer()->IsInWorld())
+            {
+                replay.loggedIn = true;
+                replay.started = std::chrono::steady_clock::now();
+            }
+
+            // stopped before being in world
+            if (!replay.loggedIn && replay.next < replay.packets.size())
+            {
+                ++itr;
+                continue;
+            }
+        }
+
+        if (replay.next < replay.packets.size())
+        {
+            replay.time += replay.step ? replay.step : diff;
+            ++replay.ticks;
+
+            while (replay.next < replay.packets.size() && replay.packets[replay.next].time <= replay.time)
+            {
+                Packet const& packet = replay.packets[replay.next++];
+                std::unique_ptr<WorldPacket> worldPacket = std::make_unique<WorldPacket>(Opcodes(packet.opcode), packet.data.size());
+                if (!packet.data.empty())
+                    worldPacket->append(packet.data.data(), packet.data.size());
+
+                session->QueuePacket(std::move(worldPacket));
+            }
+
+            ++itr;
+            continue;
+        }
+
+        uint32 const elapsed = replay.loggedIn ? uint32(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - replay.started).count()) : 0;
+        sLog.outString("Packet replay: connection %u from %s done, %u packets in %u world ticks, %u ms (%.2f ms per tick)",
+                       replay.connectionId, replay.fileName.c_str(), uint32(replay.packets.size()), replay.ticks, elapsed,
+                       replay.ticks ? float(elapsed) / replay.ticks : 0.0f);
+
+        session->KickPlayer(true, true);
+        itr = m_replays.erase(itr);
+    }
+}
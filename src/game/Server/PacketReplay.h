@@ -0,0 +1,95 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PACKET_REPLAY_H
+#define MANGOS_PACKET_REPLAY_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+struct PacketReplayConnection
+{
+    PacketReplayConnection() : clientPackets(0), serverPackets(0), firstTicks(0), lastTicks(0) {}
+
+    uint32 clientPackets;
+    uint32 serverPackets;
+    uint32 firstTicks;
+    uint32 lastTicks;
+};
+
+// Replays the client packets of one captured connection (PacketLogFile) through a session without socket
+// The character is logged in by the replay itself, the captured login sequence is skipped. Captured packets are
+// handed to the session by their recorded time: every world tick advances the recorded time by a fixed step, so
+// the same capture always ends up in the same ticks no matter how long the ticks take. The wall time the replay
+// needed is reported at the end, which makes a capture usable as a regression benchmark.
+class PacketReplay
+{
+    public:
+        static PacketReplay& Instance();
+
+        // connections of a capture, uses the index written next to it when there is one
+        static bool ReadConnections(std::string const& fileName, std::map<uint32, PacketReplayConnection>& connections, std::string& error);
+
+        // step is the recorded time in ms each world tick advances, 0 replays in real time
+        bool Start(std::string const& fileName, uint32 connectionId, std::string const& characterName, uint32 step, std::string& error);
+        bool Stop(uint32 accountId);
+        void StopAll();
+
+        // world thread
+        void Update(uint32 diff);
+
+        uint32 GetActiveCount() const { return uint32(m_replays.size()); }
+
+    private:
+        struct Packet
+        {
+            uint32 time;                                    // ms since the first packet of the connection
+            uint16 opcode;
+            std::vector<uint8> data;
+        };
+
+        struct Replay
+        {
+            std::string fileName;
+            uint32 connectionId;
+            uint32 accountId;
+            ObjectGuid character;
+            uint32 step;
+            std::vector<Packet> packets;
+            size_t next;
+            uint32 time;
+            uint32 ticks;
+            bool loginSent;
+            bool loggedIn;
+            std::chrono::steady_clock::time_point started;
+        };
+
+        static bool ReadPackets(std::string const& fileName, uint32 connectionId, std::vector<Packet>& packets, std::string& error);
+
+        std::list<Replay> m_replays;
+};
+
+#define sPacketReplay PacketReplay::Instance()
+
+#endif
@@ -96,10 +96,11 @@ bool WorldSessionFilter::Process(WorldPacket const& packet) const
 WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, time_t mute_time, LocaleConstant locale, std::string accountName, uint32 accountFlags) :
     m_muteTime(mute_time), m_accountName(accountName),
     _player(nullptr), m_Socket(sock ? sock->shared<WorldSocket>() : nullptr), _security(sec), _accountId(id), _logoutTime(0),
-    m_inQueue(false), m_playerLoading(false), m_kickSession(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_orderCounter(0), m_playerSave(true),
+    m_inQueue(false), m_playerLoading(false),
+    m_loginPrefetch(nullptr), m_loginPrefetchReady(false), m_loginPrefetchWanted(false), m_kickSession(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_orderCounter(0), m_playerSave(true),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetStorageLocaleIndexFor(locale)),
     m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_sessionState(WORLD_SESSION_STATE_CREATED),
-    m_requestSocket(nullptr), m_accountFlags(accountFlags), m_clientOS(CLIENT_OS_UNKNOWN), m_clientPlatform(CLIENT_PLATFORM_UNKNOWN) {}
+    m_requestSocket(nullptr), m_simulatedClient(false), m_accountFlags(accountFlags), m_clientOS(CLIENT_OS_UNKNOWN), m_clientPlatform(CLIENT_PLATFORM_UNKNOWN) {}
 
 /// WorldSession destructor
 WorldSession::~WorldSession()
@@ -108,6 +109,8 @@ WorldSession::~WorldSession()
     if (_player)
         LogoutPlayer();
 
+    DiscardPlayerLoginPrefetch();
+
     // marks this session as finalized in the socket which references (BUT DOES NOT OWN) it.
     // this lets the socket handling code know that the socket can be safely deleted
     if (m_Socket)
@@ -144,7 +147,7 @@ void WorldSession::SetOffline()
 
 void WorldSession::SetOnline()
 {
-    if (_player && m_Socket && !m_Socket->IsClosed())
+    if (_player && IsConnected())
     {
         m_sessionState = WORLD_SESSION_STATE_READY;
         m_kickTime = 0;
@@ -353,7 +356,7 @@ bool WorldSession::Update(uint32 diff)
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !recvQueueCopy.empty())
+    while (IsConnected() && !recvQueueCopy.empty())
     {
         // sLog.outError("MOEP: %s (0x%.4X)", packet->GetOpcodeName(), packet->GetOpcode());
 
@@ -492,7 +495,7 @@ bool WorldSession::Update(uint32 diff)
 
             // waiting to go online
             // TODO:: Maybe check if have to send queue update?
-            if (!m_Socket || (m_Socket && m_Socket->IsClosed()))
+            if (!IsConnected())
             {
                 // directly remove this session
                 return false;
@@ -551,7 +554,7 @@ void WorldSession::UpdateMap(uint32 diff)
         std::swap(recvQueueMapCopy, m_recvQueueMap);
     }
 
-    while (m_Socket && !m_Socket->IsClosed() && recvQueueMapCopy.size())
+    while (IsConnected() && recvQueueMapCopy.size())
     {
         auto const packet = std::move(recvQueueMapCopy.front());
         recvQueueMapCopy.pop_front();
@@ -617,7 +620,7 @@ void WorldSession::LogoutPlayer()
             _player->CombatStopWithPets(true, true);
 
         if (_player->IsInLFG())
-            sWorld.GetLFGQueue().GetMessager().AddMessage([playerGuid = _player->GetObjectGuid()](LFGQueue* queue)
+            sWorld.GetLFGQueue().AddMessage([playerGuid = _player->GetObjectGuid()](LFGQueue* queue)
         {
             queue->RemovePlayerFromQueue(playerGuid, PLAYER_SYSTEM_LEAVE);
         });
@@ -693,7 +696,7 @@ void WorldSession::LogoutPlayer()
 
         // remove player from the group if he is:
         // a) in group; b) not in raid group; c) logging out normally (not being kicked or disconnected)
-        if (_player->GetGroup() && !_player->GetGroup()->IsRaidGroup() && m_Socket && !m_Socket->IsClosed())
+        if (_player->GetGroup() && !_player->GetGroup()->IsRaidGroup() && IsConnected())
             _player->RemoveFromGroup();
 
         ///- Send update to group
@@ -771,6 +774,7 @@ void WorldSession::LogoutPlayer()
             m_Socket->Close();
             m_Socket = nullptr;
         }
+        m_simulatedClient = false;
         m_kickSession = false;
     }
 }
@@ -1254,15 +1258,11 @@ void WorldSession::SetDelayedAnticheat(std::unique_ptr<SessionAnticheatInterface
     m_delayedAnticheat = std::move(anticheat);
 }
 
-#ifdef BUILD_PLAYERBOT
-
 void WorldSession::SetNoAnticheat()
 {
     m_anticheat.reset(new NullSessionAnticheat(this));
 }
 
-#endif
-
 void WorldSession::HandleWardenDataOpcode(WorldPacket& recv_data)
 {
     m_anticheat->WardenPacket(recv_data);
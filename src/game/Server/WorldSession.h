@@ -250,9 +250,14 @@ class WorldSession
         void SetDelayedAnticheat(std::unique_ptr<SessionAnticheatInterface>&& anticheat);
         SessionAnticheatInterface* GetAnticheat() const { return m_anticheat.get(); }
 
-#ifdef BUILD_PLAYERBOT
+        // bots and simulated clients
         void SetNoAnticheat();
-#endif
+
+        // session without socket fed by the server itself (packet replay), handled like a connected client
+        void SetSimulatedClient(bool on) { m_simulatedClient = on; }
+        bool IsSimulatedClient() const { return m_simulatedClient; }
+        // socket open or simulated client
+        bool IsConnected() const { return m_simulatedClient || (m_Socket && !m_Socket->IsClosed()); }
 
         /// Session in auth.queue currently
         void SetInQueue(bool state) { m_inQueue = state; }
@@ -424,6 +429,12 @@ class WorldSession
         void HandlePlayerLogin(LoginQueryHolder* holder);
         void HandlePlayerReconnect();
 
+        // character select login prefetch
+        void PrefetchPlayerLogin(ObjectGuid guid);
+        bool HandlePlayerLoginPrefetched(LoginQueryHolder* holder);
+        void LoginFromPrefetch();
+        void DiscardPlayerLoginPrefetch();
+
         // played time
         void HandlePlayedTime(WorldPacket& recvPacket);
 
@@ -816,6 +827,7 @@ class WorldSession
         Player* _player;
         std::shared_ptr<WorldSocket> m_Socket;              // socket pointer is owned by the network thread which created it
         std::shared_ptr<WorldSocket> m_requestSocket;       // a new socket for this session is requested (double connection)
+        bool m_simulatedClient;
         std::string m_localAddress;
         WorldSessionState m_sessionState;                   // this session state
 
@@ -839,6 +851,9 @@ class WorldSession
         bool m_playerSave;                                  // should we have to save the player after logout request
         bool m_inQueue;                                     // session wait in auth.queue
         bool m_playerLoading;                               // code processed in LoginPlayer
+        LoginQueryHolder* m_loginPrefetch;                  // character loaded ahead at character select
+        bool m_loginPrefetchReady;                          // m_loginPrefetch queries executed
+        bool m_loginPrefetchWanted;                         // client asked to login m_loginPrefetch before it was ready
         bool m_kickSession;
 
         // True when the player is in the process of logging out (WorldSession::LogoutPlayer is currently executing)
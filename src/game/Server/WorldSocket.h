@@ -127,6 +127,7 @@ class WorldSocket : public MaNGOS::Socket
         std::deque<uint32> m_opcodeHistoryInc;
 
         bool m_loggingPackets;
+        const uint32 m_packetLogId;                         // connection id in packet captures
 
     public:
         WorldSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
@@ -46,6 +46,7 @@
 #include "MotionGenerators/PathFinder.h"
 #include "Spells/Scripts/SpellScript.h"
 #include "Entities/ObjectGuid.h"
+#include "World/TickProfiler.h"
 
 extern pEffect SpellEffects[MAX_SPELL_EFFECTS];
 
@@ -498,8 +499,7 @@ template<typename T>
 WorldObject* Spell::FindCorpseUsing()
 {
     // non-standard target selection
-    SpellRangeEntry const* srange = sSpellRangeStore.LookupEntry(m_spellInfo->rangeIndex);
-    float max_range = GetSpellMaxRange(srange);
+    float max_range = GetSpellMaxRangeByIndex(m_spellInfo->rangeIndex);
 
     WorldObject* result = nullptr;
 
@@ -1851,7 +1851,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, bool targ
         }
         case TARGET_LOCATION_CASTER_FRONT_LEAP:
         {
-            float dist = GetSpellRadius(sSpellRadiusStore.LookupEntry(m_spellInfo->EffectRadiusIndex[effIndex]));
+            float dist = GetSpellRadiusByIndex(m_spellInfo->EffectRadiusIndex[effIndex]);
             const float IN_OR_UNDER_LIQUID_RANGE = 0.8f;                // range to make player under liquid or on liquid surface from liquid level
 
             G3D::Vector3 prevPos, nextPos;
@@ -2015,8 +2015,8 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, bool targ
             float x, y, z;
             // special code for fishing bobber (TARGET_LOCATION_CASTER_FISHING_SPOT), should not try to avoid objects
             // nor try to find ground level, but randomly vary in angle
-            float min_dis = GetSpellMinRange(sSpellRangeStore.LookupEntry(m_spellInfo->rangeIndex));
-            float max_dis = GetSpellMaxRange(sSpellRangeStore.LookupEntry(m_spellInfo->rangeIndex));
+            float min_dis = GetSpellMinRangeByIndex(m_spellInfo->rangeIndex);
+            float max_dis = GetSpellMaxRangeByIndex(m_spellInfo->rangeIndex);
             SpellCastResult result = SPELL_CAST_OK;
             for (uint32 i = 0; i < 10; ++i)
             {
@@ -4055,7 +4055,7 @@ void Spell::SendChannelStart(uint32 duration)
                 target = ObjectAccessor::GetUnit(*m_caster, itr->targetGUID);
                 if (m_spellInfo->EffectRadiusIndex[EFFECT_INDEX_0] != 0 &&
                     (m_spellInfo->EffectApplyAuraName[EFFECT_INDEX_0] == SPELL_AURA_MOD_POSSESS || m_spellInfo->EffectApplyAuraName[EFFECT_INDEX_0] == SPELL_AURA_BIND_SIGHT))
-                    m_maxRange = GetSpellRadius(sSpellRadiusStore.LookupEntry(m_spellInfo->EffectRadiusIndex[EFFECT_INDEX_0]));
+                    m_maxRange = GetSpellRadiusByIndex(m_spellInfo->EffectRadiusIndex[EFFECT_INDEX_0]);
                 break;
             }
         }
@@ -5060,7 +5060,7 @@ SpellCastResult Spell::CheckCast(bool strict)
                 if (m_targets.m_targetMask & (TARGET_FLAG_DEST_LOCATION | TARGET_FLAG_SOURCE_LOCATION))
                 {
                     UnitList targetsCombat;
-                    float radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(m_spellInfo->EffectRadiusIndex[i]));
+                    float radius = GetSpellRadiusByIndex(m_spellInfo->EffectRadiusIndex[i]);
 
                     FillAreaTargets(targetsCombat, radius, 0.f, PUSH_DEST_CENTER, SPELL_TARGETS_AOE_ATTACKABLE);
 
@@ -5286,7 +5286,7 @@ SpellCastResult Spell::CheckCast(bool strict)
 
                 if (Unit* target = m_targets.getUnitTarget())
                 {
-                    float range = GetSpellMaxRange(sSpellRangeStore.LookupEntry(m_spellInfo->rangeIndex));
+                    float range = GetSpellMaxRangeByIndex(m_spellInfo->rangeIndex);
 
                     Position pos;
                     target->GetFirstCollisionPosition(pos, target->GetCombatReach(), target->GetAngle(m_caster));
@@ -6080,7 +6080,7 @@ std::pair<float, float> Spell::GetMinMaxRange(bool strict)
 
     Unit* caster = dynamic_cast<Unit*>(m_trueCaster); // preparation for GO casting
 
-    SpellRangeEntry const* spellRange = sSpellRangeStore.LookupEntry(m_spellInfo->rangeIndex);
+    SpellRangeProjection const* spellRange = sSpellRangeProjection.Lookup(m_spellInfo->rangeIndex);
     if (spellRange)
     {
         Unit* target = m_targets.getUnitTarget();
@@ -6098,8 +6098,8 @@ std::pair<float, float> Spell::GetMinMaxRange(bool strict)
                     meleeRange = caster->GetCombinedCombatReach(target ? target : caster, true, 0.f);
             }
 
-            minRange = GetSpellMinRange(spellRange) + meleeRange;
-            maxRange = GetSpellMaxRange(spellRange);
+            minRange = spellRange->minRange + meleeRange;
+            maxRange = spellRange->maxRange;
 
             if (target || m_targets.getCorpseTarget())
             {
@@ -6142,7 +6142,7 @@ SpellCastResult Spell::CheckRange(bool strict)
     std::tie(minRange, maxRange) = GetMinMaxRange(strict);
 
     // non strict spell tolerance
-    if (SpellRangeEntry const* spellRange = sSpellRangeStore.LookupEntry(m_spellInfo->rangeIndex))
+    if (SpellRangeProjection const* spellRange = sSpellRangeProjection.Lookup(m_spellInfo->rangeIndex))
         if ((spellRange->Flags & SPELL_RANGE_FLAG_MELEE) == 0 && !strict)
             maxRange += std::min(3.f, maxRange * 0.1f); // 10% but no more than MAX_SPELL_RANGE_TOLERANCE
 
@@ -7015,7 +7015,7 @@ bool Spell::HaveTargetsForEffect(SpellEffectIndex effect) const
     return false;
 }
 
-SpellEvent::SpellEvent(Spell* spell) : BasicEvent()
+SpellEvent::SpellEvent(Spell* spell)
 {
     m_Spell = spell;
 }
@@ -7042,7 +7042,10 @@ bool SpellEvent::Execute(uint64 e_time, uint32 p_time)
 {
     // update spell if it is not finished
     if (m_Spell->getState() != SPELL_STATE_FINISHED)
+    {
+        TICK_PROFILE_ZONE("spell");
         m_Spell->update(p_time);
+    }
 
     // check spell state to process
     switch (m_Spell->getState())
@@ -7406,9 +7409,9 @@ void Spell::ClearCastItem()
 void Spell::GetSpellRangeAndRadius(SpellEffectIndex effIndex, float& radius, bool targetB, uint32& EffectChainTarget)
 {
     if (m_spellInfo->EffectRadiusIndex[effIndex])
-        radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(m_spellInfo->EffectRadiusIndex[effIndex]));
+        radius = GetSpellRadiusByIndex(m_spellInfo->EffectRadiusIndex[effIndex]);
     else
-        radius = GetSpellMaxRange(sSpellRangeStore.LookupEntry(m_spellInfo->rangeIndex));
+        radius = GetSpellMaxRangeByIndex(m_spellInfo->rangeIndex);
 
     uint32 targetMode;
     if (!targetB)
@@ -335,6 +335,8 @@ class SpellCastArgs
 
 class Spell
 {
+        SLAB_ALLOCATED(Spell)
+
         friend struct MaNGOS::SpellNotifierPlayer;
         friend struct MaNGOS::SpellNotifierCreatureAndPlayer;
         friend void Unit::SetCurrentCastedSpell(Spell* pSpell);
@@ -1126,7 +1128,7 @@ namespace MaNGOS
 
 typedef void(Spell::*pEffect)(SpellEffectIndex eff_idx);
 
-class SpellEvent : public BasicEvent
+class SpellEvent : public PooledEvent<SpellEvent>
 {
     public:
         SpellEvent(Spell* spell);
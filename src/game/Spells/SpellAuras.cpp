@@ -332,7 +332,7 @@ AreaAura::AreaAura(SpellEntry const* spellproto, SpellEffectIndex eff, int32 con
     // caster==nullptr in constructor args if target==caster in fact
     Unit* caster_ptr = caster ? caster : target;
 
-    m_radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(spellproto->EffectRadiusIndex[m_effIndex]));
+    m_radius = GetSpellRadiusByIndex(spellproto->EffectRadiusIndex[m_effIndex]);
     if (Player* modOwner = caster_ptr->GetSpellModOwner())
         modOwner->ApplySpellMod(spellproto->Id, SPELLMOD_RADIUS, m_radius);
 
@@ -704,6 +704,15 @@ void Aura::ApplyModifier(bool apply, bool Real)
         OnAfterApply(apply);
     if (!apply)
         OnApply(apply);
+
+    // handlers may recalculate the amount
+    GetTarget()->InvalidateAuraModifierTotals(aura);
+}
+
+void Aura::SetAmount(int32 amount)
+{
+    m_modifier.m_amount = amount;
+    GetTarget()->InvalidateAuraModifierTotals(m_modifier.m_auraname);
 }
 
 ClassFamilyMask Aura::GetAuraSpellClassMask() const
@@ -5109,7 +5118,7 @@ void Aura::PeriodicDummyTick()
                 case 23487:                                 // Separation Anxiety (Garr)
                     if (Unit* caster = GetCaster())
                     {
-                        float m_radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(spell->EffectRadiusIndex[m_effIndex]));
+                        float m_radius = GetSpellRadiusByIndex(spell->EffectRadiusIndex[m_effIndex]);
                         if (caster->IsAlive() && !caster->IsWithinDistInMap(target, m_radius))
                             target->CastSpell(target, (spell->Id == 21094 ? 21095 : 23492), TRIGGERED_OLD_TRIGGERED, nullptr);      // Spell 21095: Separation Anxiety for Majordomo Executus' adds, 23492: Separation Anxiety for Garr's adds
                     }
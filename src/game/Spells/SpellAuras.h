@@ -23,6 +23,7 @@
 #include "Server/DBCEnums.h"
 #include "Entities/ObjectGuid.h"
 #include "Spells/Scripts/SpellScript.h"
+#include "Utilities/SlabAllocator.h"
 
 /**
  * Used to modify what an Aura does to a player/npc.
@@ -92,6 +93,8 @@ enum SpellAuraHolderState
 
 class SpellAuraHolder
 {
+        SLAB_ALLOCATED(SpellAuraHolder)
+
     public:
         SpellAuraHolder(SpellEntry const* spellproto, Unit* target, WorldObject* caster, Item* castItem, SpellEntry const* triggeredBy);
         ~SpellAuraHolder();
@@ -266,6 +269,8 @@ typedef void(Aura::*pAuraHandler)(bool Apply, bool Real);
 
 class Aura
 {
+        SLAB_ALLOCATED(Aura)
+
         friend struct ReapplyAffectedPassiveAurasHelper;
         friend Aura* CreateAura(SpellEntry const* spellproto, SpellEffectIndex eff, int32 const* currentDamage, int32 const* currentBasePoints, SpellAuraHolder* holder, Unit* target, Unit* caster, Item* castItem, uint64 scriptValue);
 
@@ -423,7 +428,7 @@ class Aura
         SpellEffectIndex GetEffIndex() const { return m_effIndex; }
         int32 GetBasePoints() const { return m_currentBasePoints; }
         int32 GetAmount() const { return m_modifier.m_amount; }
-        void SetAmount(int32 amount) { m_modifier.m_amount = amount; }
+        void SetAmount(int32 amount);
 
         int32 GetAuraMaxDuration() const { return GetHolder()->GetAuraMaxDuration(); }
         int32 GetAuraDuration() const { return GetHolder()->GetAuraDuration(); }
@@ -2194,7 +2194,7 @@ void Spell::EffectPersistentAA(SpellEffectIndex eff_idx)
 
     SpellTarget target = SpellTarget(m_spellInfo->EffectImplicitTargetB[eff_idx] ? m_spellInfo->EffectImplicitTargetB[eff_idx] : m_spellInfo->EffectImplicitTargetA[eff_idx]);
 
-    float radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(m_spellInfo->EffectRadiusIndex[eff_idx]));
+    float radius = GetSpellRadiusByIndex(m_spellInfo->EffectRadiusIndex[eff_idx]);
 
     if (Player* modOwner = pCaster->GetSpellModOwner())
         modOwner->ApplySpellMod(m_spellInfo->Id, SPELLMOD_RADIUS, radius);
@@ -2930,7 +2930,7 @@ void Spell::EffectSummonWild(SpellEffectIndex eff_idx)
     float center_y = m_targets.m_destPos.y;
     float center_z = m_targets.m_destPos.z;
 
-    float radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(m_spellInfo->EffectRadiusIndex[eff_idx]));
+    float radius = GetSpellRadiusByIndex(m_spellInfo->EffectRadiusIndex[eff_idx]);
     TempSpawnType summonType = (m_duration == 0) ? TEMPSPAWN_DEAD_DESPAWN : TEMPSPAWN_TIMED_OR_DEAD_DESPAWN;
 
     int32 amount = damage > 0 ? damage : 1;
@@ -3066,7 +3066,7 @@ void Spell::EffectSummonGuardian(SpellEffectIndex eff_idx)
     float center_y = m_targets.m_destPos.y;
     float center_z = m_targets.m_destPos.z;
 
-    float radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(m_spellInfo->EffectRadiusIndex[eff_idx]));
+    float radius = GetSpellRadiusByIndex(m_spellInfo->EffectRadiusIndex[eff_idx]);
 
     int32 amount = damage > 0 ? damage : 1;
 
@@ -5564,13 +5564,13 @@ void Spell::EffectTransmitted(SpellEffectIndex eff_idx)
     // FIXME: this can be better check for most objects but still hack
     else if (m_spellInfo->EffectRadiusIndex[eff_idx] && m_spellInfo->speed == 0)
     {
-        float dis = GetSpellRadius(sSpellRadiusStore.LookupEntry(m_spellInfo->EffectRadiusIndex[eff_idx]));
+        float dis = GetSpellRadiusByIndex(m_spellInfo->EffectRadiusIndex[eff_idx]);
         m_caster->GetClosePoint(fx, fy, fz, DEFAULT_WORLD_OBJECT_SIZE, dis);
     }
     else
     {
-        float min_dis = GetSpellMinRange(sSpellRangeStore.LookupEntry(m_spellInfo->rangeIndex));
-        float max_dis = GetSpellMaxRange(sSpellRangeStore.LookupEntry(m_spellInfo->rangeIndex));
+        float min_dis = GetSpellMinRangeByIndex(m_spellInfo->rangeIndex);
+        float max_dis = GetSpellMaxRangeByIndex(m_spellInfo->rangeIndex);
         float dis = rand_norm_f() * (max_dis - min_dis) + min_dis;
 
         // special code for fishing bobber (TARGET_LOCATION_CASTER_FISHING_SPOT), should not try to avoid objects
@@ -39,7 +39,7 @@ bool IsPrimaryProfessionSkill(uint32 skill)
     return true;
 }
 
-SpellMgr::SpellMgr()
+SpellMgr::SpellMgr() : m_spellProcEventGeneration(0)
 {
 }
 
@@ -134,7 +134,7 @@ uint32 GetSpellCastTime(SpellEntry const* spellInfo, WorldObject* caster, Spell*
                         return 0;
     }
 
-    SpellCastTimesEntry const* spellCastTimeEntry = sSpellCastTimesStore.LookupEntry(spellInfo->CastingTimeIndex);
+    SpellCastTimesProjection const* spellCastTimeEntry = sSpellCastTimesProjection.Lookup(spellInfo->CastingTimeIndex);
 
     // not all spells have cast time index and this is all is passive abilities
     if (!spellCastTimeEntry)
@@ -807,6 +807,7 @@ void SpellMgr::LoadSpellProcEvents()
         bar.step();
         sLog.outString();
         sLog.outString(">> No spell proc event conditions loaded");
+        m_spellProcEventGeneration.fetch_add(1, std::memory_order_release);
         return;
     }
 
@@ -845,6 +846,8 @@ void SpellMgr::LoadSpellProcEvents()
 
     sLog.outString(">> Loaded %u extra spell proc event conditions +%u custom proc (inc. +%u custom ranks)",  rankHelper.worker.count, rankHelper.worker.customProc, rankHelper.customRank);
     sLog.outString();
+
+    m_spellProcEventGeneration.fetch_add(1, std::memory_order_release);
 }
 
 struct DoSpellProcItemEnchant
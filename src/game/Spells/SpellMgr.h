@@ -37,6 +37,7 @@
 #include "Server/SQLStorages.h"
 #include "Spells/SpellEffectDefines.h"
 
+#include <atomic>
 #include <map>
 
 class Player;
@@ -78,11 +79,14 @@ SpellSpecific GetSpellSpecific(uint32 spellId);
 
 // Different spell properties
 inline float GetSpellRadius(SpellRadiusEntry const* radius) { return (radius ? radius->Radius : 0); }
+inline float GetSpellRadiusByIndex(uint32 radiusIndex) { return sSpellRadiusProjection.Get(radiusIndex); }
 uint32 GetSpellCastTime(SpellEntry const* spellInfo, WorldObject* caster, Spell* spell = nullptr, bool consume = false);
 uint32 GetSpellCastTimeForBonus(SpellEntry const* spellProto, DamageEffectType damagetype);
 float CalculateDefaultCoefficient(SpellEntry const* spellProto, DamageEffectType const damagetype);
 inline float GetSpellMinRange(SpellRangeEntry const* range) { return (range ? range->minRange : 0); }
 inline float GetSpellMaxRange(SpellRangeEntry const* range) { return (range ? range->maxRange : 0); }
+inline float GetSpellMinRangeByIndex(uint32 rangeIndex) { return sSpellRangeProjection.Get(rangeIndex).minRange; }
+inline float GetSpellMaxRangeByIndex(uint32 rangeIndex) { return sSpellRangeProjection.Get(rangeIndex).maxRange; }
 inline uint32 GetSpellRecoveryTime(SpellEntry const* spellInfo) { return spellInfo->RecoveryTime > spellInfo->CategoryRecoveryTime ? spellInfo->RecoveryTime : spellInfo->CategoryRecoveryTime; }
 int32 GetSpellDuration(SpellEntry const* spellInfo);
 int32 GetSpellMaxDuration(SpellEntry const* spellInfo);
@@ -2510,6 +2514,9 @@ class SpellMgr
             return nullptr;
         }
 
+        // changes with every (re)load of spell_proc_event, units compare it to see if their proc holder index is outdated
+        uint32 GetSpellProcEventGeneration() const { return m_spellProcEventGeneration.load(std::memory_order_acquire); }
+
         // Spell procs from item enchants
         float GetItemEnchantProcChance(uint32 spellid) const
         {
@@ -2870,6 +2877,7 @@ class SpellMgr
         SpellElixirMap     mSpellElixirs;
         SpellThreatMap     mSpellThreatMap;
         SpellProcEventMap  mSpellProcEventMap;
+        std::atomic<uint32> m_spellProcEventGeneration;
         SpellProcItemEnchantMap mSpellProcItemEnchantMap;
         SpellBonusMap      mSpellBonusMap;
         SkillLineAbilityMap mSkillLineAbilityMapBySpellId;
@@ -28,6 +28,8 @@
 #include "Entities/Creature.h"
 #include "Util/Util.h"
 
+#include <boost/container/small_vector.hpp>
+
 pAuraProcHandler AuraProcHandler[TOTAL_AURAS] =
 {
     &Unit::HandleNULLProc,                                  //  0 SPELL_AURA_NONE
@@ -233,7 +235,8 @@ struct ProcTriggeredData
     SpellAuraHolder* triggeredByHolder;
 };
 
-typedef std::list< ProcTriggeredData > ProcTriggeredList;
+// most events trigger only a few auras, keep them on the stack
+typedef boost::container::small_vector<ProcTriggeredData, 8> ProcTriggeredList;
 
 uint32 createProcExtendMask(SpellNonMeleeDamage* spellDamageInfo, SpellMissInfo missCondition)
 {
@@ -407,16 +410,77 @@ ProcExecutionData::ProcExecutionData(ProcSystemArguments& data, bool isVictim) :
     }
 }
 
+// same flags as used by IsTriggeredAtSpellProcEvent
+static uint32 GetProcAuraHolderFlags(SpellAuraHolder const* holder)
+{
+    SpellEntry const* spellProto = holder->GetSpellProto();
+    SpellProcEventEntry const* spellProcEvent = sSpellMgr.GetSpellProcEvent(spellProto->Id);
+    return spellProcEvent && spellProcEvent->procFlags ? spellProcEvent->procFlags : spellProto->procFlags;
+}
+
+void Unit::AddProcAuraHolder(SpellAuraHolder* holder)
+{
+    uint32 procFlags = GetProcAuraHolderFlags(holder);
+    if (!procFlags)
+        return;
+
+    // keep the order of m_spellAuraHolders, new holders go after the ones of the same spell
+    auto itr = std::upper_bound(m_procAuraHolders.begin(), m_procAuraHolders.end(), holder->GetId(),
+        [](uint32 spellId, ProcAuraHolder const& entry) { return spellId < entry.holder->GetId(); });
+    m_procAuraHolders.insert(itr, { holder, procFlags });
+    m_procAuraHoldersFlags |= procFlags;
+}
+
+void Unit::RemoveProcAuraHolder(SpellAuraHolder* holder)
+{
+    auto itr = std::find_if(m_procAuraHolders.begin(), m_procAuraHolders.end(), [holder](ProcAuraHolder const& entry) { return entry.holder == holder; });
+    if (itr == m_procAuraHolders.end())
+        return;
+
+    m_procAuraHolders.erase(itr);
+
+    m_procAuraHoldersFlags = 0;
+    for (ProcAuraHolder const& entry : m_procAuraHolders)
+        m_procAuraHoldersFlags |= entry.procFlags;
+}
+
+void Unit::RebuildProcAuraHolders()
+{
+    m_procAuraHoldersGeneration = sSpellMgr.GetSpellProcEventGeneration();
+
+    m_procAuraHolders.clear();
+    m_procAuraHoldersFlags = 0;
+    for (SpellAuraHolderMap::value_type const& itr : m_spellAuraHolders)
+    {
+        if (uint32 procFlags = GetProcAuraHolderFlags(itr.second))
+        {
+            m_procAuraHolders.push_back({ itr.second, procFlags });
+            m_procAuraHoldersFlags |= procFlags;
+        }
+    }
+}
+
 void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
 {
     ProcExecutionData execData(argData, isVictim);
 
+    // rebuilt on the first proc after .reload spell_proc_event, the flags of applied holders may have changed
+    if (m_procAuraHoldersGeneration != sSpellMgr.GetSpellProcEventGeneration())
+        RebuildProcAuraHolders();
+
+    // no holder reacts to this event
+    if (!(m_procAuraHoldersFlags & execData.procFlags))
+        return;
+
     ProcTriggeredList procTriggered;
     std::vector<SpellAuraHolder*> holdersForDeletion;
-    // Fill procTriggered list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    // Fill procTriggered list, only holders with matching proc flags can trigger
+    for (size_t i = 0; i < m_procAuraHolders.size(); ++i)
     {
-        SpellAuraHolder* holder = itr->second;
+        if (!(m_procAuraHolders[i].procFlags & execData.procFlags))
+            continue;
+
+        SpellAuraHolder* holder = m_procAuraHolders[i].holder;
         // skip deleted auras (possible at recursive triggered call
         if (holder->GetState() != SPELLAURAHOLDER_STATE_READY || holder->IsDeleted())
             continue;
@@ -439,7 +503,7 @@ void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
         if (result != SpellProcEventTriggerCheck::SPELL_PROC_TRIGGER_OK)
             continue;
 
-        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second));
+        procTriggered.push_back(ProcTriggeredData(spellProcEvent, holder));
     }
 
     for (SpellAuraHolder* holder : holdersForDeletion)
@@ -0,0 +1,407 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Tools/LoadTest.h"
+#include "Accounts/AccountMgr.h"
+#include "Database/DatabaseEnv.h"
+#include "Entities/Player.h"
+#include "Globals/ObjectMgr.h"
+#include "Groups/Group.h"
+#include "MotionGenerators/MotionMaster.h"
+#include "Server/WorldSession.h"
+#include "Server/WorldPacket.h"
+#include "Server/Opcodes.h"
+#include "World/World.h"
+#include "Log.h"
+#include "Auth/BigNumber.h"
+
+#include <openssl/crypto.h>
+
+namespace
+{
+    LoadTestScenario const loadTestScenarios[] =
+    {
+        // name     bots  ticks  map  position                                   radius  raid
+        { "city",   2000, 1200,  1,   1629.36f, -4373.39f, 31.26f, 3.55f,        60.0f,  false },   // Orgrimmar, Valley of Strength
+        { "raid",     40, 1200,  1,   1629.36f, -4373.39f, 31.26f, 3.55f,        60.0f,  true  },
+    };
+
+    // accounts and characters are reused by later runs
+    char const* const LOADTEST_ACCOUNT_PREFIX = "LOADTEST";
+    char const* const LOADTEST_CHARACTER_PREFIX = "Loadbot";
+
+    uint32 const LOADTEST_SEED = 0x4C54;                    // "LT"
+    uint32 const LOADTEST_SAVE_TIMEOUT = 600;               // ticks to wait for created characters
+    uint32 const LOADTEST_LOGIN_TIMEOUT = 6000;             // ticks to wait for all bots to be in world
+    uint32 const LOADTEST_MOVE_MIN = 60;                    // ticks between two moves of a bot
+    uint32 const LOADTEST_MOVE_MAX = 200;
+
+    // bots log in without realmd, so nobody needs to know the password of their accounts
+    std::string RandomPassword()
+    {
+        BigNumber number;
+        number.SetRand(8 * 8);
+        char const* hex = number.AsHexStr();
+        std::string password(hex);
+        OPENSSL_free((void*)hex);
+        return password;
+    }
+}
+
+LoadTest::LoadTest() : m_state(LOADTEST_DISABLED), m_scenario(), m_random(LOADTEST_SEED), m_firstCreated(0), m_lastCreated(0),
+    m_created(0), m_waitTicks(0), m_tick(0), m_inWorld(0), m_raid(nullptr), m_phases()
+{
+}
+
+LoadTest& LoadTest::Instance()
+{
+    static LoadTest loadTest;
+    return loadTest;
+}
+
+std::string LoadTest::GetScenarioNames()
+{
+    std::string names;
+    for (LoadTestScenario const& scenario : loadTestScenarios)
+    {
+        if (!names.empty())
+            names += ", ";
+        names += scenario.name;
+    }
+
+    return names;
+}
+
+bool LoadTest::Configure(std::string const& scenario, uint32 bots, uint32 ticks)
+{
+    for (LoadTestScenario const& entry : loadTestScenarios)
+    {
+        if (scenario != entry.name)
+            continue;
+
+        m_scenario = entry;
+        if (bots)
+            m_scenario.bots = bots;
+        if (ticks)
+            m_scenario.ticks = ticks;
+
+        if (m_scenario.raid)
+            m_scenario.bots = std::min<uint32>(m_scenario.bots, MAX_RAID_SIZE);
+
+        m_state = LOADTEST_PREPARE;
+        return true;
+    }
+
+    return false;
+}
+
+Player* LoadTest::GetBotPlayer(Bot const& bot) const
+{
+    return bot.guid ? sObjectMgr.GetPlayer(bot.guid) : nullptr;
+}
+
+void LoadTest::Update(uint32 /*diff*/)
+{
+    switch (m_state)
+    {
+        case LOADTEST_PREPARE:
+            Prepare();
+            break;
+        case LOADTEST_WAIT_CHARACTERS:
+        {
+            if (m_created)
+            {
+                QueryResult* result = CharacterDatabase.PQuery("SELECT COUNT(guid) FROM characters WHERE guid BETWEEN %u AND %u", m_firstCreated, m_lastCreated);
+                uint32 saved = result ? result->Fetch()[0].GetUInt32() : 0;
+                delete result;
+
+                if (saved < m_created && ++m_waitTicks < LOADTEST_SAVE_TIMEOUT)
+                    break;
+            }
+
+            // every run starts at the scenario position, in batches staying below the query length limit
+            for (size_t first = 0; first < m_bots.size(); first += 1000)
+            {
+                std::string guids;
+                for (size_t i = first; i < std::min(first + 1000, m_bots.size()); ++i)
+                    guids += (guids.empty() ? "" : ",") + std::to_string(m_bots[i].guid.GetCounter());
+
+                CharacterDatabase.DirectPExecute("UPDATE characters SET map = %u, position_x = %f, position_y = %f, position_z = %f, orientation = %f WHERE guid IN (%s)",
+                                                 m_scenario.mapId, m_scenario.x, m_scenario.y, m_scenario.z, m_scenario.o, guids.c_str());
+            }
+
+            // sessions are added to the world at the next session update, the logins are sent then
+            for (Bot const& bot : m_bots)
+            {
+                WorldSession* session = new WorldSession(bot.accountId, nullptr, SEC_PLAYER, 0, DEFAULT_LOCALE, "", 0);
+                session->SetNoAnticheat();
+                session->SetSimulatedClient(true);
+                sWorld.AddSession(session);
+            }
+
+            m_waitTicks = 0;
+            m_state = LOADTEST_LOGIN;
+            break;
+        }
+        case LOADTEST_LOGIN:
+            Login();
+            break;
+        case LOADTEST_RUN:
+            Run();
+            break;
+        default:
+            break;
+    }
+}
+
+void LoadTest::Prepare()
+{
+    sLog.outString("Load test '%s': preparing %u bots", m_scenario.name, m_scenario.bots);
+
+    m_bots.reserve(m_scenario.bots);
+    for (uint32 i = 0; i < m_scenario.bots; ++i)
+    {
+        std::string accountName = LOADTEST_ACCOUNT_PREFIX + std::to_string(i + 1);
+
+        Bot bot;
+        bot.accountId = sAccountMgr.GetId(accountName);
+        bot.loginSent = false;
+        bot.nextMove = 0;
+
+        if (!bot.accountId)
+        {
+            if (sAccountMgr.CreateAccount(accountName, RandomPassword()) != AOR_OK || !(bot.accountId = sAccountMgr.GetId(accountName)))
+            {
+                sLog.outError("Load test: can not create account %s", accountName.c_str());
+                continue;
+            }
+        }
+        else if (sAccountMgr.ChangePassword(bot.accountId, RandomPassword()) != AOR_OK)
+        {
+            // older runs used the account name as password, do not leave such an account usable
+            sLog.outError("Load test: can not change the password of account %s", accountName.c_str());
+            continue;
+        }
+
+        if (QueryResult* result = CharacterDatabase.PQuery("SELECT guid FROM characters WHERE account = %u ORDER BY guid LIMIT 1", bot.accountId))
+        {
+            bot.guid = ObjectGuid(HIGHGUID_PLAYER, result->Fetch()[0].GetUInt32());
+            delete result;
+        }
+        else if (!CreateCharacter(bot, accountName, i))
+            continue;
+
+        m_bots.push_back(bot);
+    }
+
+    if (m_created)
+        sLog.outString("Load test '%s': created %u characters", m_scenario.name, m_created);
+
+    m_state = LOADTEST_WAIT_CHARACTERS;
+}
+
+bool LoadTest::CreateCharacter(Bot& bot, std::string const& accountName, uint32 index)
+{
+    // player names can only hold letters
+    std::string name = LOADTEST_CHARACTER_PREFIX;
+    for (uint32 i = 0, value = index; i < 4; ++i, value /= 26)
+        name += char('a' + value % 26);
+
+    if (sObjectMgr.GetPlayerGuidByName(name))
+    {
+        sLog.outError("Load test: character name %s is used by another account", name.c_str());
+        return false;
+    }
+
+    WorldSession* session = new WorldSession(bot.accountId, nullptr, SEC_PLAYER, 0, DEFAULT_LOCALE, accountName, 0);
+    session->SetNoAnticheat();
+
+    // orc warrior, the scenarios are set in horde places
+    Player* player = new Player(session);
+    bool created = player->Create(sObjectMgr.GeneratePlayerLowGuid(), name, RACE_ORC, CLASS_WARRIOR, GENDER_MALE, 0, 0, 0, 0, 0, 0);
+    if (created)
+    {
+        player->setCinematic(1);
+        player->SaveToDB();
+
+        bot.guid = player->GetObjectGuid();
+        if (!m_created++)
+            m_firstCreated = bot.guid.GetCounter();
+        m_lastCreated = bot.guid.GetCounter();
+    }
+    else
+        sLog.outError("Load test: can not create character %s", name.c_str());
+
+    delete player;
+    delete session;
+    return created;
+}
+
+void LoadTest::Login()
+{
+    m_inWorld = 0;
+    for (Bot& bot : m_bots)
+    {
+        if (GetBotPlayer(bot))
+        {
+            ++m_inWorld;
+            continue;
+        }
+
+        if (bot.loginSent)
+            continue;
+
+        WorldSession* session = sWorld.FindSession(bot.accountId);
+        if (!session)
+            continue;
+
+        std::unique_ptr<WorldPacket> login = std::make_unique<WorldPacket>(CMSG_PLAYER_LOGIN, 8);
+        *login << bot.guid;
+        session->QueuePacket(std::move(login));
+        bot.loginSent = true;
+    }
+
+    if (m_inWorld == m_bots.size() || ++m_waitTicks >= LOADTEST_LOGIN_TIMEOUT)
+        StartRun();
+}
+
+void LoadTest::StartRun()
+{
+    if (m_inWorld < m_bots.size())
+        sLog.outError("Load test '%s': only %u of %u bots logged in", m_scenario.name, m_inWorld, uint32(m_bots.size()));
+
+    if (m_scenario.raid)
+    {
+        for (Bot const& bot : m_bots)
+        {
+            Player* player = GetBotPlayer(bot);
+            if (!player)
+                continue;
+
+            // left over of an aborted run
+            if (Group* oldGroup = player->GetGroup())
+                Player::RemoveFromGroup(oldGroup, player->GetObjectGuid());
+
+            if (!m_raid)
+            {
+                m_raid = new Group;
+                if (!m_raid->Create(player->GetObjectGuid(), player->GetName()))
+                {
+                    delete m_raid;
+                    m_raid = nullptr;
+                    break;
+                }
+
+                sObjectMgr.AddGroup(m_raid);
+                m_raid->ConvertToRaid();
+                continue;
+            }
+
+            m_raid->AddMember(player->GetObjectGuid(), player->GetName());
+        }
+    }
+
+    sLog.outString("Load test '%s': running %u bots for %u ticks", m_scenario.name, m_inWorld, m_scenario.ticks);
+
+    for (TickPhase phase = TICK_PHASE_WORLD; phase < MAX_TICK_PHASES; phase = TickPhase(phase + 1))
+        TickTimings::Take(phase);
+
+    TickTimings::SetEnabled(true);
+    m_started = std::chrono::steady_clock::now();
+    m_tick = 0;
+    m_state = LOADTEST_RUN;
+}
+
+void LoadTest::Run()
+{
+    // timings of the previous tick, the current one is still running
+    if (m_tick)
+    {
+        for (TickPhase phase = TICK_PHASE_WORLD; phase < MAX_TICK_PHASES; phase = TickPhase(phase + 1))
+        {
+            uint64 const time = TickTimings::Take(phase);
+            m_phases[phase].total += time;
+            m_phases[phase].max = std::max(m_phases[phase].max, time);
+        }
+    }
+
+    if (m_tick == m_scenario.ticks)
+    {
+        Finish();
+        return;
+    }
+
+    Player* leader = nullptr;
+    for (Bot& bot : m_bots)
+    {
+        Player* player = GetBotPlayer(bot);
+        if (!player)
+            continue;
+
+        // raid members stay with the leader
+        if (m_scenario.raid && leader)
+        {
+            if (!m_tick)
+                player->GetMotionMaster()->MoveFollow(leader, 2.0f, std::uniform_real_distribution<float>(0.0f, 2 * M_PI_F)(m_random));
+            continue;
+        }
+
+        if (!leader)
+            leader = player;
+
+        if (bot.nextMove > m_tick)
+            continue;
+
+        float const angle = std::uniform_real_distribution<float>(0.0f, 2 * M_PI_F)(m_random);
+        float const distance = std::uniform_real_distribution<float>(0.0f, m_scenario.radius)(m_random);
+        player->GetMotionMaster()->MovePoint(0, m_scenario.x + distance * std::cos(angle), m_scenario.y + distance * std::sin(angle), m_scenario.z);
+        bot.nextMove = m_tick + std::uniform_int_distribution<uint32>(LOADTEST_MOVE_MIN, LOADTEST_MOVE_MAX)(m_random);
+    }
+
+    ++m_tick;
+}
+
+void LoadTest::Finish()
+{
+    TickTimings::SetEnabled(false);
+
+    uint32 const elapsed = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_started).count());
+    sLog.outString("Load test '%s': %u bots, %u ticks in %u ms", m_scenario.name, m_inWorld, m_tick, elapsed);
+    sLog.outString("%-16s %12s %12s %12s", "phase", "total ms", "avg ms/tick", "max ms/tick");
+    for (TickPhase phase = TICK_PHASE_WORLD; phase < MAX_TICK_PHASES; phase = TickPhase(phase + 1))
+        sLog.outString("%-16s %12.1f %12.3f %12.3f", TickTimings::GetPhaseName(phase), m_phases[phase].total / 1000.0,
+                       m_tick ? m_phases[phase].total / 1000.0 / m_tick : 0.0, m_phases[phase].max / 1000.0);
+
+    if (m_raid)
+    {
+        m_raid->Disband(true);
+        sObjectMgr.RemoveGroup(m_raid);
+        delete m_raid;
+        m_raid = nullptr;
+    }
+
+    for (Bot const& bot : m_bots)
+    {
+        // not saved, the next run starts from the same state
+        if (WorldSession* session = sWorld.FindSession(bot.accountId))
+            session->KickPlayer(false, true);
+    }
+
+    m_state = LOADTEST_DONE;
+    World::StopNow(SHUTDOWN_EXIT_CODE);
+}
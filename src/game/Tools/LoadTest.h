@@ -0,0 +1,116 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOAD_TEST_H
+#define MANGOS_LOAD_TEST_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+#include "World/TickTimings.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+struct LoadTestScenario
+{
+    char const* name;
+    uint32 bots;
+    uint32 ticks;
+    uint32 mapId;
+    float x, y, z, o;
+    float radius;                                           // bots wander within this distance of the position
+    bool raid;                                              // bots form a raid following the first one
+};
+
+// Headless load test, started by mangosd --loadtest <scenario>
+// Logs in characters of LOADTEST accounts (created with their character when missing) on sessions without
+// socket, lets them act out the scenario for a fixed number of world ticks and reports how long the phases of
+// the tick took. The server shuts down afterwards. Behaviour is driven by a fixed seed, so runs against the same
+// database are comparable. Nothing is sent over the network, packets are still built.
+class LoadTest
+{
+    public:
+        static LoadTest& Instance();
+
+        // mangosd startup, bots and ticks of 0 keep the values of the scenario
+        bool Configure(std::string const& scenario, uint32 bots, uint32 ticks);
+        bool IsEnabled() const { return m_state != LOADTEST_DISABLED; }
+
+        static std::string GetScenarioNames();
+
+        // world thread
+        void Update(uint32 diff);
+
+    private:
+        enum LoadTestState
+        {
+            LOADTEST_DISABLED,
+            LOADTEST_PREPARE,                               // accounts and characters
+            LOADTEST_WAIT_CHARACTERS,                       // created characters being saved
+            LOADTEST_LOGIN,
+            LOADTEST_RUN,
+            LOADTEST_DONE,
+        };
+
+        struct Bot
+        {
+            uint32 accountId;
+            ObjectGuid guid;
+            bool loginSent;
+            uint32 nextMove;                                // tick
+        };
+
+        struct PhaseStats
+        {
+            uint64 total;
+            uint64 max;
+        };
+
+        LoadTest();
+
+        void Prepare();
+        bool CreateCharacter(Bot& bot, std::string const& accountName, uint32 index);
+        void Login();
+        void StartRun();
+        void Run();
+        void Finish();
+
+        class Player* GetBotPlayer(Bot const& bot) const;
+
+        LoadTestState m_state;
+        LoadTestScenario m_scenario;
+        std::vector<Bot> m_bots;
+        std::mt19937 m_random;
+
+        uint32 m_firstCreated;
+        uint32 m_lastCreated;
+        uint32 m_created;
+        uint32 m_waitTicks;
+
+        uint32 m_tick;
+        uint32 m_inWorld;
+        class Group* m_raid;
+        std::chrono::steady_clock::time_point m_started;
+        PhaseStats m_phases[MAX_TICK_PHASES];
+};
+
+#define sLoadTest LoadTest::Instance()
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/MatchmakingScheduler.h"
+
+void MatchmakingScheduler::Register(MatchmakingQueue queue, uint32 interval, UpdateFunction const& update)
+{
+    ScheduledQueue& scheduled = m_queues[queue];
+    scheduled.update = update;
+    scheduled.timer.SetInterval(interval);
+    scheduled.timer.SetCurrent(0);
+    scheduled.elapsed = 0;
+}
+
+void MatchmakingScheduler::Update(uint32 diff)
+{
+    for (ScheduledQueue& scheduled : m_queues)
+    {
+        if (!scheduled.update)
+            continue;
+
+        scheduled.elapsed += diff;
+        scheduled.timer.Update(diff);
+
+        bool const due = scheduled.timer.GetInterval() && scheduled.timer.Passed();
+        if (!scheduled.woken.exchange(false, std::memory_order_acq_rel) && !due)
+            continue;
+
+        // a woken update also serves the timers, the next timed one is a full interval later
+        scheduled.timer.SetCurrent(0);
+
+        uint32 const elapsed = scheduled.elapsed;
+        scheduled.elapsed = 0;
+        ++scheduled.updates;
+        scheduled.update(elapsed);
+    }
+}
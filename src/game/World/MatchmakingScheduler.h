@@ -0,0 +1,67 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MATCHMAKING_SCHEDULER_H
+#define MANGOS_MATCHMAKING_SCHEDULER_H
+
+#include "Common.h"
+#include "Util/Timer.h"
+
+#include <atomic>
+#include <functional>
+
+enum MatchmakingQueue
+{
+    MATCHMAKING_BATTLEGROUND    = 0,
+    MATCHMAKING_LFG             = 1,
+};
+
+#define MAX_MATCHMAKING_QUEUES 2
+
+// Updates the battleground and looking for group queues on the world thread, after the maps.
+// A queue is only updated when something changed in it (Wake, from any thread) or when its interval passed
+// for its timers, so an idle queue costs nothing and a join or a free slot is matched on the next world tick.
+class MatchmakingScheduler
+{
+    public:
+        typedef std::function<void(uint32 /*diff*/)> UpdateFunction;
+
+        // interval 0 updates the queue only when woken, diff is the time since its previous update
+        void Register(MatchmakingQueue queue, uint32 interval, UpdateFunction const& update);
+        void Wake(MatchmakingQueue queue) { m_queues[queue].woken.store(true, std::memory_order_release); }
+
+        void Update(uint32 diff);
+
+        uint32 GetUpdateCount(MatchmakingQueue queue) const { return m_queues[queue].updates; }
+
+    private:
+        struct ScheduledQueue
+        {
+            ScheduledQueue() : elapsed(0), woken(false), updates(0) {}
+
+            UpdateFunction update;
+            ShortIntervalTimer timer;
+            uint32 elapsed;
+            std::atomic<bool> woken;
+            uint32 updates;
+        };
+
+        ScheduledQueue m_queues[MAX_MATCHMAKING_QUEUES];
+};
+
+#endif
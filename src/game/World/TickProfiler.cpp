@@ -0,0 +1,199 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/TickProfiler.h"
+#include "World/World.h"
+#include "Config/Config.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <memory>
+
+thread_local TickProfileFrame* TickProfiler::s_currentFrame = nullptr;
+
+namespace
+{
+    // one ring per nesting level of captured frames on the thread
+    thread_local std::vector<std::unique_ptr<std::vector<TickProfileZoneRecord>>> s_rings;
+    thread_local uint32 s_capturedFrames = 0;
+
+    std::string JsonString(char const* value)
+    {
+        std::string escaped = "\"";
+        for (char const* c = value; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                escaped += '\\';
+            escaped += *c;
+        }
+        return escaped + "\"";
+    }
+}
+
+TickProfiler& TickProfiler::Instance()
+{
+    static TickProfiler instance;
+    return instance;
+}
+
+TickProfiler::TickProfiler() : m_lastAutomaticDump(0), m_armedMap(0), m_armedThresholdMs(0), m_armedFrames(0), m_dumpCounter(0)
+{
+}
+
+void TickProfiler::Arm(uint32 mapId, uint32 thresholdMs, uint32 frames)
+{
+    m_armedFrames.store(0, std::memory_order_relaxed);
+    m_armedMap.store(mapId, std::memory_order_relaxed);
+    m_armedThresholdMs.store(thresholdMs, std::memory_order_relaxed);
+    m_armedFrames.store(int32(std::max(frames, 1u)), std::memory_order_release);
+}
+
+void TickProfiler::Disarm()
+{
+    m_armedFrames.store(0, std::memory_order_relaxed);
+}
+
+bool TickProfiler::GetArmed(uint32& mapId, uint32& thresholdMs, uint32& frames) const
+{
+    int32 const left = m_armedFrames.load(std::memory_order_acquire);
+    if (left <= 0)
+        return false;
+
+    mapId = m_armedMap.load(std::memory_order_relaxed);
+    thresholdMs = m_armedThresholdMs.load(std::memory_order_relaxed);
+    frames = uint32(left);
+    return true;
+}
+
+bool TickProfiler::GetCaptureThreshold(uint32 mapId, uint32& thresholdMs) const
+{
+    if (m_armedFrames.load(std::memory_order_acquire) > 0 && m_armedMap.load(std::memory_order_relaxed) == mapId)
+    {
+        thresholdMs = m_armedThresholdMs.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    thresholdMs = sWorld.getConfig(CONFIG_UINT32_TICK_PROFILER_SLOW_TICK);
+    return thresholdMs != 0;
+}
+
+void TickProfiler::OnFrameCaptured(uint32 mapId, uint32 instanceId, uint32 diff, uint64 durationNs, std::vector<TickProfileZoneRecord> const& ring, uint64 recorded)
+{
+    uint64 const durationMs = durationNs / 1000000;
+
+    // an armed capture takes precedence over the automatic one, a dump of it is never skipped
+    if (m_armedFrames.load(std::memory_order_acquire) > 0 && m_armedMap.load(std::memory_order_relaxed) == mapId)
+    {
+        if (durationMs < m_armedThresholdMs.load(std::memory_order_relaxed))
+            return;
+
+        // several instances of the map can reach this at once, only as many as armed are written
+        int32 left = m_armedFrames.load(std::memory_order_relaxed);
+        while (left > 0 && !m_armedFrames.compare_exchange_weak(left, left - 1, std::memory_order_acq_rel))
+            ;
+        if (left <= 0)
+            return;
+
+        Dump(mapId, instanceId, diff, durationNs, ring, recorded);
+        return;
+    }
+
+    uint32 const slowTick = sWorld.getConfig(CONFIG_UINT32_TICK_PROFILER_SLOW_TICK);
+    if (!slowTick || durationMs < slowTick)
+        return;
+
+    // a lag spike is usually long enough to make every map slow, one dump per cooldown is enough to see why
+    time_t const now = time(nullptr);
+    time_t last = m_lastAutomaticDump.load(std::memory_order_relaxed);
+    if (now < last + time_t(sWorld.getConfig(CONFIG_UINT32_TICK_PROFILER_DUMP_COOLDOWN)))
+        return;
+    if (!m_lastAutomaticDump.compare_exchange_strong(last, now, std::memory_order_relaxed))
+        return;
+
+    Dump(mapId, instanceId, diff, durationNs, ring, recorded);
+}
+
+void TickProfiler::Dump(uint32 mapId, uint32 instanceId, uint32 diff, uint64 durationNs, std::vector<TickProfileZoneRecord> const& ring, uint64 recorded)
+{
+    std::lock_guard<std::mutex> guard(m_dumpLock);
+
+    std::string logsDir = sConfig.GetStringDefault("LogsDir", "");
+    if (!logsDir.empty() && logsDir.back() != '/' && logsDir.back() != '\\')
+        logsDir.push_back('/');
+
+    std::string const frameName = mapId == TICK_PROFILER_WORLD ? "world" : "map " + std::to_string(mapId) + " instance " + std::to_string(instanceId);
+    std::string fileName = logsDir + "tick_" + (mapId == TICK_PROFILER_WORLD ? std::string("world") : std::to_string(mapId) + "_" + std::to_string(instanceId));
+    fileName += "_" + Log::GetTimestampStr() + "_" + std::to_string(++m_dumpCounter) + ".json";
+
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("TickProfiler: can not write %s", fileName.c_str());
+        return;
+    }
+
+    uint32 const pid = mapId == TICK_PROFILER_WORLD ? 0 : mapId + 1;
+    uint64 const first = recorded > TICK_PROFILER_RING_SIZE ? recorded - TICK_PROFILER_RING_SIZE : 0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"frame\":%s,\"diff\":%u,\"zones\":" UI64FMTD ",\"dropped\":" UI64FMTD "},\n\"traceEvents\":[\n",
+            JsonString(frameName.c_str()).c_str(), diff, recorded, first);
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":%s}}", pid, instanceId, JsonString(frameName.c_str()).c_str());
+
+    // zones are stored when they end, the viewers sort them by start
+    for (uint64 i = first; i < recorded; ++i)
+    {
+        TickProfileZoneRecord const& record = ring[i % TICK_PROFILER_RING_SIZE];
+        fprintf(file, ",\n{\"name\":%s,\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}", JsonString(record.name).c_str(),
+                pid, instanceId, record.start / 1000.0, record.duration / 1000.0, record.depth);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    sLog.outString("TickProfiler: %s took " UI64FMTD " ms, " UI64FMTD " zones written to %s", frameName.c_str(), durationNs / 1000000, recorded - first, fileName.c_str());
+}
+
+TickProfileFrame::TickProfileFrame(uint32 mapId, uint32 instanceId, uint32 diff) : m_active(false), m_mapId(mapId), m_instanceId(instanceId), m_diff(diff),
+    m_depth(1), m_recorded(0), m_ring(nullptr), m_outerFrame(nullptr)
+{
+    uint32 thresholdMs;
+    if (!sTickProfiler.GetCaptureThreshold(mapId, thresholdMs))
+        return;
+
+    if (s_rings.size() <= s_capturedFrames)
+        s_rings.emplace_back(new std::vector<TickProfileZoneRecord>(TICK_PROFILER_RING_SIZE));
+
+    m_active = true;
+    m_ring = s_rings[s_capturedFrames++].get();
+    m_outerFrame = TickProfiler::s_currentFrame;
+    TickProfiler::s_currentFrame = this;
+    m_start = std::chrono::steady_clock::now();
+}
+
+TickProfileFrame::~TickProfileFrame()
+{
+    if (!m_active)
+        return;
+
+    std::chrono::steady_clock::time_point const end = std::chrono::steady_clock::now();
+    Record(m_mapId == TICK_PROFILER_WORLD ? "world tick" : "map tick", m_start, end, 0);
+
+    TickProfiler::s_currentFrame = m_outerFrame;
+    --s_capturedFrames;
+
+    sTickProfiler.OnFrameCaptured(m_mapId, m_instanceId, m_diff, uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count()), *m_ring, m_recorded);
+}
@@ -0,0 +1,151 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TICK_PROFILER_H
+#define MANGOS_TICK_PROFILER_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define TICK_PROFILER_RING_SIZE     32768                   // zones kept per thread, older zones of a frame are overwritten
+#define TICK_PROFILER_WORLD         0xFFFFFFFF              // map id of the world thread frames
+
+struct TickProfileZoneRecord
+{
+    char const* name;                                       // string literal of the zone
+    uint64 start;                                           // nanoseconds since the frame start
+    uint64 duration;
+    uint32 depth;
+};
+
+class TickProfileFrame;
+
+// Records zones of slow map and world ticks and writes them as Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+// A thread only records while one of its frames is captured: with TickProfiler.SlowTick set every frame is, otherwise
+// only frames of a map armed by .debug tickprofile. Outside of captured frames a zone costs one thread local load.
+class TickProfiler
+{
+    public:
+        static TickProfiler& Instance();
+
+        // captures the next frames of the map that take at least threshold ms, frames is the number of dumps
+        void Arm(uint32 mapId, uint32 thresholdMs, uint32 frames);
+        void Disarm();
+        bool GetArmed(uint32& mapId, uint32& thresholdMs, uint32& frames) const;
+
+        static TickProfileFrame* GetCurrentFrame() { return s_currentFrame; }
+
+    private:
+        friend class TickProfileFrame;
+
+        TickProfiler();
+
+        // threshold in ms a frame of the map has to reach to be dumped, false if the frame is not captured
+        bool GetCaptureThreshold(uint32 mapId, uint32& thresholdMs) const;
+        void OnFrameCaptured(uint32 mapId, uint32 instanceId, uint32 diff, uint64 durationNs, std::vector<TickProfileZoneRecord> const& ring, uint64 recorded);
+        void Dump(uint32 mapId, uint32 instanceId, uint32 diff, uint64 durationNs, std::vector<TickProfileZoneRecord> const& ring, uint64 recorded);
+
+        static thread_local TickProfileFrame* s_currentFrame;
+
+        std::atomic<time_t> m_lastAutomaticDump;
+
+        std::atomic<uint32> m_armedMap;
+        std::atomic<uint32> m_armedThresholdMs;
+        std::atomic<int32> m_armedFrames;                   // dumps left, 0 = not armed
+
+        std::mutex m_dumpLock;
+        uint32 m_dumpCounter;
+};
+
+#define sTickProfiler TickProfiler::Instance()
+
+// One update of a map (or of the world thread), zones entered by the thread meanwhile belong to it
+class TickProfileFrame
+{
+    public:
+        TickProfileFrame(uint32 mapId, uint32 instanceId, uint32 diff);
+        ~TickProfileFrame();
+
+        void Record(char const* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end, uint32 depth)
+        {
+            TickProfileZoneRecord& record = (*m_ring)[m_recorded++ % TICK_PROFILER_RING_SIZE];
+            record.name = name;
+            record.start = uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_start).count());
+            record.duration = uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            record.depth = depth;
+        }
+
+        uint32& GetDepth() { return m_depth; }
+
+        TickProfileFrame(TickProfileFrame const&) = delete;
+        TickProfileFrame& operator=(TickProfileFrame const&) = delete;
+
+    private:
+        bool m_active;
+        uint32 m_mapId;
+        uint32 m_instanceId;
+        uint32 m_diff;
+        uint32 m_depth;
+        uint64 m_recorded;
+        std::chrono::steady_clock::time_point m_start;
+        std::vector<TickProfileZoneRecord>* m_ring;
+        TickProfileFrame* m_outerFrame;                     // a map updated by the world thread is nested in its frame
+};
+
+// Records its lifetime into the captured frame of the thread, if any
+class TickProfileZone
+{
+    public:
+        explicit TickProfileZone(char const* name) : m_frame(TickProfiler::GetCurrentFrame()), m_name(name), m_depth(0)
+        {
+            if (!m_frame)
+                return;
+
+            m_depth = m_frame->GetDepth()++;
+            m_start = std::chrono::steady_clock::now();
+        }
+
+        ~TickProfileZone()
+        {
+            if (!m_frame)
+                return;
+
+            --m_frame->GetDepth();
+            m_frame->Record(m_name, m_start, std::chrono::steady_clock::now(), m_depth);
+        }
+
+        TickProfileZone(TickProfileZone const&) = delete;
+        TickProfileZone& operator=(TickProfileZone const&) = delete;
+
+    private:
+        TickProfileFrame* m_frame;
+        char const* m_name;
+        uint32 m_depth;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#define TICK_PROFILE_CONCAT_(a, b) a##b
+#define TICK_PROFILE_CONCAT(a, b) TICK_PROFILE_CONCAT_(a, b)
+#define TICK_PROFILE_ZONE(name) TickProfileZone TICK_PROFILE_CONCAT(tickProfileZone, __LINE__)(name)
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/TickTimings.h"
+
+std::atomic<bool> TickTimings::s_enabled(false);
+std::atomic<uint64> TickTimings::s_phases[MAX_TICK_PHASES] = {};
+thread_local bool TickPhaseScope::s_inPhase[MAX_TICK_PHASES] = {};
+
+char const* TickTimings::GetPhaseName(TickPhase phase)
+{
+    switch (phase)
+    {
+        case TICK_PHASE_WORLD:          return "world";
+        case TICK_PHASE_SESSIONS:       return "world sessions";
+        case TICK_PHASE_MAPS:           return "maps";
+        case TICK_PHASE_MAP_SESSIONS:   return "map sessions";
+        case TICK_PHASE_VISIBILITY:     return "visibility";
+        case TICK_PHASE_SERIALIZATION:  return "serialization";
+        case TICK_PHASE_DB_QUEUE:       return "db queue";
+        default:                        return "unknown";
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TICK_TIMINGS_H
+#define MANGOS_TICK_TIMINGS_H
+
+#include "Common.h"
+#include "World/TickProfiler.h"
+
+#include <atomic>
+#include <chrono>
+
+enum TickPhase
+{
+    TICK_PHASE_WORLD,                                       // whole World::Update
+    TICK_PHASE_SESSIONS,                                    // World::UpdateSessions, packets not handled by the maps
+    TICK_PHASE_MAPS,                                        // MapManager::Update, includes the phases below
+    TICK_PHASE_MAP_SESSIONS,                                // session updates of the maps, most of the packet handling
+    TICK_PHASE_VISIBILITY,                                  // visibility notifiers
+    TICK_PHASE_SERIALIZATION,                               // building the object update packets of the maps
+    TICK_PHASE_DB_QUEUE,                                    // async query results handled by the world thread
+    MAX_TICK_PHASES
+};
+
+// Time spent in phases of the world tick, summed up until taken
+// Only collected while enabled (load tests), otherwise a scope costs one relaxed load. Phases running on map
+// threads are summed over all threads, so with map threads they can exceed the wall time of the map phase.
+class TickTimings
+{
+    public:
+        static void SetEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+        static void Add(TickPhase phase, uint64 microseconds) { s_phases[phase].fetch_add(microseconds, std::memory_order_relaxed); }
+
+        // microseconds spent in the phase since the last call
+        static uint64 Take(TickPhase phase) { return s_phases[phase].exchange(0, std::memory_order_relaxed); }
+
+        static char const* GetPhaseName(TickPhase phase);
+
+    private:
+        static std::atomic<bool> s_enabled;
+        static std::atomic<uint64> s_phases[MAX_TICK_PHASES];
+};
+
+// Adds its lifetime to a tick phase, nested scopes of the same phase on a thread are only counted once
+// It is also a zone of the tick profiler, so a phase needs no TICK_PROFILE_ZONE of its own
+class TickPhaseScope
+{
+    public:
+        TickPhaseScope(TickPhase phase, char const* zone) : m_zone(zone), m_phase(phase), m_active(TickTimings::IsEnabled() && !s_inPhase[phase])
+        {
+            if (!m_active)
+                return;
+
+            s_inPhase[phase] = true;
+            m_start = std::chrono::steady_clock::now();
+        }
+
+        ~TickPhaseScope()
+        {
+            if (!m_active)
+                return;
+
+            s_inPhase[m_phase] = false;
+            TickTimings::Add(m_phase, uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count()));
+        }
+
+        TickPhaseScope(TickPhaseScope const&) = delete;
+        TickPhaseScope& operator=(TickPhaseScope const&) = delete;
+
+    private:
+        static thread_local bool s_inPhase[MAX_TICK_PHASES];
+
+        TickProfileZone m_zone;
+        TickPhase m_phase;
+        bool m_active;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#endif
@@ -51,9 +51,11 @@
 #include "OutdoorPvP/OutdoorPvP.h"
 #include "VMapFactory.h"
 #include "MotionGenerators/MoveMap.h"
+#include "MotionGenerators/PathWorkerPool.h"
 #include "GameEvents/GameEventMgr.h"
 #include "Pools/PoolManager.h"
 #include "Database/DatabaseImpl.h"
+#include "Multithreading/EpochReclaimer.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "Grids/CellImpl.h"
 #include "Maps/MapPersistentStateMgr.h"
@@ -68,6 +70,10 @@
 #include "Maps/TransportMgr.h"
 #include "Anticheat/Anticheat.hpp"
 #include "LFG/LFGMgr.h"
+#include "Server/PacketReplay.h"
+#include "Tools/LoadTest.h"
+#include "World/TickProfiler.h"
+#include "World/TickTimings.h"
 
 #ifdef BUILD_AHBOT
  #include "AuctionHouseBot/AuctionHouseBot.h"
@@ -75,6 +81,7 @@
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
+ #include "Metric/Registry.h"
 #endif
 
 #include <algorithm>
@@ -102,7 +109,7 @@ TimePoint World::m_currentTime = TimePoint();
 uint32 World::m_currentDiff = 0;
 
 /// World constructor
-World::World(): mail_timer(0), mail_timer_expires(0), m_NextWeeklyQuestReset(0), m_opcodeCounters(NUM_MSG_TYPES)
+World::World(): mail_timer(0), mail_timer_expires(0), m_NextWeeklyQuestReset(0), m_opcodeCounters(NUM_MSG_TYPES), m_backgroundReloadRunning(false)
 {
     m_playerLimit = 0;
     m_allowMovement = true;
@@ -135,6 +142,9 @@ World::~World()
 {
     // it is assumed that no other thread is accessing this data when the destructor is called.  therefore, no locks are necessary
 
+    if (m_backgroundReloadThread.joinable())
+        m_backgroundReloadThread.join();
+
     ///- Empty the kicked session set
     for (auto const session : m_sessions)
         delete session.second;
@@ -145,21 +155,55 @@ World::~World()
     for (auto const session : m_sessionAddQueue)
         delete session;
 
+    sPathWorkerPool.Stop();
     VMAP::VMapFactory::clear();
     MMAP::MMapFactory::clear();
-
-    m_lfgQueueThread.join();
 }
 
 /// Cleanups before world stop
 void World::CleanupsBeforeStop()
 {
+    if (m_backgroundReloadThread.joinable())         // a running reload still queries the world database
+        m_backgroundReloadThread.join();
     KickAll(true);                                   // save and kick all players
     UpdateSessions(1);                               // real players unload required UpdateSessions call
     sBattleGroundMgr.DeleteAllBattleGrounds();       // unload battleground templates before different singletons destroyed
     sMapMgr.UnloadAll();                             // unload all grids (including locked in memory)
 }
 
+/// Run a reload away from the world thread
+bool World::StartBackgroundReload(std::function<void()> const& loader, std::function<void()> const& finished)
+{
+    if (m_backgroundReloadRunning)
+        return false;
+
+    // the previous reload has already sent its finished message
+    if (m_backgroundReloadThread.joinable())
+        m_backgroundReloadThread.join();
+
+    m_backgroundReloadRunning = true;
+    m_backgroundReloadThread = std::thread([this, loader, finished]()
+    {
+        // a connection of its own, the big SELECTs must not hold the ones the world and map threads query through
+        WorldDatabase.ThreadStart();
+        if (!WorldDatabase.OpenThreadConnection())
+            sLog.outError("World::StartBackgroundReload: can not open a database connection, reloading through the shared ones");
+
+        loader();
+
+        WorldDatabase.CloseThreadConnection();
+        WorldDatabase.ThreadEnd();
+
+        GetMessager().AddMessage([finished](World* world)
+        {
+            world->m_backgroundReloadRunning = false;
+            finished();
+        });
+    });
+
+    return true;
+}
+
 /// Find a session by its id
 WorldSession* World::FindSession(uint32 id) const
 {
@@ -458,8 +502,11 @@ void World::LoadConfigSettings(bool reload)
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
+    setConfig(CONFIG_BOOL_PLAYER_LOGIN_PREFETCH, "PlayerLoginPrefetch", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
     setConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS, "MaxWhoListReturns", 49);
+    setConfig(CONFIG_UINT32_TICK_PROFILER_SLOW_TICK, "TickProfiler.SlowTick", 0);
+    setConfig(CONFIG_UINT32_TICK_PROFILER_DUMP_COOLDOWN, "TickProfiler.DumpCooldown", 60);
 
     std::string forceLoadGridOnMaps = sConfig.GetStringDefault("LoadAllGridsOnMaps");
     if (!forceLoadGridOnMaps.empty())
@@ -631,6 +678,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_CHATFLOOD_MUTE_TIME,     "ChatFlood.MuteTime", 10);
 
     setConfig(CONFIG_BOOL_EVENT_ANNOUNCE, "Event.Announce", false);
+    setConfig(CONFIG_UINT32_MAP_DEFERRED_MESSAGES_PER_TICK, "Event.MapChangesPerTick", 200);
 
     setConfig(CONFIG_UINT32_CREATURE_FAMILY_ASSISTANCE_DELAY, "CreatureFamilyAssistanceDelay", 1500);
     setConfig(CONFIG_UINT32_CREATURE_FAMILY_FLEE_DELAY,       "CreatureFamilyFleeDelay",       10000);
@@ -717,6 +765,10 @@ void World::LoadConfigSettings(bool reload)
     m_relocation_ai_notify_delay = sConfig.GetIntDefault("Visibility.AIRelocationNotifyDelay", 1000u);
     m_relocation_lower_limit_sq = pow(sConfig.GetFloatDefault("Visibility.RelocationLowerLimit", 10), 2);
 
+    setConfig(CONFIG_BOOL_MOVEMENT_RELAY_BATCH, "Visibility.MovementRelay.Batch", true);
+    setConfigMin(CONFIG_FLOAT_MOVEMENT_RELAY_LOD_DISTANCE, "Visibility.MovementRelay.LodDistance", 0.0f, 0.0f);
+    setConfigMin(CONFIG_UINT32_MOVEMENT_RELAY_LOD_INTERVAL, "Visibility.MovementRelay.LodInterval", 1000, 100);
+
     // Visibility on Continents
     m_MaxVisibleDistanceOnContinents      = sConfig.GetFloatDefault("Visibility.Distance.Continents",     DEFAULT_VISIBILITY_DISTANCE);
     if (m_MaxVisibleDistanceOnContinents < 45 * getConfig(CONFIG_FLOAT_RATE_CREATURE_AGGRO))
@@ -788,6 +840,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
+    setConfig(CONFIG_BOOL_VMAP_QUERY_CACHE, "vmap.enableQueryCache", true);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
 
@@ -807,6 +860,8 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_BOOL_PATH_FIND_OPTIMIZE, "PathFinder.OptimizePath", true);
     setConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z, "PathFinder.NormalizeZ", false);
+    setConfig(CONFIG_UINT32_PATH_FIND_SHARED_CORRIDOR_LIFETIME, "PathFinder.SharedCorridorLifetime", 500);
+    setConfig(CONFIG_UINT32_PATH_FIND_ASYNC_THREADS, "PathFinder.AsyncThreads", 2);
 
     sLog.outString();
 }
@@ -1326,11 +1381,16 @@ void World::SetInitialWorldSettings()
     ///- Initialize MapManager
     sLog.outString("Starting Map System");
     sMapMgr.Initialize();
+    sPathWorkerPool.Start(getConfig(CONFIG_UINT32_PATH_FIND_ASYNC_THREADS));
     sLog.outString();
 
     ///- Initialize Battlegrounds
     sLog.outString("Starting BattleGround System");
     sBattleGroundMgr.CreateInitialBattleGrounds();
+
+    // battleground queues are only updated on joins, leaves and free slots, lfg also for its queue timers
+    m_matchmakingScheduler.Register(MATCHMAKING_BATTLEGROUND, 0, [](uint32 diff) { sBattleGroundMgr.Update(diff); });
+    m_matchmakingScheduler.Register(MATCHMAKING_LFG, LFG_QUEUE_UPDATE_INTERVAL, [this](uint32 diff) { m_lfgQueue.Update(diff); });
     CheckLootTemplates_Reference(ids_set);
 
     sLog.outString("Deleting expired bans...");
@@ -1440,6 +1500,9 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    TickPhaseScope worldPhase(TICK_PHASE_WORLD, "world");
+    TickProfileFrame worldFrame(TICK_PROFILER_WORLD, 0, diff);
+
     m_currentMSTime = WorldTimer::getMSTime();
     m_currentTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     m_currentDiff = diff;
@@ -1456,10 +1519,19 @@ void World::Update(uint32 diff)
     ///- Update the game time and check for shutdown time
     _UpdateGameTime();
 
-    GetMessager().Execute(this);
+    {
+        TICK_PROFILE_ZONE("messager");
+        GetMessager().Execute(this);
+    }
+
+    ///- Free the tables replaced by reloads once no map update can read them anymore
+    sEpochReclaimer.Reclaim();
 
     ///-Update mass mailer tasks if any
-    sMassMailMgr.Update();
+    {
+        TICK_PROFILE_ZONE("mass mail");
+        sMassMailMgr.Update();
+    }
 
     /// Handle weekly quests reset time
     if (m_gameTime > m_NextWeeklyQuestReset)
@@ -1468,6 +1540,7 @@ void World::Update(uint32 diff)
     /// <ul><li> Handle auctions when the timer has passed
     if (m_timers[WUPDATE_AUCTIONS].Passed())
     {
+        TICK_PROFILE_ZONE("mails and auctions");
         m_timers[WUPDATE_AUCTIONS].Reset();
 
         ///- Update mails (return old mails with item, or delete them)
@@ -1491,11 +1564,21 @@ void World::Update(uint32 diff)
     }
 #endif
 
+    /// <li> Feed replayed captures and load test bots to their sessions
+    {
+        TICK_PROFILE_ZONE("replay and load test");
+        sPacketReplay.Update(diff);
+        sLoadTest.Update(diff);
+    }
+
     /// <li> Handle session updates
 #ifdef BUILD_METRICS
     auto preSessionTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
-    UpdateSessions(diff);
+    {
+        TickPhaseScope sessionPhase(TICK_PHASE_SESSIONS, "sessions");
+        UpdateSessions(diff);
+    }
 
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
@@ -1512,13 +1595,25 @@ void World::Update(uint32 diff)
 #ifdef BUILD_METRICS
     auto preMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
-    sMapMgr.Update(diff);
+    {
+        TickPhaseScope mapPhase(TICK_PHASE_MAPS, "maps");
+        sMapMgr.Update(diff);
+    }
 #ifdef BUILD_METRICS
     auto postMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
-    sBattleGroundMgr.Update(diff);
-    sOutdoorPvPMgr.Update(diff);
-    sWorldState.Update(diff);
+    {
+        TICK_PROFILE_ZONE("matchmaking");
+        m_matchmakingScheduler.Update(diff);
+    }
+    {
+        TICK_PROFILE_ZONE("outdoor pvp");
+        sOutdoorPvPMgr.Update(diff);
+    }
+    {
+        TICK_PROFILE_ZONE("world state");
+        sWorldState.Update(diff);
+    }
 #ifdef BUILD_METRICS
     auto postSingletonTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
@@ -1541,7 +1636,10 @@ void World::Update(uint32 diff)
     }
 
     // execute callbacks from sql queries that were queued recently
-    UpdateResultQueue();
+    {
+        TickPhaseScope dbPhase(TICK_PHASE_DB_QUEUE, "db callbacks");
+        UpdateResultQueue();
+    }
 
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
@@ -1554,6 +1652,7 @@ void World::Update(uint32 diff)
     ///- Process Game events when necessary
     if (m_timers[WUPDATE_EVENTS].Passed())
     {
+        TICK_PROFILE_ZONE("game events");
         m_timers[WUPDATE_EVENTS].Reset();                   // to give time for Update() to be processed
         uint32 nextGameEvent = sGameEventMgr.Update();
         m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);
@@ -1565,6 +1664,7 @@ void World::Update(uint32 diff)
     {
         m_timers[WUPDATE_METRICS].Reset();
         GeneratePacketMetrics();
+        metric::registry::instance().aggregate();
     }
 #endif
 
@@ -1941,14 +2041,6 @@ bool World::RemoveBanAccount(BanMode mode, const std::string& source, const std:
     return true;
 }
 
-void World::StartLFGQueueThread()
-{
-    m_lfgQueueThread = std::thread([&]()
-    {
-        m_lfgQueue.Update();
-    });
-}
-
 /// Update the game time
 void World::_UpdateGameTime()
 {
@@ -31,6 +31,7 @@
 #include "Multithreading/Messager.h"
 #include "Globals/GraveyardManager.h"
 #include "LFG/LFGQueue.h"
+#include "World/MatchmakingScheduler.h"
 
 #include <set>
 #include <list>
@@ -40,6 +41,8 @@
 #include <utility>
 #include <vector>
 #include <array>
+#include <atomic>
+#include <thread>
 
 class Object;
 class ObjectGuid;
@@ -197,6 +200,12 @@ enum eConfigUInt32Values
     CONFIG_UINT32_CREATURE_PICKPOCKET_RESTOCK_DELAY,
     CONFIG_UINT32_CHANNEL_STATIC_AUTO_TRESHOLD,
     CONFIG_UINT32_LFG_MATCHMAKING_TIMER,
+    CONFIG_UINT32_PATH_FIND_SHARED_CORRIDOR_LIFETIME,
+    CONFIG_UINT32_PATH_FIND_ASYNC_THREADS,
+    CONFIG_UINT32_MOVEMENT_RELAY_LOD_INTERVAL,
+    CONFIG_UINT32_TICK_PROFILER_SLOW_TICK,
+    CONFIG_UINT32_TICK_PROFILER_DUMP_COOLDOWN,
+    CONFIG_UINT32_MAP_DEFERRED_MESSAGES_PER_TICK,
     CONFIG_UINT32_VALUE_COUNT
 };
 
@@ -282,6 +291,7 @@ enum eConfigFloatValues
     CONFIG_FLOAT_GHOST_RUN_SPEED_WORLD,
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
     CONFIG_FLOAT_LEASH_RADIUS,
+    CONFIG_FLOAT_MOVEMENT_RELAY_LOD_DISTANCE,
     CONFIG_FLOAT_VALUE_COUNT
 };
 
@@ -348,6 +358,9 @@ enum eConfigBoolValues
     CONFIG_BOOL_PATH_FIND_OPTIMIZE,
     CONFIG_BOOL_PATH_FIND_NORMALIZE_Z,
     CONFIG_BOOL_LFG_MATCHMAKING,
+    CONFIG_BOOL_PLAYER_LOGIN_PREFETCH,
+    CONFIG_BOOL_VMAP_QUERY_CACHE,
+    CONFIG_BOOL_MOVEMENT_RELAY_BATCH,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -627,7 +640,12 @@ class World
         void SendGMTextFlags(uint32 accountFlag, int32 stringId, std::string type, const char* message);
 
         LFGQueue& GetLFGQueue() { return m_lfgQueue; }
-        void StartLFGQueueThread();
+        MatchmakingScheduler& GetMatchmakingScheduler() { return m_matchmakingScheduler; }
+
+        // runs loader on its own thread and database connection, the stores it loads publish themselves when complete
+        // finished is called on the world thread afterwards, returns false while another background reload runs
+        bool StartBackgroundReload(std::function<void()> const& loader, std::function<void()> const& finished);
+        bool IsBackgroundReloadRunning() const { return m_backgroundReloadRunning; }
     protected:
         void _UpdateGameTime();
         // callback for UpdateRealmCharacters
@@ -740,9 +758,11 @@ class World
 
         GraveyardManager m_graveyardManager;
 
-        // Housing this here but logically it is completely asynchronous - TODO: Separate this and unify with BG queue
         LFGQueue m_lfgQueue;
-        std::thread m_lfgQueueThread;
+        MatchmakingScheduler m_matchmakingScheduler;        // battleground and lfg queues
+
+        std::thread m_backgroundReloadThread;
+        std::atomic<bool> m_backgroundReloadRunning;
 };
 
 extern uint32 realmID;
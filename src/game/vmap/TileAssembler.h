@@ -98,17 +98,23 @@ namespace VMAP
             unsigned int iCurrentUniqueNameId;
             MapData mapData;
             std::set<std::string> spawnedModelFiles;
+            uint32 iThreads;
+
+            bool convertMap(uint32 mapId, MapSpawns& spawns, std::set<std::string>& modelFiles) const;
 
         public:
             TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
             virtual ~TileAssembler();
 
+            // maps and model files are converted by that many threads, 1 (default) keeps everything on the calling thread
+            void setThreadCount(uint32 threads) { iThreads = threads ? threads : 1; }
+
             bool convertWorld2();
             bool readMapSpawns();
-            bool calculateTransformedBound(ModelSpawn& spawn);
+            bool calculateTransformedBound(ModelSpawn& spawn) const;
 
             void exportGameobjectModels();
-            bool convertRawFile(const std::string& pModelFilename);
+            bool convertRawFile(const std::string& pModelFilename) const;
             void setModelNameFilterMethod(bool (*pFilterMethod)(char* pName)) { iFilterMethod = pFilterMethod; }
     };
 }                                                           // VMAP
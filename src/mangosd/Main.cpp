@@ -29,6 +29,7 @@
 #include "SystemConfig.h"
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "PlayerBot/config.h"
+#include "Tools/LoadTest.h"
 
 #include <openssl/opensslv.h>
 #include <openssl/crypto.h>
@@ -68,7 +69,8 @@ uint32 realmID;                                             ///< Id of the realm
 /// Launch the mangos server
 int main(int argc, char* argv[])
 {
-    std::string auctionBotConfig, configFile, playerBotConfig, serviceParameter;
+    std::string auctionBotConfig, configFile, playerBotConfig, serviceParameter, loadTestScenario;
+    uint32 loadTestBots = 0, loadTestTicks = 0;
 
     boost::program_options::options_description desc("Allowed options");
     desc.add_options()
@@ -77,6 +79,9 @@ int main(int argc, char* argv[])
 #ifdef BUILD_PLAYERBOT
     ("playerbot,p", boost::program_options::value<std::string>(&playerBotConfig)->default_value(_D_PLAYERBOT_CONFIG), "playerbot configuration file")
 #endif
+    ("loadtest", boost::program_options::value<std::string>(&loadTestScenario), ("run a load test without network and exit, scenarios: " + LoadTest::GetScenarioNames()).c_str())
+    ("loadtest-bots", boost::program_options::value<uint32>(&loadTestBots), "bots of the load test instead of the scenario default")
+    ("loadtest-ticks", boost::program_options::value<uint32>(&loadTestTicks), "world ticks of the load test instead of the scenario default")
     ("help,h", "prints usage")
     ("version,v", "print version and exit")
 #ifdef _WIN32
@@ -116,6 +121,12 @@ int main(int argc, char* argv[])
     if (vm.count("ahbot"))
         sAuctionHouseBot.SetConfigFileName(auctionBotConfig);
 
+    if (vm.count("loadtest") && !sLoadTest.Configure(loadTestScenario, loadTestBots, loadTestTicks))
+    {
+        std::cerr << "ERROR: unknown load test scenario " << loadTestScenario << ", known are " << LoadTest::GetScenarioNames() << std::endl;
+        return 1;
+    }
+
 #ifdef BUILD_PLAYERBOT
     if (vm.count("playerbot"))
         _PLAYERBOT_CONFIG = playerBotConfig;
@@ -41,6 +41,7 @@
 #include "Policies/Singleton.h"
 #include "Network/Listener.hpp"
 #include "Network/Socket.hpp"
+#include "Tools/LoadTest.h"
 
 #include <memory>
 
@@ -141,14 +142,13 @@ int Master::Run()
     world_thread.setPriority(MaNGOS::Priority_Highest);
 
     // set realmbuilds depend on mangosd expected builds, and set server online
+    if (!sLoadTest.IsEnabled())
     {
         std::string builds = AcceptableClientBuildsListStr();
         LoginDatabase.escape_string(builds);
         LoginDatabase.DirectPExecute("UPDATE realmlist SET realmflags = realmflags & ~(%u), population = 0, realmbuilds = '%s'  WHERE id = '%u'", REALM_FLAG_OFFLINE, builds.c_str(), realmID);
     }
 
-    sWorld.StartLFGQueueThread();
-
     MaNGOS::Thread* cliThread = nullptr;
 
 #ifdef _WIN32
@@ -222,14 +222,19 @@ int Master::Run()
             sLog.outError("Invalid network tread workers setting in mangosd.conf. (%d) should be > 0", networkThreadWorker);
             networkThreadWorker = 1;
         }
-        MaNGOS::Listener<WorldSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), int32(sWorld.getConfig(CONFIG_UINT32_PORT_WORLD)), networkThreadWorker);
+        // load tests run without network
+        bool const network = !sLoadTest.IsEnabled();
+
+        std::unique_ptr<MaNGOS::Listener<WorldSocket>> listener;
+        if (network)
+            listener.reset(new MaNGOS::Listener<WorldSocket>(sConfig.GetStringDefault("BindIP", "0.0.0.0"), int32(sWorld.getConfig(CONFIG_UINT32_PORT_WORLD)), networkThreadWorker));
 
         std::unique_ptr<MaNGOS::Listener<RASocket>> raListener;
-        if (sConfig.GetBoolDefault("Ra.Enable", false))
+        if (network && sConfig.GetBoolDefault("Ra.Enable", false))
             raListener.reset(new MaNGOS::Listener<RASocket>(sConfig.GetStringDefault("Ra.IP", "0.0.0.0"), sConfig.GetIntDefault("Ra.Port", 3443), 1));
 
         std::unique_ptr<SOAPThread> soapThread;
-        if (sConfig.GetBoolDefault("SOAP.Enabled", false))
+        if (network && sConfig.GetBoolDefault("SOAP.Enabled", false))
             soapThread.reset(new SOAPThread(sConfig.GetStringDefault("SOAP.IP", "127.0.0.1"), sConfig.GetIntDefault("SOAP.Port", 7878)));
 
         // wait for shut down and then let things go out of scope to close them down
@@ -335,6 +340,7 @@ bool Master::_StartDB()
 
     dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo");
     nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
+    int nHolderConnections = sConfig.GetIntDefault("CharacterDatabaseHolderConnections", 4);
     if (dbstring.empty())
     {
         sLog.outError("Character Database not specified in configuration file");
@@ -343,10 +349,10 @@ bool Master::_StartDB()
         WorldDatabase.HaltDelayThread();
         return false;
     }
-    sLog.outString("Character Database total connections: %i", nConnections + 1);
+    sLog.outString("Character Database total connections: %i (+%i for player login queries)", nConnections + 1, nHolderConnections);
 
     ///- Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections, nHolderConnections))
     {
         sLog.outError("Cannot connect to Character database %s", dbstring.c_str());
 
@@ -178,7 +178,7 @@ std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B,
 
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
-    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(service)
+    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _pinReceived(false), _build(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(service)
 {
 }
 
@@ -264,7 +264,41 @@ bool AuthSocket::ProcessIncomingData()
     return true;
 }
 
-void AuthSocket::SendProof(Sha1Hash sha)
+/// Run the blocking part of a handler on the AuthWorkerPool, the reply is applied on the network thread
+void AuthSocket::ScheduleAuthWork(AuthStage stage, std::function<void(AuthReply&)> work, AuthReplyHandler handler)
+{
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    std::shared_ptr<AuthReply> reply = std::make_shared<AuthReply>(_status);
+
+    _status = STATUS_PENDING;
+
+    sAuthWorkerPool.Schedule(stage, GetAsioSocket().get_executor(),
+                             [self, reply, work]() { work(*reply); },
+                             [self, reply, handler]()
+    {
+        // client went away while we were busy
+        if (self->IsClosed())
+            return;
+
+        (self.get()->*handler)(*reply);
+    });
+}
+
+void AuthSocket::SendAuthReply(AuthReply& reply)
+{
+    _status = reply.status;
+
+    if (reply.close)
+    {
+        Close();
+        return;
+    }
+
+    if (!reply.pkt.empty())
+        Write((const char*)reply.pkt.contents(), reply.pkt.size());
+}
+
+void AuthSocket::BuildProof(ByteBuffer& pkt, Sha1Hash sha)
 {
     switch (_build)
     {
@@ -278,7 +312,7 @@ void AuthSocket::SendProof(Sha1Hash sha)
             proof.error = 0;
             proof.LoginFlags = 0x00;
 
-            Write((const char*)&proof, sizeof(proof));
+            pkt.append((uint8 const*)&proof, sizeof(proof));
             break;
         }
         case 8606:                                          // 2.4.3
@@ -297,7 +331,7 @@ void AuthSocket::SendProof(Sha1Hash sha)
             proof.surveyId = 0x00000000;
             proof.unkFlags = 0x0000;
 
-            Write((const char*)&proof, sizeof(proof));
+            pkt.append((uint8 const*)&proof, sizeof(proof));
             break;
         }
     }
@@ -347,8 +381,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -375,138 +407,139 @@ bool AuthSocket::_HandleLogonChallenge()
     LoginDatabase.escape_string(_safelocale);
     LoginDatabase.escape_string(m_os);
 
-    pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
-    pkt << uint8(0x00);
+    ///- Account lookup and SRP6 host ephemeral are done by the worker pool
+    ScheduleAuthWork(AUTH_STAGE_LOGON_CHALLENGE, [this](AuthReply& reply)
+    {
+        ByteBuffer& pkt = reply.pkt;
+
+        pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
+        pkt << uint8(0x00);
 
-    ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
-            "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
+        ///- Verify that this IP is not in the ip_banned table
+        // No SQL injection possible (paste the IP address as passed by the socket)
+        std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
+                "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
+
+        if (ip_banned_result)
+        {
+            pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
+            BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
+            return;
+        }
 
-    if (ip_banned_result)
-    {
-        pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
-        BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
-    }
-    else
-    {
         ///- Get the account details from the account table
         // No SQL injection (escaped user name)
-        QueryResult* result = LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
-        if (result)
+        std::unique_ptr<QueryResult> result(LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str()));
+        if (!result)                                        // no account
         {
-            Field* fields = result->Fetch();
+            pkt << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT);
+            return;
+        }
 
-            ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
-            bool locked = false;
-            if (fields[1].GetUInt8() == 1)               // if ip is locked
+        Field* fields = result->Fetch();
+
+        ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
+        bool locked = false;
+        if (fields[1].GetUInt8() == 1)                      // if ip is locked
+        {
+            DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[2].GetString());
+            DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
+            if (strcmp(fields[2].GetString(), m_address.c_str()))
             {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[2].GetString());
-                DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
-                if (strcmp(fields[2].GetString(), m_address.c_str()))
-                {
-                    DEBUG_LOG("[AuthChallenge] Account IP differs");
-                    pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
-                    locked = true;
-                }
-                else
-                    DEBUG_LOG("[AuthChallenge] Account IP matches");
+                DEBUG_LOG("[AuthChallenge] Account IP differs");
+                pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
+                locked = true;
             }
             else
-                DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+                DEBUG_LOG("[AuthChallenge] Account IP matches");
+        }
+        else
+            DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+
+        std::string databaseV = fields[4].GetCppString();
+        std::string databaseS = fields[5].GetCppString();
+        bool broken = false;
+
+        if (!srp.SetVerifier(databaseV.c_str()) || !srp.SetSalt(databaseS.c_str()))
+        {
+            pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
+            DEBUG_LOG("[AuthChallenge] Broken v/s values in database for account %s!", _login.c_str());
+            broken = true;
+        }
 
-            std::string databaseV = fields[4].GetCppString();
-            std::string databaseS = fields[5].GetCppString();
-            bool broken = false;
+        if (locked || broken)
+            return;
 
-            if (!srp.SetVerifier(databaseV.c_str()) || !srp.SetSalt(databaseS.c_str()))
+        ///- If the account is banned, reject the logon attempt
+        std::unique_ptr<QueryResult> banresult(LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
+                                               "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[0].GetUInt32()));
+        if (banresult)
+        {
+            if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
             {
-                pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
-                DEBUG_LOG("[AuthChallenge] Broken v/s values in database for account %s!", _login.c_str());
-                broken = true;
+                pkt << uint8(AUTH_LOGON_FAILED_BANNED);
+                BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
             }
-
-            if (!locked && !broken)
+            else
             {
-                ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
-                                         "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[0].GetUInt32());
-                if (banresult)
-                {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-                    {
-                        pkt << uint8(AUTH_LOGON_FAILED_BANNED);
-                        BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
-                    }
-                    else
-                    {
-                        pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
-                        BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
-                    }
+                pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
+                BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
+            }
+            return;
+        }
 
-                    delete banresult;
-                }
-                else
-                {
-                    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
+        DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
 
-                    BigNumber s;
-                    s.SetHexStr(databaseS.c_str());
+        BigNumber s;
+        s.SetHexStr(databaseS.c_str());
 
-                    srp.CalculateHostPublicEphemeral();
+        srp.CalculateHostPublicEphemeral();
 
-                    ///- Fill the response packet with the result
-                    pkt << uint8(AUTH_LOGON_SUCCESS);
+        ///- Fill the response packet with the result
+        pkt << uint8(AUTH_LOGON_SUCCESS);
 
-                    // B may be calculated < 32B so we force minimal length to 32B
-                    pkt.append(srp.GetHostPublicEphemeral().AsByteArray(32));      // 32 bytes
-                    pkt << uint8(1);
-                    pkt.append(srp.GetGeneratorModulo().AsByteArray());
-                    pkt << uint8(32);
-                    pkt.append(srp.GetPrime().AsByteArray(32));
-                    pkt.append(s.AsByteArray());// 32 bytes
-                    pkt.append(VersionChallenge.data(), VersionChallenge.size());
-                    uint8 securityFlags = 0;
+        // B may be calculated < 32B so we force minimal length to 32B
+        pkt.append(srp.GetHostPublicEphemeral().AsByteArray(32));      // 32 bytes
+        pkt << uint8(1);
+        pkt.append(srp.GetGeneratorModulo().AsByteArray());
+        pkt << uint8(32);
+        pkt.append(srp.GetPrime().AsByteArray(32));
+        pkt.append(s.AsByteArray());// 32 bytes
+        pkt.append(VersionChallenge.data(), VersionChallenge.size());
+        uint8 securityFlags = 0;
 
-                    _token = fields[6].GetCppString();
-                    if (!_token.empty() && _build >= 8606) // authenticator was added in 2.4.3
-                        securityFlags = SECURITY_FLAG_AUTHENTICATOR;
+        _token = fields[6].GetCppString();
+        if (!_token.empty() && _build >= 8606) // authenticator was added in 2.4.3
+            securityFlags = SECURITY_FLAG_AUTHENTICATOR;
 
-                    pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
+        pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
 
-                    if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
-                    {
-                        pkt << uint32(0);
-                        pkt << uint64(0);
-                        pkt << uint64(0);
-                    }
+        if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
+        {
+            pkt << uint32(0);
+            pkt << uint64(0);
+            pkt << uint64(0);
+        }
 
-                    if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
-                    {
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint64(0);
-                    }
+        if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
+        {
+            pkt << uint8(0);
+            pkt << uint8(0);
+            pkt << uint8(0);
+            pkt << uint8(0);
+            pkt << uint64(0);
+        }
 
-                    if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
-                        pkt << uint8(1);
+        if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
+            pkt << uint8(1);
 
-                    uint8 secLevel = fields[3].GetUInt8();
-                    _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+        uint8 secLevel = fields[3].GetUInt8();
+        _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
 
-                    ///- All good, await client's proof
-                    _status = STATUS_LOGON_PROOF;
-                }
-            }
-            delete result;
-        }
-        else                                                // no account
-            pkt << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT);
-    }
+        ///- All good, await client's proof
+        reply.status = STATUS_LOGON_PROOF;
+    });
 
-    Write((const char*)pkt.contents(), pkt.size());
     return true;
 }
 
@@ -537,132 +570,141 @@ bool AuthSocket::_HandleLogonProof()
     }
     /// </ul>
 
-    ///- Continue the SRP6 calculation based on data received from the client
-    if(!srp.CalculateSessionKey(lp.A, 32))
+    ///- The authenticator pin follows the proof, read it while we still own the input buffer
+    _pinReceived = false;
+    if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
     {
-        BASIC_LOG("[AuthChallenge] Session calculation failed for account %s!", _login.c_str());
-        return false;
+        uint8 pinCount;
+        if (Read((char*)&pinCount, sizeof(uint8)))
+        {
+            std::vector<char> keys(pinCount + 1);
+            _pinReceived = Read(keys.data(), sizeof(uint8) * pinCount);
+            keys[pinCount] = '\0';
+            _pinKeys = keys.data();
+        }
     }
 
-    srp.HashSessionKey();
-    srp.CalculateProof(_login);
-
-    ///- Check if SRP6 results match (password is correct), else send an error
-    if (!srp.Proof(lp.M1, 20))
+    ///- SRP6 proof verification and account update are done by the worker pool
+    ScheduleAuthWork(AUTH_STAGE_LOGON_PROOF, [this, lp](AuthReply& reply) mutable
     {
-        if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
+        ByteBuffer& pkt = reply.pkt;
+
+        ///- Continue the SRP6 calculation based on data received from the client
+        if (!srp.CalculateSessionKey(lp.A, 32))
         {
-            uint8 pinCount;
-            if (!Read((char*)&pinCount, sizeof(uint8)))
-            {
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
-                Write(data, sizeof(data));
-                return true;
-            }
-            std::vector<uint8> keys(pinCount + 1);
-            if (!Read((char*)keys.data(), sizeof(uint8) * pinCount))
-            {
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
-                Write(data, sizeof(data));
-                return true;
-            }
+            BASIC_LOG("[AuthChallenge] Session calculation failed for account %s!", _login.c_str());
+            reply.close = true;
+            return;
+        }
 
-            keys[pinCount] = '\0';
-            auto ServerToken = generateToken(_token.c_str());
-            auto clientToken = atoi((const char*)keys.data());
-            if (ServerToken != clientToken)
+        srp.HashSessionKey();
+        srp.CalculateProof(_login);
+
+        ///- Check if SRP6 results match (password is correct), else send an error
+        if (!srp.Proof(lp.M1, 20))
+        {
+            if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
             {
-                BASIC_LOG("[AuthChallenge] Account %s tried to login with wrong pincode! Given %u Expected %u Pin Count: %u", _login.c_str(), clientToken, ServerToken, pinCount);
+                if (!_pinReceived)
+                {
+                    pkt << uint8(CMD_AUTH_LOGON_PROOF) << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT) << uint8(3) << uint8(0);
+                    return;
+                }
 
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 0, 0 };
-                Write(data, sizeof(data));
-                return true;
+                auto ServerToken = generateToken(_token.c_str());
+                auto clientToken = atoi(_pinKeys.c_str());
+                if (ServerToken != clientToken)
+                {
+                    BASIC_LOG("[AuthChallenge] Account %s tried to login with wrong pincode! Given %u Expected %u Pin Count: %u", _login.c_str(), clientToken, ServerToken, uint32(_pinKeys.size()));
+
+                    pkt << uint8(CMD_AUTH_LOGON_PROOF) << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT) << uint8(0) << uint8(0);
+                    return;
+                }
             }
-        }
 
-        if (!VerifyVersion(lp.A, sizeof(lp.A), lp.crc_hash, false))
-        {
-            BASIC_LOG("[AuthChallenge] Account %s tried to login with modified client!", _login.c_str());
+            if (!VerifyVersion(lp.A, sizeof(lp.A), lp.crc_hash, false))
+            {
+                BASIC_LOG("[AuthChallenge] Account %s tried to login with modified client!", _login.c_str());
 
-            const char data[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_VERSION_INVALID };
-            Write(data, sizeof(data));
-            return true;
-        }
+                pkt << uint8(CMD_AUTH_LOGON_PROOF) << uint8(AUTH_LOGON_FAILED_VERSION_INVALID);
+                return;
+            }
 
-        BASIC_LOG("User '%s' successfully authenticated", _login.c_str());
+            BASIC_LOG("User '%s' successfully authenticated", _login.c_str());
 
-        ///- Update the sessionkey, current ip and login time and reset number of failed logins in the account table for this account
-        // No SQL injection (escaped user input) and IP address as received by socket
-        const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
-        LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s', platform = '%s' WHERE username = '%s'", K_hex, _safelocale.c_str(), m_os.c_str(), m_platform.c_str(), _safelogin.c_str());
-        if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str()))
-            LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s',NOW(),'%u')", loginfail->Fetch()[0].GetUInt32(), m_address.c_str(), LOGIN_TYPE_REALMD);
-        OPENSSL_free((void*)K_hex);
+            ///- Update the sessionkey, current ip and login time and reset number of failed logins in the account table for this account
+            // No SQL injection (escaped user input) and IP address as received by socket
+            const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
+            LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s', platform = '%s' WHERE username = '%s'", K_hex, _safelocale.c_str(), m_os.c_str(), m_platform.c_str(), _safelogin.c_str());
+            if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str()))
+            {
+                LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s',NOW(),'%u')", loginfail->Fetch()[0].GetUInt32(), m_address.c_str(), LOGIN_TYPE_REALMD);
+                delete loginfail;
+            }
+            OPENSSL_free((void*)K_hex);
 
-        ///- Finish SRP6 and send the final result to the client
-        Sha1Hash sha;
-        srp.Finalize(sha);
+            ///- Finish SRP6 and send the final result to the client
+            Sha1Hash sha;
+            srp.Finalize(sha);
 
-        SendProof(sha);
+            BuildProof(pkt, sha);
 
-        ///- Set _status to authed!
-        _status = STATUS_AUTHED;
-    }
-    else
-    {
-        if (_build > 6005)                                  // > 1.12.2
-        {
-            const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 0, 0 };
-            Write(data, sizeof(data));
+            ///- Set _status to authed!
+            reply.status = STATUS_AUTHED;
         }
         else
         {
-            // 1.x not react incorrectly at 4-byte message use 3 as real error
-            const char data[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT };
-            Write(data, sizeof(data));
-        }
-
-        BASIC_LOG("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str());
+            if (_build > 6005)                                  // > 1.12.2
+                pkt << uint8(CMD_AUTH_LOGON_PROOF) << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT) << uint8(0) << uint8(0);
+            else
+            {
+                // 1.x not react incorrectly at 4-byte message use 3 as real error
+                pkt << uint8(CMD_AUTH_LOGON_PROOF) << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT);
+            }
 
-        uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
-        if (MaxWrongPassCount > 0)
-        {
-            // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
-            LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
+            BASIC_LOG("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str());
 
-            if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
+            uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
+            if (MaxWrongPassCount > 0)
             {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
+                // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
+                LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
 
-                if (failed_logins >= MaxWrongPassCount)
+                if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
                 {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+                    Field* fields = loginfail->Fetch();
+                    uint32 failed_logins = fields[1].GetUInt32();
 
-                    if (WrongPassBanType)
-                    {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
-                                               "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
-                                               acc_id, WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                                  _login.c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
+                    if (failed_logins >= MaxWrongPassCount)
                     {
-                        std::string current_ip = m_address;
-                        LoginDatabase.escape_string(current_ip);
-                        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
-                                               current_ip.c_str(), WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                                  current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
+                        uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+                        bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+
+                        if (WrongPassBanType)
+                        {
+                            uint32 acc_id = fields[0].GetUInt32();
+                            LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
+                                                   "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
+                                                   acc_id, WrongPassBanTime);
+                            BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+                                      _login.c_str(), WrongPassBanTime, failed_logins);
+                        }
+                        else
+                        {
+                            std::string current_ip = m_address;
+                            LoginDatabase.escape_string(current_ip);
+                            LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
+                                                   current_ip.c_str(), WrongPassBanTime);
+                            BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+                                      current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
+                        }
                     }
+                    delete loginfail;
                 }
-                delete loginfail;
             }
         }
-    }
+    });
+
     return true;
 }
 
@@ -709,31 +751,34 @@ bool AuthSocket::_HandleReconnectChallenge()
     EndianConvert(ch->build);
     _build = ch->build;
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str());
-
-    // Stop if the account is not found
-    if (!result)
+    ///- Session key lookup is done by the worker pool
+    ScheduleAuthWork(AUTH_STAGE_RECONNECT_CHALLENGE, [this](AuthReply& reply)
     {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
-        Close();
-        return false;
-    }
+        std::unique_ptr<QueryResult> result(LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str()));
 
-    Field* fields = result->Fetch();
-    srp.SetStrongSessionKey(fields[0].GetString());
-    delete result;
+        // Stop if the account is not found
+        if (!result)
+        {
+            sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
+            reply.close = true;
+            return;
+        }
 
-    ///- All good, await client's proof
-    _status = STATUS_RECON_PROOF;
+        Field* fields = result->Fetch();
+        srp.SetStrongSessionKey(fields[0].GetString());
+
+        ///- All good, await client's proof
+        reply.status = STATUS_RECON_PROOF;
+
+        ///- Sending response
+        ByteBuffer& pkt = reply.pkt;
+        pkt << (uint8)  CMD_AUTH_RECONNECT_CHALLENGE;
+        pkt << (uint8)  0x00;
+        _reconnectProof.SetRand(16 * 8);
+        pkt.append(_reconnectProof.AsByteArray(16));        // 16 bytes random
+        pkt.append(VersionChallenge.data(), VersionChallenge.size());
+    });
 
-    ///- Sending response
-    ByteBuffer pkt;
-    pkt << (uint8)  CMD_AUTH_RECONNECT_CHALLENGE;
-    pkt << (uint8)  0x00;
-    _reconnectProof.SetRand(16 * 8);
-    pkt.append(_reconnectProof.AsByteArray(16));        // 16 bytes random
-    pkt.append(VersionChallenge.data(), VersionChallenge.size());
-    Write((const char*)pkt.contents(), pkt.size());
     return true;
 }
 
@@ -798,38 +843,59 @@ bool AuthSocket::_HandleRealmList()
 
     ReadSkip(5);
 
-    ///- Get the user id (else close the connection)
-    // No SQL injection (escaped user name)
+    ///- Get the security level (else close the connection) and the character count on every realm in a single query
+    ScheduleAuthWork(AUTH_STAGE_REALM_LIST, [this](AuthReply& reply)
+    {
+        // No SQL injection (escaped user name)
+        std::unique_ptr<QueryResult> result(LoginDatabase.PQuery("SELECT a.gmlevel, rc.realmid, rc.numchars FROM account a "
+                                            "LEFT JOIN realmcharacters rc ON rc.acctid = a.id WHERE a.username = '%s'", _safelogin.c_str()));
+        if (!result)
+        {
+            sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", _login.c_str());
+            reply.close = true;
+            return;
+        }
+
+        reply.securityLevel = (*result)[0].GetUInt8();
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT id, gmlevel FROM account WHERE username = '%s'", _safelogin.c_str());
-    if (!result)
+        do
+        {
+            Field* fields = result->Fetch();
+            if (!fields[1].IsNULL())
+                reply.characters[fields[1].GetUInt32()] = fields[2].GetUInt8();
+        }
+        while (result->NextRow());
+
+        reply.status = STATUS_AUTHED;
+    }, &AuthSocket::SendRealmList);
+
+    return true;
+}
+
+void AuthSocket::SendRealmList(AuthReply& reply)
+{
+    if (reply.close)
     {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", _login.c_str());
-        Close();
-        return false;
+        SendAuthReply(reply);
+        return;
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    uint8 accountSecurityLevel = (*result)[1].GetUInt8();
-    delete result;
-
     ///- Update realm list if need
     sRealmList.UpdateIfNeed();
 
     ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id, accountSecurityLevel);
+    LoadRealmlist(pkt, reply.characters, reply.securityLevel);
 
-    ByteBuffer hdr;
+    ByteBuffer& hdr = reply.pkt;
     hdr << (uint8) CMD_REALM_LIST;
     hdr << (uint16)pkt.size();
     hdr.append(pkt);
 
-    Write((const char*)hdr.contents(), hdr.size());
-    return true;
+    SendAuthReply(reply);
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLevel)
+void AuthSocket::LoadRealmlist(ByteBuffer& pkt, RealmCharacterCounts const& characters, uint8 securityLevel)
 {
     switch (_build)
     {
@@ -842,18 +908,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                auto const chars = characters.find(i.second.m_ID);
+                uint8 AmountOfCharacters = chars != characters.end() ? chars->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -907,18 +963,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                auto const chars = characters.find(i.second.m_ID);
+                uint8 AmountOfCharacters = chars != characters.end() ? chars->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -30,10 +30,12 @@
 #include "Util/ByteBuffer.h"
 
 #include "Network/Socket.hpp"
+#include "AuthWorkerPool.h"
 
 #include <boost/asio.hpp>
 
 #include <functional>
+#include <map>
 
 #define HMAC_RES_SIZE 20
 
@@ -42,12 +44,14 @@ class AuthSocket : public MaNGOS::Socket
     public:
         const static int s_BYTE_SIZE = 32;
 
+        typedef std::map<uint32, uint8> RealmCharacterCounts;   // realm id -> number of characters of the account
+
         AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
 
         bool Open() override;
 
-        void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 accountSecurityLevel = 0);
+        void BuildProof(ByteBuffer& pkt, Sha1Hash sha);
+        void LoadRealmlist(ByteBuffer& pkt, RealmCharacterCounts const& characters, uint8 accountSecurityLevel = 0);
         int32 generateToken(char const* b32key);
 
         uint8 getEligibleRealmCount(uint8 accountSecurityLevel);
@@ -72,9 +76,30 @@ class AuthSocket : public MaNGOS::Socket
             STATUS_RECON_PROOF,
             STATUS_PATCH,      // unused in CMaNGOS
             STATUS_AUTHED,
+            STATUS_PENDING,    // waiting for an AuthWorkerPool job, any packet received meanwhile is rejected
             STATUS_CLOSED
         };
 
+        /// Result of a job executed by the AuthWorkerPool, applied on the network thread
+        struct AuthReply
+        {
+            explicit AuthReply(eStatus currentStatus) : status(currentStatus), close(false), securityLevel(0) {}
+
+            ByteBuffer pkt;                                 // sent to the client as is, unless empty
+            eStatus status;                                 // socket status once the reply is applied, unchanged unless the job sets it
+            bool close;                                     // close the socket instead of replying
+
+            // realm list only
+            uint8 securityLevel;
+            RealmCharacterCounts characters;
+        };
+
+        typedef void (AuthSocket::*AuthReplyHandler)(AuthReply& reply);
+
+        void ScheduleAuthWork(AuthStage stage, std::function<void(AuthReply&)> work, AuthReplyHandler handler = &AuthSocket::SendAuthReply);
+        void SendAuthReply(AuthReply& reply);
+        void SendRealmList(AuthReply& reply);
+
         SRP6 srp;
         BigNumber _reconnectProof;
 
@@ -83,6 +108,8 @@ class AuthSocket : public MaNGOS::Socket
         std::string _login;
         std::string _safelogin;
         std::string _token;
+        std::string _pinKeys;                               // authenticator pin sent with the logon proof
+        bool _pinReceived;
         std::string m_os;
         std::string m_platform;
         std::string m_locale;
@@ -0,0 +1,152 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "AuthWorkerPool.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+
+extern DatabaseType LoginDatabase;
+
+static char const* AuthStageNames[MAX_AUTH_STAGE] =
+{
+    "LogonChallenge",
+    "LogonProof",
+    "ReconnectChallenge",
+    "RealmList"
+};
+
+static void UpdateMax(std::atomic<uint64>& target, uint64 value)
+{
+    uint64 current = target.load(std::memory_order_relaxed);
+    while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+void AuthStageStats::Record(uint64 queued, uint64 executed)
+{
+    count.fetch_add(1, std::memory_order_relaxed);
+    queueTime.fetch_add(queued, std::memory_order_relaxed);
+    execTime.fetch_add(executed, std::memory_order_relaxed);
+    UpdateMax(maxQueueTime, queued);
+    UpdateMax(maxExecTime, executed);
+}
+
+AuthWorkerPool::AuthWorkerPool() : m_pending(0)
+{
+}
+
+AuthWorkerPool::~AuthWorkerPool()
+{
+    Stop();
+}
+
+AuthWorkerPool& sAuthWorkerPool
+{
+    static AuthWorkerPool pool;
+    return pool;
+}
+
+void AuthWorkerPool::Start(uint32 threads)
+{
+    if (!threads)
+        return;
+
+    m_work.reset(new boost::asio::io_service::work(m_service));
+
+    for (uint32 i = 0; i < threads; ++i)
+        m_threads.emplace_back(&AuthWorkerPool::WorkerThread, this);
+}
+
+void AuthWorkerPool::Stop()
+{
+    if (m_threads.empty())
+        return;
+
+    // pending work is dropped, the sockets waiting for it are closed together with the listener
+    m_work.reset();
+    m_service.stop();
+
+    for (auto& thread : m_threads)
+        if (thread.joinable())
+            thread.join();
+
+    m_threads.clear();
+}
+
+void AuthWorkerPool::WorkerThread()
+{
+    LoginDatabase.ThreadStart();
+
+    boost::system::error_code ec;
+    m_service.run(ec);
+
+    LoginDatabase.ThreadEnd();
+}
+
+void AuthWorkerPool::Schedule(AuthStage stage, Executor const& executor, std::function<void()> work, std::function<void()> completion)
+{
+    Clock::time_point const queued = Clock::now();
+
+    // no worker threads, keep the old behaviour of running everything on the network thread
+    if (m_threads.empty())
+    {
+        work();
+        m_stats[stage].Record(0, std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - queued).count());
+        completion();
+        return;
+    }
+
+    ++m_pending;
+    boost::asio::post(m_service, [this, stage, executor, queued, work = std::move(work), completion = std::move(completion)]()
+    {
+        Clock::time_point const started = Clock::now();
+        work();
+        Clock::time_point const finished = Clock::now();
+
+        m_stats[stage].Record(std::chrono::duration_cast<std::chrono::microseconds>(started - queued).count(),
+                              std::chrono::duration_cast<std::chrono::microseconds>(finished - started).count());
+        --m_pending;
+
+        boost::asio::post(executor, completion);
+    });
+}
+
+void AuthWorkerPool::LogStats()
+{
+    sLog.outString("Auth pipeline: %u worker threads, %u requests pending", uint32(m_threads.size()), m_pending.load());
+
+    for (int i = 0; i < MAX_AUTH_STAGE; ++i)
+    {
+        AuthStageStats& stats = m_stats[i];
+
+        uint64 const count = stats.count.exchange(0);
+        uint64 const queueTime = stats.queueTime.exchange(0);
+        uint64 const execTime = stats.execTime.exchange(0);
+        uint64 const maxQueueTime = stats.maxQueueTime.exchange(0);
+        uint64 const maxExecTime = stats.maxExecTime.exchange(0);
+
+        if (!count)
+            continue;
+
+        sLog.outString("  %-18s count " UI64FMTD " queue avg " UI64FMTD "us max " UI64FMTD "us, exec avg " UI64FMTD "us max " UI64FMTD "us",
+                       AuthStageNames[i], count, queueTime / count, maxQueueTime, execTime / count, maxExecTime);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _AUTHWORKERPOOL_H
+#define _AUTHWORKERPOOL_H
+
+#include "Common.h"
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/// Blocking steps of the authentication handshake that are moved off the network threads
+enum AuthStage
+{
+    AUTH_STAGE_LOGON_CHALLENGE      = 0,                    // account/ban lookup + SRP6 host ephemeral
+    AUTH_STAGE_LOGON_PROOF          = 1,                    // SRP6 session key/proof + account update
+    AUTH_STAGE_RECONNECT_CHALLENGE  = 2,                    // session key lookup
+    AUTH_STAGE_REALM_LIST           = 3,                    // account + character count lookup
+    MAX_AUTH_STAGE
+};
+
+/// Latency counters of one auth stage, all times in microseconds
+struct AuthStageStats
+{
+    AuthStageStats() : count(0), queueTime(0), execTime(0), maxQueueTime(0), maxExecTime(0) {}
+
+    void Record(uint64 queued, uint64 executed);
+
+    std::atomic<uint64> count;
+    std::atomic<uint64> queueTime;
+    std::atomic<uint64> execTime;
+    std::atomic<uint64> maxQueueTime;
+    std::atomic<uint64> maxExecTime;
+};
+
+/// Small pool of worker threads running the DB lookups and SRP6 math of AuthSocket
+/// Work is executed on a worker and its completion is posted back to the io_service of the socket,
+/// so socket state is still only touched by the network thread owning the socket.
+class AuthWorkerPool
+{
+    public:
+        typedef boost::asio::ip::tcp::socket::executor_type Executor;
+
+        static AuthWorkerPool& Instance();
+
+        AuthWorkerPool();
+        ~AuthWorkerPool();
+
+        /// Start the worker threads, with 0 threads all work is executed inline on the caller thread
+        void Start(uint32 threads);
+        void Stop();
+
+        void Schedule(AuthStage stage, Executor const& executor, std::function<void()> work, std::function<void()> completion);
+
+        /// Log the collected stage latencies and reset the counters
+        void LogStats();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        void WorkerThread();
+
+        boost::asio::io_service m_service;
+        // note that the work member *must* be declared after the service member
+        std::unique_ptr<boost::asio::io_service::work> m_work;
+        std::vector<std::thread> m_threads;
+
+        AuthStageStats m_stats[MAX_AUTH_STAGE];
+        std::atomic<uint32> m_pending;
+};
+
+#define sAuthWorkerPool AuthWorkerPool::Instance()
+
+#endif
+/// @}
@@ -23,6 +23,7 @@
 #include "Common.h"
 #include "Database/DatabaseEnv.h"
 #include "RealmList.h"
+#include "AuthWorkerPool.h"
 
 #include "Config/Config.h"
 #include "Log.h"
@@ -288,10 +289,17 @@ int main(int argc, char* argv[])
     // server has started up successfully => enable async DB requests
     LoginDatabase.AllowAsyncTransactions();
 
+    ///- Start the workers running blocking DB lookups and SRP6 math of the auth handshake
+    sAuthWorkerPool.Start(sConfig.GetIntDefault("AuthWorker.Threads", 2));
+
     // maximum counter for next ping
     auto const numLoops = sConfig.GetIntDefault("MaxPingTime", 30) * MINUTE * 10;
     uint32 loopCounter = 0;
 
+    // counter for next auth pipeline statistics dump
+    auto const statsLoops = sConfig.GetIntDefault("AuthWorker.StatsInterval", 0) * 10;
+    uint32 statsCounter = 0;
+
 #ifndef _WIN32
     detachDaemon();
 #endif
@@ -304,6 +312,11 @@ int main(int argc, char* argv[])
             DETAIL_LOG("Ping MySQL to keep connection alive");
             LoginDatabase.Ping();
         }
+        if (statsLoops > 0 && (++statsCounter) == uint32(statsLoops))
+        {
+            statsCounter = 0;
+            sAuthWorkerPool.LogStats();
+        }
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
 #ifdef _WIN32
         if (m_ServiceStatus == 0) stopEvent = true;
@@ -311,6 +324,9 @@ int main(int argc, char* argv[])
 #endif
     }
 
+    ///- Stop the auth workers before the listener and its network threads go away
+    sAuthWorkerPool.Stop();
+
     ///- Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
@@ -351,9 +367,12 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    // one connection per auth worker by default, so lookups of concurrent logins don't wait on each other
+    int nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", std::max(sConfig.GetIntDefault("AuthWorker.Threads", 2), 1));
+
+    sLog.outString("Login Database total connections: %i", nConnections + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
     {
         sLog.outError("Cannot connect to database");
         return false;
@@ -21,6 +21,9 @@
 
 #include "DBCFileLoader.h"
 
+#include <algorithm>
+#include <vector>
+
 template<class T>
 class DBCStorage
 {
@@ -100,4 +103,88 @@ class DBCStorage
         StringPoolList m_stringPoolList;
 };
 
+// Hot fields of a loaded store, copied at load time into one contiguous array of small values.
+// A lookup reads one value instead of the index table pointer and then the whole row.
+// Ids that are dense enough index the array directly. Sparse ids use a sorted id array and a binary search.
+// The rows of the store are not touched, so rebuild the projection when the store changes.
+template<class V>
+class DBCProjection
+{
+    public:
+        DBCProjection() : m_sparse(false) { }
+
+        template<class T, class Projector>
+        void Build(DBCStorage<T> const& storage, Projector projector)
+        {
+            Clear();
+
+            uint32 rows = 0;
+            for (uint32 id = 0; id < storage.GetNumRows(); ++id)
+                if (storage.LookupEntry(id))
+                    ++rows;
+
+            // index directly while that takes at most twice the memory of the sorted ids
+            m_sparse = storage.GetNumRows() * sizeof(Slot) > 2 * rows * (sizeof(Slot) + sizeof(uint32));
+            if (m_sparse)
+            {
+                m_ids.reserve(rows);
+                m_slots.reserve(rows);
+            }
+            else
+                m_slots.resize(storage.GetNumRows());
+
+            for (uint32 id = 0; id < storage.GetNumRows(); ++id)
+            {
+                T const* entry = storage.LookupEntry(id);
+                if (!entry)
+                    continue;
+
+                if (m_sparse)
+                {
+                    m_ids.push_back(id);
+                    m_slots.push_back({ projector(*entry), true });
+                }
+                else
+                    m_slots[id] = { projector(*entry), true };
+            }
+        }
+
+        V const* Lookup(uint32 id) const
+        {
+            if (!m_sparse)
+                return id < m_slots.size() && m_slots[id].present ? &m_slots[id].value : nullptr;
+
+            std::vector<uint32>::const_iterator itr = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+            return itr != m_ids.end() && *itr == id ? &m_slots[itr - m_ids.begin()].value : nullptr;
+        }
+
+        // value initialized V for ids not in the store
+        V Get(uint32 id) const
+        {
+            V const* value = Lookup(id);
+            return value ? *value : V();
+        }
+
+        void Clear()
+        {
+            m_slots.clear();
+            m_ids.clear();
+            m_sparse = false;
+        }
+
+        bool IsSparse() const { return m_sparse; }
+        size_t GetMemoryUsage() const { return m_slots.capacity() * sizeof(Slot) + m_ids.capacity() * sizeof(uint32); }
+
+    private:
+        struct Slot
+        {
+            V value;
+            bool present;
+        };
+
+        std::vector<Slot> m_slots;
+        std::vector<uint32> m_ids;                          // ids of the slots when sparse
+        bool m_sparse;
+};
+
 #endif
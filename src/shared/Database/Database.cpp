@@ -97,7 +97,7 @@ Database::~Database()
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nHolderConns /*= 0*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -111,6 +111,8 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
 
     m_pingIntervallms = sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000);
 
+    m_infoString = infoString;
+
     // create DB connections
 
     // setup connection pool size
@@ -139,6 +141,20 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     if (!m_pAsyncConn->Initialize(infoString))
         return false;
 
+    // create connections for parallel query holder execution
+    nHolderConns = std::min(nHolderConns, MAX_CONNECTION_POOL_SIZE);
+    for (int i = 0; i < nHolderConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pHolderConnections.push_back(pConn);
+    }
+
     m_pResultQueue = new SqlResultQueue;
 
     InitDelayThread();
@@ -159,6 +175,11 @@ void Database::StopServer()
         delete m_pQueryConnection;
 
     m_pQueryConnections.clear();
+
+    for (auto& m_pHolderConnection : m_pHolderConnections)
+        delete m_pHolderConnection;
+
+    m_pHolderConnections.clear();
 }
 
 SqlDelayThread* Database::CreateDelayThread()
@@ -174,6 +195,14 @@ void Database::InitDelayThread()
     // New delay thread for delay execute
     m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
     m_delayThread = new MaNGOS::Thread(m_threadBody);
+
+    // one thread per holder connection, pinged by the main delay thread
+    for (auto& pConn : m_pHolderConnections)
+    {
+        SqlDelayThread* threadBody = new SqlDelayThread(this, pConn, false);
+        m_holderThreadBodies.push_back(threadBody);
+        m_holderThreads.push_back(new MaNGOS::Thread(threadBody));
+    }
 }
 
 void Database::HaltDelayThread()
@@ -185,6 +214,17 @@ void Database::HaltDelayThread()
     delete m_delayThread;                                   // This also deletes m_threadBody
     m_delayThread = nullptr;
     m_threadBody = nullptr;
+
+    // holder threads last, the delay thread may still have handed them work while flushing
+    for (size_t i = 0; i < m_holderThreads.size(); ++i)
+    {
+        m_holderThreadBodies[i]->Stop();
+        m_holderThreads[i]->wait();
+        delete m_holderThreads[i];                          // This also deletes m_holderThreadBodies[i]
+    }
+
+    m_holderThreads.clear();
+    m_holderThreadBodies.clear();
 }
 
 void Database::ThreadStart()
@@ -213,8 +253,32 @@ void Database::escape_string(std::string& str)
     delete[] buf;
 }
 
+bool Database::OpenThreadConnection()
+{
+    if (m_threadConnection.get())
+        return true;
+
+    SqlConnection* pConn = CreateConnection();
+    if (!pConn->Initialize(m_infoString.c_str()))
+    {
+        delete pConn;
+        return false;
+    }
+
+    m_threadConnection.reset(pConn);
+    return true;
+}
+
+void Database::CloseThreadConnection()
+{
+    m_threadConnection.reset();
+}
+
 SqlConnection* Database::getQueryConnection()
 {
+    if (SqlConnection* pConn = m_threadConnection.get())
+        return pConn;
+
     int nCount = 0;
 
     if (m_nQueryCounter == long(1 << 31))
@@ -239,6 +303,12 @@ void Database::Ping()
         SqlConnection::Lock guard(m_pQueryConnections[i]);
         delete guard->Query(sql);
     }
+
+    for (auto& m_pHolderConnection : m_pHolderConnections)
+    {
+        SqlConnection::Lock guard(m_pHolderConnection);
+        delete guard->Query(sql);
+    }
 }
 
 bool Database::PExecuteLog(const char* format, ...)
@@ -104,12 +104,15 @@ class Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nHolderConns = 0);
         // start worker thread for async DB request execution
         virtual void InitDelayThread();
         // stop worker thread
         virtual void HaltDelayThread();
 
+        // amount of threads the queries of a query holder are split over, 0 when holders run on the async connection
+        size_t GetHolderThreadCount() const { return m_holderThreadBodies.size(); }
+
         /// Synchronous DB queries
         inline QueryResult* Query(const char* sql)
         {
@@ -206,6 +209,11 @@ class Database
         // must be called before finish thread run (one time for thread using one from existing Database objects)
         virtual void ThreadEnd();
 
+        // gives the calling thread a connection of its own for sync queries, so a long running loader
+        // does not hold the shared pool connections the world and map threads query through
+        bool OpenThreadConnection();
+        void CloseThreadConnection();
+
         // set database-wide result queue. also we should use object-bases and not thread-based result queues
         void ProcessResultQueue();
 
@@ -238,6 +246,8 @@ class Database
 
         // per-thread based storage for SqlTransaction object initialization - no locking is required
         boost::thread_specific_ptr<SqlTransaction> m_currentTransaction;
+        // per-thread connection opened by OpenThreadConnection, used instead of the pool
+        boost::thread_specific_ptr<SqlConnection> m_threadConnection;
 
         ///< DB connections
 
@@ -259,10 +269,16 @@ class Database
         // lets use pool of connections for sync queries
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
+        std::string m_infoString;                           // for connections opened after Initialize
 
         // only one single DB connection for transactions
         SqlConnection* m_pAsyncConn;
 
+        // connections and threads executing query holders in parallel, each thread owns one connection
+        SqlConnectionContainer m_pHolderConnections;
+        SqlDelayThreadContainer m_holderThreadBodies;
+        std::vector<MaNGOS::Thread*> m_holderThreads;
+
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
         SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
         MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
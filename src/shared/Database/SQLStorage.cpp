@@ -175,6 +175,13 @@ void SQLHashStorage::Free()
 {
     SQLStorageBase::Free();
     m_indexMap.clear();
+    m_loadingIndex.clear();
+}
+
+void SQLHashStorage::JustLoaded()
+{
+    m_indexMap.Assign(std::move(m_loadingIndex));
+    m_loadingIndex.clear();
 }
 
 void SQLHashStorage::prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize)
@@ -188,9 +195,7 @@ void SQLHashStorage::prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint3
 void SQLHashStorage::EraseEntry(uint32 id)
 {
     // do not erase from m_records
-    RecordMap::iterator find = m_indexMap.find(id);
-    if (find != m_indexMap.end())
-        find->second = nullptr;
+    m_indexMap.Erase(id);
 }
 
 SQLHashStorage::SQLHashStorage(const char* fmt, const char* _entry_field, const char* sqlname)
@@ -214,6 +219,13 @@ void SQLMultiStorage::Free()
 {
     SQLStorageBase::Free();
     m_indexMultiMap.clear();
+    m_loadingIndex.clear();
+}
+
+void SQLMultiStorage::JustLoaded()
+{
+    m_indexMultiMap.Assign(std::move(m_loadingIndex));
+    m_loadingIndex.clear();
 }
 
 void SQLMultiStorage::prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize)
@@ -226,7 +238,7 @@ void SQLMultiStorage::prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint
 
 void SQLMultiStorage::EraseEntry(uint32 id)
 {
-    m_indexMultiMap.erase(id);
+    m_indexMultiMap.Erase(id);
 }
 
 SQLMultiStorage::SQLMultiStorage(const char* fmt, const char* _entry_field, const char* sqlname)
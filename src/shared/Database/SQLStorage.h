@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "Database/DatabaseEnv.h"
 #include "DBCFileLoader.h"
+#include "Util/FlatLookupTable.h"
 
 class SQLStorageBase
 {
@@ -76,6 +77,7 @@ class SQLStorageBase
 
         virtual void prepareToLoad(uint32 maxEntry, uint32 recordCount, uint32 recordSize);
         virtual void JustCreatedRecord(uint32 recordId, char* record) = 0;
+        virtual void JustLoaded() {}                        // all records of the table are created
         virtual void Free();
 
     private:
@@ -162,14 +164,16 @@ class SQLHashStorage : public SQLStorageBase
         void prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize) override;
         void JustCreatedRecord(uint32 recordId, char* record) override
         {
-            m_indexMap[recordId] = record;
+            m_loadingIndex.push_back(RecordMap::value_type(recordId, record));
         }
+        void JustLoaded() override;
 
         void Free() override;
 
     private:
-        typedef std::unordered_map<uint32 /*recordId*/, char* /*record*/> RecordMap;
+        typedef FlatLookupTable<char* /*record*/> RecordMap;
         RecordMap m_indexMap;
+        RecordMap::Container m_loadingIndex;                // records of a running load, indexed by JustLoaded
 };
 
 class SQLMultiStorage : public SQLStorageBase
@@ -179,7 +183,7 @@ class SQLMultiStorage : public SQLStorageBase
         template<typename T> friend class SQLMSIteratorBounds;
 
     private:
-        typedef std::multimap<uint32 /*recordId*/, char* /*record*/> RecordMultiMap;
+        typedef FlatLookupTable<char* /*record*/> RecordMultiMap;
 
     public:
         SQLMultiStorage(const char* fmt, const char* _entry_field, const char* sqlname);
@@ -235,13 +239,15 @@ class SQLMultiStorage : public SQLStorageBase
         void prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize) override;
         void JustCreatedRecord(uint32 recordId, char* record) override
         {
-            m_indexMultiMap.insert(RecordMultiMap::value_type(recordId, record));
+            m_loadingIndex.push_back(RecordMultiMap::value_type(recordId, record));
         }
+        void JustLoaded() override;
 
         void Free() override;
 
     private:
         RecordMultiMap m_indexMultiMap;
+        RecordMultiMap::Container m_loadingIndex;           // records of a running load, indexed by JustLoaded
 };
 
 template <class DerivedLoader, class StorageClass>
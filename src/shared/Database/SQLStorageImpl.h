@@ -445,6 +445,8 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     while (result->NextRow());
 
     delete result;
+
+    store.JustLoaded();
 }
 
 #endif
@@ -20,7 +20,8 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase) :
+    m_dbEngine(db), m_dbConnection(conn), m_running(true), m_pingDatabase(pingDatabase)
 {
 }
 
@@ -36,22 +37,25 @@ void SqlDelayThread::run()
     mysql_thread_init();
 #endif
 
-    const uint32 loopSleepms = 10;
+    const std::chrono::milliseconds loopSleep(10);
+    const std::chrono::milliseconds pingInterval(m_dbEngine->GetPingIntervall());
 
-    const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
-
-    uint32 loopCounter = 0;
+    auto nextPing = std::chrono::steady_clock::now() + pingInterval;
     while (m_running)
     {
+        // sleep until something is queued, waking up regularly for pings
         // if the running state gets turned off while sleeping
         // empty the queue before exiting
-        MaNGOS::Thread::Sleep(loopSleepms);
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCond.wait_for(lock, loopSleep, [this] { return !m_sqlQueue.empty() || !m_running; });
+        }
 
         ProcessRequests();
 
-        if ((loopCounter++) >= pingEveryLoop)
+        if (m_pingDatabase && std::chrono::steady_clock::now() >= nextPing)
         {
-            loopCounter = 0;
+            nextPing = std::chrono::steady_clock::now() + pingInterval;
             m_dbEngine->Ping();
         }
     }
@@ -63,7 +67,11 @@ void SqlDelayThread::run()
 
 void SqlDelayThread::Stop()
 {
-    m_running = false;
+    {
+        std::lock_guard<std::mutex> guard(m_queueMutex);
+        m_running = false;
+    }
+    m_queueCond.notify_one();
 }
 
 void SqlDelayThread::ProcessRequests()
@@ -23,6 +23,7 @@
 #include "SqlOperations.h"
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -35,23 +36,28 @@ class SqlDelayThread : public MaNGOS::Runnable
 {
     private:
         std::mutex m_queueMutex;
+        std::condition_variable m_queueCond;                    ///< Wakes the thread up when a statement is queued
         std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
         Database* m_dbEngine;                                   ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
         std::atomic<bool> m_running;
+        bool m_pingDatabase;                                    ///< Keep the connections of m_dbEngine alive
 
         // process all enqueued requests
         void ProcessRequests();
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase = true);
         ~SqlDelayThread();
 
         ///< Put sql statement to delay queue
         bool Delay(SqlOperation* sql)
         {
-            std::lock_guard<std::mutex> guard(m_queueMutex);
-            m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            {
+                std::lock_guard<std::mutex> guard(m_queueMutex);
+                m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            }
+            m_queueCond.notify_one();
             return true;
         }
 
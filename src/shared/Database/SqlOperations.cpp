@@ -117,18 +117,25 @@ void SqlResultQueue::Add(MaNGOS::IQueryCallback* callback)
     m_queue.push(std::unique_ptr<MaNGOS::IQueryCallback>(callback));
 }
 
-bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
+bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue, SqlDelayThreadContainer const* workers)
 {
     if (!callback || !thread || !queue)
         return false;
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
-    SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
+    SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue, workers);
     thread->Delay(holderEx);
     return true;
 }
 
+void SqlQueryHolder::ExecuteQuery(SqlConnection* conn, size_t index)
+{
+    SqlHolderQuery& query = m_queries[index];
+    query.result = conn->Query(query.sql);
+    query.executed = true;
+}
+
 bool SqlQueryHolder::SetQuery(size_t index, const char* sql)
 {
     if (m_queries.size() <= index)
@@ -137,15 +144,17 @@ bool SqlQueryHolder::SetQuery(size_t index, const char* sql)
         return false;
     }
 
-    if (m_queries[index].first != nullptr)
+    if (m_queries[index].sql != nullptr)
     {
         sLog.outError("Attempt assign query to holder index (" SIZEFMTD ") where other query stored (Old: [%s] New: [%s])",
-                      index, m_queries[index].first, sql);
+                      index, m_queries[index].sql, sql);
         return false;
     }
 
     /// not executed yet, just stored (it's not called a holder for nothing)
-    m_queries[index] = SqlResultPair(mangos_strdup(sql), (QueryResult*)nullptr);
+    m_queries[index].sql = mangos_strdup(sql);
+    m_queries[index].result = nullptr;
+    m_queries[index].executed = false;
     return true;
 }
 
@@ -177,13 +186,13 @@ QueryResult* SqlQueryHolder::GetResult(size_t index)
     if (index < m_queries.size())
     {
         /// the query strings are freed on the first GetResult or in the destructor
-        if (m_queries[index].first != nullptr)
+        if (m_queries[index].sql != nullptr)
         {
-            delete[](const_cast<char*>(m_queries[index].first));
-            m_queries[index].first = nullptr;
+            delete[](const_cast<char*>(m_queries[index].sql));
+            m_queries[index].sql = nullptr;
         }
         /// when you get a result aways remember to delete it!
-        return m_queries[index].second;
+        return m_queries[index].result;
     }
     return nullptr;
 }
@@ -192,7 +201,18 @@ void SqlQueryHolder::SetResult(size_t index, QueryResult* result)
 {
     /// store the result in the holder
     if (index < m_queries.size())
-        m_queries[index].second = result;
+        m_queries[index].result = result;
+}
+
+void SqlQueryHolder::ResetResult(size_t index)
+{
+    /// results already taken (query string freed) are owned by the caller
+    if (index >= m_queries.size() || m_queries[index].sql == nullptr)
+        return;
+
+    delete m_queries[index].result;
+    m_queries[index].result = nullptr;
+    m_queries[index].executed = false;
 }
 
 SqlQueryHolder::~SqlQueryHolder()
@@ -201,10 +221,10 @@ SqlQueryHolder::~SqlQueryHolder()
     {
         /// if the result was never used, free the resources
         /// results used already (getresult called) are expected to be deleted
-        if (m_querie.first != nullptr)
+        if (m_querie.sql != nullptr)
         {
-            delete[](const_cast<char*>(m_querie.first));
-            delete m_querie.second;
+            delete[](const_cast<char*>(m_querie.sql));
+            delete m_querie.result;
         }
     }
 }
@@ -220,18 +240,60 @@ bool SqlQueryHolderEx::Execute(SqlConnection* conn)
     if (!m_holder || !m_callback || !m_queue)
         return false;
 
-    LOCK_DB_CONN(conn);
     /// we can do this, we are friends
-    std::vector<SqlQueryHolder::SqlResultPair>& queries = m_holder->m_queries;
+    std::vector<SqlQueryHolder::SqlHolderQuery>& queries = m_holder->m_queries;
+
+    /// queries already executed (kept from a previous execution of the holder) are skipped
+    std::vector<size_t> pending;
     for (size_t i = 0; i < queries.size(); ++i)
+        if (queries[i].sql && !queries[i].executed)
+            pending.push_back(i);
+
+    /// with holder threads available split the queries over them, we are executed by the async
+    /// connection so everything queued before the holder (character saves etc) is already committed
+    if (m_workers && !m_workers->empty() && pending.size() > 1)
     {
-        /// execute all queries in the holder and pass the results
-        char const* sql = queries[i].first;
-        if (sql) m_holder->SetResult(i, conn->Query(sql));
+        static std::atomic<size_t> nextWorker(0);
+
+        size_t const parts = std::min(pending.size(), m_workers->size());
+        size_t const first = nextWorker.fetch_add(parts);
+
+        std::shared_ptr<SqlQueryHolderBatch> batch = std::make_shared<SqlQueryHolderBatch>(parts, m_callback, m_queue);
+        std::vector<SqlQueryHolderPart*> holderParts(parts);
+        for (size_t i = 0; i < parts; ++i)
+            holderParts[i] = new SqlQueryHolderPart(m_holder, batch);
+
+        for (size_t i = 0; i < pending.size(); ++i)
+            holderParts[i % parts]->AddIndex(pending[i]);
+
+        for (size_t i = 0; i < parts; ++i)
+            (*m_workers)[(first + i) % m_workers->size()]->Delay(holderParts[i]);
+
+        return true;
     }
 
+    LOCK_DB_CONN(conn);
+    /// execute all queries in the holder and pass the results
+    for (size_t index : pending)
+        m_holder->ExecuteQuery(conn, index);
+
     /// sync with the caller thread
     m_queue->Add(m_callback);
 
     return true;
 }
+
+bool SqlQueryHolderPart::Execute(SqlConnection* conn)
+{
+    {
+        LOCK_DB_CONN(conn);
+        for (size_t index : m_indexes)
+            m_holder->ExecuteQuery(conn, index);
+    }
+
+    /// last part done, sync with the caller thread
+    if (--m_batch->pending == 0)
+        m_batch->queue->Add(m_batch->callback);
+
+    return true;
+}
@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "Utilities/Callback.h"
 
+#include <atomic>
 #include <queue>
 #include <vector>
 #include <mutex>
@@ -87,6 +88,9 @@ class SqlQuery;                                             /// contains a singl
 class QueryResult;                                          /// the result of one
 class SqlQueryHolder;                                       /// groups several async quries
 class SqlQueryHolderEx;                                     /// points to a holder, added to the delay thread
+class SqlQueryHolderPart;                                   /// part of a holder, executed by one of the holder threads
+
+typedef std::vector<SqlDelayThread*> SqlDelayThreadContainer;
 
 class SqlResultQueue
 {
@@ -119,9 +123,19 @@ class SqlQuery : public SqlOperation
 class SqlQueryHolder
 {
         friend class SqlQueryHolderEx;
+        friend class SqlQueryHolderPart;
     private:
-        typedef std::pair<const char*, QueryResult*> SqlResultPair;
-        std::vector<SqlResultPair> m_queries;
+        struct SqlHolderQuery
+        {
+            SqlHolderQuery() : sql(nullptr), result(nullptr), executed(false) {}
+
+            const char* sql;
+            QueryResult* result;
+            bool executed;
+        };
+        std::vector<SqlHolderQuery> m_queries;
+
+        void ExecuteQuery(SqlConnection* conn, size_t index);
     public:
         SqlQueryHolder() {}
         virtual ~SqlQueryHolder();
@@ -130,7 +144,10 @@ class SqlQueryHolder
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult* result);
-        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
+        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue, SqlDelayThreadContainer const* workers = nullptr);
+    protected:
+        // drop the result of a not yet taken query so the next Execute runs it again
+        void ResetResult(size_t index);
 };
 
 class SqlQueryHolderEx : public SqlOperation
@@ -139,9 +156,34 @@ class SqlQueryHolderEx : public SqlOperation
         SqlQueryHolder* m_holder;
         MaNGOS::IQueryCallback* m_callback;
         SqlResultQueue* m_queue;
+        SqlDelayThreadContainer const* m_workers;
+    public:
+        SqlQueryHolderEx(SqlQueryHolder* holder, MaNGOS::IQueryCallback* callback, SqlResultQueue* queue, SqlDelayThreadContainer const* workers)
+            : m_holder(holder), m_callback(callback), m_queue(queue), m_workers(workers) {}
+        bool Execute(SqlConnection* conn) override;
+};
+
+/// shared by all parts of a holder split over the holder threads, the last part to finish calls back
+struct SqlQueryHolderBatch
+{
+    SqlQueryHolderBatch(size_t parts, MaNGOS::IQueryCallback* callback, SqlResultQueue* queue)
+        : pending(parts), callback(callback), queue(queue) {}
+
+    std::atomic<size_t> pending;
+    MaNGOS::IQueryCallback* const callback;
+    SqlResultQueue* const queue;
+};
+
+class SqlQueryHolderPart : public SqlOperation
+{
+    private:
+        SqlQueryHolder* m_holder;
+        std::vector<size_t> m_indexes;
+        std::shared_ptr<SqlQueryHolderBatch> m_batch;
     public:
-        SqlQueryHolderEx(SqlQueryHolder* holder, MaNGOS::IQueryCallback* callback, SqlResultQueue* queue)
-            : m_holder(holder), m_callback(callback), m_queue(queue) {}
+        SqlQueryHolderPart(SqlQueryHolder* holder, std::shared_ptr<SqlQueryHolderBatch> batch)
+            : m_holder(holder), m_batch(std::move(batch)) {}
+        void AddIndex(size_t index) { m_indexes.push_back(index); }
         bool Execute(SqlConnection* conn) override;
 };
 #endif                                                      //__SQLOPERATIONS_H
@@ -23,11 +23,14 @@
 #include "Util/Util.h"
 #include "Util/ByteBuffer.h"
 #include "Util/ProgressBar.h"
+#include "Multithreading/RecordQueue.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <thread>
 #include <cstdarg>
+#include <cstring>
 
 #include <boost/stacktrace.hpp>
 
@@ -70,7 +73,9 @@ const int LogType_count = int(LogError) + 1;
 
 Log::Log() :
     raLogfile(nullptr), logfile(nullptr), gmLogfile(nullptr), charLogfile(nullptr), dberLogfile(nullptr),
-    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
+    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false),
+    m_scriptLibErrorPrefix("<Scripting Library ERROR>: "), m_async(false), m_asyncStop(false), m_asyncBufferSize(0), m_asyncFlushInterval(0), m_asyncFlushSize(0),
+    m_asyncReportedDrops(0), m_asyncFlushes(0)
 {
     Initialize();
 }
@@ -287,6 +292,9 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    if (sConfig.GetBoolDefault("LogAsync", false))
+        StartAsyncWriter();
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -317,30 +325,38 @@ FILE* Log::openGmlogPerAccount(uint32 account)
     return fopen(namebuf, "a");
 }
 
+namespace
+{
+    void WriteTimestamp(FILE* file, time_t t)
+    {
+        tm* aTm = localtime(&t);
+        //       YYYY   year
+        //       MM     month (2 digits 01-12)
+        //       DD     day (2 digits 01-31)
+        //       HH     hour (2 digits 00-23)
+        //       MM     minutes (2 digits 00-59)
+        //       SS     seconds (2 digits 00-59)
+        fprintf(file, "%-4d-%02d-%02d %02d:%02d:%02d ", aTm->tm_year + 1900, aTm->tm_mon + 1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+    }
+
+    void WriteTime(FILE* file, time_t t)
+    {
+        tm* aTm = localtime(&t);
+        //       HH     hour (2 digits 00-23)
+        //       MM     minutes (2 digits 00-59)
+        //       SS     seconds (2 digits 00-59)
+        fprintf(file, "%02d:%02d:%02d ", aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+    }
+}
+
 void Log::outTimestamp(FILE* file)
 {
-    time_t t = time(nullptr);
-    tm* aTm = localtime(&t);
-    //       YYYY   year
-    //       MM     month (2 digits 01-12)
-    //       DD     day (2 digits 01-31)
-    //       HH     hour (2 digits 00-23)
-    //       MM     minutes (2 digits 00-59)
-    //       SS     seconds (2 digits 00-59)
-    fprintf(file, "%-4d-%02d-%02d %02d:%02d:%02d ", aTm->tm_year + 1900, aTm->tm_mon + 1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+    WriteTimestamp(file, time(nullptr));
 }
 
 void Log::outTime() const
 {
-    time_t t = time(nullptr);
-    tm* aTm = localtime(&t);
-    //       YYYY   year
-    //       MM     month (2 digits 01-12)
-    //       DD     day (2 digits 01-31)
-    //       HH     hour (2 digits 00-23)
-    //       MM     minutes (2 digits 00-59)
-    //       SS     seconds (2 digits 00-59)
-    printf("%02d:%02d:%02d ", aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+    WriteTime(stdout, time(nullptr));
 }
 
 std::string Log::GetTimestampStr()
@@ -360,255 +376,393 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
-void Log::outString()
+// One formatted message and where it goes
+// Queued as is in front of its payload: the prefix (main log file only) followed by the text.
+struct LogRecord
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-    printf("\n");
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    fflush(stdout);
-}
+    LogRecord(FILE* console_, LogType color_, FILE* file_, FILE* extraFile_ = nullptr) :
+        length(0), prefixLength(0), time(0), console(console_), file(file_), extraFile(extraFile_), color(color_), timestamp(true) {}
+
+    uint32 length;                                          // payload bytes
+    uint32 prefixLength;                                    // leading payload bytes only written to the main log file
+    time_t time;
+    FILE* console;                                          // stdout, stderr or nullptr
+    FILE* file;                                             // main log file, gets prefix and text
+    FILE* extraFile;                                        // specific log file, gets the text only
+    LogType color;
+    bool timestamp;                                         // files get the time in front of the message
+};
 
-void Log::outString(const char* str, ...)
+// Queue of one logging thread, drained by whoever holds Log::m_worldLogMtx
+class LogRing : public RecordQueue<LogRecord>
 {
-    if (!str)
-        return;
+    public:
+        explicit LogRing(size_t capacity) : RecordQueue<LogRecord>(capacity) {}
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_colored)
-        SetColor(true, m_colors[LogNormal]);
-
-    if (m_includeTime)
-        outTime();
-
-    va_list ap;
-
-    va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
-    va_end(ap);
+        void AddStats(LogAsyncStats& stats) const
+        {
+            stats.queued += GetQueued();
+            stats.dropped += GetDropped();
+            stats.overflowed += GetOverflowed();
+        }
+};
 
-    if (m_colored)
-        ResetColor(true);
+namespace
+{
+    // queue of the current thread, created with its first asynchronous message
+    struct LogRingHolder
+    {
+        ~LogRingHolder()
+        {
+            if (ring)
+                ring->Retire();
+        }
 
-    printf("\n");
+        std::shared_ptr<LogRing> ring;
+    };
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
+    thread_local LogRingHolder threadLogRing;
+}
 
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
+void Log::StartAsyncWriter()
+{
+    m_asyncBufferSize = GetRecordQueueCapacity(size_t(std::max(0, sConfig.GetIntDefault("LogAsyncBufferSize", 256))) * 1024);
+    m_asyncFlushInterval = std::max(1, sConfig.GetIntDefault("LogAsyncFlushInterval", 100));
+    m_asyncFlushSize = size_t(std::max(0, sConfig.GetIntDefault("LogAsyncFlushSize", 64))) * 1024;
 
-        fflush(logfile);
-    }
+    if (m_asyncWriter.joinable())
+        return;
 
-    fflush(stdout);
+    m_asyncStop = false;
+    m_async = true;
+    m_asyncWriter = std::thread(&Log::AsyncWriterThread, this);
 }
 
-void Log::outError(const char* err, ...)
+void Log::StopAsyncWriter()
 {
-    if (!err)
+    if (!m_asyncWriter.joinable())
         return;
 
+    // late messages are written right away by their threads from now on, a thread that still queued one after
+    // the drain below sees m_async cleared and drains it itself (the fences pair with the one in Write)
+    m_async = false;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(m_asyncWakeupMtx);
+        m_asyncStop = true;
+    }
+    m_asyncWakeup.notify_one();
+    m_asyncWriter.join();
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    DrainQueues();
+    FlushFiles();
+}
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+void Log::AsyncWriterThread()
+{
+    auto lastFlush = std::chrono::steady_clock::now();
+    size_t unflushed = 0;
 
-    if (m_includeTime)
-        outTime();
+    while (!m_asyncStop)
+    {
+        {
+            // woken early by a thread whose queue runs full
+            std::unique_lock<std::mutex> lock(m_asyncWakeupMtx);
+            if (!m_asyncStop)
+                m_asyncWakeup.wait_for(lock, std::chrono::milliseconds(m_asyncFlushInterval));
+        }
 
-    va_list ap;
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
+        unflushed += DrainQueues();
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+        uint64 const dropped = CollectAsyncStats().dropped;
+        if (dropped != m_asyncReportedDrops)
+        {
+            char text[128];
+            LogRecord record(stderr, LogError, logfile);
+            record.time = time(nullptr);
+            record.length = snprintf(text, sizeof(text), "Log queue full, " UI64FMTD " messages dropped", dropped - m_asyncReportedDrops);
+            WriteRecord(record, text);
+            m_asyncReportedDrops = dropped;
+        }
 
-    if (m_colored)
-        ResetColor(false);
+        auto const now = std::chrono::steady_clock::now();
+        if (unflushed && (unflushed >= m_asyncFlushSize || now - lastFlush >= std::chrono::milliseconds(m_asyncFlushInterval)))
+        {
+            FlushFiles();
+            lastFlush = now;
+            unflushed = 0;
+        }
+    }
+}
 
-    fprintf(stderr, "\n");
-    if (logfile)
+size_t Log::DrainQueues()
+{
+    size_t written = 0;
+    LogRecord record(nullptr, LogNormal, nullptr);
+    for (auto itr = m_asyncQueues.begin(); itr != m_asyncQueues.end();)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
+        LogRing& ring = **itr;
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+        // checked before draining, a retired queue gets no more messages
+        bool const retired = ring.IsRetired();
+        while (ring.Pop(record, m_asyncPayload))
+        {
+            WriteRecord(record, m_asyncPayload.data());
+            written += record.length + 1;
+        }
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        if (retired)
+        {
+            ring.AddStats(m_asyncRetiredStats);
+            itr = m_asyncQueues.erase(itr);
+        }
+        else
+            ++itr;
     }
 
+    return written;
+}
+
+void Log::FlushFiles()
+{
+    for (FILE* file : { raLogfile, logfile, gmLogfile, charLogfile, dberLogfile, eventAiErLogfile, scriptErrLogFile, worldLogfile, customLogFile })
+        if (file)
+            fflush(file);
+
+    fflush(stdout);
     fflush(stderr);
+    ++m_asyncFlushes;
 }
 
-void Log::outErrorDb()
+void Log::Flush()
 {
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    DrainQueues();
+    FlushFiles();
+}
+
+LogAsyncStats Log::CollectAsyncStats() const
+{
+    LogAsyncStats stats = m_asyncRetiredStats;
+    for (auto const& ring : m_asyncQueues)
+        ring->AddStats(stats);
+
+    stats.flushes = m_asyncFlushes;
+    return stats;
+}
 
-    if (m_includeTime)
-        outTime();
+LogAsyncStats Log::GetAsyncStats()
+{
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    return CollectAsyncStats();
+}
 
-    fprintf(stderr, "\n");
+void Log::WriteRecord(LogRecord const& record, char const* payload)
+{
+    char const* text = payload + record.prefixLength;
+    int const textLength = int(record.length - record.prefixLength);
 
-    if (logfile)
+    if (record.console)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
+        bool const stdout_stream = record.console == stdout;
+        if (m_colored && textLength)
+            SetColor(stdout_stream, m_colors[record.color]);
+
+        if (m_includeTime)
+            WriteTime(record.console, record.time);
+
+        utf8printf(record.console, "%.*s", textLength, text);
+
+        if (m_colored && textLength)
+            ResetColor(stdout_stream);
+
+        fputc('\n', record.console);
     }
 
-    if (dberLogfile)
+    if (record.file)
     {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+        if (record.timestamp)
+            WriteTimestamp(record.file, record.time);
+
+        fwrite(payload, 1, record.length, record.file);
+        fputc('\n', record.file);
     }
 
-    fflush(stderr);
+    if (record.extraFile)
+    {
+        if (record.timestamp)
+            WriteTimestamp(record.extraFile, record.time);
+
+        fwrite(text, 1, textLength, record.extraFile);
+        fputc('\n', record.extraFile);
+    }
 }
 
-void Log::outErrorDb(const char* err, ...)
+void Log::Write(LogRecord& record, char const* payload, size_t length)
 {
-    if (!err)
+    if (!record.console && !record.file && !record.extraFile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
+    record.length = uint32(length);
+    record.time = time(nullptr);
 
-    va_list ap;
+    if (m_async.load(std::memory_order_relaxed))
+    {
+        if (!threadLogRing.ring)
+        {
+            threadLogRing.ring = std::make_shared<LogRing>(m_asyncBufferSize);
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+            std::lock_guard<std::mutex> guard(m_worldLogMtx);
+            m_asyncQueues.push_back(threadLogRing.ring);
+        }
 
-    if (m_colored)
-        ResetColor(false);
+        LogRing& ring = *threadLogRing.ring;
+        if (ring.Push(record, payload, record.length))
+        {
+            ring.CountQueued();
 
-    fprintf(stderr, "\n");
+            // StopAsyncWriter may have done its last drain before this push, then the message is written from here
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!m_async.load(std::memory_order_relaxed))
+            {
+                std::lock_guard<std::mutex> guard(m_worldLogMtx);
+                DrainQueues();
+                FlushFiles();
+                return;
+            }
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
+            if (ring.IsHalfFull())
+                m_asyncWakeup.notify_one();
+            return;
+        }
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+        // fits once the writer caught up, dropped rather than stalling the thread
+        if (!ring.IsOversized(length))
+        {
+            ring.CountDropped();
+            return;
+        }
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        // never fits, written right away after everything queued before it
+        ring.CountOverflowed();
     }
 
-    if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
-        va_end(ap);
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (m_async)
+        DrainQueues();
 
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
-    }
+    WriteRecord(record, payload);
 
-    fflush(stderr);
+    if (record.console)
+        fflush(record.console);
+    if (record.file)
+        fflush(record.file);
+    if (record.extraFile)
+        fflush(record.extraFile);
 }
 
-void Log::outErrorEventAI()
+void Log::Write(LogRecord& record, char const* prefix, char const* format, va_list ap)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    // formatted on the calling thread, everything after that is a copy
+    thread_local char buffer[4 * 1024];
 
-    if (m_includeTime)
-        outTime();
+    size_t const prefixLength = prefix ? std::min(strlen(prefix), sizeof(buffer) - 1) : 0;
+    if (prefixLength)
+        std::memcpy(buffer, prefix, prefixLength);
+    record.prefixLength = uint32(prefixLength);
 
-    fprintf(stderr, "\n");
+    va_list copy;
+    va_copy(copy, ap);
+    int const textLength = vsnprintf(buffer + prefixLength, sizeof(buffer) - prefixLength, format, copy);
+    va_end(copy);
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
-    }
+    if (textLength < 0)
+        return;
 
-    if (eventAiErLogfile)
+    if (prefixLength + textLength < sizeof(buffer))
     {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
+        Write(record, buffer, prefixLength + textLength);
+        return;
     }
 
-    fflush(stderr);
+    std::string payload(prefix ? prefix : "", prefixLength);
+    payload.resize(prefixLength + textLength + 1);
+    vsnprintf(&payload[prefixLength], textLength + 1, format, ap);
+    Write(record, payload.data(), prefixLength + textLength);
 }
 
-void Log::outErrorEventAI(const char* err, ...)
+void Log::outString()
 {
-    if (!err)
-        return;
+    LogRecord record(stdout, LogNormal, logfile);
+    Write(record, "", 0);
+}
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+void Log::outString(const char* str, ...)
+{
+    if (!str)
+        return;
 
-    if (m_includeTime)
-        outTime();
+    LogRecord record(stdout, LogNormal, logfile);
 
     va_list ap;
+    va_start(ap, str);
+    Write(record, nullptr, str, ap);
+    va_end(ap);
+}
+
+void Log::outError(const char* err, ...)
+{
+    if (!err)
+        return;
+
+    LogRecord record(stderr, LogError, logfile);
 
+    va_list ap;
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    Write(record, "ERROR:", err, ap);
     va_end(ap);
+}
 
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
+void Log::outErrorDb()
+{
+    LogRecord record(stderr, LogError, logfile, dberLogfile);
+    record.prefixLength = 6;
+    Write(record, "ERROR:", 6);
+}
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
+void Log::outErrorDb(const char* err, ...)
+{
+    if (!err)
+        return;
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+    LogRecord record(stderr, LogError, logfile, dberLogfile);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    va_list ap;
+    va_start(ap, err);
+    Write(record, "ERROR:", err, ap);
+    va_end(ap);
+}
 
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
+void Log::outErrorEventAI()
+{
+    LogRecord record(stderr, LogError, logfile, eventAiErLogfile);
+    record.prefixLength = 21;
+    Write(record, "ERROR CreatureEventAI", 21);
+}
 
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
-        va_end(ap);
+void Log::outErrorEventAI(const char* err, ...)
+{
+    if (!err)
+        return;
 
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
+    LogRecord record(stderr, LogError, logfile, eventAiErLogfile);
 
-    fflush(stderr);
+    va_list ap;
+    va_start(ap, err);
+    Write(record, "ERROR CreatureEventAI: ", err, ap);
+    va_end(ap);
 }
 
 void Log::outBasic(const char* str, ...)
@@ -616,38 +770,13 @@ void Log::outBasic(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_BASIC)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
-    {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
+    LogRecord record(m_logLevel >= LOG_LVL_BASIC ? stdout : nullptr, LogDetails,
+                     m_logFileLevel >= LOG_LVL_BASIC ? logfile : nullptr);
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(record, nullptr, str, ap);
+    va_end(ap);
 }
 
 void Log::outDetail(const char* str, ...)
@@ -655,40 +784,13 @@ void Log::outDetail(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        outTimestamp(logfile);
-
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
+    LogRecord record(m_logLevel >= LOG_LVL_DETAIL ? stdout : nullptr, LogDetails,
+                     m_logFileLevel >= LOG_LVL_DETAIL ? logfile : nullptr);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(record, nullptr, str, ap);
+    va_end(ap);
 }
 
 void Log::outDebug(const char* str, ...)
@@ -696,40 +798,13 @@ void Log::outDebug(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DEBUG)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDebug]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
-    {
-        outTimestamp(logfile);
-
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    LogRecord record(m_logLevel >= LOG_LVL_DEBUG ? stdout : nullptr, LogDebug,
+                     m_logFileLevel >= LOG_LVL_DEBUG ? logfile : nullptr);
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(record, nullptr, str, ap);
+    va_end(ap);
 }
 
 void Log::outCommand(uint32 account, const char* str, ...)
@@ -737,42 +812,20 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    LogRecord record(m_logLevel >= LOG_LVL_DETAIL ? stdout : nullptr, LogDetails,
+                     m_logFileLevel >= LOG_LVL_DETAIL ? logfile : nullptr, m_gmlog_per_account ? nullptr : gmLogfile);
 
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    Write(record, nullptr, str, ap);
+    va_end(ap);
 
+    // per account files are opened for every command, rare enough to stay synchronous
     if (m_gmlog_per_account)
     {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
         if (FILE* per_file = openGmlogPerAccount(account))
         {
-            va_list ap;
             outTimestamp(per_file);
             va_start(ap, str);
             vfprintf(per_file, str, ap);
@@ -781,18 +834,6 @@ void Log::outCommand(uint32 account, const char* str, ...)
             fclose(per_file);
         }
     }
-    else if (gmLogfile)
-    {
-        va_list ap;
-        outTimestamp(gmLogfile);
-        va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
-        va_end(ap);
-        fflush(gmLogfile);
-    }
-
-    fflush(stdout);
 }
 
 void Log::outChar(const char* str, ...)
@@ -800,45 +841,19 @@ void Log::outChar(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (charLogfile)
-    {
-        va_list ap;
-        outTimestamp(charLogfile);
-        va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
-        va_end(ap);
-        fflush(charLogfile);
-    }
+    LogRecord record(nullptr, LogNormal, charLogfile);
+
+    va_list ap;
+    va_start(ap, str);
+    Write(record, nullptr, str, ap);
+    va_end(ap);
 }
 
 void Log::outErrorScriptLib()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        fflush(logfile);
-    }
-
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
-
-    fflush(stderr);
+    LogRecord record(stderr, LogError, logfile, scriptErrLogFile);
+    record.prefixLength = uint32(m_scriptLibErrorPrefix.size());
+    Write(record, m_scriptLibErrorPrefix.c_str(), m_scriptLibErrorPrefix.size());
 }
 
 void Log::outErrorScriptLib(const char* err, ...)
@@ -846,54 +861,12 @@ void Log::outErrorScriptLib(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
+    LogRecord record(stderr, LogError, logfile, scriptErrLogFile);
 
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    Write(record, m_scriptLibErrorPrefix.c_str(), err, ap);
     va_end(ap);
-
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
-        va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
-
-    fflush(stderr);
 }
 
 void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opcodeName, ByteBuffer const& packet, bool incoming)
@@ -901,36 +874,45 @@ void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opco
     if (!worldLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    outTimestamp(worldLogfile);
+    std::string dump;
+    dump.reserve(128 + packet.size() * 3 + packet.size() / 16);
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
-            incoming ? "CLIENT" : "SERVER",
-            socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
+    char buf[256];
+    snprintf(buf, sizeof(buf), "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
+             incoming ? "CLIENT" : "SERVER",
+             socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
+    dump.append(buf);
 
     size_t p = 0;
     while (p < packet.size())
     {
         for (size_t j = 0; j < 16 && p < packet.size(); ++j)
-            fprintf(worldLogfile, "%.2X ", packet[p++]);
+        {
+            snprintf(buf, sizeof(buf), "%.2X ", packet[p++]);
+            dump.append(buf);
+        }
 
-        fprintf(worldLogfile, "\n");
+        dump.append("\n");
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    dump.append("\n");
+
+    LogRecord record(nullptr, LogNormal, worldLogfile);
+    Write(record, dump.data(), dump.size());
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (!charLogfile)
+        return;
 
-    if (charLogfile)
-    {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
-    }
+    LogRecord record(nullptr, LogNormal, charLogfile);
+    record.timestamp = false;
+
+    std::string dump = "== START DUMP == (account: " + std::to_string(account_id) + " guid: " + std::to_string(guid) + " name: " + name + " )\n";
+    dump.append(str);
+    dump.append("\n== END DUMP ==");
+    Write(record, dump.data(), dump.size());
 }
 
 void Log::outRALog(const char* str, ...)
@@ -938,19 +920,12 @@ void Log::outRALog(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (raLogfile)
-    {
-        va_list ap;
-        outTimestamp(raLogfile);
-        va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
-        va_end(ap);
-        fflush(raLogfile);
-    }
+    LogRecord record(nullptr, LogNormal, raLogfile);
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(record, nullptr, str, ap);
+    va_end(ap);
 }
 
 void Log::outCustomLog(const char* str, ...)
@@ -958,23 +933,19 @@ void Log::outCustomLog(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (customLogFile)
-    {
-        va_list ap;
-        outTimestamp(customLogFile);
-        va_start(ap, str);
-        vfprintf(customLogFile, str, ap);
-        fprintf(customLogFile, "\n");
-        va_end(ap);
-        fflush(customLogFile);
-    }
+    LogRecord record(nullptr, LogNormal, customLogFile);
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(record, nullptr, str, ap);
+    va_end(ap);
 }
 
 void Log::WaitBeforeContinueIfNeed()
 {
+    // the reason for waiting has to be on screen first
+    sLog.Flush();
+
     int mode = sConfig.GetIntDefault("WaitAtStartupError", 0);
 
     if (mode < 0)
@@ -998,7 +969,11 @@ void Log::WaitBeforeContinueIfNeed()
 
 void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
 {
-    m_scriptLibName = libName;
+    // queued messages may still refer to the old file
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    DrainQueues();
+
+    m_scriptLibErrorPrefix = libName ? std::string("<") + libName + " ERROR>: " : "<Scripting Library ERROR>: ";
 
     if (scriptErrLogFile)
         fclose(scriptErrLogFile);
@@ -1111,6 +1086,7 @@ void script_error_log(const char* str, ...)
 void Log::traceLog()
 {
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    DrainQueues();
     if (customLogFile)
     {
         fprintf(customLogFile, "%s\n", GetTraceLog().data());
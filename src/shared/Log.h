@@ -22,10 +22,18 @@
 #include "Common.h"
 #include "Policies/Singleton.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 class Config;
 class ByteBuffer;
+class LogRing;
+struct LogRecord;
 
 enum LogLevel
 {
@@ -93,6 +101,16 @@ enum Color
 
 const int Color_count = int(WHITE) + 1;
 
+struct LogAsyncStats
+{
+    LogAsyncStats() : queued(0), dropped(0), overflowed(0), flushes(0) {}
+
+    uint64 queued;                                          // messages handed to the writer thread
+    uint64 dropped;                                         // messages lost, the queue of their thread was full
+    uint64 overflowed;                                      // messages larger than a queue, written by their thread
+    uint64 flushes;
+};
+
 class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::mutex> >
 {
         friend class MaNGOS::OperatorNew<Log>;
@@ -100,6 +118,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
 
         ~Log()
         {
+            StopAsyncWriter();
+
             if (logfile != nullptr)
                 fclose(logfile);
             logfile = nullptr;
@@ -194,10 +214,29 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
 
         void traceLog();
 
+        // LogAsync mode: messages are formatted by the calling thread into its own queue and written by a writer thread
+        bool IsAsync() const { return m_async; }
+        // writes out everything queued so far, from any thread
+        void Flush();
+        LogAsyncStats GetAsyncStats();
+
     private:
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
+        // format, then queue or write right away
+        void Write(LogRecord& record, char const* prefix, char const* format, va_list ap);
+        void Write(LogRecord& record, char const* payload, size_t length);
+        // m_worldLogMtx has to be held for these
+        void WriteRecord(LogRecord const& record, char const* payload);
+        size_t DrainQueues();
+        void FlushFiles();
+        LogAsyncStats CollectAsyncStats() const;
+
+        void StartAsyncWriter();
+        void StopAsyncWriter();
+        void AsyncWriterThread();
+
         FILE* raLogfile;
         FILE* logfile;
         FILE* gmLogfile;
@@ -230,7 +269,22 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         bool m_gmlog_per_account;
         std::string m_gmlog_filename_format;
 
-        char const* m_scriptLibName;
+        std::string m_scriptLibErrorPrefix;
+
+        // asynchronous writer, queues and counters are guarded by m_worldLogMtx
+        std::atomic<bool> m_async;
+        std::atomic<bool> m_asyncStop;
+        size_t m_asyncBufferSize;                           // bytes per thread queue
+        uint32 m_asyncFlushInterval;                        // ms
+        size_t m_asyncFlushSize;                            // bytes
+        std::vector<std::shared_ptr<LogRing>> m_asyncQueues;
+        std::vector<char> m_asyncPayload;
+        LogAsyncStats m_asyncRetiredStats;                  // of queues whose thread exited
+        uint64 m_asyncReportedDrops;
+        uint64 m_asyncFlushes;
+        std::mutex m_asyncWakeupMtx;
+        std::condition_variable m_asyncWakeup;
+        std::thread m_asyncWriter;
 };
 
 #define sLog MaNGOS::Singleton<Log>::Instance()
@@ -0,0 +1,360 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+#include "Config/Config.h"
+#include "Log.h"
+#include "Metric.h"
+#include "Registry.h"
+#include "Util/Errors.h"
+
+namespace
+{
+    std::atomic<uint32> s_allocatedSlots(0);
+
+    // shards of running threads and the sums of the ended ones
+    std::mutex s_shardsLock;
+    std::vector<metric::thread_shard*> s_shards;
+    std::vector<int64> s_retired;
+
+    uint32 allocate_slots(uint32 count)
+    {
+        uint32 slot = s_allocatedSlots.fetch_add(count);
+        MANGOS_ASSERT(slot + count <= METRIC_SHARD_CHUNKS * METRIC_SHARD_CHUNK_SLOTS);
+        return slot;
+    }
+
+    // all time value of a slot, s_shardsLock must be held
+    int64 slot_total(uint32 slot)
+    {
+        int64 total = slot < s_retired.size() ? s_retired[slot] : 0;
+        for (metric::thread_shard const* shard : s_shards)
+            if (std::atomic<int64> const* chunk = shard->chunks[slot / METRIC_SHARD_CHUNK_SLOTS].load(std::memory_order_acquire))
+                total += chunk[slot % METRIC_SHARD_CHUNK_SLOTS].load(std::memory_order_relaxed);
+        return total;
+    }
+
+    std::string prometheus_name(std::string const& name)
+    {
+        std::string result = name;
+        for (char& c : result)
+            if (!isalnum(uint8(c)) && c != '_')
+                c = '_';
+        return result;
+    }
+
+    std::string prometheus_labels(metric::tag_list const& tags, char const* extraKey = nullptr, char const* extraValue = nullptr)
+    {
+        std::string labels;
+        for (auto const& tag : tags)
+            labels += (labels.empty() ? "" : ",") + prometheus_name(tag.first) + "=\"" + tag.second + "\"";
+        if (extraKey)
+            labels += (labels.empty() ? "" : ",") + std::string(extraKey) + "=\"" + extraValue + "\"";
+        return labels.empty() ? labels : "{" + labels + "}";
+    }
+}
+
+metric::thread_shard::thread_shard()
+{
+    for (auto& chunk : chunks)
+        chunk.store(nullptr, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(s_shardsLock);
+    s_shards.push_back(this);
+}
+
+metric::thread_shard::~thread_shard()
+{
+    std::lock_guard<std::mutex> guard(s_shardsLock);
+    s_shards.erase(std::remove(s_shards.begin(), s_shards.end(), this), s_shards.end());
+
+    // values of an ended thread stay in the totals
+    for (uint32 i = 0; i < METRIC_SHARD_CHUNKS; ++i)
+    {
+        std::atomic<int64>* chunk = chunks[i].load(std::memory_order_relaxed);
+        if (!chunk)
+            continue;
+
+        if (s_retired.size() < (i + 1) * METRIC_SHARD_CHUNK_SLOTS)
+            s_retired.resize((i + 1) * METRIC_SHARD_CHUNK_SLOTS, 0);
+        for (uint32 j = 0; j < METRIC_SHARD_CHUNK_SLOTS; ++j)
+            s_retired[i * METRIC_SHARD_CHUNK_SLOTS + j] += chunk[j].load(std::memory_order_relaxed);
+
+        delete[] chunk;
+    }
+}
+
+std::atomic<int64>* metric::thread_shard::add_chunk(uint32 chunk)
+{
+    std::atomic<int64>* slots = new std::atomic<int64>[METRIC_SHARD_CHUNK_SLOTS];
+    for (uint32 i = 0; i < METRIC_SHARD_CHUNK_SLOTS; ++i)
+        slots[i].store(0, std::memory_order_relaxed);
+
+    chunks[chunk].store(slots, std::memory_order_release);
+    return slots;
+}
+
+uint64 metric::histogram::bucket_value(uint32 index)
+{
+    if (index < METRIC_HISTOGRAM_SUB_BUCKETS)
+        return index;
+
+    uint32 const exponent = (index - METRIC_HISTOGRAM_SUB_BUCKETS) / METRIC_HISTOGRAM_SUB_BUCKETS + 3;
+    uint64 const mantissa = (index - METRIC_HISTOGRAM_SUB_BUCKETS) % METRIC_HISTOGRAM_SUB_BUCKETS + METRIC_HISTOGRAM_SUB_BUCKETS;
+    return ((mantissa + 1) << (exponent - 3)) - 1;
+}
+
+metric::registry::registry()
+{
+    reload_config();
+}
+
+metric::registry& metric::registry::instance()
+{
+    static registry instance;
+    return instance;
+}
+
+void metric::registry::reload_config()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_textFile = sConfig.GetStringDefault("Metric.TextFile", "");
+}
+
+metric::registry::entry& metric::registry::find_or_add(std::string const& name, tag_list const& tags, metric_type type)
+{
+    std::string key = name;
+    for (auto const& tag : tags)
+        key += "," + tag.first + "=" + tag.second;
+
+    auto itr = m_index.find(key);
+    if (itr != m_index.end())
+    {
+        MANGOS_ASSERT(m_entries[itr->second].type == type);
+        return m_entries[itr->second];
+    }
+
+    m_index[key] = m_entries.size();
+    m_entries.emplace_back();
+
+    entry& item = m_entries.back();
+    item.name = name;
+    item.tags = tags;
+    item.type = type;
+    item.current = snapshot();
+    item.current.name = name;
+    item.current.tags = tags;
+    item.current.type = type;
+    return item;
+}
+
+metric::counter& metric::registry::get_counter(std::string const& name, tag_list const& tags)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    entry& item = find_or_add(name, tags, metric_type::counter);
+    if (!item.counter_metric)
+    {
+        item.counter_metric.reset(new counter(allocate_slots(1)));
+        item.last.resize(1, 0);
+    }
+    return *item.counter_metric;
+}
+
+metric::gauge& metric::registry::get_gauge(std::string const& name, tag_list const& tags)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    entry& item = find_or_add(name, tags, metric_type::gauge);
+    if (!item.gauge_metric)
+        item.gauge_metric.reset(new gauge());
+    return *item.gauge_metric;
+}
+
+metric::histogram& metric::registry::get_histogram(std::string const& name, tag_list const& tags)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    entry& item = find_or_add(name, tags, metric_type::histogram);
+    if (!item.histogram_metric)
+    {
+        item.histogram_metric.reset(new histogram(allocate_slots(METRIC_HISTOGRAM_BUCKETS + 1)));
+        item.last.resize(METRIC_HISTOGRAM_BUCKETS + 1, 0);
+    }
+    return *item.histogram_metric;
+}
+
+void metric::registry::aggregate()
+{
+    std::string textFile;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::lock_guard<std::mutex> shardsGuard(s_shardsLock);
+
+        std::vector<int64> buckets(METRIC_HISTOGRAM_BUCKETS);
+        for (entry& item : m_entries)
+        {
+            snapshot& current = item.current;
+            switch (item.type)
+            {
+                case metric_type::counter:
+                {
+                    int64 total = slot_total(item.counter_metric->m_slot);
+                    current.interval = total - item.last[0];
+                    current.total = total;
+                    item.last[0] = total;
+                    break;
+                }
+                case metric_type::gauge:
+                    current.value = item.gauge_metric->m_value.load(std::memory_order_relaxed);
+                    break;
+                case metric_type::histogram:
+                {
+                    uint32 const slot = item.histogram_metric->m_slot;
+                    int64 samples = 0;
+                    for (uint32 i = 0; i < METRIC_HISTOGRAM_BUCKETS; ++i)
+                    {
+                        int64 total = slot_total(slot + i);
+                        buckets[i] = total - item.last[i];
+                        item.last[i] = total;
+                        samples += buckets[i];
+                    }
+
+                    int64 sum = slot_total(slot + METRIC_HISTOGRAM_BUCKETS);
+                    current.interval_sum = sum - item.last[METRIC_HISTOGRAM_BUCKETS];
+                    item.last[METRIC_HISTOGRAM_BUCKETS] = sum;
+                    current.sum = sum;
+                    current.total += samples;
+                    current.interval = samples;
+
+                    // percentiles of the interval, as the highest value of the bucket they fall into
+                    uint64* const targets[] = { &current.p50, &current.p90, &current.p99, &current.max };
+                    double const quantiles[] = { 0.5, 0.9, 0.99, 1.0 };
+                    int64 seen = 0;
+                    uint32 next = 0;
+                    for (uint32 i = 0; i < METRIC_HISTOGRAM_BUCKETS && next < 4; ++i)
+                    {
+                        seen += buckets[i];
+                        while (next < 4 && buckets[i] && seen >= std::max<int64>(1, int64(std::ceil(quantiles[next] * samples))))
+                            *targets[next++] = histogram::bucket_value(i);
+                    }
+                    for (; next < 4; ++next)
+                        *targets[next] = 0;
+                    break;
+                }
+            }
+        }
+
+        textFile = m_textFile;
+    }
+
+    // the InfluxDB writer does nothing unless Metric.Enable is set
+    for (snapshot const& current : get_snapshots())
+    {
+        std::map<std::string, std::string> tags(current.tags.begin(), current.tags.end());
+        std::map<std::string, boost::any> fields;
+        switch (current.type)
+        {
+            case metric_type::counter:
+                fields["count"] = current.interval;
+                break;
+            case metric_type::gauge:
+                fields["value"] = current.value;
+                break;
+            case metric_type::histogram:
+                fields["count"] = current.interval;
+                fields["sum"] = current.interval_sum;
+                fields["p50"] = int64(current.p50);
+                fields["p90"] = int64(current.p90);
+                fields["p99"] = int64(current.p99);
+                fields["max"] = int64(current.max);
+                break;
+        }
+        metric::instance().report(current.name, fields, tags);
+    }
+
+    if (textFile.empty())
+        return;
+
+    // written aside and renamed, a reader never sees half a file
+    std::string const temporary = textFile + ".tmp";
+    if (FILE* file = fopen(temporary.c_str(), "w"))
+    {
+        std::string const text = format_text();
+        fwrite(text.data(), 1, text.size(), file);
+        fclose(file);
+        if (std::rename(temporary.c_str(), textFile.c_str()) != 0)
+            sLog.outError("metric::registry::aggregate can not replace %s", textFile.c_str());
+    }
+    else
+        sLog.outError("metric::registry::aggregate can not write %s", temporary.c_str());
+}
+
+std::vector<metric::snapshot> metric::registry::get_snapshots() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    std::vector<snapshot> snapshots;
+    snapshots.reserve(m_entries.size());
+    for (entry const& item : m_entries)
+        snapshots.push_back(item.current);
+    return snapshots;
+}
+
+std::string metric::registry::format_text() const
+{
+    std::vector<snapshot> snapshots = get_snapshots();
+    std::stable_sort(snapshots.begin(), snapshots.end(), [](snapshot const& left, snapshot const& right)
+    {
+        return left.name < right.name;
+    });
+
+    std::ostringstream text;
+    std::string lastName;
+    for (snapshot const& current : snapshots)
+    {
+        std::string const name = prometheus_name(current.name);
+        bool const first = current.name != lastName;
+        lastName = current.name;
+
+        switch (current.type)
+        {
+            case metric_type::counter:
+                if (first)
+                    text << "# TYPE " << name << "_total counter\n";
+                text << name << "_total" << prometheus_labels(current.tags) << " " << current.total << "\n";
+                break;
+            case metric_type::gauge:
+                if (first)
+                    text << "# TYPE " << name << " gauge\n";
+                text << name << prometheus_labels(current.tags) << " " << current.value << "\n";
+                break;
+            case metric_type::histogram:
+                if (first)
+                    text << "# TYPE " << name << " summary\n";
+                text << name << prometheus_labels(current.tags, "quantile", "0.5") << " " << current.p50 << "\n";
+                text << name << prometheus_labels(current.tags, "quantile", "0.9") << " " << current.p90 << "\n";
+                text << name << prometheus_labels(current.tags, "quantile", "0.99") << " " << current.p99 << "\n";
+                text << name << prometheus_labels(current.tags, "quantile", "1") << " " << current.max << "\n";
+                text << name << "_sum" << prometheus_labels(current.tags) << " " << current.sum << "\n";
+                text << name << "_count" << prometheus_labels(current.tags) << " " << current.total << "\n";
+                break;
+        }
+    }
+    return text.str();
+}
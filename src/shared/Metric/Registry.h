@@ -0,0 +1,251 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_METRIC_REGISTRY_H
+#define MANGOSSERVER_METRIC_REGISTRY_H
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common.h"
+
+// slots of a histogram: log-linear buckets like HdrHistogram, 8 per power of two (12.5% precision) up to 2^40
+#define METRIC_HISTOGRAM_SUB_BUCKETS    8
+#define METRIC_HISTOGRAM_BUCKETS        (METRIC_HISTOGRAM_SUB_BUCKETS + 37 * METRIC_HISTOGRAM_SUB_BUCKETS)
+
+#define METRIC_SHARD_CHUNK_SLOTS        1024
+#define METRIC_SHARD_CHUNKS             256
+
+// Pre-registered counters, gauges and latency histograms, cheap enough to stay in hot paths
+//
+// A metric is registered once with its name and tags (usually into a static or a member) and updated through the
+// returned reference. Updates go to a shard of the updating thread: plain loads and stores of slots nobody else
+// writes, no lock, no allocation and no string. aggregate(), called once a second by the world, sums the shards and
+// keeps the values of the last interval for the exporters: the InfluxDB writer of metric::metric, a text file in
+// Prometheus format (Metric.TextFile) and .server metrics.
+namespace metric
+{
+    typedef std::vector<std::pair<std::string, std::string>> tag_list;
+
+    // slot storage of one thread, chunks are allocated by the owning thread when first used
+    // only the owner writes its slots, readers may see a slightly older value
+    struct thread_shard
+    {
+        thread_shard();
+        ~thread_shard();
+
+        std::atomic<int64>& slot(uint32 index)
+        {
+            std::atomic<int64>* chunk = chunks[index / METRIC_SHARD_CHUNK_SLOTS].load(std::memory_order_relaxed);
+            if (!chunk)
+                chunk = add_chunk(index / METRIC_SHARD_CHUNK_SLOTS);
+            return chunk[index % METRIC_SHARD_CHUNK_SLOTS];
+        }
+
+        void add(uint32 index, int64 value)
+        {
+            std::atomic<int64>& target = slot(index);
+            target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        std::atomic<int64>* add_chunk(uint32 chunk);
+
+        std::atomic<std::atomic<int64>*> chunks[METRIC_SHARD_CHUNKS];
+    };
+
+    inline thread_shard& local_shard()
+    {
+        static thread_local thread_shard shard;
+        return shard;
+    }
+
+    class counter
+    {
+        public:
+            explicit counter(uint32 slot) : m_slot(slot) {}
+
+            void add(int64 value = 1) { local_shard().add(m_slot, value); }
+
+        private:
+            friend class registry;
+            uint32 m_slot;
+    };
+
+    // last value set by any thread
+    class gauge
+    {
+        public:
+            gauge() : m_value(0) {}
+
+            void set(int64 value) { m_value.store(value, std::memory_order_relaxed); }
+
+        private:
+            friend class registry;
+            std::atomic<int64> m_value;
+    };
+
+    class histogram
+    {
+        public:
+            explicit histogram(uint32 slot) : m_slot(slot) {}
+
+            void record(uint64 value)
+            {
+                thread_shard& shard = local_shard();
+                shard.add(m_slot + bucket_index(value), 1);
+                shard.add(m_slot + METRIC_HISTOGRAM_BUCKETS, int64(value));
+            }
+
+            static uint32 bucket_index(uint64 value)
+            {
+                if (value < METRIC_HISTOGRAM_SUB_BUCKETS)
+                    return uint32(value);
+
+                uint32 exponent = highest_bit(value);
+                if (exponent > 39)
+                    return METRIC_HISTOGRAM_BUCKETS - 1;
+
+                return METRIC_HISTOGRAM_SUB_BUCKETS + (exponent - 3) * METRIC_HISTOGRAM_SUB_BUCKETS + uint32((value >> (exponent - 3)) & (METRIC_HISTOGRAM_SUB_BUCKETS - 1));
+            }
+
+            // highest value counted in the bucket
+            static uint64 bucket_value(uint32 index);
+
+        private:
+            friend class registry;
+
+            static uint32 highest_bit(uint64 value)
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                return 63 - uint32(__builtin_clzll(value));
+#else
+                uint32 bit = 0;
+                while (value >>= 1)
+                    ++bit;
+                return bit;
+#endif
+            }
+
+            uint32 m_slot;                                  // buckets followed by the sum
+    };
+
+    // records the lifetime of the scope in microseconds
+    class scoped_timer
+    {
+        public:
+            explicit scoped_timer(histogram& target) : m_target(target), m_start(std::chrono::steady_clock::now()) {}
+            ~scoped_timer()
+            {
+                m_target.record(uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count()));
+            }
+
+        private:
+            histogram& m_target;
+            std::chrono::steady_clock::time_point m_start;
+    };
+
+    enum class metric_type
+    {
+        counter,
+        gauge,
+        histogram
+    };
+
+    // value of a metric after aggregate(), interval values cover the last aggregation interval
+    struct snapshot
+    {
+        std::string name;
+        tag_list tags;
+        metric_type type;
+
+        int64 total;                                        // counter, samples of a histogram
+        int64 interval;
+        int64 value;                                        // gauge
+
+        int64 sum;                                          // histogram, all time
+        int64 interval_sum;
+        uint64 p50, p90, p99, max;                          // histogram, last interval
+    };
+
+    class registry
+    {
+        public:
+            static registry& instance();
+
+            // the same name and tags always give the same metric
+            counter& get_counter(std::string const& name, tag_list const& tags = {});
+            gauge& get_gauge(std::string const& name, tag_list const& tags = {});
+            histogram& get_histogram(std::string const& name, tag_list const& tags = {});
+
+            // sums the thread shards, reports the interval to the InfluxDB writer and rewrites the text file
+            void aggregate();
+            void reload_config();
+
+            std::vector<snapshot> get_snapshots() const;
+            std::string format_text() const;
+
+        private:
+            registry();
+
+            struct entry
+            {
+                std::string name;
+                tag_list tags;
+                metric_type type;
+                std::unique_ptr<counter> counter_metric;
+                std::unique_ptr<gauge> gauge_metric;
+                std::unique_ptr<histogram> histogram_metric;
+
+                std::vector<int64> last;                    // slot totals at the previous aggregation
+                snapshot current;
+            };
+
+            entry& find_or_add(std::string const& name, tag_list const& tags, metric_type type);
+
+            mutable std::mutex m_lock;
+            std::deque<entry> m_entries;
+            std::map<std::string, size_t> m_index;          // name and tags -> m_entries
+            std::string m_textFile;
+    };
+
+    // one histogram per value of a single tag, looked up once so static instances can sit in hot paths
+    class histogram_set
+    {
+        public:
+            histogram_set(std::string const& name, std::string const& tag, std::initializer_list<char const*> values)
+            {
+                for (char const* value : values)
+                    m_histograms.push_back(&registry::instance().get_histogram(name, { { tag, value } }));
+            }
+
+            histogram& operator[](size_t index) const { return *m_histograms[index]; }
+
+        private:
+            std::vector<histogram*> m_histograms;
+    };
+}
+
+#endif // MANGOSSERVER_METRIC_REGISTRY_H
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Multithreading/EpochReclaimer.h"
+#include "Policies/Singleton.h"
+#include "Util/Errors.h"
+
+#include <algorithm>
+#include <iterator>
+
+INSTANTIATE_SINGLETON_1(EpochReclaimer);
+
+EpochReclaimer::EpochReclaimer() : m_epoch(1), m_readerCount(0)
+{
+    for (auto& reader : m_readers)
+        reader = 0;
+}
+
+EpochReclaimer::~EpochReclaimer()
+{
+    // no reader is left at shutdown
+    for (Retired& retired : m_retired)
+        retired.deleter();
+}
+
+uint32 EpochReclaimer::GetReaderSlot()
+{
+    // a thread keeps its slot for its lifetime, the map update workers live as long as the server
+    thread_local uint32 slot = m_readerCount++;
+    MANGOS_ASSERT(slot < MAX_EPOCH_READERS);
+    return slot;
+}
+
+void EpochReclaimer::Retire(std::function<void()> const& deleter)
+{
+    std::lock_guard<std::mutex> guard(m_retiredLock);
+
+    // readers entering from now on get the next epoch and can only see the new copy
+    m_retired.push_back({ m_epoch.fetch_add(1), deleter });
+}
+
+void EpochReclaimer::Reclaim()
+{
+    std::vector<Retired> reclaimable;
+    {
+        std::lock_guard<std::mutex> guard(m_retiredLock);
+        if (m_retired.empty())
+            return;
+
+        uint64 oldestReader = m_epoch.load();
+        uint32 const readerCount = std::min<uint32>(m_readerCount.load(), MAX_EPOCH_READERS);
+        for (uint32 i = 0; i < readerCount; ++i)
+            if (uint64 epoch = m_readers[i].load())
+                oldestReader = std::min(oldestReader, epoch);
+
+        // a reader that entered at the epoch of a retired copy may still hold it
+        auto itr = std::partition(m_retired.begin(), m_retired.end(), [oldestReader](Retired const& retired) { return retired.epoch >= oldestReader; });
+        reclaimable.assign(std::make_move_iterator(itr), std::make_move_iterator(m_retired.end()));
+        m_retired.erase(itr, m_retired.end());
+    }
+
+    for (Retired& retired : reclaimable)
+        retired.deleter();
+}
+
+size_t EpochReclaimer::GetRetiredCount()
+{
+    std::lock_guard<std::mutex> guard(m_retiredLock);
+    return m_retired.size();
+}
+
+EpochReader::EpochReader(EpochReclaimer& reclaimer) : m_slot(&reclaimer.m_readers[reclaimer.GetReaderSlot()])
+{
+    if (m_slot->load())
+    {
+        m_slot = nullptr;
+        return;
+    }
+
+    m_slot->store(reclaimer.m_epoch.load());
+}
+
+EpochReader::~EpochReader()
+{
+    if (m_slot)
+        m_slot->store(0);
+}
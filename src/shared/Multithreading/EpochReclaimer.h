@@ -0,0 +1,86 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_EPOCH_RECLAIMER_H
+#define MANGOS_EPOCH_RECLAIMER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#define MAX_EPOCH_READERS 128
+
+/**
+ * Epoch based reclamation for data that is replaced by publishing a new copy (copy-on-write reloads).
+ *
+ * Threads that read published data without the world thread waiting on them (the map update workers)
+ * wrap their work in an EpochReader. Retire takes the deleter of a replaced copy and Reclaim, called
+ * by the world thread between its own uses of the data, runs every deleter whose copy was retired
+ * before all current readers started.
+ */
+class EpochReclaimer
+{
+    public:
+        EpochReclaimer();
+        ~EpochReclaimer();
+
+        // the new copy has to be published before its old one is retired
+        void Retire(std::function<void()> const& deleter);
+        void Reclaim();
+
+        size_t GetRetiredCount();
+
+    private:
+        friend class EpochReader;
+
+        uint32 GetReaderSlot();
+
+        struct Retired
+        {
+            uint64 epoch;
+            std::function<void()> deleter;
+        };
+
+        std::atomic<uint64> m_epoch;
+        std::atomic<uint64> m_readers[MAX_EPOCH_READERS];   // epoch the reader entered at, 0 when idle
+        std::atomic<uint32> m_readerCount;
+
+        std::vector<Retired> m_retired;
+        std::mutex m_retiredLock;
+};
+
+#define sEpochReclaimer MaNGOS::Singleton<EpochReclaimer>::Instance()
+
+class EpochReader
+{
+    public:
+        explicit EpochReader(EpochReclaimer& reclaimer);
+        ~EpochReader();
+
+        EpochReader(EpochReader const&) = delete;
+        EpochReader& operator=(EpochReader const&) = delete;
+
+    private:
+        std::atomic<uint64>* m_slot;                        // nullptr for a nested reader
+};
+
+#endif
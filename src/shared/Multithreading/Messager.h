@@ -20,6 +20,8 @@
 #define MANGOS_MESSAGER_H
 
 #include <vector>
+#include <deque>
+#include <iterator>
 #include <mutex>
 #include <functional>
 
@@ -44,8 +46,35 @@ class Messager
 
             messageVectorCopy.clear();
         }
+
+        // deferred messages are spread over several ticks: in the order they were added, at most budget of them per call (0 for all)
+        void AddDeferredMessage(const std::function<void(T*)>& message)
+        {
+            std::lock_guard<std::mutex> guard(m_messageMutex);
+            m_deferredMessages.push_back(message);
+        }
+        size_t ExecuteDeferred(T* object, size_t budget)    // returns the number of messages left
+        {
+            std::vector<std::function<void(T*)>> messageVectorCopy;
+            {
+                std::lock_guard<std::mutex> guard(m_messageMutex);
+                size_t count = budget && budget < m_deferredMessages.size() ? budget : m_deferredMessages.size();
+                messageVectorCopy.assign(std::make_move_iterator(m_deferredMessages.begin()), std::make_move_iterator(m_deferredMessages.begin() + count));
+                m_deferredMessages.erase(m_deferredMessages.begin(), m_deferredMessages.begin() + count);
+            }
+            for (auto& message : messageVectorCopy)
+                message(object);
+
+            return GetDeferredCount();
+        }
+        size_t GetDeferredCount()
+        {
+            std::lock_guard<std::mutex> guard(m_messageMutex);
+            return m_deferredMessages.size();
+        }
     private:
         std::vector<std::function<void(T*)>> m_messageVector;
+        std::deque<std::function<void(T*)>> m_deferredMessages;
         std::mutex m_messageMutex;  
 };
 
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_RECORD_QUEUE_H
+#define MANGOS_RECORD_QUEUE_H
+
+#include "Common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+// Single producer single consumer queue of variable sized records, a trivially copyable header and its payload
+// Meant for one queue per producing thread, drained by a writer thread: pushing is two memcpy and no lock.
+// Positions only ever grow and are masked into the power of two sized buffer. The consumer side has to be
+// serialized by the owner when more than one thread may drain.
+template <class Header>
+class RecordQueue
+{
+    public:
+        explicit RecordQueue(size_t capacity) : m_buffer(capacity), m_head(0), m_tail(0), m_retired(false),
+            m_queued(0), m_dropped(0), m_overflowed(0) {}
+
+        size_t GetCapacity() const { return m_buffer.size(); }
+
+        // a record of this payload size can never be queued
+        bool IsOversized(size_t length) const { return sizeof(uint32) + sizeof(Header) + length > m_buffer.size(); }
+
+        // producer side
+        bool Push(Header const& header, void const* payload, uint32 length)
+        {
+            size_t const size = sizeof(uint32) + sizeof(Header) + length;
+            size_t const head = m_head.load(std::memory_order_relaxed);
+            if (size > m_buffer.size() - (head - m_tail.load(std::memory_order_acquire)))
+                return false;
+
+            Write(head, &length, sizeof(uint32));
+            Write(head + sizeof(uint32), &header, sizeof(Header));
+            Write(head + sizeof(uint32) + sizeof(Header), payload, length);
+            m_head.store(head + size, std::memory_order_release);
+            return true;
+        }
+
+        bool IsHalfFull() const
+        {
+            return (m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_relaxed)) * 2 >= m_buffer.size();
+        }
+
+        // consumer side, payload gets null terminated
+        bool Pop(Header& header, std::vector<char>& payload)
+        {
+            size_t const tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_head.load(std::memory_order_acquire))
+                return false;
+
+            uint32 length;
+            Read(tail, &length, sizeof(uint32));
+            Read(tail + sizeof(uint32), &header, sizeof(Header));
+            payload.resize(length + 1);
+            Read(tail + sizeof(uint32) + sizeof(Header), payload.data(), length);
+            payload[length] = '\0';
+            m_tail.store(tail + sizeof(uint32) + sizeof(Header) + length, std::memory_order_release);
+            return true;
+        }
+
+        // owning thread exited, the queue can be dropped once drained
+        void Retire() { m_retired.store(true, std::memory_order_release); }
+        bool IsRetired() const { return m_retired.load(std::memory_order_acquire); }
+
+        // counters are only written by the producer, no read-modify-write needed
+        void CountQueued() { Increment(m_queued); }
+        void CountDropped() { Increment(m_dropped); }
+        void CountOverflowed() { Increment(m_overflowed); }
+
+        uint64 GetQueued() const { return m_queued.load(std::memory_order_relaxed); }
+        uint64 GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+        uint64 GetOverflowed() const { return m_overflowed.load(std::memory_order_relaxed); }
+
+    private:
+        static void Increment(std::atomic<uint64>& counter)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        void Write(size_t pos, void const* data, size_t size)
+        {
+            size_t const offset = pos & (m_buffer.size() - 1);
+            size_t const first = std::min(size, m_buffer.size() - offset);
+            std::memcpy(&m_buffer[offset], data, first);
+            std::memcpy(&m_buffer[0], static_cast<char const*>(data) + first, size - first);
+        }
+
+        void Read(size_t pos, void* data, size_t size) const
+        {
+            size_t const offset = pos & (m_buffer.size() - 1);
+            size_t const first = std::min(size, m_buffer.size() - offset);
+            std::memcpy(data, &m_buffer[offset], first);
+            std::memcpy(static_cast<char*>(data) + first, &m_buffer[0], size - first);
+        }
+
+        std::vector<char> m_buffer;
+        alignas(64) std::atomic<size_t> m_head;             // written by the producer only
+        alignas(64) std::atomic<size_t> m_tail;             // written by the consumer only
+        std::atomic<bool> m_retired;
+
+        std::atomic<uint64> m_queued;
+        std::atomic<uint64> m_dropped;
+        std::atomic<uint64> m_overflowed;
+};
+
+// Rounds a configured queue size up to the power of two RecordQueue needs
+inline size_t GetRecordQueueCapacity(size_t wanted)
+{
+    size_t capacity = 4 * 1024;
+    while (capacity < wanted && capacity < (size_t(1) << 30))
+        capacity <<= 1;
+
+    return capacity;
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_FLAT_LOOKUP_TABLE_H
+#define MANGOS_FLAT_LOOKUP_TABLE_H
+
+#include "Platform/Define.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/**
+ * Immutable uint32 keyed lookup table for data that is loaded once and only replaced by a reload.
+ *
+ * The entries are kept sorted in one vector, which gives multimap like ranges for duplicate keys,
+ * and the keys are indexed by a static open addressing hash at most half full. A lookup is one hash
+ * multiply and usually a single probe into an 8 byte slot array, without the node chasing of
+ * std::map or the per node allocations and bucket indirection of std::unordered_map.
+ *
+ * Assign builds the new arrays aside and swaps them in. Erase only marks the slot of the key, so
+ * dropping many keys after a load stays linear; the erased entries are skipped by lookups but stay
+ * in the begin/end range until the next Assign.
+ */
+template<class V>
+class FlatLookupTable
+{
+    public:
+        typedef std::pair<uint32, V> value_type;
+        typedef std::vector<value_type> Container;
+        typedef typename Container::const_iterator const_iterator;
+
+        FlatLookupTable() : m_shift(32) {}
+
+        // entries with the same key keep their order, as they would in a std::multimap
+        void Assign(Container&& entries)
+        {
+            std::stable_sort(entries.begin(), entries.end(), [](value_type const& a, value_type const& b) { return a.first < b.first; });
+
+            uint32 shift = 31;
+            while ((size_t(1) << (32 - shift)) < entries.size() * 2)
+                --shift;
+
+            std::vector<Slot> slots(size_t(1) << (32 - shift));
+            size_t const mask = slots.size() - 1;
+            for (size_t rank = 0; rank < entries.size(); ++rank)
+            {
+                // only the first entry of a key is indexed, equal_range walks on from there
+                if (rank && entries[rank - 1].first == entries[rank].first)
+                    continue;
+
+                size_t index = Hash(entries[rank].first, shift);
+                while (slots[index].rank != EMPTY_SLOT)
+                    index = (index + 1) & mask;
+
+                slots[index].key = entries[rank].first;
+                slots[index].rank = uint32(rank);
+            }
+
+            m_entries.swap(entries);
+            m_slots.swap(slots);
+            m_shift = shift;
+        }
+
+        void Erase(uint32 key)
+        {
+            if (m_slots.empty())
+                return;
+
+            size_t const mask = m_slots.size() - 1;
+            for (size_t index = Hash(key, m_shift); m_slots[index].rank != EMPTY_SLOT; index = (index + 1) & mask)
+            {
+                if (m_slots[index].key == key)
+                {
+                    // the slot keeps its key, probes for other keys must still walk past it
+                    m_slots[index].rank = ERASED_SLOT;
+                    return;
+                }
+            }
+        }
+
+        void clear()
+        {
+            Container().swap(m_entries);
+            std::vector<Slot>().swap(m_slots);
+            m_shift = 32;
+        }
+
+        const_iterator begin() const { return m_entries.begin(); }
+        const_iterator end() const { return m_entries.end(); }
+        size_t size() const { return m_entries.size(); }
+        bool empty() const { return m_entries.empty(); }
+
+        const_iterator find(uint32 key) const
+        {
+            if (m_slots.empty())
+                return m_entries.end();
+
+            size_t const mask = m_slots.size() - 1;
+            for (size_t index = Hash(key, m_shift); m_slots[index].rank != EMPTY_SLOT; index = (index + 1) & mask)
+                if (m_slots[index].key == key)
+                    return m_slots[index].rank != ERASED_SLOT ? m_entries.begin() + m_slots[index].rank : m_entries.end();
+
+            return m_entries.end();
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(uint32 key) const
+        {
+            const_iterator first = find(key);
+            const_iterator last = first;
+            while (last != m_entries.end() && last->first == key)
+                ++last;
+            return std::make_pair(first, last);
+        }
+
+        V const* Lookup(uint32 key) const
+        {
+            const_iterator itr = find(key);
+            return itr != m_entries.end() ? &itr->second : nullptr;
+        }
+
+        size_t GetMemoryUsage() const { return m_entries.capacity() * sizeof(value_type) + m_slots.capacity() * sizeof(Slot); }
+
+    private:
+        static uint32 const EMPTY_SLOT = 0xFFFFFFFF;
+        static uint32 const ERASED_SLOT = 0xFFFFFFFE;
+
+        struct Slot
+        {
+            Slot() : key(0), rank(EMPTY_SLOT) {}
+
+            uint32 key;
+            uint32 rank;                                    // position of the first entry of the key in m_entries
+        };
+
+        // fibonacci hashing, the high bits of the product are well mixed even for consecutive ids
+        static size_t Hash(uint32 key, uint32 shift) { return size_t(uint32(key * 2654435769u) >> shift); }
+
+        Container m_entries;
+        std::vector<Slot> m_slots;                          // power of two sized, linear probing
+        uint32 m_shift;                                     // 32 - log2(m_slots.size())
+};
+
+#endif
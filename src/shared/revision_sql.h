@@ -2,6 +2,6 @@
 #define __REVISION_SQL_H__
  #define REVISION_DB_REALMD "required_z2800_01_realmd_platform"
  #define REVISION_DB_LOGS "required_z2778_01_logs_anticheat"
- #define REVISION_DB_CHARACTERS "required_z2799_01_characters_account_data"
+ #define REVISION_DB_CHARACTERS "required_z2802_01_characters_mail_expire_time"
  #define REVISION_DB_MANGOS "required_z2801_01_mangos_aggro_range"
 #endif // __REVISION_SQL_H__